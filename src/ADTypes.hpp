@@ -11,6 +11,24 @@ namespace PHiLiP {
 using FadType = Sacado::Fad::DFad<double>; ///< Sacado AD type for first derivatives.
 using FadFadType = Sacado::Fad::DFad<FadType>; ///< Sacado AD type that allows 2nd derivatives.
 
+static constexpr int max_static_fad_degree = 3; ///< Highest polynomial degree differentiated with SFadType.
+/// Number of derivatives that fit in SFadType<dim,nstate>.
+/** Covers the solution of both cells of a face, (max_static_fad_degree+1)^dim * nstate each.
+ */
+template <int dim, int nstate>
+constexpr int n_static_fad_derivatives ()
+{
+    int n_dofs_cell = nstate;
+    for (int d = 0; d < dim; ++d) n_dofs_cell *= max_static_fad_degree+1;
+    return 2*n_dofs_cell;
+}
+/// Sacado AD type for first derivatives with statically allocated derivatives.
+/** The number of derivatives is set at runtime, up to n_static_fad_derivatives<dim,nstate>(),
+ *  such that it does not allocate memory. Larger cells fall back to FadType.
+ */
+template <int dim, int nstate>
+using SFadType = Sacado::Fad::SLFad<double, n_static_fad_derivatives<dim,nstate>()>;
+
 static constexpr int dimForwardAD = 1; ///< Size of the forward vector mode for CoDiPack.
 static constexpr int dimReverseAD = 1; ///< Size of the reverse vector mode for CoDiPack.
 
@@ -28,4 +46,19 @@ using RadType = codi_JacobianComputationType; ///< CoDiPaco reverse-AD type for
 using RadFadType = codi_HessianComputationType ; ///< Nested reverse-forward mode type for Jacobian and Hessian computation using TapeHelper.
 } // PHiLiP namespace
 
+namespace dealii {
+/// Allows the statically allocated Sacado types in dealii::Tensor, as done by deal.II for Sacado::Fad::DFad.
+template <typename T, int N>
+struct EnableIfScalar<Sacado::Fad::SLFad<T,N>> { using type = Sacado::Fad::SLFad<T,N>; };
+/// Product of two statically allocated Sacado types.
+template <int N>
+struct ProductType<Sacado::Fad::SLFad<double,N>, Sacado::Fad::SLFad<double,N>> { using type = Sacado::Fad::SLFad<double,N>; };
+/// Product of a statically allocated Sacado type with a double.
+template <int N>
+struct ProductType<Sacado::Fad::SLFad<double,N>, double> { using type = Sacado::Fad::SLFad<double,N>; };
+/// Product of a double with a statically allocated Sacado type.
+template <int N>
+struct ProductType<double, Sacado::Fad::SLFad<double,N>> { using type = Sacado::Fad::SLFad<double,N>; };
+} // dealii namespace
+
 #endif
@@ -1,11 +1,16 @@
+#include<algorithm>
 #include<limits>
 #include<fstream>
 #include <deal.II/base/parameter_handler.h>
 #include <deal.II/base/tensor.h>
+#include <deal.II/base/std_cxx17/optional.h>
 
 #include <deal.II/base/qprojector.h>
+#include <deal.II/base/work_stream.h>
+#include <deal.II/base/graph_coloring.h>
 
 #include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
 #include <deal.II/grid/grid_refinement.h>
 
 #include <deal.II/dofs/dof_handler.h>
@@ -48,13 +53,7 @@
 #include <EpetraExt_Transpose_RowMatrix.h>
 
 
-#include "global_counter.hpp"
-
-unsigned int n_vmult;
-unsigned int dRdW_form;
-unsigned int dRdW_mult;
-unsigned int dRdX_mult;
-unsigned int d2R_mult;
+#include "telemetry/telemetry.h"
 
 
 namespace PHiLiP {
@@ -67,6 +66,21 @@ std::vector< real > project_function(
     const dealii::FESystem<dim,dim> &fe_output,
     const dealii::QGauss<dim> &projection_quadrature);
 
+namespace {
+    /// Whether the locally owned values of @p a and @p b differ on any process.
+    template <typename real>
+    bool vectors_differ(
+        const dealii::LinearAlgebra::distributed::Vector<real> &a,
+        const dealii::LinearAlgebra::distributed::Vector<real> &b,
+        const MPI_Comm mpi_communicator)
+    {
+        const bool local_differ = a.size() != b.size()
+                                  || a.locally_owned_elements() != b.locally_owned_elements()
+                                  || !std::equal(a.begin(), a.end(), b.begin());
+        return dealii::Utilities::MPI::max(local_differ ? 1 : 0, mpi_communicator) == 1;
+    }
+} // anonymous namespace
+
 
 template <int dim, typename real>
 DGBase<dim,real>::DGBase(
@@ -119,6 +133,9 @@ void DGBase<dim,real>::set_high_order_grid(std::shared_ptr<HighOrderGrid<dim,rea
 {
     high_order_grid = new_high_order_grid;
     triangulation = high_order_grid->triangulation;
+    // The volume_nodes version of the new grid says nothing about the cached metric terms.
+    volume_metric_terms_cache.reinit(0, 0);
+    face_metric_terms_cache.reinit(0, 0);
     dof_handler.initialize(*triangulation, fe_collection);
     dof_handler_artificial_dissipation.initialize(*triangulation, fe_q_artificial_dissipation);
     set_all_cells_fe_degree(max_degree);
@@ -246,6 +263,7 @@ DGBaseState<dim,nstate,real>::DGBaseState(
 {
     pde_physics_double = Physics::PhysicsFactory<dim,nstate,real> ::create_Physics(parameters_input);
     pde_physics_fad = Physics::PhysicsFactory<dim,nstate,FadType> ::create_Physics(parameters_input);
+    pde_physics_sfad = Physics::PhysicsFactory<dim,nstate,SFadType<dim,nstate>> ::create_Physics(parameters_input);
     pde_physics_rad = Physics::PhysicsFactory<dim,nstate,RadType> ::create_Physics(parameters_input);
     pde_physics_fad_fad = Physics::PhysicsFactory<dim,nstate,FadFadType> ::create_Physics(parameters_input);
     pde_physics_rad_fad = Physics::PhysicsFactory<dim,nstate,RadFadType> ::create_Physics(parameters_input);
@@ -262,6 +280,14 @@ void DGBaseState<dim,nstate,real>::reset_numerical_fluxes()
     conv_num_flux_fad = NumericalFlux::NumericalFluxFactory<dim, nstate, FadType> ::create_convective_numerical_flux (all_parameters->conv_num_flux_type, pde_physics_fad);
     diss_num_flux_fad = NumericalFlux::NumericalFluxFactory<dim, nstate, FadType> ::create_dissipative_numerical_flux (all_parameters->diss_num_flux_type, pde_physics_fad);
 
+    if (pde_physics_sfad) {
+        conv_num_flux_sfad = NumericalFlux::NumericalFluxFactory<dim, nstate, SFadType<dim,nstate>> ::create_convective_numerical_flux (all_parameters->conv_num_flux_type, pde_physics_sfad);
+        diss_num_flux_sfad = NumericalFlux::NumericalFluxFactory<dim, nstate, SFadType<dim,nstate>> ::create_dissipative_numerical_flux (all_parameters->diss_num_flux_type, pde_physics_sfad);
+    } else {
+        conv_num_flux_sfad = nullptr;
+        diss_num_flux_sfad = nullptr;
+    }
+
     conv_num_flux_rad = NumericalFlux::NumericalFluxFactory<dim, nstate, RadType> ::create_convective_numerical_flux (all_parameters->conv_num_flux_type, pde_physics_rad);
     diss_num_flux_rad = NumericalFlux::NumericalFluxFactory<dim, nstate, RadType> ::create_dissipative_numerical_flux (all_parameters->diss_num_flux_type, pde_physics_rad);
 
@@ -282,6 +308,8 @@ void DGBaseState<dim,nstate,real>::set_physics(
 {
     pde_physics_double = pde_physics_double_input;
     pde_physics_fad = pde_physics_fad_input;
+    // The given physics can not be duplicated with SFadType, so the Jacobians use pde_physics_fad.
+    pde_physics_sfad = nullptr;
     pde_physics_rad = pde_physics_rad_input;
     pde_physics_fad_fad = pde_physics_fad_fad_input;
     pde_physics_rad_fad = pde_physics_rad_fad_input;
@@ -474,15 +502,22 @@ void DGBase<dim,real>::assemble_cell_residual (
 
     const dealii::types::global_dof_index current_cell_index = current_cell->active_cell_index();
 
-    assemble_volume_term_explicit (
-        current_cell,
-        current_cell_index,
-        fe_values_volume,
-        current_dofs_indices,
-        current_cell_rhs,
-        fe_values_lagrange);
-    current_cell_rhs*=0.0;
-    //if ( compute_dRdW || compute_dRdX || compute_d2R ) {
+    {
+    const Telemetry::ScopedTimer volume_timer("volume");
+    const bool compute_derivatives = compute_dRdW || compute_dRdX || compute_d2R;
+    if (assembly_uses_fe_values_geometry()) {
+        // Also evaluates the cell's largest stable time step.
+        assemble_volume_term_explicit (
+            current_cell,
+            current_cell_index,
+            fe_values_volume,
+            current_dofs_indices,
+            current_cell_rhs,
+            fe_values_lagrange);
+        // The derivatives assembly below evaluates the residual again.
+        if (compute_derivatives) current_cell_rhs*=0.0;
+    }
+    if (compute_derivatives || !assembly_uses_fe_values_geometry()) {
         assemble_volume_term_derivatives (
             current_cell,
             current_cell_index,
@@ -490,6 +525,8 @@ void DGBase<dim,real>::assemble_cell_residual (
             current_metric_dofs_indices, current_dofs_indices,
             current_cell_rhs, fe_values_lagrange,
             compute_dRdW, compute_dRdX, compute_d2R);
+    }
+    }
     //} else {
     //    assemble_volume_term_explicit (
     //    cell,
@@ -513,6 +550,7 @@ void DGBase<dim,real>::assemble_cell_residual (
 
         // CASE 1: FACE AT BOUNDARY
         if (current_face->at_boundary() && !current_cell->has_periodic_neighbor(iface) ) {
+            const Telemetry::ScopedTimer boundary_timer("boundary");
 
             fe_values_collection_face_int.reinit(current_cell, iface, i_quad, i_mapp, i_fele);
 
@@ -548,6 +586,7 @@ void DGBase<dim,real>::assemble_cell_residual (
 
 
             if (!current_cell->periodic_neighbor_is_coarser(iface) && current_cell_should_do_the_work(current_cell, neighbor_cell)) {
+                const Telemetry::ScopedTimer face_timer("face");
 
                 Assert (current_cell->periodic_neighbor(iface).state() == dealii::IteratorState::valid, dealii::ExcInternalError());
 
@@ -638,6 +677,7 @@ void DGBase<dim,real>::assemble_cell_residual (
         // CASE 4: NEIGHBOR IS COARSER
         // Assemble face residual.
         } else if (current_cell->neighbor(iface)->face(current_cell->neighbor_face_no(iface))->has_children()) {
+            const Telemetry::ScopedTimer face_timer("face");
 
             Assert (current_cell->neighbor(iface).state() == dealii::IteratorState::valid, dealii::ExcInternalError());
             Assert (!(current_cell->neighbor(iface)->has_children()), dealii::ExcInternalError());
@@ -733,6 +773,7 @@ void DGBase<dim,real>::assemble_cell_residual (
         // CASE 5: NEIGHBOR CELL HAS SAME COARSENESS
         // Therefore, we need to choose one of them to do the work
         } else if ( current_cell_should_do_the_work(current_cell, current_cell->neighbor(iface)) ) {
+            const Telemetry::ScopedTimer face_timer("face");
             Assert (current_cell->neighbor(iface).state() == dealii::IteratorState::valid, dealii::ExcInternalError());
 
             const auto neighbor_cell = current_cell->neighbor_or_periodic_neighbor(iface);
@@ -826,10 +867,359 @@ void DGBase<dim,real>::assemble_cell_residual (
     }
 }
 
+template <int dim, typename real>
+DGBase<dim,real>::AssemblyScratchData::AssemblyScratchData (
+    const dealii::hp::MappingCollection<dim> &mapping_collection,
+    const dealii::hp::FECollection<dim>      &fe_collection,
+    const dealii::hp::FECollection<dim>      &fe_collection_lagrange,
+    const dealii::hp::QCollection<dim>       &volume_quadrature_collection,
+    const dealii::hp::QCollection<dim-1>     &face_quadrature_collection,
+    const dealii::UpdateFlags volume_update_flags,
+    const dealii::UpdateFlags face_update_flags,
+    const dealii::UpdateFlags neighbor_face_update_flags)
+    : mapping_collection(mapping_collection)
+    , fe_collection(fe_collection)
+    , fe_collection_lagrange(fe_collection_lagrange)
+    , volume_quadrature_collection(volume_quadrature_collection)
+    , face_quadrature_collection(face_quadrature_collection)
+    , volume_update_flags(volume_update_flags)
+    , face_update_flags(face_update_flags)
+    , neighbor_face_update_flags(neighbor_face_update_flags)
+    , fe_values_collection_volume (mapping_collection, fe_collection, volume_quadrature_collection, volume_update_flags)
+    , fe_values_collection_face_int (mapping_collection, fe_collection, face_quadrature_collection, face_update_flags)
+    , fe_values_collection_face_ext (mapping_collection, fe_collection, face_quadrature_collection, neighbor_face_update_flags)
+    , fe_values_collection_subface (mapping_collection, fe_collection, face_quadrature_collection, face_update_flags)
+    , fe_values_collection_volume_lagrange (mapping_collection, fe_collection_lagrange, volume_quadrature_collection, volume_update_flags)
+{ }
+
+template <int dim, typename real>
+DGBase<dim,real>::AssemblyScratchData::AssemblyScratchData (const AssemblyScratchData &scratch_data)
+    : AssemblyScratchData (
+        scratch_data.mapping_collection,
+        scratch_data.fe_collection,
+        scratch_data.fe_collection_lagrange,
+        scratch_data.volume_quadrature_collection,
+        scratch_data.face_quadrature_collection,
+        scratch_data.volume_update_flags,
+        scratch_data.face_update_flags,
+        scratch_data.neighbor_face_update_flags)
+{ }
+
+template <int dim, typename real>
+void DGBase<dim,real>::color_locally_owned_cells ()
+{
+    using ActiveCellIterator = typename dealii::DoFHandler<dim>::active_cell_iterator;
+
+    // A cell writes into its own residual and into the residual of the neighbors
+    // for which it does the face work. Two cells therefore conflict if their
+    // stencils of face neighbors overlap.
+    const auto get_conflict_indices = [&] (const ActiveCellIterator &cell)
+    {
+        std::vector<dealii::types::global_dof_index> conflict_indices;
+        std::vector<dealii::types::global_dof_index> dofs_indices;
+
+        const auto add_cell_dofs = [&] (const auto &stencil_cell)
+        {
+            dofs_indices.resize(stencil_cell->get_fe().n_dofs_per_cell());
+            stencil_cell->get_dof_indices(dofs_indices);
+            conflict_indices.insert(conflict_indices.end(), dofs_indices.begin(), dofs_indices.end());
+        };
+
+        add_cell_dofs(cell);
+        for (unsigned int iface=0; iface < dealii::GeometryInfo<dim>::faces_per_cell; ++iface) {
+            if (cell->face(iface)->at_boundary() && !cell->has_periodic_neighbor(iface)) continue;
+
+            const auto neighbor_cell = cell->neighbor_or_periodic_neighbor(iface);
+            if (neighbor_cell->is_active()) {
+                add_cell_dofs(neighbor_cell);
+            } else {
+                // Finer neighbors. Including all the active children is conservative, but simple.
+                for (const auto &child_cell : dealii::GridTools::get_active_child_cells<dealii::DoFHandler<dim>>(neighbor_cell)) {
+                    if (child_cell->is_artificial()) continue;
+                    add_cell_dofs(child_cell);
+                }
+            }
+        }
+        std::sort(conflict_indices.begin(), conflict_indices.end());
+        conflict_indices.erase(std::unique(conflict_indices.begin(), conflict_indices.end()), conflict_indices.end());
+        return conflict_indices;
+    };
+
+    std::vector<ActiveCellIterator> locally_owned_cells;
+    for (auto cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell) {
+        if (cell->is_locally_owned()) locally_owned_cells.push_back(cell);
+    }
+
+    using CellListIterator = typename std::vector<ActiveCellIterator>::const_iterator;
+    const std::vector<std::vector<CellListIterator>> colored_list_iterators = dealii::GraphColoring::make_graph_coloring(
+        locally_owned_cells.cbegin(),
+        locally_owned_cells.cend(),
+        [&get_conflict_indices] (const CellListIterator &cell) { return get_conflict_indices(*cell); });
+
+    colored_locally_owned_cells.clear();
+    colored_locally_owned_cells.resize(colored_list_iterators.size());
+    for (unsigned int icolor = 0; icolor < colored_list_iterators.size(); ++icolor) {
+        for (const auto &cell : colored_list_iterators[icolor]) {
+            colored_locally_owned_cells[icolor].push_back(*cell);
+        }
+    }
+}
+
+template <int dim, typename real>
+void DGBase<dim,real>::MetricTermsCache::reinit (const unsigned int n_slots, const unsigned int max_n_quad_pts_input, const bool store_face_terms)
+{
+    max_n_quad_pts = max_n_quad_pts_input;
+    n_quad_pts.assign(n_slots, 0);
+    jacobian_determinant.assign(n_slots*max_n_quad_pts, 0.0);
+    jacobian_transpose_inverse.assign(n_slots*max_n_quad_pts*dim*dim, 0.0);
+    JxW.assign(n_slots*max_n_quad_pts, 0.0);
+    unit_normal.assign(store_face_terms ? n_slots*max_n_quad_pts*dim : 0, 0.0);
+    surface_jacobian_determinant.assign(store_face_terms ? n_slots*max_n_quad_pts : 0, 0.0);
+}
+
+template <int dim, typename real>
+bool DGBase<dim,real>::MetricTermsCache::load (
+    const unsigned int slot,
+    std::vector<real> &jacobian_determinant_output,
+    std::vector<dealii::Tensor<2,dim,real>> &jacobian_transpose_inverse_output,
+    std::vector<real> &JxW_output,
+    std::vector<dealii::Tensor<1,dim,real>> &unit_normal_output,
+    std::vector<real> &surface_jacobian_determinant_output) const
+{
+    const unsigned int n_quad_pts_slot = jacobian_determinant_output.size();
+    if (slot >= n_quad_pts.size() || n_quad_pts[slot] != n_quad_pts_slot) return false;
+    const bool load_face_terms = !unit_normal_output.empty();
+    if (load_face_terms && unit_normal.empty()) return false;
+
+    const real *det = &jacobian_determinant[slot*max_n_quad_pts];
+    const real *jac = &jacobian_transpose_inverse[slot*max_n_quad_pts*dim*dim];
+    const real *jxw = &JxW[slot*max_n_quad_pts];
+    for (unsigned int iquad=0; iquad<n_quad_pts_slot; ++iquad) {
+        jacobian_determinant_output[iquad] = det[iquad];
+        for (int row=0; row<dim; ++row) {
+            for (int col=0; col<dim; ++col) {
+                jacobian_transpose_inverse_output[iquad][row][col] = *jac++;
+            }
+        }
+        JxW_output[iquad] = jxw[iquad];
+    }
+    if (load_face_terms) {
+        const real *normal = &unit_normal[slot*max_n_quad_pts*dim];
+        const real *surface_det = &surface_jacobian_determinant[slot*max_n_quad_pts];
+        for (unsigned int iquad=0; iquad<n_quad_pts_slot; ++iquad) {
+            for (int d=0; d<dim; ++d) {
+                unit_normal_output[iquad][d] = *normal++;
+            }
+            surface_jacobian_determinant_output[iquad] = surface_det[iquad];
+        }
+    }
+    return true;
+}
+
+template <int dim, typename real>
+void DGBase<dim,real>::MetricTermsCache::store (
+    const unsigned int slot,
+    const std::vector<real> &jacobian_determinant_input,
+    const std::vector<dealii::Tensor<2,dim,real>> &jacobian_transpose_inverse_input,
+    const std::vector<real> &JxW_input,
+    const std::vector<dealii::Tensor<1,dim,real>> &unit_normal_input,
+    const std::vector<real> &surface_jacobian_determinant_input)
+{
+    const unsigned int n_quad_pts_slot = jacobian_determinant_input.size();
+    if (slot >= n_quad_pts.size() || n_quad_pts_slot > max_n_quad_pts) return;
+    // A face slot is only filled once its face terms are known.
+    if (!unit_normal.empty() && unit_normal_input.size() != n_quad_pts_slot) return;
+
+    real *det = &jacobian_determinant[slot*max_n_quad_pts];
+    real *jac = &jacobian_transpose_inverse[slot*max_n_quad_pts*dim*dim];
+    real *jxw = &JxW[slot*max_n_quad_pts];
+    for (unsigned int iquad=0; iquad<n_quad_pts_slot; ++iquad) {
+        det[iquad] = jacobian_determinant_input[iquad];
+        for (int row=0; row<dim; ++row) {
+            for (int col=0; col<dim; ++col) {
+                *jac++ = jacobian_transpose_inverse_input[iquad][row][col];
+            }
+        }
+        jxw[iquad] = JxW_input[iquad];
+    }
+    if (!unit_normal.empty()) {
+        real *normal = &unit_normal[slot*max_n_quad_pts*dim];
+        real *surface_det = &surface_jacobian_determinant[slot*max_n_quad_pts];
+        for (unsigned int iquad=0; iquad<n_quad_pts_slot; ++iquad) {
+            for (int d=0; d<dim; ++d) {
+                *normal++ = unit_normal_input[iquad][d];
+            }
+            surface_det[iquad] = surface_jacobian_determinant_input[iquad];
+        }
+    }
+    n_quad_pts[slot] = n_quad_pts_slot;
+}
+
+template <int dim, typename real>
+void DGBase<dim,real>::update_metric_terms_caches ()
+{
+    const unsigned int volume_nodes_version = high_order_grid->get_volume_nodes_version();
+    const unsigned int n_active_cells = triangulation->n_active_cells();
+#ifdef DEBUG
+    const double volume_nodes_l2norm = high_order_grid->volume_nodes.l2_norm();
+#endif
+    if (volume_nodes_version == metric_terms_cache_volume_nodes_version
+        && volume_metric_terms_cache.n_quad_pts.size() == n_active_cells) {
+#ifdef DEBUG
+        Assert(std::abs(volume_nodes_l2norm - metric_terms_cache_volume_nodes_l2norm)
+                   <= 1e-14 * std::max(volume_nodes_l2norm, metric_terms_cache_volume_nodes_l2norm),
+               dealii::ExcMessage("The volume_nodes have been modified without calling volume_nodes_modified(), "
+                                  "the cached metric terms are out of date."));
+#endif
+        return;
+    }
+
+    unsigned int max_n_volume_quad_pts = 0;
+    for (unsigned int i_quad = 0; i_quad < volume_quadrature_collection.size(); ++i_quad) {
+        max_n_volume_quad_pts = std::max(max_n_volume_quad_pts, volume_quadrature_collection[i_quad].size());
+    }
+    unsigned int max_n_face_quad_pts = 0;
+    for (unsigned int i_quad = 0; i_quad < face_quadrature_collection.size(); ++i_quad) {
+        max_n_face_quad_pts = std::max(max_n_face_quad_pts, face_quadrature_collection[i_quad].size());
+    }
+    volume_metric_terms_cache.reinit(n_active_cells, max_n_volume_quad_pts);
+    face_metric_terms_cache.reinit(n_active_cells*dealii::GeometryInfo<dim>::faces_per_cell, max_n_face_quad_pts, true);
+
+    metric_terms_cache_volume_nodes_version = volume_nodes_version;
+#ifdef DEBUG
+    metric_terms_cache_volume_nodes_l2norm = volume_nodes_l2norm;
+#endif
+}
+
 template <int dim, typename real>
 void DGBase<dim,real>::set_dual(const dealii::LinearAlgebra::distributed::Vector<real> &dual_input)
 {
+    if (!vectors_differ(dual, dual_input, mpi_communicator)) return;
     dual = dual_input;
+    dual_modified();
+}
+
+template <int dim, typename real>
+void DGBase<dim,real>::set_solution(const dealii::LinearAlgebra::distributed::Vector<double> &solution_input)
+{
+    if (!vectors_differ(solution, solution_input, mpi_communicator)) return;
+    solution = solution_input;
+    solution.update_ghost_values();
+    solution_modified();
+}
+
+template <int dim, typename real>
+void DGBase<dim,real>::solution_modified() {
+    solution_version = ++latest_solution_version;
+}
+
+template <int dim, typename real>
+void DGBase<dim,real>::restore_solution_version(const unsigned int version) {
+    Assert(version <= latest_solution_version, dealii::ExcMessage("Can only restore a previous solution version."));
+    solution_version = version;
+}
+
+template <int dim, typename real>
+unsigned int DGBase<dim,real>::get_solution_version() const {
+    return solution_version;
+}
+
+template <int dim, typename real>
+void DGBase<dim,real>::dual_modified() {
+    ++dual_version;
+}
+
+template <int dim, typename real>
+unsigned int DGBase<dim,real>::get_dual_version() const {
+    return dual_version;
+}
+
+template <int dim, typename real>
+unsigned int DGBase<dim,real>::get_allocation_version() const {
+    return allocation_version;
+}
+
+template <int dim, typename real>
+StateVersions DGBase<dim,real>::get_state_versions(const bool with_dual) const
+{
+    StateVersions versions;
+    versions.solution = solution_version;
+    versions.volume_nodes = high_order_grid->get_volume_nodes_version();
+    if (with_dual) versions.dual = dual_version;
+#ifdef DEBUG
+    versions.solution_l2norm = solution.l2_norm();
+    versions.volume_nodes_l2norm = high_order_grid->volume_nodes.l2_norm();
+    if (with_dual) versions.dual_l2norm = dual.l2_norm();
+#endif
+    return versions;
+}
+
+template <int dim, typename real>
+void DGBase<dim,real>::build_discontinuity_sensor_operators()
+{
+    discontinuity_sensor_operators.clear();
+    discontinuity_sensor_operators.resize(fe_collection.size());
+    for (unsigned int i_fele = 0; i_fele < fe_collection.size(); ++i_fele) {
+        const dealii::FESystem<dim,dim> &fe_high = fe_collection[i_fele];
+        const unsigned int degree = fe_high.tensor_degree();
+        if (degree == 0) continue;
+
+        // Only the first state is used by the sensor.
+        const unsigned int istate = 0;
+        const unsigned int n_dofs_high = fe_high.dofs_per_cell / fe_high.n_components();
+
+        // Lower degree basis.
+        const dealii::FE_DGQLegendre<dim> fe_lower(degree-1);
+        const unsigned int n_dofs_lower = fe_lower.dofs_per_cell;
+
+        // L2-projection onto the lower degree basis, P = M_{p-1}^{-1} V_{p-1}^T W V_p
+        const dealii::QGauss<dim> projection_quadrature(degree+5);
+        const unsigned int n_projection_quad_pts = projection_quadrature.size();
+        dealii::FullMatrix<double> lower_basis(n_projection_quad_pts, n_dofs_lower);
+        dealii::FullMatrix<double> weighted_lower_basis(n_projection_quad_pts, n_dofs_lower);
+        dealii::FullMatrix<double> high_basis(n_projection_quad_pts, n_dofs_high);
+        for (unsigned int iquad=0; iquad<n_projection_quad_pts; ++iquad) {
+            const dealii::Point<dim,double> &point = projection_quadrature.point(iquad);
+            const double weight = projection_quadrature.weight(iquad);
+            for (unsigned int idof=0; idof<n_dofs_lower; ++idof) {
+                lower_basis[iquad][idof] = fe_lower.shape_value(idof, point);
+                weighted_lower_basis[iquad][idof] = weight * lower_basis[iquad][idof];
+            }
+            for (unsigned int idof=0; idof<n_dofs_high; ++idof) {
+                const unsigned int idof_vector = fe_high.component_to_system_index(istate,idof);
+                high_basis[iquad][idof] = fe_high.shape_value_component(idof_vector, point, istate);
+            }
+        }
+        dealii::FullMatrix<double> lower_mass(n_dofs_lower, n_dofs_lower);
+        weighted_lower_basis.Tmmult(lower_mass, lower_basis);
+        dealii::FullMatrix<double> inverse_lower_mass(n_dofs_lower, n_dofs_lower);
+        inverse_lower_mass.invert(lower_mass);
+        dealii::FullMatrix<double> projection_rhs(n_dofs_lower, n_dofs_high);
+        weighted_lower_basis.Tmmult(projection_rhs, high_basis);
+        dealii::FullMatrix<double> projection(n_dofs_lower, n_dofs_high);
+        inverse_lower_mass.mmult(projection, projection_rhs);
+
+        // Interpolation onto the volume quadrature points.
+        const dealii::Quadrature<dim> &quadrature = volume_quadrature_collection[i_fele];
+        const unsigned int n_quad_pts = quadrature.size();
+        DiscontinuitySensorOperators &operators = discontinuity_sensor_operators[i_fele];
+        operators.soln_at_quad.reinit(n_quad_pts, n_dofs_high);
+        dealii::FullMatrix<double> lower_at_quad(n_quad_pts, n_dofs_lower);
+        for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+            const dealii::Point<dim,double> &point = quadrature.point(iquad);
+            for (unsigned int idof=0; idof<n_dofs_high; ++idof) {
+                const unsigned int idof_vector = fe_high.component_to_system_index(istate,idof);
+                operators.soln_at_quad[iquad][idof] = fe_high.shape_value_component(idof_vector, point, istate);
+            }
+            for (unsigned int idof=0; idof<n_dofs_lower; ++idof) {
+                lower_at_quad[iquad][idof] = fe_lower.shape_value(idof, point);
+            }
+        }
+        operators.projection_error_at_quad.reinit(n_quad_pts, n_dofs_high);
+        lower_at_quad.mmult(operators.projection_error_at_quad, projection);
+        operators.projection_error_at_quad *= -1.0;
+        operators.projection_error_at_quad.add(1.0, operators.soln_at_quad);
+    }
 }
 
 template <int dim, typename real>
@@ -837,16 +1227,19 @@ void DGBase<dim,real>::update_artificial_dissipation_discontinuity_sensor()
 {
     const auto mapping = (*(high_order_grid->mapping_fe_field));
     dealii::hp::MappingCollection<dim> mapping_collection(mapping);
-    const dealii::UpdateFlags update_flags = dealii::update_values | dealii::update_JxW_values;
+    const dealii::UpdateFlags update_flags = dealii::update_JxW_values;
     dealii::hp::FEValues<dim,dim> fe_values_collection_volume (mapping_collection, fe_collection, volume_quadrature_collection, update_flags); ///< FEValues of volume.
 
-    std::vector< double > soln_coeff_high;
+    dealii::Vector< double > soln_coeff_high;
+    dealii::Vector< double > soln_high;
+    dealii::Vector< double > soln_error;
     std::vector<dealii::types::global_dof_index> dof_indices;
 
     const unsigned int n_dofs_arti_diss = fe_q_artificial_dissipation.dofs_per_cell;
     std::vector<dealii::types::global_dof_index> dof_indices_artificial_dissipation(n_dofs_arti_diss);
 
     if (freeze_artificial_dissipation) return;
+    if (discontinuity_sensor_operators.empty()) build_discontinuity_sensor_operators();
     artificial_dissipation_c0 *= 0.0;
     for (auto cell : dof_handler.active_cell_iterators()) {
         if (!(cell->is_locally_owned() || cell->is_ghost())) continue;
@@ -867,7 +1260,6 @@ void DGBase<dim,real>::update_artificial_dissipation_discontinuity_sensor()
 
         if (degree == 0) continue;
 
-        const unsigned int nstate = fe_high.components;
         const unsigned int n_dofs_high = fe_high.dofs_per_cell;
 
         fe_values_collection_volume.reinit (cell, i_quad, i_mapp, i_fele);
@@ -876,55 +1268,28 @@ void DGBase<dim,real>::update_artificial_dissipation_discontinuity_sensor()
         dof_indices.resize(n_dofs_high);
         cell->get_dof_indices (dof_indices);
 
-        soln_coeff_high.resize(n_dofs_high);
-        for (unsigned int idof=0; idof<n_dofs_high; ++idof) {
-            soln_coeff_high[idof] = solution[dof_indices[idof]];
+        // Only integrate over the first state variable.
+        // Persson and Peraire only did density.
+        const DiscontinuitySensorOperators &sensor_operators = discontinuity_sensor_operators[i_fele];
+        const unsigned int n_dofs_state = sensor_operators.soln_at_quad.n();
+        const unsigned int n_quad_pts = sensor_operators.soln_at_quad.m();
+        soln_coeff_high.reinit(n_dofs_state);
+        for (unsigned int idof=0; idof<n_dofs_state; ++idof) {
+            soln_coeff_high[idof] = solution[dof_indices[fe_high.component_to_system_index(0,idof)]];
         }
-
-        // Lower degree basis.
-        const unsigned int lower_degree = degree-1;
-        const dealii::FE_DGQLegendre<dim> fe_dgq_lower(lower_degree);
-        const dealii::FESystem<dim,dim> fe_lower(fe_dgq_lower, nstate);
-
-        // Projection quadrature.
-        const dealii::QGauss<dim> projection_quadrature(degree+5);
-        std::vector< double > soln_coeff_lower = project_function<dim,double>( soln_coeff_high, fe_high, fe_lower, projection_quadrature);
-
-        // Quadrature used for solution difference.
-        const dealii::Quadrature<dim> &quadrature = fe_values_volume.get_quadrature();
-        const std::vector<dealii::Point<dim,double>> &unit_quad_pts = quadrature.get_points();
-
-        const unsigned int n_quad_pts = quadrature.size();
-        const unsigned int n_dofs_lower = fe_lower.dofs_per_cell;
+        soln_high.reinit(n_quad_pts);
+        soln_error.reinit(n_quad_pts);
+        sensor_operators.soln_at_quad.vmult(soln_high, soln_coeff_high);
+        sensor_operators.projection_error_at_quad.vmult(soln_error, soln_coeff_high);
 
         double element_volume = 0.0;
         double error = 0.0;
         double soln_norm = 0.0;
-        std::vector<double> soln_high(nstate);
-        std::vector<double> soln_lower(nstate);
         for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
-            for (unsigned int s=0; s<nstate; ++s) {
-                soln_high[s] = 0.0;
-                soln_lower[s] = 0.0;
-            }
-            // Interpolate solution
-            for (unsigned int idof=0; idof<n_dofs_high; ++idof) {
-                  const unsigned int istate = fe_high.system_to_component_index(idof).first;
-                  soln_high[istate] += soln_coeff_high[idof] * fe_high.shape_value_component(idof,unit_quad_pts[iquad],istate);
-            }
-            // Interpolate low order solution
-            for (unsigned int idof=0; idof<n_dofs_lower; ++idof) {
-                  const unsigned int istate = fe_lower.system_to_component_index(idof).first;
-                  soln_lower[istate] += soln_coeff_lower[idof] * fe_lower.shape_value_component(idof,unit_quad_pts[iquad],istate);
-            }
-            // Quadrature
-            element_volume += fe_values_volume.JxW(iquad);
-            // Only integrate over the first state variable.
-            // Persson and Peraire only did density.
-            for (unsigned int s=0; s<1/*nstate*/; ++s) {
-                error += (soln_high[s] - soln_lower[s]) * (soln_high[s] - soln_lower[s]) * fe_values_volume.JxW(iquad);
-                soln_norm += soln_high[s] * soln_high[s] * fe_values_volume.JxW(iquad);
-            }
+            const double JxW = fe_values_volume.JxW(iquad);
+            element_volume += JxW;
+            error += soln_error[iquad] * soln_error[iquad] * JxW;
+            soln_norm += soln_high[iquad] * soln_high[iquad] * JxW;
         }
 
         //std::cout << " error: " << error
@@ -1006,67 +1371,65 @@ void DGBase<dim,real>::update_artificial_dissipation_discontinuity_sensor()
 
 
 template <int dim, typename real>
-void DGBase<dim,real>::assemble_residual (const bool compute_dRdW, const bool compute_dRdX, const bool compute_d2R, const double CFL_mass)
+void DGBase<dim,real>::assemble_residual (const bool compute_dRdW_input, const bool compute_dRdX_input, const bool compute_d2R_input, const double CFL_mass)
 {
+    const int n_requested_derivatives = compute_dRdW_input + compute_dRdX_input + compute_d2R_input;
+    const Telemetry::ScopedTimer timer(n_requested_derivatives > 1 ? "assemble_fused"
+                                       : compute_dRdW_input ? "assemble_dRdW"
+                                       : compute_dRdX_input ? "assemble_dRdX"
+                                       : compute_d2R_input ? "assemble_d2R"
+                                       : "assemble_residual");
     dealii::deal_II_exceptions::disable_abort_on_exception(); // Allows us to catch negative Jacobians.
-    Assert( !(compute_dRdW && compute_dRdX)
-        &&  !(compute_dRdW && compute_d2R)
-        &&  !(compute_dRdX && compute_d2R)
-            , dealii::ExcMessage("Can only do one at a time compute_dRdW or compute_dRdX or compute_d2R"));
+
+    // Any combination of derivatives is assembled in a single pass over the cells.
+    // The derivatives that are already assembled at the current state are skipped.
+    bool compute_dRdW = compute_dRdW_input;
+    bool compute_dRdX = compute_dRdX_input;
+    bool compute_d2R = compute_d2R_input;
 
     //pcout << "Assembling DG residual...";
+    const StateVersions state_versions = get_state_versions();
+    const StateVersions state_versions_with_dual = get_state_versions(true);
     if (compute_dRdW) {
         pcout << " with dRdW...";
-
-        auto diff_sol = solution;
-        diff_sol -= solution_dRdW;
-        const double l2_norm_sol = diff_sol.l2_norm();
-
-        if (l2_norm_sol == 0.0) {
-
-            auto diff_node = high_order_grid->volume_nodes;
-            diff_node -= volume_nodes_dRdW;
-            const double l2_norm_node = diff_node.l2_norm();
-
-            if (l2_norm_node == 0.0) {
-                if (CFL_mass_dRdW == CFL_mass) {
-                    pcout << " which is already assembled..." << std::endl;
-                    return;
-                }
-            }
+        if (dRdW_stamp.is_current(state_versions) && CFL_mass_dRdW == CFL_mass) {
+            pcout << " which is already assembled...";
+            compute_dRdW = false;
+        }
+    }
+    if (compute_dRdX) {
+        pcout << " with dRdX...";
+        if (dRdX_stamp.is_current(state_versions)) {
+            pcout << " which is already assembled...";
+            compute_dRdX = false;
+        }
+    }
+    if (compute_d2R) {
+        pcout << " with d2RdWdW, d2RdWdX, d2RdXdX...";
+        if (d2R_stamp.is_current(state_versions_with_dual)) {
+            pcout << " which is already assembled...";
+            compute_d2R = false;
         }
+    }
+    if (n_requested_derivatives > 0 && !compute_dRdW && !compute_dRdX && !compute_d2R) {
+        pcout << std::endl;
+        return;
+    }
+
+    if (compute_dRdW) {
         {
             int n_stencil = 1 + std::pow(2,dim);
             int n_dofs_cell = nstate*std::pow(max_degree+1,dim);
-            n_vmult += n_stencil*n_dofs_cell;
-            dRdW_form += 1;
+            Telemetry::add_to_counter(Telemetry::n_vmult, n_stencil*n_dofs_cell);
+            Telemetry::add_to_counter(Telemetry::dRdW_form);
         }
-        solution_dRdW = solution;
-        volume_nodes_dRdW = high_order_grid->volume_nodes;
+        dRdW_stamp.set(state_versions);
         CFL_mass_dRdW = CFL_mass;
 
         system_matrix = 0;
     }
     if (compute_dRdX) {
-        pcout << " with dRdX...";
-
-        auto diff_sol = solution;
-        diff_sol -= solution_dRdX;
-        const double l2_norm_sol = diff_sol.l2_norm();
-
-        if (l2_norm_sol == 0.0) {
-
-            auto diff_node = high_order_grid->volume_nodes;
-            diff_node -= volume_nodes_dRdX;
-            const double l2_norm_node = diff_node.l2_norm();
-
-            if (l2_norm_node == 0.0) {
-                pcout << " which is already assembled..." << std::endl;
-                return;
-            }
-        }
-        solution_dRdX = solution;
-        volume_nodes_dRdX = high_order_grid->volume_nodes;
+        dRdX_stamp.set(state_versions);
 
         if (   dRdXv.m() != solution.size() || dRdXv.n() != high_order_grid->volume_nodes.size()) {
 
@@ -1075,31 +1438,7 @@ void DGBase<dim,real>::assemble_residual (const bool compute_dRdW, const bool co
         dRdXv = 0;
     }
     if (compute_d2R) {
-        pcout << " with d2RdWdW, d2RdWdX, d2RdXdX...";
-        auto diff_sol = solution;
-        diff_sol -= solution_d2R;
-        const double l2_norm_sol = diff_sol.l2_norm();
-
-        if (l2_norm_sol == 0.0) {
-
-            auto diff_node = high_order_grid->volume_nodes;
-            diff_node -= volume_nodes_d2R;
-            const double l2_norm_node = diff_node.l2_norm();
-
-            if (l2_norm_node == 0.0) {
-
-                auto diff_dual = dual;
-                diff_dual -= dual_d2R;
-                const double l2_norm_dual = diff_dual.l2_norm();
-                if (l2_norm_dual == 0.0) {
-                    pcout << " which is already assembled..." << std::endl;
-                    return;
-                }
-            }
-        }
-        solution_d2R = solution;
-        volume_nodes_d2R = high_order_grid->volume_nodes;
-        dual_d2R = dual;
+        d2R_stamp.set(state_versions_with_dual);
 
         if (   d2RdWdW.m() != solution.size()
             || d2RdWdX.m() != solution.size()
@@ -1124,48 +1463,89 @@ void DGBase<dim,real>::assemble_residual (const bool compute_dRdW, const bool co
 
     dealii::hp::MappingCollection<dim> mapping_collection(mapping);
 
-    dealii::hp::FEValues<dim,dim>        fe_values_collection_volume (mapping_collection, fe_collection, volume_quadrature_collection, this->volume_update_flags); ///< FEValues of volume.
-    dealii::hp::FEFaceValues<dim,dim>    fe_values_collection_face_int (mapping_collection, fe_collection, face_quadrature_collection, this->face_update_flags); ///< FEValues of interior face.
-    dealii::hp::FEFaceValues<dim,dim>    fe_values_collection_face_ext (mapping_collection, fe_collection, face_quadrature_collection, this->neighbor_face_update_flags); ///< FEValues of exterior face.
-    dealii::hp::FESubfaceValues<dim,dim> fe_values_collection_subface (mapping_collection, fe_collection, face_quadrature_collection, this->face_update_flags); ///< FEValues of subface.
+    // Without the geometric update flags, the reinit() of the FEValues does not evaluate the mapping.
+    const bool use_fe_values_geometry = assembly_uses_fe_values_geometry();
+    const dealii::UpdateFlags assembly_volume_update_flags = use_fe_values_geometry ? this->volume_update_flags : dealii::update_values;
+    const dealii::UpdateFlags assembly_face_update_flags = use_fe_values_geometry ? this->face_update_flags : dealii::update_values;
+    const dealii::UpdateFlags assembly_neighbor_face_update_flags = use_fe_values_geometry ? this->neighbor_face_update_flags : dealii::update_values;
+
+    dealii::hp::FEValues<dim,dim>        fe_values_collection_volume (mapping_collection, fe_collection, volume_quadrature_collection, assembly_volume_update_flags); ///< FEValues of volume.
+    dealii::hp::FEFaceValues<dim,dim>    fe_values_collection_face_int (mapping_collection, fe_collection, face_quadrature_collection, assembly_face_update_flags); ///< FEValues of interior face.
+    dealii::hp::FEFaceValues<dim,dim>    fe_values_collection_face_ext (mapping_collection, fe_collection, face_quadrature_collection, assembly_neighbor_face_update_flags); ///< FEValues of exterior face.
+    dealii::hp::FESubfaceValues<dim,dim> fe_values_collection_subface (mapping_collection, fe_collection, face_quadrature_collection, assembly_face_update_flags); ///< FEValues of subface.
 
-    dealii::hp::FEValues<dim,dim>        fe_values_collection_volume_lagrange (mapping_collection, fe_collection_lagrange, volume_quadrature_collection, this->volume_update_flags);
+    dealii::hp::FEValues<dim,dim>        fe_values_collection_volume_lagrange (mapping_collection, fe_collection_lagrange, volume_quadrature_collection, assembly_volume_update_flags);
 
     solution.update_ghost_values();
 
+    update_metric_terms_caches();
+
     int assembly_error = 0;
     try {
 
         update_artificial_dissipation_discontinuity_sensor();
 
-        auto metric_cell = high_order_grid->dof_handler_grid.begin_active();
-        for (auto soln_cell = dof_handler.begin_active(); soln_cell != dof_handler.end(); ++soln_cell, ++metric_cell) {
-        //for (auto cell = triangulation->begin_active(); cell != triangulation->end(); ++cell) {
-            if (!soln_cell->is_locally_owned()) continue;
-
-            //const int tria_level = cell->level();
-            //const int tria_index = cell->index();
-            //dealii::DoFCellAccessor<dim,dim,false> soln_cell(triangulation.get(), tria_level, tria_index, &dof_handler);
-            //dealii::DoFCellAccessor<dim,dim,false> metric_cell(triangulation.get(), tria_level, tria_index, &high_order_grid->dof_handler_grid);
-
-            //dealii::TriaActiveIterator< dealii::DoFCellAccessor<dim,dim,false> >
-
-            //DoFCellAccessor<dim,dim,false> soln_cell(triangulation.get(), tria_level, tria_index, &dof_handler);
-            //dealii::DoFCellAccessor<dim,dim,false> metric_cell(triangulation.get(), tria_level, tria_index, &high_order_grid->dof_handler_grid);
-
-
-            // Add right-hand side contributions this cell can compute
-            assemble_cell_residual (
-                soln_cell,
-                metric_cell,
-                compute_dRdW, compute_dRdX, compute_d2R,
-                fe_values_collection_volume,
-                fe_values_collection_face_int,
-                fe_values_collection_face_ext,
-                fe_values_collection_subface,
-                fe_values_collection_volume_lagrange,
-                right_hand_side);
-        } // end of cell loop
+        // The CoDiPack tape used to evaluate the derivatives is global.
+        // Therefore, only the residual can be assembled by multiple threads.
+        const bool use_threaded_assembly = all_parameters->use_threaded_assembly && !compute_dRdW && !compute_dRdX && !compute_d2R;
+
+        if (use_threaded_assembly) {
+            // The volume and face regions are only timed by the serial cell loop.
+            const Telemetry::ScopedPause telemetry_pause;
+            using ActiveCellIterator = typename dealii::DoFHandler<dim>::active_cell_iterator;
+
+            const auto worker = [&] (const ActiveCellIterator &soln_cell, AssemblyScratchData &scratch_data, AssemblyCopyData &/*copy_data*/)
+            {
+                const ActiveCellIterator metric_cell(triangulation.get(), soln_cell->level(), soln_cell->index(), &(high_order_grid->dof_handler_grid));
+                assemble_cell_residual (
+                    soln_cell,
+                    metric_cell,
+                    compute_dRdW, compute_dRdX, compute_d2R,
+                    scratch_data.fe_values_collection_volume,
+                    scratch_data.fe_values_collection_face_int,
+                    scratch_data.fe_values_collection_face_ext,
+                    scratch_data.fe_values_collection_subface,
+                    scratch_data.fe_values_collection_volume_lagrange,
+                    right_hand_side);
+            };
+            // Cells of the same color do not write to the same entries.
+            const auto copier = [] (const AssemblyCopyData &/*copy_data*/) {};
+
+            const AssemblyScratchData sample_scratch_data(
+                mapping_collection, fe_collection, fe_collection_lagrange,
+                volume_quadrature_collection, face_quadrature_collection,
+                assembly_volume_update_flags, assembly_face_update_flags, assembly_neighbor_face_update_flags);
+            dealii::WorkStream::run(colored_locally_owned_cells, worker, copier, sample_scratch_data, AssemblyCopyData());
+        } else {
+            auto metric_cell = high_order_grid->dof_handler_grid.begin_active();
+            for (auto soln_cell = dof_handler.begin_active(); soln_cell != dof_handler.end(); ++soln_cell, ++metric_cell) {
+            //for (auto cell = triangulation->begin_active(); cell != triangulation->end(); ++cell) {
+                if (!soln_cell->is_locally_owned()) continue;
+
+                //const int tria_level = cell->level();
+                //const int tria_index = cell->index();
+                //dealii::DoFCellAccessor<dim,dim,false> soln_cell(triangulation.get(), tria_level, tria_index, &dof_handler);
+                //dealii::DoFCellAccessor<dim,dim,false> metric_cell(triangulation.get(), tria_level, tria_index, &high_order_grid->dof_handler_grid);
+
+                //dealii::TriaActiveIterator< dealii::DoFCellAccessor<dim,dim,false> >
+
+                //DoFCellAccessor<dim,dim,false> soln_cell(triangulation.get(), tria_level, tria_index, &dof_handler);
+                //dealii::DoFCellAccessor<dim,dim,false> metric_cell(triangulation.get(), tria_level, tria_index, &high_order_grid->dof_handler_grid);
+
+
+                // Add right-hand side contributions this cell can compute
+                assemble_cell_residual (
+                    soln_cell,
+                    metric_cell,
+                    compute_dRdW, compute_dRdX, compute_d2R,
+                    fe_values_collection_volume,
+                    fe_values_collection_face_int,
+                    fe_values_collection_face_ext,
+                    fe_values_collection_subface,
+                    fe_values_collection_volume_lagrange,
+                    right_hand_side);
+            } // end of cell loop
+        }
     } catch(...) {
         assembly_error = 1;
     }
@@ -1192,6 +1572,8 @@ void DGBase<dim,real>::assemble_residual (const bool compute_dRdW, const bool co
         //}
     }
 
+    if (all_parameters->ode_solver_param.local_time_step_max_neighbor_ratio > 0.0) limit_local_time_step_ratios();
+
     right_hand_side.compress(dealii::VectorOperation::add);
     right_hand_side.update_ghost_values();
     if ( compute_dRdW ) {
@@ -1206,34 +1588,6 @@ void DGBase<dim,real>::assemble_residual (const bool compute_dRdW, const bool co
             add_time_scaled_mass_matrices();
         }
 
-        Epetra_CrsMatrix *input_matrix  = const_cast<Epetra_CrsMatrix *>(&(system_matrix.trilinos_matrix()));
-        Epetra_CrsMatrix *output_matrix;
-        epetra_rowmatrixtransposer_dRdW = std::make_unique<Epetra_RowMatrixTransposer> ( input_matrix );
-        const bool make_data_contiguous = true;
-        int error_transpose = epetra_rowmatrixtransposer_dRdW->CreateTranspose( make_data_contiguous, output_matrix);
-        if (error_transpose) {
-            std::cout << "Failed to create dRdW transpose... Aborting" << std::endl;
-            //std::abort();
-        }
-        bool copy_values = true;
-        system_matrix_transpose.reinit(*output_matrix, copy_values);
-        delete(output_matrix);
-
-        //Epetra_CrsMatrix *input_matrix  = const_cast<Epetra_CrsMatrix *>(&(system_matrix.trilinos_matrix()));
-        //std::shared_ptr<Epetra_CrsMatrix> output_matrix = std::make_shared<Epetra_CrsMatrix> ();
-        //epetra_rowmatrixtransposer_dRdW = std::make_unique<Epetra_RowMatrixTransposer> ( input_matrix );
-        //const bool make_data_contiguous = true;
-        //epetra_rowmatrixtransposer_dRdW->CreateTranspose( make_data_contiguous, output_matrix.get());
-        //system_matrix_transpose.reinit(*output_matrix);
-        
-        //EpetraExt::RowMatrix_Transpose transposer;
-        //Epetra_CrsMatrix* input_matrix  = const_cast<Epetra_CrsMatrix *>(&(system_matrix.trilinos_matrix()));
-        //Epetra_CrsMatrix* output_matrix = dynamic_cast<Epetra_CrsMatrix*>(&transposer(*input_matrix));
-        //system_matrix_transpose.reinit(*output_matrix);
-        //std::cout << output_matrix << std::endl;
-        //delete(output_matrix);
-
-
         //double condition_estimate;
         //dRdW_preconditioner_builder.ConstructPreconditioner(condition_estimate);
     }
@@ -1248,6 +1602,50 @@ void DGBase<dim,real>::assemble_residual (const bool compute_dRdW, const bool co
 
 } // end of assemble_system_explicit ()
 
+template <int dim, typename real>
+void DGBase<dim,real>::limit_local_time_step_ratios ()
+{
+    const Parameters::ODESolverParam &ode_param = all_parameters->ode_solver_param;
+    const double max_ratio = ode_param.local_time_step_max_neighbor_ratio;
+
+    using DoFHandlerType = dealii::DoFHandler<dim>;
+    using cell_iterator = typename DoFHandlerType::active_cell_iterator;
+    // Sends the time steps of the locally owned cells to the processors on which they are ghosts.
+    const auto update_ghost_max_dt = [&] () {
+#if PHILIP_DIM!=1
+        dealii::GridTools::exchange_cell_data_to_ghosts<double, DoFHandlerType>(
+            dof_handler,
+            [&] (const cell_iterator &cell) { return dealii::std_cxx17::optional<double>(max_dt_cell[cell->active_cell_index()]); },
+            [&] (const cell_iterator &cell, const double &max_dt) { max_dt_cell[cell->active_cell_index()] = max_dt; });
+#endif
+    };
+
+    std::vector<cell_iterator> active_neighbors;
+    bool is_limited = true;
+    for (unsigned int isweep = 0; isweep < ode_param.local_time_step_smoothing_sweeps && is_limited; ++isweep) {
+        update_ghost_max_dt();
+
+        is_limited = false;
+        for (const auto &cell : dof_handler.active_cell_iterators()) {
+            if (!cell->is_locally_owned()) continue;
+
+            double &max_dt = max_dt_cell[cell->active_cell_index()];
+            dealii::GridTools::get_active_neighbors<DoFHandlerType>(cell, active_neighbors);
+            for (const auto &neighbor : active_neighbors) {
+                const double neighbor_limit = max_ratio * max_dt_cell[neighbor->active_cell_index()];
+                if (neighbor_limit < max_dt) {
+                    max_dt = neighbor_limit;
+                    is_limited = true;
+                }
+            }
+        }
+        // Another sweep is needed as long as any processor limited a time step.
+        is_limited = dealii::Utilities::MPI::max(is_limited ? 1 : 0, mpi_communicator) == 1;
+    }
+    // The ghost time steps are only out of date if the last sweep limited some time steps.
+    if (is_limited) update_ghost_max_dt();
+}
+
 template <int dim, typename real>
 double DGBase<dim,real>::get_residual_linfnorm () const
 {
@@ -1645,6 +2043,7 @@ void DGBase<dim,real>::output_face_results_vtk (const unsigned int cycle)// cons
 template <int dim, typename real>
 void DGBase<dim,real>::output_results_vtk (const unsigned int cycle)// const
 {
+    const Telemetry::ScopedTimer timer("output_vtk");
 #if PHILIP_DIM>1
     output_face_results_vtk (cycle);
 #endif
@@ -1758,6 +2157,91 @@ void DGBase<dim,real>::output_results_vtk (const unsigned int cycle)// const
 
 }
 
+template <int dim, typename real>
+void DGBase<dim,real>::output_results_binary (const unsigned int cycle, const double time)
+{
+    const Telemetry::ScopedTimer timer("output_binary");
+    // Same subdivision of the curved cells as output_results_vtk().
+    const unsigned int n_subdivisions = std::max(1u, high_order_grid->max_degree);
+    const unsigned int n_points_1d = n_subdivisions + 1;
+    const unsigned int n_points_cell = dealii::Utilities::pow(n_points_1d, dim);
+    const unsigned int n_subcells = dealii::Utilities::pow(n_subdivisions, dim);
+
+    // Equidistant points in lexicographic order.
+    std::vector<dealii::Point<dim>> unit_points(n_points_cell);
+    for (unsigned int ipoint = 0; ipoint < n_points_cell; ++ipoint) {
+        unsigned int index = ipoint;
+        for (int d = 0; d < dim; ++d) {
+            unit_points[ipoint][d] = static_cast<double>(index % n_points_1d) / n_subdivisions;
+            index /= n_points_1d;
+        }
+    }
+    const dealii::hp::QCollection<dim> output_quadrature_collection(dealii::Quadrature<dim>(unit_points));
+    const dealii::hp::MappingCollection<dim> mapping_collection(*(high_order_grid->mapping_fe_field));
+    dealii::hp::FEValues<dim,dim> fe_values_collection(mapping_collection, fe_collection, output_quadrature_collection,
+                                                       dealii::update_values | dealii::update_quadrature_points);
+
+    // Vertices of the linear sub-cells in the ordering of the XDMF elements.
+    std::vector<unsigned int> subcell_vertex_offsets { 0, 1 };
+    if (dim >= 2) subcell_vertex_offsets = { 0, 1, 1+n_points_1d, n_points_1d };
+    if (dim == 3) {
+        const unsigned int n_points_face = n_points_1d*n_points_1d;
+        for (unsigned int iv = 0; iv < 4; ++iv) subcell_vertex_offsets.push_back(subcell_vertex_offsets[iv] + n_points_face);
+    }
+    const auto element_type = (dim == 1) ? Postprocess::BinarySolutionWriter::polyline
+                            : (dim == 2) ? Postprocess::BinarySolutionWriter::quadrilateral
+                                         : Postprocess::BinarySolutionWriter::hexahedron;
+
+    const unsigned int n_locally_owned_cells = triangulation->n_locally_owned_active_cells();
+    std::vector<double> points;
+    points.reserve(3 * n_points_cell * n_locally_owned_cells);
+    std::vector<std::int64_t> connectivity;
+    connectivity.reserve(subcell_vertex_offsets.size() * n_subcells * n_locally_owned_cells);
+    std::vector<std::vector<double>> fields(nstate);
+    for (auto &field : fields) field.reserve(n_points_cell * n_locally_owned_cells);
+
+    std::vector<dealii::Vector<double>> point_values(n_points_cell, dealii::Vector<double>(nstate));
+    for (const auto &cell : dof_handler.active_cell_iterators()) {
+        if (!cell->is_locally_owned()) continue;
+
+        fe_values_collection.reinit (cell, 0, 0, cell->active_fe_index());
+        const dealii::FEValues<dim,dim> &fe_values = fe_values_collection.get_present_fe_values();
+        fe_values.get_function_values(solution, point_values);
+
+        const std::int64_t first_point = points.size() / 3;
+        for (unsigned int ipoint = 0; ipoint < n_points_cell; ++ipoint) {
+            const dealii::Point<dim> &point = fe_values.quadrature_point(ipoint);
+            for (int d = 0; d < 3; ++d) points.push_back(d < dim ? point[d] : 0.0);
+            for (int s = 0; s < nstate; ++s) fields[s].push_back(point_values[ipoint][s]);
+        }
+        for (unsigned int isubcell = 0; isubcell < n_subcells; ++isubcell) {
+            // Lexicographic index of the first vertex of the sub-cell.
+            unsigned int index = isubcell;
+            unsigned int first_vertex = 0;
+            unsigned int stride = 1;
+            for (int d = 0; d < dim; ++d) {
+                first_vertex += (index % n_subdivisions) * stride;
+                index /= n_subdivisions;
+                stride *= n_points_1d;
+            }
+            for (const unsigned int offset : subcell_vertex_offsets) {
+                connectivity.push_back(first_point + first_vertex + offset);
+            }
+        }
+    }
+
+    std::vector<std::string> field_names;
+    for (int s = 0; s < nstate; ++s) {
+        field_names.push_back("state" + dealii::Utilities::int_to_string(s,1));
+    }
+
+    std::string filename = "solution-" + dealii::Utilities::int_to_string(dim, 1) +"D_maxpoly"+dealii::Utilities::int_to_string(max_degree, 2)+"-";
+    filename += dealii::Utilities::int_to_string(cycle, 4);
+
+    if (!binary_solution_writer) binary_solution_writer = std::make_unique<Postprocess::BinarySolutionWriter>(mpi_communicator);
+    binary_solution_writer->write(filename, time, element_type, std::move(points), std::move(connectivity), field_names, std::move(fields));
+}
+
 template <int dim, typename real>
 void DGBase<dim,real>::allocate_system ()
 {
@@ -1821,23 +2305,14 @@ void DGBase<dim,real>::allocate_system ()
     right_hand_side.add(1.0); // Avoid 0 initial residual for output and logarithmic visualization.
     dual.reinit(locally_owned_dofs, ghost_dofs, mpi_communicator);
 
-    // System matrix allocation
-    dealii::DynamicSparsityPattern dsp(locally_relevant_dofs);
-    dealii::DoFTools::make_flux_sparsity_pattern(dof_handler, dsp);
-    dealii::SparsityTools::distribute_sparsity_pattern(dsp, dof_handler.locally_owned_dofs(), mpi_communicator, locally_relevant_dofs);
+    allocate_system_matrix ();
 
-    sparsity_pattern.copy_from(dsp);
+    if (all_parameters->use_threaded_assembly) color_locally_owned_cells();
 
-    system_matrix.reinit(locally_owned_dofs, sparsity_pattern, mpi_communicator);
+    // The cell numbering or the quadratures might have changed.
+    volume_metric_terms_cache.reinit(0, 0);
+    face_metric_terms_cache.reinit(0, 0);
 
-    // system_matrix_transpose.reinit(system_matrix);
-    // Epetra_CrsMatrix *input_matrix  = const_cast<Epetra_CrsMatrix *>(&(system_matrix.trilinos_matrix()));
-    // Epetra_CrsMatrix *output_matrix;
-    // epetra_rowmatrixtransposer_dRdW = std::make_unique<Epetra_RowMatrixTransposer> ( input_matrix );
-    // const bool make_data_contiguous = true;
-    // epetra_rowmatrixtransposer_dRdW->CreateTranspose( make_data_contiguous, output_matrix);
-    // system_matrix_transpose.reinit(*output_matrix);
-    // delete(output_matrix);
 
     // {
     //     dRdW_preconditioner_builder.SetUserMatrix(const_cast<Epetra_CrsMatrix *>(&system_matrix.trilinos_matrix()));
@@ -1869,30 +2344,51 @@ void DGBase<dim,real>::allocate_system ()
     // Make sure that derivatives are cleared when reallocating DG objects.
     // The call to assemble the derivatives will reallocate those derivatives
     // if they are ever needed.
-    system_matrix_transpose.clear();
     dRdXv.clear();
     d2RdWdX.clear();
     d2RdWdW.clear();
     d2RdXdX.clear();
 
-    solution_dRdW.reinit(solution);
-    solution_dRdW *= 0.0;
-    volume_nodes_dRdW.reinit(high_order_grid->volume_nodes);
-    volume_nodes_dRdW *= 0.0;
+    solution_modified();
+    dual_modified();
+    dRdX_stamp.invalidate();
+    d2R_stamp.invalidate();
+}
 
+template <int dim, typename real>
+void DGBase<dim,real>::allocate_system_matrix ()
+{
+    dealii::DynamicSparsityPattern dsp(locally_relevant_dofs);
+    if (cell_block_jacobian) {
+        // The DG basis functions only couple within their cell.
+        dealii::DoFTools::make_sparsity_pattern(dof_handler, dsp);
+    } else {
+        dealii::DoFTools::make_flux_sparsity_pattern(dof_handler, dsp);
+    }
+    dealii::SparsityTools::distribute_sparsity_pattern(dsp, dof_handler.locally_owned_dofs(), mpi_communicator, locally_relevant_dofs);
+
+    sparsity_pattern.copy_from(dsp);
+
+    system_matrix.reinit(locally_owned_dofs, sparsity_pattern, mpi_communicator);
+
+    ++allocation_version;
+    dRdW_stamp.invalidate();
     CFL_mass_dRdW = 0.0;
+}
+
+template <int dim, typename real>
+void DGBase<dim,real>::set_cell_block_jacobian (const bool cell_block_jacobian_input)
+{
+    if (cell_block_jacobian == cell_block_jacobian_input) return;
+    cell_block_jacobian = cell_block_jacobian_input;
+    // Otherwise, allocate_system() has not been called yet and will use the new setting.
+    if (system_matrix.m() > 0) allocate_system_matrix ();
+}
 
-    solution_dRdX.reinit(solution);
-    solution_dRdX *= 0.0;
-    volume_nodes_dRdX.reinit(high_order_grid->volume_nodes);
-    volume_nodes_dRdX *= 0.0;
-
-    solution_d2R.reinit(solution);
-    solution_d2R *= 0.0;
-    volume_nodes_d2R.reinit(high_order_grid->volume_nodes);
-    volume_nodes_d2R *= 0.0;
-    dual_d2R.reinit(dual);
-    dual_d2R *= 0.0;
+template <int dim, typename real>
+bool DGBase<dim,real>::is_cell_block_jacobian () const
+{
+    return cell_block_jacobian;
 }
 
 template <int dim, typename real>
@@ -1934,6 +2430,9 @@ void DGBase<dim,real>::allocate_dRdX ()
 template <int dim, typename real>
 void DGBase<dim,real>::evaluate_mass_matrices (bool do_inverse_mass_matrix)
 {
+    // The explicit ODE solver applies the inverse through the cell blocks, see apply_inverse_mass_matrix().
+    if (do_inverse_mass_matrix == true) evaluate_cell_inverse_mass_matrices();
+
     // Mass matrix sparsity pattern
     //dealii::SparsityPattern dsp(dof_handler.n_dofs(), dof_handler.n_dofs(), dof_handler.get_fe_collection().max_dofs_per_cell());
     //dealii::SparsityPattern dsp(dof_handler.n_dofs(), dof_handler.n_dofs(), dof_handler.get_fe_collection().max_dofs_per_cell());
@@ -2054,6 +2553,122 @@ void DGBase<dim,real>::evaluate_mass_matrices (bool do_inverse_mass_matrix)
 
     return;
 }
+
+template <int dim, typename real>
+void DGBase<dim,real>::evaluate_cell_inverse_mass_matrices ()
+{
+    const auto mapping = (*(high_order_grid->mapping_fe_field));
+    dealii::hp::MappingCollection<dim> mapping_collection(mapping);
+
+    const dealii::UpdateFlags update_flags = dealii::update_values | dealii::update_JxW_values;
+    dealii::hp::FEValues<dim,dim> fe_values_collection_volume (mapping_collection, fe_collection, volume_quadrature_collection, update_flags);
+
+    cell_inverse_mass_blocks.clear();
+    cell_inverse_mass_offsets.assign(1, 0);
+    cell_inverse_mass_dof_indices.clear();
+    cell_inverse_mass_n_dofs_state.clear();
+
+    std::vector<dealii::types::global_dof_index> dofs_indices;
+    for (auto cell = dof_handler.begin_active(); cell!=dof_handler.end(); ++cell) {
+
+        if (!cell->is_locally_owned()) continue;
+
+        const unsigned int mapping_index = 0;
+        const unsigned int fe_index_curr_cell = cell->active_fe_index();
+        const unsigned int quad_index = fe_index_curr_cell;
+
+        const dealii::FESystem<dim,dim> &current_fe_ref = fe_collection[fe_index_curr_cell];
+        AssertThrow(current_fe_ref.n_base_elements() == 1,
+                    dealii::ExcMessage("The cell inverse mass matrices require all the states to share the same basis."));
+        const unsigned int n_dofs_cell = current_fe_ref.n_dofs_per_cell();
+        const unsigned int n_dofs_state = n_dofs_cell / nstate;
+
+        fe_values_collection_volume.reinit (cell, quad_index, mapping_index, fe_index_curr_cell);
+        const dealii::FEValues<dim,dim> &fe_values_volume = fe_values_collection_volume.get_present_fe_values();
+        const unsigned int n_quad_pts = fe_values_volume.n_quadrature_points;
+
+        // Mass matrix of the first state, the other states have the same one.
+        dealii::FullMatrix<real> local_mass_matrix(n_dofs_state);
+        for (unsigned int itest=0; itest<n_dofs_state; ++itest) {
+            const unsigned int itest_system = current_fe_ref.component_to_system_index(0, itest);
+            for (unsigned int itrial=itest; itrial<n_dofs_state; ++itrial) {
+                const unsigned int itrial_system = current_fe_ref.component_to_system_index(0, itrial);
+                real value = 0.0;
+                for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+                    value +=
+                        fe_values_volume.shape_value_component(itest_system,iquad,0)
+                        * fe_values_volume.shape_value_component(itrial_system,iquad,0)
+                        * fe_values_volume.JxW(iquad);
+                }
+                local_mass_matrix[itest][itrial] = value;
+                local_mass_matrix[itrial][itest] = value;
+            }
+        }
+        dealii::FullMatrix<real> local_inverse_mass_matrix(n_dofs_state);
+        local_inverse_mass_matrix.invert(local_mass_matrix);
+
+        for (unsigned int irow=0; irow<n_dofs_state; ++irow) {
+            for (unsigned int icol=0; icol<n_dofs_state; ++icol) {
+                cell_inverse_mass_blocks.push_back(local_inverse_mass_matrix[irow][icol]);
+            }
+        }
+        cell_inverse_mass_offsets.push_back(cell_inverse_mass_blocks.size());
+        cell_inverse_mass_n_dofs_state.push_back(n_dofs_state);
+
+        dofs_indices.resize(n_dofs_cell);
+        cell->get_dof_indices (dofs_indices);
+        for (unsigned int idof=0; idof<n_dofs_state; ++idof) {
+            for (int istate=0; istate<nstate; ++istate) {
+                const dealii::types::global_dof_index global_index = dofs_indices[current_fe_ref.component_to_system_index(istate, idof)];
+                cell_inverse_mass_dof_indices.push_back(locally_owned_dofs.index_within_set(global_index));
+            }
+        }
+    }
+}
+
+template <int dim, typename real>
+void DGBase<dim,real>::apply_inverse_mass_matrix (
+    const dealii::LinearAlgebra::distributed::Vector<double> &src,
+    dealii::LinearAlgebra::distributed::Vector<double> &dst) const
+{
+    AssertThrow(cell_inverse_mass_offsets.size() == cell_inverse_mass_n_dofs_state.size() + 1,
+                dealii::ExcMessage("The cell inverse mass matrices have not been evaluated."));
+    const Telemetry::ScopedTimer timer("inverse_mass");
+
+    const double *src_local = src.begin();
+    double *dst_local = dst.begin();
+
+    // Cell values ordered by basis function then by state, such that the inner loop runs
+    // contiguously over the states.
+    std::vector<double> src_cell, dst_cell;
+    const unsigned int n_cells = cell_inverse_mass_n_dofs_state.size();
+    const unsigned int *dof_indices = cell_inverse_mass_dof_indices.data();
+    for (unsigned int icell = 0; icell < n_cells; ++icell) {
+        const unsigned int n_dofs_state = cell_inverse_mass_n_dofs_state[icell];
+        const unsigned int n_dofs_cell = n_dofs_state * nstate;
+        const real *block = &cell_inverse_mass_blocks[cell_inverse_mass_offsets[icell]];
+
+        src_cell.resize(n_dofs_cell);
+        dst_cell.assign(n_dofs_cell, 0.0);
+        for (unsigned int i = 0; i < n_dofs_cell; ++i) src_cell[i] = src_local[dof_indices[i]];
+
+        for (unsigned int irow = 0; irow < n_dofs_state; ++irow) {
+            double *dst_row = &dst_cell[irow*nstate];
+            for (unsigned int icol = 0; icol < n_dofs_state; ++icol) {
+                const double value = block[irow*n_dofs_state + icol];
+                const double *src_row = &src_cell[icol*nstate];
+                for (int istate = 0; istate < nstate; ++istate) dst_row[istate] += value * src_row[istate];
+            }
+        }
+
+        for (unsigned int i = 0; i < n_dofs_cell; ++i) dst_local[dof_indices[i]] = dst_cell[i];
+        dof_indices += n_dofs_cell;
+    }
+    // A multiply-add per block entry and state. The block, the cell values and their indices are read once.
+    const double n_block_entries = cell_inverse_mass_blocks.size();
+    const double n_cell_values = cell_inverse_mass_dof_indices.size();
+    Telemetry::add_work(2.0 * nstate * n_block_entries, 8.0 * n_block_entries + 20.0 * n_cell_values);
+}
 template<int dim, typename real>
 void DGBase<dim,real>::add_mass_matrices(const real scale)
 {
@@ -2353,11 +2968,55 @@ void DGBase<dim,real>::refine_residual_based()
     solution.zero_out_ghosts();
     solution_transfer.interpolate(solution);
     solution.update_ghost_values();
+    solution_modified();
 
     assemble_residual ();
 
 }
 
+template <int dim, typename real>
+void DGBase<dim,real>::save_checkpoint (const std::string &filename)
+{
+    const Telemetry::ScopedTimer timer("checkpoint_write");
+#if PHILIP_DIM==1
+    (void) filename;
+    AssertThrow(false, dealii::ExcMessage("Checkpoints require a distributed triangulation, which is not used in 1D."));
+#else
+    // The data is attached in the order it will be deserialized in load_checkpoint().
+    dof_handler.prepare_for_serialization_of_active_fe_indices();
+    high_order_grid->prepare_for_serialization();
+
+    dealii::LinearAlgebra::distributed::Vector<double> old_solution(solution);
+    old_solution.update_ghost_values();
+    dealii::parallel::distributed::SolutionTransfer<dim, dealii::LinearAlgebra::distributed::Vector<double>, dealii::DoFHandler<dim>> solution_transfer(dof_handler);
+    solution_transfer.prepare_for_serialization(old_solution);
+
+    triangulation->save(filename);
+#endif
+}
+
+template <int dim, typename real>
+void DGBase<dim,real>::load_checkpoint (const std::string &filename)
+{
+    const Telemetry::ScopedTimer timer("checkpoint_read");
+#if PHILIP_DIM==1
+    (void) filename;
+    AssertThrow(false, dealii::ExcMessage("Checkpoints require a distributed triangulation, which is not used in 1D."));
+#else
+    triangulation->load(filename);
+
+    dof_handler.deserialize_active_fe_indices();
+    high_order_grid->deserialize();
+
+    allocate_system ();
+    dealii::parallel::distributed::SolutionTransfer<dim, dealii::LinearAlgebra::distributed::Vector<double>, dealii::DoFHandler<dim>> solution_transfer(dof_handler);
+    solution.zero_out_ghosts();
+    solution_transfer.deserialize(solution);
+    solution.update_ghost_values();
+    solution_modified();
+#endif
+}
+
 // No support for anisotropic mesh refinement with parallel::distributed::Triangulation
 // template<int dim, typename real>
 // void DGBase<dim,real>::set_anisotropic_flags()
@@ -21,11 +21,11 @@
 #include <deal.II/hp/fe_values.h>
 
 #include <deal.II/lac/vector.h>
+#include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/lac/trilinos_sparse_matrix.h>
 #include <deal.II/lac/trilinos_vector.h>
 
-#include <Epetra_RowMatrixTransposer.h>
 #include <AztecOO.h>
 
 #include "ADTypes.hpp"
@@ -33,11 +33,13 @@
 #include <CoDiPack/include/codi.hpp>
 
 #include "mesh/high_order_grid.h"
+#include "state_versions.h"
 #include "physics/physics.h"
 #include "numerical_flux/numerical_flux_factory.hpp"
 #include "numerical_flux/convective_numerical_flux.hpp"
 #include "numerical_flux/viscous_numerical_flux.hpp"
 #include "parameters/all_parameters.h"
+#include "post_processor/binary_solution_writer.h"
 
 // Template specialization of MappingFEField
 //extern template class dealii::MappingFEField<PHILIP_DIM,PHILIP_DIM,dealii::LinearAlgebra::distributed::Vector<double>, dealii::DoFHandler<PHILIP_DIM> >;
@@ -144,7 +146,24 @@ public:
     /** Must be done after setting the mesh and before assembling the system. */
     virtual void allocate_system ();
 
+    /// Sets whether the system_matrix only stores the couplings within the cells.
+    /** The assembly of dRdW then skips the couplings between neighbouring cells. Meant for the
+     *  Jacobian-free solvers preconditioned by block Jacobi, which never use those couplings, such
+     *  that dRdW only takes a fraction of its usual memory. Re-allocates the system_matrix if the
+     *  setting changes.
+     */
+    void set_cell_block_jacobian (const bool cell_block_jacobian_input);
+
+    /// Whether the system_matrix only stores the couplings within the cells. See set_cell_block_jacobian().
+    bool is_cell_block_jacobian () const;
+
 private:
+    /// Allocates the system_matrix with the sparsity pattern of dRdW, or only its cell blocks.
+    void allocate_system_matrix ();
+
+    /// Whether the system_matrix only stores the couplings within the cells.
+    bool cell_block_jacobian = false;
+
     /// Allocates the second derivatives.
     /** Is called when assembling the residual's second derivatives, and is currently empty
      *  due to being cleared by the allocate_system().
@@ -172,9 +191,24 @@ public:
     /// Allocates and evaluates the mass matrices for the entire grid
     /** Although straightforward, this has not been tested yet.
      *  Will be required for accurate time-stepping or nonlinear problems
+     *
+     *  If do_inverse_mass_matrix is true, the global_inverse_mass_matrix is evaluated, as well as the
+     *  inverse mass matrix blocks of the locally owned cells applied through apply_inverse_mass_matrix().
      */
     void evaluate_mass_matrices (bool do_inverse_mass_matrix = false);
 
+    /// Evaluates the inverse mass matrix blocks of the locally owned cells.
+    void evaluate_cell_inverse_mass_matrices ();
+
+    /// Applies the inverse mass matrix, dst = M^{-1} src, one cell block at a time.
+    /** Requires evaluate_mass_matrices(true) to have been called on the current DoF distribution.
+     *  Only the locally owned entries are used such that no communication is needed,
+     *  and the ghost values of dst are not updated.
+     */
+    void apply_inverse_mass_matrix (
+        const dealii::LinearAlgebra::distributed::Vector<double> &src,
+        dealii::LinearAlgebra::distributed::Vector<double> &dst) const;
+
     /// Evaluates the maximum stable time step
     /** If exact_time_stepping = true, use the same time step for the entire solution
      *  NOT YET IMPLEMENTED
@@ -200,6 +234,16 @@ public:
     /// Refine cells with the highest residuals.
     void refine_residual_based();
 
+    /// Writes the triangulation, active finite elements, high-order grid and solution to files starting with @p filename.
+    /** Uses dealii::parallel::distributed::Triangulation::save() and is therefore not available in 1D.
+     */
+    void save_checkpoint (const std::string &filename);
+    /// Recovers the triangulation, active finite elements, high-order grid and solution written by save_checkpoint().
+    /** The triangulation must have been created with the same coarse grid as the one that was saved.
+     *  The checkpoint may be loaded with a different number of MPI processes.
+     */
+    void load_checkpoint (const std::string &filename);
+
     /// Set anisotropic flags based on jump indicator.
     /** Some cells must have already been tagged for refinement through some other indicator
      */
@@ -221,19 +265,26 @@ public:
     /** Should be block diagonal where each block contains the mass matrix of each cell.  */
     dealii::TrilinosWrappers::SparseMatrix global_mass_matrix;
     /// Global inverser mass matrix
-    /** Should be block diagonal where each block contains the inverse mass matrix of each cell.  */
+    /** Should be block diagonal where each block contains the inverse mass matrix of each cell.
+     *  The time stepping uses the cell blocks through apply_inverse_mass_matrix() instead.
+     */
     dealii::TrilinosWrappers::SparseMatrix global_inverse_mass_matrix;
+
+    /// Inverse mass matrix blocks of the locally owned cells, see apply_inverse_mass_matrix().
+    /** The mass matrix does not couple the states, which all share the same basis. Each cell therefore
+     *  only stores one n_dofs_state x n_dofs_state row-major block, contiguously in the order of the cells.
+     */
+    std::vector<real> cell_inverse_mass_blocks;
+    /// Offsets of each cell block into cell_inverse_mass_blocks, with an extra last entry.
+    std::vector<std::size_t> cell_inverse_mass_offsets;
+    /// Local indices of the DoFs of the cells one after the other, each ordered by basis function then by state.
+    std::vector<unsigned int> cell_inverse_mass_dof_indices;
+    /// Number of basis functions per state of each cell.
+    std::vector<unsigned int> cell_inverse_mass_n_dofs_state;
     /// System matrix corresponding to the derivative of the right_hand_side with
     /// respect to the solution
     dealii::TrilinosWrappers::SparseMatrix system_matrix;
 
-    /// System matrix corresponding to the derivative of the right_hand_side with
-    /// respect to the solution TRANSPOSED.
-    dealii::TrilinosWrappers::SparseMatrix system_matrix_transpose;
-
-    /// Epetra_RowMatrixTransposer used to transpose the system_matrix.
-    std::unique_ptr<Epetra_RowMatrixTransposer> epetra_rowmatrixtransposer_dRdW;
-
     //AztecOO dRdW_preconditioner_builder;
 
     /// System matrix corresponding to the derivative of the right_hand_side with
@@ -292,33 +343,66 @@ public:
      *  and has write-access to all locally_owned_dofs
      */
     dealii::LinearAlgebra::distributed::Vector<double> solution;
+
+    /// Flags the solution as modified.
+    /** Must be called after modifying the solution such that the quantities depending on it,
+     *  such as the residual derivatives and the functionals, are evaluated again.
+     */
+    void solution_modified();
+
+    /// Current version of the solution, which changes whenever it is flagged as modified.
+    unsigned int get_solution_version() const;
+
+    /// Sets the solution version back to a previous @p version.
+    /** The solution must have been set back to its values at that version. Used by temporary
+     *  perturbations of the solution, such as the Jacobian-free products, such that the quantities
+     *  evaluated at the unperturbed solution remain valid. Later modifications never reuse a version.
+     */
+    void restore_solution_version(const unsigned int version);
+
+    /// Flags the dual as modified.
+    /** Called by set_dual(). Must be called after modifying the dual directly.
+     */
+    void dual_modified();
+
+    /// Number of times the dual has been flagged as modified.
+    unsigned int get_dual_version() const;
+
+    /// Current versions of the solution, the volume_nodes, and, if @p with_dual, the dual.
+    /** In debug mode, also evaluates their l2-norms to check the versions, such that it must
+     *  be called by all the processes.
+     */
+    StateVersions get_state_versions(const bool with_dual = false) const;
+
+    /// Number of times the system_matrix has been allocated.
+    /** Incremented by allocate_system() and set_cell_block_jacobian(). Used by the owners of
+     *  preconditioners of the system_matrix to know when its sparsity pattern and parallel layout changed.
+     */
+    unsigned int get_allocation_version() const;
+
 private:
-    /// Modal coefficients of the solution used to compute dRdW last
+    /// Incremented whenever the system_matrix is allocated.
+    unsigned int allocation_version = 0;
+    /// Set to a new version by solution_modified().
+    unsigned int solution_version = 0;
+    /// Latest version given to the solution, such that restore_solution_version() does not lead to reused versions.
+    unsigned int latest_solution_version = 0;
+    /// Incremented by dual_modified().
+    unsigned int dual_version = 0;
+
+    /// State at which dRdW was last assembled.
     /// Will be used to avoid recomputing dRdW.
-    dealii::LinearAlgebra::distributed::Vector<double> solution_dRdW;
-    /// Modal coefficients of the grid nodes used to compute dRdW last
-    /// Will be used to avoid recomputing dRdW.
-    dealii::LinearAlgebra::distributed::Vector<double> volume_nodes_dRdW;
-
+    EvaluationStamp dRdW_stamp;
     /// CFL used to add mass matrix in the optimization FlowConstraints class
     double CFL_mass_dRdW;
 
-    /// Modal coefficients of the solution used to compute dRdX last
-    /// Will be used to avoid recomputing dRdX.
-    dealii::LinearAlgebra::distributed::Vector<double> solution_dRdX;
-    /// Modal coefficients of the grid nodes used to compute dRdX last
+    /// State at which dRdX was last assembled.
     /// Will be used to avoid recomputing dRdX.
-    dealii::LinearAlgebra::distributed::Vector<double> volume_nodes_dRdX;
+    EvaluationStamp dRdX_stamp;
 
-    /// Modal coefficients of the solution used to compute d2R last
+    /// State, including the dual, at which d2R was last assembled.
     /// Will be used to avoid recomputing d2R.
-    dealii::LinearAlgebra::distributed::Vector<double> solution_d2R;
-    /// Modal coefficients of the grid nodes used to compute d2R last
-    /// Will be used to avoid recomputing d2R.
-    dealii::LinearAlgebra::distributed::Vector<double> volume_nodes_d2R;
-    /// Dual variables to compute d2R last
-    /// Will be used to avoid recomputing d2R.
-    dealii::LinearAlgebra::distributed::Vector<double> dual_d2R;
+    EvaluationStamp d2R_stamp;
 public:
 
     /// Time it takes for the maximum wavespeed to cross the cell domain.
@@ -335,6 +419,14 @@ public:
      */
     dealii::Vector<double> max_dt_cell;
 
+    /// Limits the max_dt_cell of each cell to a ratio of the ones of its neighbours.
+    /** Uses ODESolverParam::local_time_step_max_neighbor_ratio and local_time_step_smoothing_sweeps.
+     *  The time steps are only decreased such that the local pseudotime stepping remains stable.
+     *  The time steps of the ghost cells are exchanged before every sweep, such that the converged
+     *  time steps do not depend on the partitioning. They are up to date on return.
+     */
+    void limit_local_time_step_ratios ();
+
     /// Artificial dissipation in each cell.
     dealii::Vector<double> artificial_dissipation_coeffs;
 
@@ -355,8 +447,16 @@ public:
     dealii::LinearAlgebra::distributed::Vector<real> dual;
 
     /// Sets the stored dual variables used to compute the dual dotted with the residual Hessians
+    /** The dual is only flagged as modified if @p dual_input differs from it.
+     */
     void set_dual(const dealii::LinearAlgebra::distributed::Vector<real> &dual_input);
 
+    /// Sets the solution and updates its ghost values.
+    /** The solution is only flagged as modified if @p solution_input differs from it, such that
+     *  the optimizers that set the same state before every evaluation reuse the assembled derivatives.
+     */
+    void set_solution(const dealii::LinearAlgebra::distributed::Vector<double> &solution_input);
+
     /// Evaluate SparsityPattern of dRdX
     /*  Where R represents the residual and X represents the grid degrees of freedom stored as high_order_grid.volume_nodes.
      */
@@ -404,6 +504,12 @@ public:
     void initialize_manufactured_solution (); ///< Virtual function defined in DG
 
     void output_results_vtk (const unsigned int ith_grid); ///< Output solution
+    /// Outputs the solution at the points of subdivided cells into a single binary file described by an XDMF file.
+    /** Compact alternative to output_results_vtk() for frequent outputs of unsteady runs. Only the conservative
+     *  state is written, using the same subdivision of the curved cells. The file is written by all the processes
+     *  together and the write completes in the background, see Postprocess::BinarySolutionWriter.
+     */
+    void output_results_binary (const unsigned int ith_grid, const double time);
     void output_face_results_vtk (const unsigned int ith_grid); ///< Output Euler face solution
     void output_paraview_results (std::string filename); ///< Outputs a paraview file to view the solution
 
@@ -438,6 +544,10 @@ public:
      * 4. Neighbor is coarser. Therefore, the current cell is the finer one.
      * Do nothing since this cell will be taken care of by scenario 2.
      *
+     * Any combination of dRdW, dRdX, and the second derivatives may be requested. They are then
+     * assembled in a single pass, where the weak form records a single tape per cell and face.
+     * The derivatives already assembled at the current solution, nodes, and dual are skipped.
+     *
      */
     //void assemble_residual_dRdW ();
     void assemble_residual (const bool compute_dRdW=false, const bool compute_dRdX=false, const bool compute_d2R=false, const double CFL_mass = 0.0);
@@ -603,11 +713,90 @@ protected:
     /** NOTE: With hp-adaptation, might need to query neighbor's quadrature points depending on the order of the cells. */
     const dealii::UpdateFlags neighbor_face_update_flags = dealii::update_values | dealii::update_gradients | dealii::update_quadrature_points | dealii::update_JxW_values;
 
+    /// Whether the residual assembly reads the geometry of the cells from the FEValues.
+    /** Forms evaluating their metric terms from the grid nodes, or reading them from the metric terms caches,
+     *  only request the shape values from the FEValues, such that the reinit() of the FEValues does not
+     *  evaluate the mapping.
+     */
+    virtual bool assembly_uses_fe_values_geometry () const { return true; }
+
+    /// Metric terms evaluated at the quadrature points of a set of slots.
+    /** The Jacobian determinants, the transposes of the inverse metric Jacobians and the
+     *  JxW values are stored contiguously (structure of arrays) with a fixed stride of
+     *  max_n_quad_pts per slot. The slots of faces also store the physical unit normals
+     *  and the surface Jacobian determinants, in which case the JxW values are those of the face.
+     *  A slot is filled on first use. Since every slot is filled and used by a single cell
+     *  during the assembly, a slot is only ever accessed by one thread at a time.
+     */
+    struct MetricTermsCache
+    {
+        /// Discards the cached terms and allocates @p n_slots empty slots.
+        /** The unit normals and surface Jacobian determinants are only allocated if @p store_face_terms is true.
+         */
+        void reinit (const unsigned int n_slots, const unsigned int max_n_quad_pts, const bool store_face_terms = false);
+
+        /// Copies the cached terms of @p slot into the given vectors.
+        /** Returns false if that slot has not been filled with the same number of quadrature points.
+         *  @p unit_normal and @p surface_jacobian_determinant are only filled when they are not empty.
+         */
+        bool load (
+            const unsigned int slot,
+            std::vector<real> &jacobian_determinant,
+            std::vector<dealii::Tensor<2,dim,real>> &jacobian_transpose_inverse,
+            std::vector<real> &JxW,
+            std::vector<dealii::Tensor<1,dim,real>> &unit_normal,
+            std::vector<real> &surface_jacobian_determinant) const;
+
+        /// Fills @p slot with the given metric terms.
+        /** @p unit_normal and @p surface_jacobian_determinant are ignored by caches that do not store face terms.
+         */
+        void store (
+            const unsigned int slot,
+            const std::vector<real> &jacobian_determinant,
+            const std::vector<dealii::Tensor<2,dim,real>> &jacobian_transpose_inverse,
+            const std::vector<real> &JxW,
+            const std::vector<dealii::Tensor<1,dim,real>> &unit_normal,
+            const std::vector<real> &surface_jacobian_determinant);
+
+        unsigned int max_n_quad_pts = 0; ///< Stride between two slots.
+        std::vector<unsigned int> n_quad_pts; ///< Number of cached quadrature points of each slot. Zero if not cached yet.
+        std::vector<real> jacobian_determinant; ///< Jacobian determinants.
+        std::vector<real> jacobian_transpose_inverse; ///< Row-major entries of the transposed inverse metric Jacobians.
+        std::vector<real> JxW; ///< Jacobian determinants, or surface Jacobian determinants of faces, times the quadrature weights.
+        std::vector<real> unit_normal; ///< Components of the physical unit normals of faces.
+        std::vector<real> surface_jacobian_determinant; ///< Surface Jacobian determinants of faces.
+    };
+
+    /// Metric terms of the cell volumes, indexed by active_cell_index().
+    MetricTermsCache volume_metric_terms_cache;
+    /// Metric terms of the full cell faces, indexed by active_cell_index()*faces_per_cell + iface.
+    /** Subfaces are not cached and always evaluated. */
+    MetricTermsCache face_metric_terms_cache;
+
+    /// HighOrderGrid::get_volume_nodes_version() at which the metric terms caches are valid.
+    unsigned int metric_terms_cache_volume_nodes_version = 0;
+#ifdef DEBUG
+    /// l2-norm of the volume_nodes at which the metric terms caches are valid.
+    /** Only used in debug mode to catch volume_nodes modifications that were not flagged
+     *  through HighOrderGrid::volume_nodes_modified().
+     */
+    double metric_terms_cache_volume_nodes_l2norm = 0.0;
+#endif
+
+    /// Discards the metric terms cached by the residual assembly if the grid has been modified.
+    /** The metric terms only depend on the volume_nodes. They are therefore kept across the
+     *  residual evaluations until the grid is moved or refined.
+     */
+    void update_metric_terms_caches ();
+
 
 
 protected:
     MPI_Comm mpi_communicator; ///< MPI communicator
     dealii::ConditionalOStream pcout; ///< Parallel std::cout that only outputs on mpi_rank==0
+
+    /// Writer used by output_results_binary(). Keeps the data of the last output until it is written.
+    std::unique_ptr<Postprocess::BinarySolutionWriter> binary_solution_writer;
 private:
 
     /** Evaluate the average penalty term at the face.
@@ -632,6 +821,53 @@ private:
     template<typename DoFCellAccessorType1, typename DoFCellAccessorType2>
     bool current_cell_should_do_the_work (const DoFCellAccessorType1 &current_cell, const DoFCellAccessorType2 &neighbor_cell) const;
 
+    /// Locally owned cells grouped by color for the threaded assembly.
+    /** Two cells of the same color do not share any of the degrees of freedom
+     *  that their assemble_cell_residual() writes to, which includes the face neighbors' ones.
+     *  Built by color_locally_owned_cells() in allocate_system().
+     */
+    std::vector<std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator>> colored_locally_owned_cells;
+
+    /// Graph-colors the locally owned cells into colored_locally_owned_cells.
+    void color_locally_owned_cells ();
+
+    /// Thread-local FEValues used by the threaded cell loop of assemble_residual().
+    struct AssemblyScratchData
+    {
+        /// Constructor.
+        AssemblyScratchData (
+            const dealii::hp::MappingCollection<dim> &mapping_collection,
+            const dealii::hp::FECollection<dim>      &fe_collection,
+            const dealii::hp::FECollection<dim>      &fe_collection_lagrange,
+            const dealii::hp::QCollection<dim>       &volume_quadrature_collection,
+            const dealii::hp::QCollection<dim-1>     &face_quadrature_collection,
+            const dealii::UpdateFlags volume_update_flags,
+            const dealii::UpdateFlags face_update_flags,
+            const dealii::UpdateFlags neighbor_face_update_flags);
+
+        /// Copy constructor used by dealii::WorkStream to create each thread's FEValues.
+        AssemblyScratchData (const AssemblyScratchData &scratch_data);
+
+        const dealii::hp::MappingCollection<dim> &mapping_collection; ///< Mapping of the high-order grid.
+        const dealii::hp::FECollection<dim>      &fe_collection; ///< Solution FE.
+        const dealii::hp::FECollection<dim>      &fe_collection_lagrange; ///< Lagrange basis used in strong form.
+        const dealii::hp::QCollection<dim>       &volume_quadrature_collection; ///< Volume quadrature.
+        const dealii::hp::QCollection<dim-1>     &face_quadrature_collection; ///< Face quadrature.
+        const dealii::UpdateFlags volume_update_flags; ///< Update flags needed at volume points.
+        const dealii::UpdateFlags face_update_flags; ///< Update flags needed at face points.
+        const dealii::UpdateFlags neighbor_face_update_flags; ///< Update flags needed at neighbor' face points.
+
+        dealii::hp::FEValues<dim,dim>        fe_values_collection_volume; ///< FEValues of volume.
+        dealii::hp::FEFaceValues<dim,dim>    fe_values_collection_face_int; ///< FEValues of interior face.
+        dealii::hp::FEFaceValues<dim,dim>    fe_values_collection_face_ext; ///< FEValues of exterior face.
+        dealii::hp::FESubfaceValues<dim,dim> fe_values_collection_subface; ///< FEValues of subface.
+        dealii::hp::FEValues<dim,dim>        fe_values_collection_volume_lagrange; ///< FEValues of the Lagrange basis.
+    };
+
+    /// Empty copy data for dealii::WorkStream.
+    /** The cells of a given color write directly into the global vector without conflicts. */
+    struct AssemblyCopyData {};
+
     /// Used in the delegated constructor
     /** The main reason we use this weird function is because all of the above objects
      *  need to be looped with the various p-orders. This function allows us to do this in a
@@ -639,9 +875,31 @@ private:
      */
     MassiveCollectionTuple create_collection_tuple(const unsigned int max_degree, const int nstate, const Parameters::AllParameters *const parameters_input) const;
 
+    /// Reference-element operators of the discontinuity sensor, indexed by FE index.
+    /** Only the first state is used by the sensor, such that the operators act on the
+     *  coefficients of the first component of the FESystem.
+     *  Since the FE and quadrature collections never change, they are built once by
+     *  build_discontinuity_sensor_operators().
+     */
+    struct DiscontinuitySensorOperators
+    {
+        /// Interpolates the coefficients onto the volume quadrature points.
+        dealii::FullMatrix<double> soln_at_quad;
+        /// Interpolates the difference between the solution and its L2-projection onto p-1.
+        /** I.e. (V_p - V_{p-1} M_{p-1}^{-1} V_{p-1}^T W V_p) at the volume quadrature points. */
+        dealii::FullMatrix<double> projection_error_at_quad;
+    };
+    /// Discontinuity sensor operators of each FE index.
+    std::vector<DiscontinuitySensorOperators> discontinuity_sensor_operators;
+    /// Builds the discontinuity_sensor_operators.
+    void build_discontinuity_sensor_operators ();
+
 public:
     bool freeze_artificial_dissipation;
     /// Update discontinuity sensor.
+    /** Uses the precomputed discontinuity_sensor_operators such that each cell only
+     *  requires two small dense matrix-vector products.
+     */
     void update_artificial_dissipation_discontinuity_sensor();
 
 }; // end of DGBase class
@@ -680,6 +938,14 @@ public:
     /// Dissipative numerical flux with FadType
     std::unique_ptr < NumericalFlux::NumericalFluxDissipative<dim, nstate, FadType > > diss_num_flux_fad;
 
+    /// Contains the physics of the PDE with SFadType
+    /** Reset to nullptr by set_physics(), in which case FadType is used instead. */
+    std::shared_ptr < Physics::PhysicsBase<dim, nstate, SFadType<dim,nstate> > > pde_physics_sfad;
+    /// Convective numerical flux with SFadType
+    std::unique_ptr < NumericalFlux::NumericalFluxConvective<dim, nstate, SFadType<dim,nstate> > > conv_num_flux_sfad;
+    /// Dissipative numerical flux with SFadType
+    std::unique_ptr < NumericalFlux::NumericalFluxDissipative<dim, nstate, SFadType<dim,nstate> > > diss_num_flux_sfad;
+
     /// Contains the physics of the PDE with RadType
     std::shared_ptr < Physics::PhysicsBase<dim, nstate, RadType > > pde_physics_rad;
     /// Convective numerical flux with RadType
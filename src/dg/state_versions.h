@@ -0,0 +1,82 @@
+#ifndef __STATE_VERSIONS_H__
+#define __STATE_VERSIONS_H__
+
+#include <algorithm>
+#include <cmath>
+
+#include <deal.II/base/exceptions.h>
+
+namespace PHiLiP {
+
+/// Versions of the vectors the residual, its derivatives, and the functionals depend on.
+/** Each version is incremented whenever the corresponding vector is flagged as modified through
+ *  DGBase::solution_modified(), HighOrderGrid::volume_nodes_modified(), or DGBase::dual_modified().
+ *  Quantities that do not depend on the dual leave its version to 0.
+ */
+struct StateVersions
+{
+    unsigned int solution = 0; ///< DGBase::get_solution_version().
+    unsigned int volume_nodes = 0; ///< HighOrderGrid::get_volume_nodes_version().
+    unsigned int dual = 0; ///< DGBase::get_dual_version().
+
+    /// Whether all the versions are equal.
+    bool operator== (const StateVersions &other) const
+    {
+        return solution == other.solution && volume_nodes == other.volume_nodes && dual == other.dual;
+    }
+
+#ifdef DEBUG
+    /// l2-norms of the vectors, only used in debug mode to catch modifications that were not flagged.
+    /** Filled by DGBase::get_state_versions(). They are not part of operator==.
+     */
+    double solution_l2norm = 0.0;
+    double volume_nodes_l2norm = 0.0; ///< See solution_l2norm.
+    double dual_l2norm = 0.0; ///< See solution_l2norm.
+
+    /// Whether the vectors have the same l2-norms, up to round-off of the parallel reductions.
+    bool same_l2norms (const StateVersions &other) const
+    {
+        const auto same = [](const double a, const double b) { return std::abs(a-b) <= 1e-14 * std::max(std::abs(a), std::abs(b)); };
+        return same(solution_l2norm, other.solution_l2norm)
+               && same(volume_nodes_l2norm, other.volume_nodes_l2norm)
+               && same(dual_l2norm, other.dual_l2norm);
+    }
+#endif
+};
+
+/// Memoizes the state at which a quantity was last evaluated.
+/** Checking whether the quantity is up to date only compares the versions, such that it is
+ *  done in constant time and without any communication.
+ */
+class EvaluationStamp
+{
+public:
+    /// Whether the quantity was evaluated at the @p current versions.
+    /** In debug mode, asserts that vectors with unchanged versions also have unchanged l2-norms,
+     *  which catches direct writes that were not flagged as modifications.
+     */
+    bool is_current (const StateVersions &current) const
+    {
+        const bool same_versions = valid && versions == current;
+#ifdef DEBUG
+        Assert(!same_versions || versions.same_l2norms(current),
+               dealii::ExcMessage("The solution, volume_nodes, or dual has been modified without being flagged "
+                                  "through solution_modified(), volume_nodes_modified(), or dual_modified()."));
+#endif
+        return same_versions;
+    }
+
+    /// Records that the quantity has been evaluated at the @p current versions.
+    void set (const StateVersions &current) { versions = current; valid = true; }
+
+    /// Forces the quantity to be evaluated again.
+    void invalidate () { valid = false; }
+
+private:
+    StateVersions versions; ///< Versions at the last evaluation.
+    bool valid = false; ///< Whether the quantity has been evaluated since the last invalidate().
+};
+
+} // PHiLiP namespace
+
+#endif
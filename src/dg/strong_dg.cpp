@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+
 #include <deal.II/base/tensor.h>
+#include <deal.II/base/utilities.h>
 
 #include <deal.II/fe/fe_values.h>
 
@@ -15,6 +20,70 @@
 
 namespace PHiLiP {
 
+namespace {
+/// Applies a 1D operator along one direction of a lexicographically ordered tensor-product array.
+/** The row-major @p matrix has @p n_rows rows and @p n_cols columns, and is transposed if @p transpose is true.
+ *  Entry i of the input line is in[(i_outer*n_in + i)*stride + i_inner] and similarly for the output,
+ *  where @p stride is the number of points in the faster running directions, and @p n_outer in the slower ones.
+ *  The innermost loop runs over contiguous entries such that it vectorizes.
+ */
+template <typename real>
+void apply_1d_operator (
+    const real *matrix,
+    const unsigned int n_rows,
+    const unsigned int n_cols,
+    const bool transpose,
+    const unsigned int stride,
+    const unsigned int n_outer,
+    const real *in,
+    real *out)
+{
+    const unsigned int n_in = transpose ? n_rows : n_cols;
+    const unsigned int n_out = transpose ? n_cols : n_rows;
+    for (unsigned int i_outer = 0; i_outer < n_outer; ++i_outer) {
+        const real *in_outer = in + i_outer*n_in*stride;
+        real *out_outer = out + i_outer*n_out*stride;
+        for (unsigned int i = 0; i < n_out; ++i) {
+            real *out_line = out_outer + i*stride;
+            for (unsigned int i_inner = 0; i_inner < stride; ++i_inner) out_line[i_inner] = 0.0;
+            for (unsigned int j = 0; j < n_in; ++j) {
+                const real m = transpose ? matrix[j*n_cols + i] : matrix[i*n_cols + j];
+                const real *in_line = in_outer + j*stride;
+                for (unsigned int i_inner = 0; i_inner < stride; ++i_inner) out_line[i_inner] += m * in_line[i_inner];
+            }
+        }
+    }
+}
+
+/// Applies the tensor product of the 1D operators @p matrices, where matrices[d] acts along direction d.
+/** All the matrices have the same dimensions, see apply_1d_operator(). @p work is resized as needed.
+ */
+template <int dim, typename real>
+void apply_tensor_product_operator (
+    const std::array<const real*,dim> &matrices,
+    const unsigned int n_rows,
+    const unsigned int n_cols,
+    const bool transpose,
+    const real *in,
+    real *out,
+    std::vector<real> &work)
+{
+    const unsigned int n_in = transpose ? n_rows : n_cols;
+    const unsigned int n_out = transpose ? n_cols : n_rows;
+    const unsigned int work_size = dealii::Utilities::fixed_power<dim>(std::max(n_in, n_out));
+    if (work.size() < 2*work_size) work.resize(2*work_size);
+
+    const real *src = in;
+    for (int d = 0; d < dim; ++d) {
+        const unsigned int stride = dealii::Utilities::pow(n_out, d);
+        const unsigned int n_outer = dealii::Utilities::pow(n_in, dim-1-d);
+        real *dst = (d == dim-1) ? out : &work[(d%2)*work_size];
+        apply_1d_operator(matrices[d], n_rows, n_cols, transpose, stride, n_outer, src, dst);
+        src = dst;
+    }
+}
+} // anonymous namespace
+
 #if PHILIP_DIM==1 // dealii::parallel::distributed::Triangulation<dim> does not work for 1D
     template <int dim> using Triangulation = dealii::Triangulation<dim>;
 #else
@@ -29,7 +98,10 @@ DGStrong<dim,nstate,real>::DGStrong(
     const unsigned int grid_degree_input,
     const std::shared_ptr<Triangulation> triangulation_input)
     : DGBaseState<dim,nstate,real>::DGBaseState(parameters_input, degree, max_degree_input, grid_degree_input, triangulation_input)
-{ }
+{
+    // Built once here since the volume terms are assembled concurrently.
+    build_tensor_product_operators();
+}
 // Destructor
 template <int dim, int nstate, typename real>
 DGStrong<dim,nstate,real>::~DGStrong ()
@@ -38,27 +110,19 @@ DGStrong<dim,nstate,real>::~DGStrong ()
 }
 
 template <int dim, int nstate, typename real>
-void DGStrong<dim,nstate,real>::assemble_boundary_term_derivatives(
-    typename dealii::DoFHandler<dim>::active_cell_iterator /*cell*/,
-    const dealii::types::global_dof_index current_cell_index,
-    const unsigned int ,//face_number,
+template <typename adtype>
+void DGStrong<dim,nstate,real>::assemble_boundary_term(
     const unsigned int boundary_id,
     const dealii::FEFaceValuesBase<dim,dim> &fe_values_boundary,
     const real penalty,
-    const dealii::FESystem<dim,dim> &,//fe,
-    const dealii::Quadrature<dim-1> &,//quadrature,
-    const std::vector<dealii::types::global_dof_index> &,//metric_dof_indices,
     const std::vector<dealii::types::global_dof_index> &soln_dof_indices,
-    dealii::Vector<real> &local_rhs_int_cell,
-    const bool compute_dRdW,
-    const bool compute_dRdX,
-    const bool compute_d2R)
-{ 
-    (void) current_cell_index;
-    assert(compute_dRdW); assert(!compute_dRdX); assert(!compute_d2R);
-    (void) compute_dRdW; (void) compute_dRdX; (void) compute_d2R;
-    using ADArray = std::array<FadType,nstate>;
-    using ADArrayTensor1 = std::array< dealii::Tensor<1,dim,FadType>, nstate >;
+    const Physics::PhysicsBase<dim, nstate, adtype> &physics,
+    const NumericalFlux::NumericalFluxConvective<dim, nstate, adtype> &conv_num_flux,
+    const NumericalFlux::NumericalFluxDissipative<dim, nstate, adtype> &diss_num_flux,
+    dealii::Vector<real> &local_rhs_int_cell)
+{
+    using ADArray = std::array<adtype,nstate>;
+    using ADArrayTensor1 = std::array< dealii::Tensor<1,dim,adtype>, nstate >;
  
     const unsigned int n_dofs_cell = fe_values_boundary.dofs_per_cell;
     const unsigned int n_face_quad_pts = fe_values_boundary.n_quadrature_points;
@@ -84,7 +148,7 @@ void DGStrong<dim,nstate,real>::assemble_boundary_term_derivatives(
     std::vector<ADArrayTensor1> conv_phys_flux(n_face_quad_pts);
  
     // AD variable
-    std::vector< FadType > soln_coeff_int(n_dofs_cell);
+    std::vector< adtype > soln_coeff_int(n_dofs_cell);
     const unsigned int n_total_indep = n_dofs_cell;
     for (unsigned int idof = 0; idof < n_dofs_cell; ++idof) {
         soln_coeff_int[idof] = DGBase<dim,real>::solution(soln_dof_indices[idof]);
@@ -102,8 +166,8 @@ void DGStrong<dim,nstate,real>::assemble_boundary_term_derivatives(
     const std::vector< dealii::Point<dim,real> > quad_pts = fe_values_boundary.get_quadrature_points();
     for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
  
-        const dealii::Tensor<1,dim,FadType> normal_int = normals[iquad];
-        const dealii::Tensor<1,dim,FadType> normal_ext = -normal_int;
+        const dealii::Tensor<1,dim,adtype> normal_int = normals[iquad];
+        const dealii::Tensor<1,dim,adtype> normal_ext = -normal_int;
  
         for (unsigned int idof=0; idof<n_dofs_cell; ++idof) {
             const int istate = fe_values_boundary.get_fe().system_to_component_index(idof).first;
@@ -112,9 +176,9 @@ void DGStrong<dim,nstate,real>::assemble_boundary_term_derivatives(
         }
  
         const dealii::Point<dim, real> real_quad_point = quad_pts[iquad];
-        dealii::Point<dim,FadType> ad_point;
+        dealii::Point<dim,adtype> ad_point;
         for (int d=0;d<dim;++d) { ad_point[d] = real_quad_point[d]; }
-        this->pde_physics_fad->boundary_face_values (boundary_id, ad_point, normal_int, soln_int[iquad], soln_grad_int[iquad], soln_ext[iquad], soln_grad_ext[iquad]);
+        physics.boundary_face_values (boundary_id, ad_point, normal_int, soln_int[iquad], soln_grad_int[iquad], soln_ext[iquad], soln_grad_ext[iquad]);
  
         //
         // Evaluate physical convective flux, physical dissipative flux
@@ -122,20 +186,20 @@ void DGStrong<dim,nstate,real>::assemble_boundary_term_derivatives(
         //      Hartmann, R., Numerical Analysis of Higher Order Discontinuous Galerkin Finite Element Methods,
         //      Institute of Aerodynamics and Flow Technology, DLR (German Aerospace Center), 2008.
         //      Details given on page 93
-        //conv_num_flux_dot_n[iquad] = DGBaseState<dim,nstate,real>::conv_num_flux_fad->evaluate_flux(soln_ext[iquad], soln_ext[iquad], normal_int);
+        //conv_num_flux_dot_n[iquad] = conv_num_flux.evaluate_flux(soln_ext[iquad], soln_ext[iquad], normal_int);
  
         // So, I wasn't able to get Euler manufactured solutions to converge when F* = F*(Ubc, Ubc)
         // Changing it back to the standdard F* = F*(Uin, Ubc)
         // This is known not be adjoint consistent as per the paper above. Page 85, second to last paragraph.
         // Losing 2p+1 OOA on functionals for all PDEs.
-        conv_num_flux_dot_n[iquad] = DGBaseState<dim,nstate,real>::conv_num_flux_fad->evaluate_flux(soln_int[iquad], soln_ext[iquad], normal_int);
+        conv_num_flux_dot_n[iquad] = conv_num_flux.evaluate_flux(soln_int[iquad], soln_ext[iquad], normal_int);
  
         // Used for strong form
         // Which physical convective flux to use?
-        conv_phys_flux[iquad] = this->pde_physics_fad->convective_flux (soln_int[iquad]);
+        conv_phys_flux[iquad] = physics.convective_flux (soln_int[iquad]);
  
         // Notice that the flux uses the solution given by the Dirichlet or Neumann boundary condition
-        diss_soln_num_flux[iquad] = DGBaseState<dim,nstate,real>::diss_num_flux_fad->evaluate_solution_flux(soln_ext[iquad], soln_ext[iquad], normal_int);
+        diss_soln_num_flux[iquad] = diss_num_flux.evaluate_solution_flux(soln_ext[iquad], soln_ext[iquad], normal_int);
  
         ADArrayTensor1 diss_soln_jump_int;
         for (int s=0; s<nstate; s++) {
@@ -143,9 +207,9 @@ void DGStrong<dim,nstate,real>::assemble_boundary_term_derivatives(
     diss_soln_jump_int[s][d] = (diss_soln_num_flux[iquad][s] - soln_int[iquad][s]) * normal_int[d];
    }
         }
-        diss_flux_jump_int[iquad] = this->pde_physics_fad->dissipative_flux (soln_int[iquad], diss_soln_jump_int);
+        diss_flux_jump_int[iquad] = physics.dissipative_flux (soln_int[iquad], diss_soln_jump_int);
  
-        diss_auxi_num_flux_dot_n[iquad] = DGBaseState<dim,nstate,real>::diss_num_flux_fad->evaluate_auxiliary_flux(
+        diss_auxi_num_flux_dot_n[iquad] = diss_num_flux.evaluate_auxiliary_flux(
             0.0, 0.0,
             soln_int[iquad], soln_ext[iquad],
             soln_grad_int[iquad], soln_grad_ext[iquad],
@@ -155,14 +219,14 @@ void DGStrong<dim,nstate,real>::assemble_boundary_term_derivatives(
     // Boundary integral
     for (unsigned int itest=0; itest<n_dofs_cell; ++itest) {
  
-        FadType rhs = 0.0;
+        adtype rhs = 0.0;
  
         const unsigned int istate = fe_values_boundary.get_fe().system_to_component_index(itest).first;
  
         for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
  
             // Convection
-            const FadType flux_diff = conv_num_flux_dot_n[iquad][istate] - conv_phys_flux[iquad][istate]*normals[iquad];
+            const adtype flux_diff = conv_num_flux_dot_n[iquad][istate] - conv_phys_flux[iquad][istate]*normals[iquad];
             rhs = rhs - fe_values_boundary.shape_value_component(itest,iquad,istate) * flux_diff * JxW[iquad];
             // Diffusive
             rhs = rhs - fe_values_boundary.shape_value_component(itest,iquad,istate) * diss_auxi_num_flux_dot_n[iquad][istate] * JxW[iquad];
@@ -182,16 +246,18 @@ void DGStrong<dim,nstate,real>::assemble_boundary_term_derivatives(
     }
 }
 template <int dim, int nstate, typename real>
-void DGStrong<dim,nstate,real>::assemble_volume_term_derivatives(
+void DGStrong<dim,nstate,real>::assemble_boundary_term_derivatives(
     typename dealii::DoFHandler<dim>::active_cell_iterator /*cell*/,
     const dealii::types::global_dof_index current_cell_index,
-    const dealii::FEValues<dim,dim> &fe_values_vol,
+    const unsigned int ,//face_number,
+    const unsigned int boundary_id,
+    const dealii::FEFaceValuesBase<dim,dim> &fe_values_boundary,
+    const real penalty,
     const dealii::FESystem<dim,dim> &,//fe,
-    const dealii::Quadrature<dim> &,//quadrature,
+    const dealii::Quadrature<dim-1> &,//quadrature,
     const std::vector<dealii::types::global_dof_index> &,//metric_dof_indices,
-    const std::vector<dealii::types::global_dof_index> &cell_dofs_indices,
+    const std::vector<dealii::types::global_dof_index> &soln_dof_indices,
     dealii::Vector<real> &local_rhs_int_cell,
-    const dealii::FEValues<dim,dim> &fe_values_lagrange,
     const bool compute_dRdW,
     const bool compute_dRdX,
     const bool compute_d2R)
@@ -199,8 +265,32 @@ void DGStrong<dim,nstate,real>::assemble_volume_term_derivatives(
     (void) current_cell_index;
     assert(compute_dRdW); assert(!compute_dRdX); assert(!compute_d2R);
     (void) compute_dRdW; (void) compute_dRdX; (void) compute_d2R;
-    using ADArray = std::array<FadType,nstate>;
-    using ADArrayTensor1 = std::array< dealii::Tensor<1,dim,FadType>, nstate >;
+
+    const unsigned int n_dofs_cell = fe_values_boundary.dofs_per_cell;
+    if (this->pde_physics_sfad && n_dofs_cell <= static_cast<unsigned int>(n_static_fad_derivatives<dim,nstate>())) {
+        assemble_boundary_term<SFadType<dim,nstate>>(
+            boundary_id, fe_values_boundary, penalty, soln_dof_indices,
+            *(this->pde_physics_sfad), *(this->conv_num_flux_sfad), *(this->diss_num_flux_sfad),
+            local_rhs_int_cell);
+    } else {
+        assemble_boundary_term<FadType>(
+            boundary_id, fe_values_boundary, penalty, soln_dof_indices,
+            *(this->pde_physics_fad), *(this->conv_num_flux_fad), *(this->diss_num_flux_fad),
+            local_rhs_int_cell);
+    }
+}
+
+template <int dim, int nstate, typename real>
+template <typename adtype>
+void DGStrong<dim,nstate,real>::assemble_volume_term(
+    const dealii::FEValues<dim,dim> &fe_values_vol,
+    const std::vector<dealii::types::global_dof_index> &cell_dofs_indices,
+    const Physics::PhysicsBase<dim, nstate, adtype> &physics,
+    dealii::Vector<real> &local_rhs_int_cell,
+    const dealii::FEValues<dim,dim> &fe_values_lagrange)
+{
+    using ADArray = std::array<adtype,nstate>;
+    using ADArrayTensor1 = std::array< dealii::Tensor<1,dim,adtype>, nstate >;
 
     const unsigned int n_quad_pts      = fe_values_vol.n_quadrature_points;
     const unsigned int n_dofs_cell     = fe_values_vol.dofs_per_cell;
@@ -221,7 +311,7 @@ void DGStrong<dim,nstate,real>::assemble_volume_term_derivatives(
 
 
     // AD variable
-    std::vector< FadType > soln_coeff(n_dofs_cell);
+    std::vector< adtype > soln_coeff(n_dofs_cell);
     for (unsigned int idof = 0; idof < n_dofs_cell; ++idof) {
         soln_coeff[idof] = DGBase<dim,real>::solution(cell_dofs_indices[idof]);
         soln_coeff[idof].diff(idof, n_dofs_cell);
@@ -244,14 +334,14 @@ void DGStrong<dim,nstate,real>::assemble_volume_term_derivatives(
         //if(nstate>1) std::cout << "Momentum " << soln_at_q[iquad][1] << std::endl;
         //std::cout << "Energy " << soln_at_q[iquad][nstate-1] << std::endl;
         // Evaluate physical convective flux and source term
-        conv_phys_flux_at_q[iquad] = this->pde_physics_fad->convective_flux (soln_at_q[iquad]);
-        diss_phys_flux_at_q[iquad] = this->pde_physics_fad->dissipative_flux (soln_at_q[iquad], soln_grad_at_q[iquad]);
+        conv_phys_flux_at_q[iquad] = physics.convective_flux (soln_at_q[iquad]);
+        diss_phys_flux_at_q[iquad] = physics.dissipative_flux (soln_at_q[iquad], soln_grad_at_q[iquad]);
 
         if(this->all_parameters->manufactured_convergence_study_param.use_manufactured_source_term) {
             const dealii::Point<dim,real> real_quad_point = fe_values_vol.quadrature_point(iquad);
-            dealii::Point<dim,FadType> ad_point;
+            dealii::Point<dim,adtype> ad_point;
             for (int d=0;d<dim;++d) { ad_point[d] = real_quad_point[d]; }
-            source_at_q[iquad] = this->pde_physics_fad->source_term (ad_point, soln_at_q[iquad]);
+            source_at_q[iquad] = physics.source_term (ad_point, soln_at_q[iquad]);
         }
     }
 
@@ -261,8 +351,8 @@ void DGStrong<dim,nstate,real>::assemble_volume_term_derivatives(
     //const dealii::FEValues<dim,dim> &fe_values_lagrange = this->fe_values_collection_volume_lagrange.get_present_fe_values();
     std::vector<ADArray> flux_divergence(n_quad_pts);
 
-    std::array<std::array<std::vector<FadType>,nstate>,dim> f;
-    std::array<std::array<std::vector<FadType>,nstate>,dim> g;
+    std::array<std::array<std::vector<adtype>,nstate>,dim> f;
+    std::array<std::array<std::vector<adtype>,nstate>,dim> g;
 
     for (int istate = 0; istate<nstate; ++istate) {
         for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
@@ -284,7 +374,7 @@ void DGStrong<dim,nstate,real>::assemble_volume_term_derivatives(
     // is negative. Therefore, negative of negative means we add that volume term to the right-hand-side
     for (unsigned int itest=0; itest<n_dofs_cell; ++itest) {
 
-        FadType rhs = 0;
+        adtype rhs = 0;
 
 
         const unsigned int istate = fe_values_vol.get_fe().system_to_component_index(itest).first;
@@ -319,36 +409,50 @@ void DGStrong<dim,nstate,real>::assemble_volume_term_derivatives(
     }
 }
 template <int dim, int nstate, typename real>
-void DGStrong<dim,nstate,real>::assemble_face_term_derivatives(
+void DGStrong<dim,nstate,real>::assemble_volume_term_derivatives(
     typename dealii::DoFHandler<dim>::active_cell_iterator /*cell*/,
     const dealii::types::global_dof_index current_cell_index,
-    const dealii::types::global_dof_index neighbor_cell_index,
-    const std::pair<unsigned int, int> /*face_subface_int*/,
-    const std::pair<unsigned int, int> /*face_subface_ext*/,
-    const typename dealii::QProjector<dim>::DataSetDescriptor /*face_data_set_int*/,
-    const typename dealii::QProjector<dim>::DataSetDescriptor /*face_data_set_ext*/,
-    const dealii::FEFaceValuesBase<dim,dim>     &fe_values_int,
-    const dealii::FEFaceValuesBase<dim,dim>     &fe_values_ext,
-    const real penalty,
-    const dealii::FESystem<dim,dim> &,//fe_int,
-    const dealii::FESystem<dim,dim> &,//fe_ext,
-    const dealii::Quadrature<dim-1> &,//face_quadrature_int,
-    const std::vector<dealii::types::global_dof_index> &,//metric_dof_indices_int,
-    const std::vector<dealii::types::global_dof_index> &,//metric_dof_indices_ext,
-    const std::vector<dealii::types::global_dof_index> &soln_dof_indices_int,
-    const std::vector<dealii::types::global_dof_index> &soln_dof_indices_ext,
-    dealii::Vector<real>          &local_rhs_int_cell,
-    dealii::Vector<real>          &local_rhs_ext_cell,
+    const dealii::FEValues<dim,dim> &fe_values_vol,
+    const dealii::FESystem<dim,dim> &,//fe,
+    const dealii::Quadrature<dim> &,//quadrature,
+    const std::vector<dealii::types::global_dof_index> &,//metric_dof_indices,
+    const std::vector<dealii::types::global_dof_index> &cell_dofs_indices,
+    dealii::Vector<real> &local_rhs_int_cell,
+    const dealii::FEValues<dim,dim> &fe_values_lagrange,
     const bool compute_dRdW,
     const bool compute_dRdX,
     const bool compute_d2R)
 {
     (void) current_cell_index;
-    (void) neighbor_cell_index;
     assert(compute_dRdW); assert(!compute_dRdX); assert(!compute_d2R);
     (void) compute_dRdW; (void) compute_dRdX; (void) compute_d2R;
-    using ADArray = std::array<FadType,nstate>;
-    using ADArrayTensor1 = std::array< dealii::Tensor<1,dim,FadType>, nstate >;
+
+    const unsigned int n_dofs_cell = fe_values_vol.dofs_per_cell;
+    if (this->pde_physics_sfad && n_dofs_cell <= static_cast<unsigned int>(n_static_fad_derivatives<dim,nstate>())) {
+        assemble_volume_term<SFadType<dim,nstate>>(
+            fe_values_vol, cell_dofs_indices, *(this->pde_physics_sfad), local_rhs_int_cell, fe_values_lagrange);
+    } else {
+        assemble_volume_term<FadType>(
+            fe_values_vol, cell_dofs_indices, *(this->pde_physics_fad), local_rhs_int_cell, fe_values_lagrange);
+    }
+}
+
+template <int dim, int nstate, typename real>
+template <typename adtype>
+void DGStrong<dim,nstate,real>::assemble_face_term(
+    const dealii::FEFaceValuesBase<dim,dim>     &fe_values_int,
+    const dealii::FEFaceValuesBase<dim,dim>     &fe_values_ext,
+    const real penalty,
+    const std::vector<dealii::types::global_dof_index> &soln_dof_indices_int,
+    const std::vector<dealii::types::global_dof_index> &soln_dof_indices_ext,
+    const Physics::PhysicsBase<dim, nstate, adtype> &physics,
+    const NumericalFlux::NumericalFluxConvective<dim, nstate, adtype> &conv_num_flux,
+    const NumericalFlux::NumericalFluxDissipative<dim, nstate, adtype> &diss_num_flux,
+    dealii::Vector<real>          &local_rhs_int_cell,
+    dealii::Vector<real>          &local_rhs_ext_cell)
+{
+    using ADArray = std::array<adtype,nstate>;
+    using ADArrayTensor1 = std::array< dealii::Tensor<1,dim,adtype>, nstate >;
 
     // Use quadrature points of neighbor cell
     // Might want to use the maximum n_quad_pts1 and n_quad_pts2
@@ -366,8 +470,8 @@ void DGStrong<dim,nstate,real>::assemble_face_term_derivatives(
     const std::vector<dealii::Tensor<1,dim> > &normals_int = fe_values_int.get_normal_vectors ();
 
     // AD variable
-    std::vector<FadType> soln_coeff_int_ad(n_dofs_int);
-    std::vector<FadType> soln_coeff_ext_ad(n_dofs_ext);
+    std::vector<adtype> soln_coeff_int_ad(n_dofs_int);
+    std::vector<adtype> soln_coeff_ext_ad(n_dofs_ext);
 
 
     // Jacobian blocks
@@ -412,8 +516,8 @@ void DGStrong<dim,nstate,real>::assemble_face_term_derivatives(
     }
     for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
 
-        const dealii::Tensor<1,dim,FadType> normal_int = normals_int[iquad];
-        const dealii::Tensor<1,dim,FadType> normal_ext = -normal_int;
+        const dealii::Tensor<1,dim,adtype> normal_int = normals_int[iquad];
+        const dealii::Tensor<1,dim,adtype> normal_ext = -normal_int;
 
         // Interpolate solution to face
         for (unsigned int idof=0; idof<n_dofs_int; ++idof) {
@@ -434,12 +538,12 @@ void DGStrong<dim,nstate,real>::assemble_face_term_derivatives(
         //std::cout << "Energy ext" << soln_ext[iquad][nstate-1] << std::endl;
 
         // Evaluate physical convective flux, physical dissipative flux, and source term
-        conv_num_flux_dot_n[iquad] = DGBaseState<dim,nstate,real>::conv_num_flux_fad->evaluate_flux(soln_int[iquad], soln_ext[iquad], normal_int);
+        conv_num_flux_dot_n[iquad] = conv_num_flux.evaluate_flux(soln_int[iquad], soln_ext[iquad], normal_int);
 
-        conv_phys_flux_int[iquad] = this->pde_physics_fad->convective_flux (soln_int[iquad]);
-        conv_phys_flux_ext[iquad] = this->pde_physics_fad->convective_flux (soln_ext[iquad]);
+        conv_phys_flux_int[iquad] = physics.convective_flux (soln_int[iquad]);
+        conv_phys_flux_ext[iquad] = physics.convective_flux (soln_ext[iquad]);
 
-        diss_soln_num_flux[iquad] = DGBaseState<dim,nstate,real>::diss_num_flux_fad->evaluate_solution_flux(soln_int[iquad], soln_ext[iquad], normal_int);
+        diss_soln_num_flux[iquad] = diss_num_flux.evaluate_solution_flux(soln_int[iquad], soln_ext[iquad], normal_int);
 
         ADArrayTensor1 diss_soln_jump_int, diss_soln_jump_ext;
         for (int s=0; s<nstate; s++) {
@@ -448,10 +552,10 @@ void DGStrong<dim,nstate,real>::assemble_face_term_derivatives(
     diss_soln_jump_ext[s][d] = (diss_soln_num_flux[iquad][s] - soln_ext[iquad][s]) * normal_ext[d];
    }
         }
-        diss_flux_jump_int[iquad] = this->pde_physics_fad->dissipative_flux (soln_int[iquad], diss_soln_jump_int);
-        diss_flux_jump_ext[iquad] = this->pde_physics_fad->dissipative_flux (soln_ext[iquad], diss_soln_jump_ext);
+        diss_flux_jump_int[iquad] = physics.dissipative_flux (soln_int[iquad], diss_soln_jump_int);
+        diss_flux_jump_ext[iquad] = physics.dissipative_flux (soln_ext[iquad], diss_soln_jump_ext);
 
-        diss_auxi_num_flux_dot_n[iquad] = DGBaseState<dim,nstate,real>::diss_num_flux_fad->evaluate_auxiliary_flux(
+        diss_auxi_num_flux_dot_n[iquad] = diss_num_flux.evaluate_auxiliary_flux(
             0.0, 0.0,
             soln_int[iquad], soln_ext[iquad],
             soln_grad_int[iquad], soln_grad_ext[iquad],
@@ -460,12 +564,12 @@ void DGStrong<dim,nstate,real>::assemble_face_term_derivatives(
 
     // From test functions associated with interior cell point of view
     for (unsigned int itest_int=0; itest_int<n_dofs_int; ++itest_int) {
-        FadType rhs = 0.0;
+        adtype rhs = 0.0;
         const unsigned int istate = fe_values_int.get_fe().system_to_component_index(itest_int).first;
 
         for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
             // Convection
-            const FadType flux_diff = conv_num_flux_dot_n[iquad][istate] - conv_phys_flux_int[iquad][istate]*normals_int[iquad];
+            const adtype flux_diff = conv_num_flux_dot_n[iquad][istate] - conv_phys_flux_int[iquad][istate]*normals_int[iquad];
             rhs = rhs - fe_values_int.shape_value_component(itest_int,iquad,istate) * flux_diff * JxW_int[iquad];
             // Diffusive
             rhs = rhs - fe_values_int.shape_value_component(itest_int,iquad,istate) * diss_auxi_num_flux_dot_n[iquad][istate] * JxW_int[iquad];
@@ -481,18 +585,18 @@ void DGStrong<dim,nstate,real>::assemble_face_term_derivatives(
                 dR1_dW2[idof] = rhs.fastAccessDx(n_dofs_int+idof);
             }
             this->system_matrix.add(soln_dof_indices_int[itest_int], soln_dof_indices_int, dR1_dW1);
-            this->system_matrix.add(soln_dof_indices_int[itest_int], soln_dof_indices_ext, dR1_dW2);
+            if (!this->is_cell_block_jacobian()) this->system_matrix.add(soln_dof_indices_int[itest_int], soln_dof_indices_ext, dR1_dW2);
         }
     }
 
     // From test functions associated with neighbour cell point of view
     for (unsigned int itest_ext=0; itest_ext<n_dofs_ext; ++itest_ext) {
-        FadType rhs = 0.0;
+        adtype rhs = 0.0;
         const unsigned int istate = fe_values_int.get_fe().system_to_component_index(itest_ext).first;
 
         for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
             // Convection
-            const FadType flux_diff = (-conv_num_flux_dot_n[iquad][istate]) - conv_phys_flux_ext[iquad][istate]*(-normals_int[iquad]);
+            const adtype flux_diff = (-conv_num_flux_dot_n[iquad][istate]) - conv_phys_flux_ext[iquad][istate]*(-normals_int[iquad]);
             rhs = rhs - fe_values_ext.shape_value_component(itest_ext,iquad,istate) * flux_diff * JxW_int[iquad];
             // Diffusive
             rhs = rhs - fe_values_ext.shape_value_component(itest_ext,iquad,istate) * (-diss_auxi_num_flux_dot_n[iquad][istate]) * JxW_int[iquad];
@@ -507,7 +611,7 @@ void DGStrong<dim,nstate,real>::assemble_face_term_derivatives(
             for (unsigned int idof = 0; idof < n_dofs_ext; ++idof) {
                 dR2_dW2[idof] = rhs.fastAccessDx(n_dofs_int+idof);
             }
-            this->system_matrix.add(soln_dof_indices_ext[itest_ext], soln_dof_indices_int, dR2_dW1);
+            if (!this->is_cell_block_jacobian()) this->system_matrix.add(soln_dof_indices_ext[itest_ext], soln_dof_indices_int, dR2_dW1);
             this->system_matrix.add(soln_dof_indices_ext[itest_ext], soln_dof_indices_ext, dR2_dW2);
         }
     }
@@ -515,15 +619,65 @@ void DGStrong<dim,nstate,real>::assemble_face_term_derivatives(
 
 
 template <int dim, int nstate, typename real>
-void DGStrong<dim,nstate,real>::assemble_volume_term_explicit(
+void DGStrong<dim,nstate,real>::assemble_face_term_derivatives(
     typename dealii::DoFHandler<dim>::active_cell_iterator /*cell*/,
     const dealii::types::global_dof_index current_cell_index,
+    const dealii::types::global_dof_index neighbor_cell_index,
+    const std::pair<unsigned int, int> /*face_subface_int*/,
+    const std::pair<unsigned int, int> /*face_subface_ext*/,
+    const typename dealii::QProjector<dim>::DataSetDescriptor /*face_data_set_int*/,
+    const typename dealii::QProjector<dim>::DataSetDescriptor /*face_data_set_ext*/,
+    const dealii::FEFaceValuesBase<dim,dim>     &fe_values_int,
+    const dealii::FEFaceValuesBase<dim,dim>     &fe_values_ext,
+    const real penalty,
+    const dealii::FESystem<dim,dim> &,//fe_int,
+    const dealii::FESystem<dim,dim> &,//fe_ext,
+    const dealii::Quadrature<dim-1> &,//face_quadrature_int,
+    const std::vector<dealii::types::global_dof_index> &,//metric_dof_indices_int,
+    const std::vector<dealii::types::global_dof_index> &,//metric_dof_indices_ext,
+    const std::vector<dealii::types::global_dof_index> &soln_dof_indices_int,
+    const std::vector<dealii::types::global_dof_index> &soln_dof_indices_ext,
+    dealii::Vector<real>          &local_rhs_int_cell,
+    dealii::Vector<real>          &local_rhs_ext_cell,
+    const bool compute_dRdW,
+    const bool compute_dRdX,
+    const bool compute_d2R)
+{
+    (void) current_cell_index;
+    (void) neighbor_cell_index;
+    assert(compute_dRdW); assert(!compute_dRdX); assert(!compute_d2R);
+    (void) compute_dRdW; (void) compute_dRdX; (void) compute_d2R;
+
+    // Derivatives are taken with respect to the solution of both cells.
+    const unsigned int n_total_indep = fe_values_int.dofs_per_cell + fe_values_ext.dofs_per_cell;
+    if (this->pde_physics_sfad && n_total_indep <= static_cast<unsigned int>(n_static_fad_derivatives<dim,nstate>())) {
+        assemble_face_term<SFadType<dim,nstate>>(
+            fe_values_int, fe_values_ext, penalty, soln_dof_indices_int, soln_dof_indices_ext,
+            *(this->pde_physics_sfad), *(this->conv_num_flux_sfad), *(this->diss_num_flux_sfad),
+            local_rhs_int_cell, local_rhs_ext_cell);
+    } else {
+        assemble_face_term<FadType>(
+            fe_values_int, fe_values_ext, penalty, soln_dof_indices_int, soln_dof_indices_ext,
+            *(this->pde_physics_fad), *(this->conv_num_flux_fad), *(this->diss_num_flux_fad),
+            local_rhs_int_cell, local_rhs_ext_cell);
+    }
+}
+
+template <int dim, int nstate, typename real>
+void DGStrong<dim,nstate,real>::assemble_volume_term_explicit(
+    typename dealii::DoFHandler<dim>::active_cell_iterator cell,
+    const dealii::types::global_dof_index current_cell_index,
     const dealii::FEValues<dim,dim> &fe_values_vol,
     const std::vector<dealii::types::global_dof_index> &cell_dofs_indices,
     dealii::Vector<real> &local_rhs_int_cell,
     const dealii::FEValues<dim,dim> &fe_values_lagrange)
 {
     (void) current_cell_index;
+    const TensorProductOperators &operators = tensor_product_operators[cell->active_fe_index()];
+    if (use_sum_factorization && operators.is_tensor_product) {
+        assemble_volume_term_explicit_sum_factorized(operators, fe_values_vol, cell_dofs_indices, local_rhs_int_cell);
+        return;
+    }
     //std::cout << "assembling cell terms" << std::endl;
     using realtype = real;
     using realArray = std::array<realtype,nstate>;
@@ -638,6 +792,240 @@ void DGStrong<dim,nstate,real>::assemble_volume_term_explicit(
 }
 
 
+template <int dim, int nstate, typename real>
+void DGStrong<dim,nstate,real>::build_tensor_product_operators ()
+{
+    tensor_product_operators.clear();
+    tensor_product_operators.resize(this->fe_collection.size());
+    for (unsigned int i_fele = 0; i_fele < this->fe_collection.size(); ++i_fele) {
+        TensorProductOperators &operators = tensor_product_operators[i_fele];
+
+        const dealii::FiniteElement<dim,dim> &fe = this->fe_collection[i_fele];
+        const dealii::Quadrature<1> &oned_quadrature = this->oned_quadrature_collection[i_fele];
+        const dealii::Quadrature<dim> &quadrature = this->volume_quadrature_collection[i_fele];
+
+        // Every state must use the same lexicographically numbered Lagrange basis.
+        if (fe.n_base_elements() != 1) continue;
+        const dealii::FiniteElement<dim,dim> &base_fe = fe.base_element(0);
+        if (dynamic_cast<const dealii::FE_DGQ<dim,dim>*>(&base_fe) == nullptr) continue;
+
+        const unsigned int n_dofs_1d = base_fe.tensor_degree() + 1;
+        const unsigned int n_quad_1d = oned_quadrature.size();
+        if (dealii::Utilities::fixed_power<dim>(n_dofs_1d) != base_fe.dofs_per_cell) continue;
+        if (dealii::Utilities::fixed_power<dim>(n_quad_1d) != quadrature.size()) continue;
+
+        // The volume quadrature must be the tensor product of the 1D quadrature, with x running fastest.
+        bool is_tensor_product = true;
+        for (unsigned int iquad = 0; iquad < quadrature.size() && is_tensor_product; ++iquad) {
+            unsigned int index = iquad;
+            for (int d = 0; d < dim; ++d) {
+                const unsigned int iquad_1d = index % n_quad_1d;
+                index /= n_quad_1d;
+                if (std::abs(quadrature.point(iquad)[d] - oned_quadrature.point(iquad_1d)[0]) > 1e-14) is_tensor_product = false;
+            }
+        }
+        if (!is_tensor_product) continue;
+
+        // The first n_dofs_1d basis functions vary along x only. On the line through the first support point,
+        // the other 1D polynomials take the value 1, such that they reduce to the 1D basis.
+        const dealii::Point<dim> first_support_point = base_fe.get_unit_support_points()[0];
+        operators.basis.resize(n_quad_1d * n_dofs_1d);
+        operators.basis_derivative.resize(n_quad_1d * n_dofs_1d);
+        for (unsigned int iquad = 0; iquad < n_quad_1d; ++iquad) {
+            dealii::Point<dim> point = first_support_point;
+            point[0] = oned_quadrature.point(iquad)[0];
+            for (unsigned int idof = 0; idof < n_dofs_1d; ++idof) {
+                operators.basis[iquad*n_dofs_1d + idof] = base_fe.shape_value(idof, point);
+                operators.basis_derivative[iquad*n_dofs_1d + idof] = base_fe.shape_grad(idof, point)[0];
+            }
+        }
+
+        // Same as the 1D factor of fe_collection_lagrange.
+        const dealii::FE_DGQArbitraryNodes<1,1> collocated_fe(oned_quadrature);
+        operators.collocated_derivative.resize(n_quad_1d * n_quad_1d);
+        for (unsigned int iquad = 0; iquad < n_quad_1d; ++iquad) {
+            for (unsigned int jquad = 0; jquad < n_quad_1d; ++jquad) {
+                operators.collocated_derivative[iquad*n_quad_1d + jquad] = collocated_fe.shape_grad(jquad, oned_quadrature.point(iquad))[0];
+            }
+        }
+
+        operators.n_dofs_1d = n_dofs_1d;
+        operators.n_quad_1d = n_quad_1d;
+        operators.is_tensor_product = true;
+    }
+}
+
+template <int dim, int nstate, typename real>
+void DGStrong<dim,nstate,real>::assemble_volume_term_explicit_sum_factorized(
+    const TensorProductOperators &operators,
+    const dealii::FEValues<dim,dim> &fe_values_vol,
+    const std::vector<dealii::types::global_dof_index> &cell_dofs_indices,
+    dealii::Vector<real> &local_rhs_int_cell)
+{
+    using realArray = std::array<real,nstate>;
+    using realArrayTensor1 = std::array< dealii::Tensor<1,dim,real>, nstate >;
+
+    const dealii::FiniteElement<dim,dim> &fe = fe_values_vol.get_fe();
+    const unsigned int n_quad_pts   = fe_values_vol.n_quadrature_points;
+    const unsigned int n_dofs_cell  = fe_values_vol.dofs_per_cell;
+    const unsigned int n_dofs_state = n_dofs_cell / nstate;
+    const unsigned int n_dofs_1d    = operators.n_dofs_1d;
+    const unsigned int n_quad_1d    = operators.n_quad_1d;
+
+    AssertDimension (n_dofs_cell, cell_dofs_indices.size());
+    AssertDimension (n_quad_pts, dealii::Utilities::fixed_power<dim>(n_quad_1d));
+    AssertDimension (n_dofs_state, dealii::Utilities::fixed_power<dim>(n_dofs_1d));
+
+    const std::vector<real> &JxW = fe_values_vol.get_JxW_values ();
+    const bool use_source = this->all_parameters->manufactured_convergence_study_param.use_manufactured_source_term;
+
+    // Operators interpolating the values, and the reference derivatives along each direction.
+    std::array<const real*,dim> value_operators;
+    value_operators.fill(operators.basis.data());
+    std::array<std::array<const real*,dim>,dim> derivative_operators;
+    for (int d = 0; d < dim; ++d) {
+        derivative_operators[d] = value_operators;
+        derivative_operators[d][d] = operators.basis_derivative.data();
+    }
+
+    std::vector<real> work;
+    std::vector<real> state_coeff(n_dofs_state);
+    std::vector<real> state_values(n_quad_pts);
+    std::array<std::vector<real>,dim> state_reference_gradients;
+    for (int d = 0; d < dim; ++d) state_reference_gradients[d].resize(n_quad_pts);
+
+    // Interpolate the solution and its gradient one state at a time
+    std::vector< realArray > soln_at_q(n_quad_pts);
+    std::vector< realArrayTensor1 > soln_grad_at_q(n_quad_pts);
+    for (int istate = 0; istate < nstate; ++istate) {
+        for (unsigned int idof = 0; idof < n_dofs_state; ++idof) {
+            state_coeff[idof] = DGBase<dim,real>::solution(cell_dofs_indices[fe.component_to_system_index(istate, idof)]);
+        }
+        apply_tensor_product_operator<dim,real>(value_operators, n_quad_1d, n_dofs_1d, false, state_coeff.data(), state_values.data(), work);
+        for (int d = 0; d < dim; ++d) {
+            apply_tensor_product_operator<dim,real>(derivative_operators[d], n_quad_1d, n_dofs_1d, false, state_coeff.data(), state_reference_gradients[d].data(), work);
+        }
+        for (unsigned int iquad = 0; iquad < n_quad_pts; ++iquad) {
+            soln_at_q[iquad][istate] = state_values[iquad];
+            const dealii::DerivativeForm<1,dim,dim> &inverse_jacobian = fe_values_vol.inverse_jacobian(iquad);
+            for (int j = 0; j < dim; ++j) {
+                real gradient = 0.0;
+                for (int d = 0; d < dim; ++d) gradient += inverse_jacobian[d][j] * state_reference_gradients[d][iquad];
+                soln_grad_at_q[iquad][istate][j] = gradient;
+            }
+        }
+    }
+
+    // Evaluate physical convective flux, physical dissipative flux, and source term
+    std::vector< realArrayTensor1 > conv_phys_flux_at_q(n_quad_pts);
+    std::vector< realArrayTensor1 > diss_phys_flux_at_q(n_quad_pts);
+    std::vector< realArray > source_at_q(n_quad_pts);
+    for (unsigned int iquad = 0; iquad < n_quad_pts; ++iquad) {
+        conv_phys_flux_at_q[iquad] = DGBaseState<dim,nstate,real>::pde_physics_double->convective_flux (soln_at_q[iquad]);
+        diss_phys_flux_at_q[iquad] = DGBaseState<dim,nstate,real>::pde_physics_double->dissipative_flux (soln_at_q[iquad], soln_grad_at_q[iquad]);
+        if (use_source) {
+            source_at_q[iquad] = DGBaseState<dim,nstate,real>::pde_physics_double->source_term (fe_values_vol.quadrature_point(iquad), soln_at_q[iquad]);
+        }
+    }
+
+    const double cell_diameter = fe_values_vol.get_cell()->diameter();
+    const unsigned int cell_index = fe_values_vol.get_cell()->active_cell_index();
+    const unsigned int cell_degree = fe.tensor_degree();
+    this->max_dt_cell[cell_index] = DGBaseState<dim,nstate,real>::evaluate_CFL ( soln_at_q, 0.0, cell_diameter, cell_degree);
+
+    // Split form
+    // The derivative of the Lagrange basis collocated at the quadrature points only couples points on the same
+    // line along the differentiated direction. The two-point flux is therefore only needed for those pairs,
+    // and is evaluated once for all the states, and once for (i,j) and (j,i) when it is symmetric.
+    const bool use_split_form = this->all_parameters->use_split_form;
+    std::vector<realArray> split_flux_divergence;
+    if (use_split_form) {
+        const Physics::PhysicsBase<dim,nstate,real> &physics = *(DGBaseState<dim,nstate,real>::pde_physics_double);
+        const bool symmetric_split_flux = physics.has_symmetric_split_flux();
+        const std::vector<real> &derivative_1d = operators.collocated_derivative;
+
+        realArray zero_array;
+        zero_array.fill(0.0);
+        split_flux_divergence.assign(n_quad_pts, zero_array);
+
+        // Adds 2 * d(phi_j)/dxi_d (x_i) * F(u_i,u_j) . dxi_d/dx
+        const auto add_two_point_flux = [&] (const unsigned int iquad, const int d, const real derivative, const realArrayTensor1 &two_point_flux) {
+            const dealii::DerivativeForm<1,dim,dim> &inverse_jacobian = fe_values_vol.inverse_jacobian(iquad);
+            for (int istate = 0; istate < nstate; ++istate) {
+                real flux_reference = 0.0;
+                for (int j = 0; j < dim; ++j) flux_reference += inverse_jacobian[d][j] * two_point_flux[istate][j];
+                split_flux_divergence[iquad][istate] += 2.0 * derivative * flux_reference;
+            }
+        };
+
+        const unsigned int n_lines = n_quad_pts / n_quad_1d;
+        for (int d = 0; d < dim; ++d) {
+            const unsigned int stride = dealii::Utilities::pow(n_quad_1d, d);
+            for (unsigned int iline = 0; iline < n_lines; ++iline) {
+                const unsigned int first_quad = (iline / stride) * stride * n_quad_1d + iline % stride;
+                for (unsigned int i = 0; i < n_quad_1d; ++i) {
+                    const unsigned int iquad = first_quad + i*stride;
+                    for (unsigned int j = (symmetric_split_flux ? i : 0); j < n_quad_1d; ++j) {
+                        const unsigned int jquad = first_quad + j*stride;
+                        const realArrayTensor1 two_point_flux = physics.convective_numerical_split_flux(soln_at_q[iquad], soln_at_q[jquad]);
+                        add_two_point_flux(iquad, d, derivative_1d[i*n_quad_1d + j], two_point_flux);
+                        if (symmetric_split_flux && j != i) add_two_point_flux(jquad, d, derivative_1d[j*n_quad_1d + i], two_point_flux);
+                    }
+                }
+            }
+        }
+    }
+
+    // Same terms as assemble_volume_term_explicit(), where the flux divergence is obtained by differentiating
+    // the nodal flux values along each reference direction, and the test functions are applied through the
+    // transposed 1D operators.
+    std::vector<real> flux_component(n_quad_pts);
+    std::vector<real> flux_derivative(n_quad_pts);
+    std::vector<real> weighted_values(n_quad_pts);
+    std::vector<real> weighted_gradient(n_quad_pts);
+    std::vector<real> state_rhs(n_dofs_state);
+    std::vector<real> state_rhs_gradient(n_dofs_state);
+    for (int istate = 0; istate < nstate; ++istate) {
+        for (unsigned int iquad = 0; iquad < n_quad_pts; ++iquad) {
+            weighted_values[iquad] = use_source ? source_at_q[iquad][istate] : 0.0;
+        }
+        if (use_split_form) {
+            for (unsigned int iquad = 0; iquad < n_quad_pts; ++iquad) weighted_values[iquad] -= split_flux_divergence[iquad][istate];
+        } else {
+            for (int j = 0; j < dim; ++j) {
+                for (unsigned int iquad = 0; iquad < n_quad_pts; ++iquad) flux_component[iquad] = conv_phys_flux_at_q[iquad][istate][j];
+                for (int d = 0; d < dim; ++d) {
+                    apply_1d_operator(operators.collocated_derivative.data(), n_quad_1d, n_quad_1d, false,
+                                      dealii::Utilities::pow(n_quad_1d, d), dealii::Utilities::pow(n_quad_1d, dim-1-d),
+                                      flux_component.data(), flux_derivative.data());
+                    for (unsigned int iquad = 0; iquad < n_quad_pts; ++iquad) {
+                        weighted_values[iquad] -= fe_values_vol.inverse_jacobian(iquad)[d][j] * flux_derivative[iquad];
+                    }
+                }
+            }
+        }
+        for (unsigned int iquad = 0; iquad < n_quad_pts; ++iquad) weighted_values[iquad] *= JxW[iquad];
+        apply_tensor_product_operator<dim,real>(value_operators, n_quad_1d, n_dofs_1d, true, weighted_values.data(), state_rhs.data(), work);
+
+        // Diffusive
+        // Note that for diffusion, the negative is defined in the physics
+        for (int d = 0; d < dim; ++d) {
+            for (unsigned int iquad = 0; iquad < n_quad_pts; ++iquad) {
+                const dealii::DerivativeForm<1,dim,dim> &inverse_jacobian = fe_values_vol.inverse_jacobian(iquad);
+                real flux_reference = 0.0;
+                for (int j = 0; j < dim; ++j) flux_reference += inverse_jacobian[d][j] * diss_phys_flux_at_q[iquad][istate][j];
+                weighted_gradient[iquad] = flux_reference * JxW[iquad];
+            }
+            apply_tensor_product_operator<dim,real>(derivative_operators[d], n_quad_1d, n_dofs_1d, true, weighted_gradient.data(), state_rhs_gradient.data(), work);
+            for (unsigned int idof = 0; idof < n_dofs_state; ++idof) state_rhs[idof] += state_rhs_gradient[idof];
+        }
+
+        for (unsigned int idof = 0; idof < n_dofs_state; ++idof) {
+            local_rhs_int_cell(fe.component_to_system_index(istate, idof)) += state_rhs[idof];
+        }
+    }
+}
+
 template <int dim, int nstate, typename real>
 void DGStrong<dim,nstate,real>::assemble_boundary_term_explicit(
     typename dealii::DoFHandler<dim>::active_cell_iterator /*cell*/,
@@ -929,7 +1317,7 @@ void DGStrong<dim,nstate,real>::assemble_face_term_explicit(
                 dR1_dW2[idof] = rhs.fastAccessDx(n_dofs_int+idof);
             }
             this->system_matrix.add(dof_indices_int[itest_int], dof_indices_int, dR1_dW1);
-            this->system_matrix.add(dof_indices_int[itest_int], dof_indices_ext, dR1_dW2);
+            if (!this->is_cell_block_jacobian()) this->system_matrix.add(dof_indices_int[itest_int], dof_indices_ext, dR1_dW2);
         }
     }
 
@@ -955,7 +1343,7 @@ void DGStrong<dim,nstate,real>::assemble_face_term_explicit(
             for (unsigned int idof = 0; idof < n_dofs_ext; ++idof) {
                 dR2_dW2[idof] = rhs.fastAccessDx(n_dofs_int+idof);
             }
-            this->system_matrix.add(dof_indices_ext[itest_ext], dof_indices_int, dR2_dW1);
+            if (!this->is_cell_block_jacobian()) this->system_matrix.add(dof_indices_ext[itest_ext], dof_indices_int, dR2_dW1);
             this->system_matrix.add(dof_indices_ext[itest_ext], dof_indices_ext, dR2_dW2);
         }
     }
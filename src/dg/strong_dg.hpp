@@ -26,6 +26,11 @@ public:
     /// Destructor
     ~DGStrong();
 
+    /// Whether the explicit volume terms of tensor-product cells use the sum-factorized kernels.
+    /** Otherwise, they use the dense evaluation of the other cells, against which the kernels are verified.
+     */
+    bool use_sum_factorization = true;
+
 private:
 
     /// Evaluate the integral over the cell volume and the specified derivatives.
@@ -80,6 +85,40 @@ private:
         dealii::Vector<real>          &local_rhs_ext_cell,
         const bool compute_dRdW, const bool compute_dRdX, const bool compute_d2R);
 
+    /// Evaluate the integral over the cell volume and its derivatives with respect to the solution using @p adtype.
+    /** Called by assemble_volume_term_derivatives() with SFadType when the cell is small enough, and FadType otherwise. */
+    template <typename adtype>
+    void assemble_volume_term(
+        const dealii::FEValues<dim,dim> &fe_values_vol,
+        const std::vector<dealii::types::global_dof_index> &cell_dofs_indices,
+        const Physics::PhysicsBase<dim, nstate, adtype> &physics,
+        dealii::Vector<real> &local_rhs_int_cell,
+        const dealii::FEValues<dim,dim> &fe_values_lagrange);
+    /// Evaluate the integral over the cell edges that are on domain boundaries and its derivatives with respect to the solution using @p adtype.
+    template <typename adtype>
+    void assemble_boundary_term(
+        const unsigned int boundary_id,
+        const dealii::FEFaceValuesBase<dim,dim> &fe_values_boundary,
+        const real penalty,
+        const std::vector<dealii::types::global_dof_index> &soln_dof_indices,
+        const Physics::PhysicsBase<dim, nstate, adtype> &physics,
+        const NumericalFlux::NumericalFluxConvective<dim, nstate, adtype> &conv_num_flux,
+        const NumericalFlux::NumericalFluxDissipative<dim, nstate, adtype> &diss_num_flux,
+        dealii::Vector<real> &local_rhs_int_cell);
+    /// Evaluate the integral over the internal cell edges and its derivatives with respect to the solution using @p adtype.
+    template <typename adtype>
+    void assemble_face_term(
+        const dealii::FEFaceValuesBase<dim,dim>     &fe_values_int,
+        const dealii::FEFaceValuesBase<dim,dim>     &fe_values_ext,
+        const real penalty,
+        const std::vector<dealii::types::global_dof_index> &soln_dof_indices_int,
+        const std::vector<dealii::types::global_dof_index> &soln_dof_indices_ext,
+        const Physics::PhysicsBase<dim, nstate, adtype> &physics,
+        const NumericalFlux::NumericalFluxConvective<dim, nstate, adtype> &conv_num_flux,
+        const NumericalFlux::NumericalFluxDissipative<dim, nstate, adtype> &diss_num_flux,
+        dealii::Vector<real>          &local_rhs_int_cell,
+        dealii::Vector<real>          &local_rhs_ext_cell);
+
     /// Evaluate the integral over the cell volume
     void assemble_volume_term_explicit(
         typename dealii::DoFHandler<dim>::active_cell_iterator cell,
@@ -110,6 +149,38 @@ private:
         dealii::Vector<real>          &current_cell_rhs,
         dealii::Vector<real>          &neighbor_cell_rhs);
 
+    /// One-dimensional operators of the sum-factorized volume kernels of a given FE index.
+    /** The solution basis of DGStrong is a tensor-product Lagrange basis (FE_DGQ) and the
+     *  volume quadrature is the tensor product of the 1D quadrature of the same index.
+     *  All the volume interpolations, gradients, and flux divergences can therefore be
+     *  evaluated one direction at a time, costing O(p^{dim+1}) instead of O(p^{2 dim}).
+     *
+     *  Matrices are stored row-major.
+     */
+    struct TensorProductOperators
+    {
+        /// Whether the FE and quadrature are tensor products such that the operators below are valid.
+        bool is_tensor_product = false;
+        unsigned int n_dofs_1d = 0; ///< Number of 1D basis functions.
+        unsigned int n_quad_1d = 0; ///< Number of 1D quadrature points.
+        std::vector<real> basis; ///< n_quad_1d x n_dofs_1d values of the 1D basis at the 1D quadrature points.
+        std::vector<real> basis_derivative; ///< n_quad_1d x n_dofs_1d derivatives of the 1D basis at the 1D quadrature points.
+        /// n_quad_1d x n_quad_1d derivatives of the 1D Lagrange polynomials collocated at the 1D quadrature points.
+        /** Used to differentiate the fluxes known at the quadrature points, such as fe_collection_lagrange. */
+        std::vector<real> collocated_derivative;
+    };
+    /// Sum-factorization operators of each FE index.
+    std::vector<TensorProductOperators> tensor_product_operators;
+    /// Builds the tensor_product_operators from the FE and quadrature collections.
+    void build_tensor_product_operators ();
+
+    /// Sum-factorized version of assemble_volume_term_explicit() for tensor-product cells.
+    void assemble_volume_term_explicit_sum_factorized(
+        const TensorProductOperators &operators,
+        const dealii::FEValues<dim,dim> &fe_values_volume,
+        const std::vector<dealii::types::global_dof_index> &current_dofs_indices,
+        dealii::Vector<real> &current_cell_rhs);
+
     using DGBase<dim,real>::all_parameters; ///< Pointer to all parameters
     using DGBase<dim,real>::mpi_communicator; ///< MPI communicator
     using DGBase<dim,real>::pcout; ///< Parallel std::cout that only outputs on mpi_rank==0
@@ -14,6 +14,7 @@
 #include <deal.II/lac/vector.h>
 
 #include "ADTypes.hpp"
+#include "telemetry/telemetry.h"
 
 #include "weak_dg.hpp"
 
@@ -245,6 +246,77 @@ void automatic_differentiation_indexing_2(
     }
 }
 
+/// Hessian of the dual-weighted residual, accessed like the Hessian of a single output of codi::TapeHelper.
+struct DualWeightedResidualHessian
+{
+    /// Hessian entries with respect to the registered inputs.
+    dealii::FullMatrix<double> values;
+    /// Entry (i,j). The dependent index is ignored since the dual-weighted residual is the only output.
+    double operator() (const unsigned int /*i_dependent*/, const unsigned int i, const unsigned int j) const
+    {
+        return values(i,j);
+    }
+};
+
+/// Evaluates the Jacobian of the residuals and the Hessian of the dual-weighted residual from a single recording.
+/** The recorded outputs are the @p n_residuals residuals followed by the dual-weighted residual, and @p input_values
+ *  are the values of the registered inputs. codi::TapeHelper::evalHessian would differentiate every output twice.
+ *  Instead, one reverse sweep per residual gives the Jacobian, and one forward sweep per input followed by a reverse
+ *  sweep of the dual-weighted residual gives a column of its Hessian.
+ *
+ *  Only valid for the primal value tape of codi_HessianComputationType.
+ */
+template <typename adtype>
+void evaluate_residual_jacobian_and_dual_hessian (
+    codi::TapeHelper<adtype> &th,
+    const std::vector<double> &input_values,
+    const unsigned int n_residuals,
+    dealii::FullMatrix<double> &jacobian,
+    DualWeightedResidualHessian &hessian)
+{
+    using Real = typename adtype::Real;
+    using GradientValue = typename adtype::GradientValue;
+    const unsigned int n_inputs = input_values.size();
+    const unsigned int n_outputs = n_residuals + 1;
+
+    Real *x = th.createPrimalVectorInput();
+    Real *y = th.createPrimalVectorOutput();
+    GradientValue *x_b = th.createGradientVectorInput();
+    GradientValue *y_b = th.createGradientVectorOutput();
+    for (unsigned int i = 0; i < n_outputs; ++i) y_b[i] = GradientValue();
+
+    // Reverse sweeps of the residuals at the recorded point.
+    jacobian.reinit(n_residuals, n_inputs);
+    for (unsigned int i_start = 0; i_start < n_residuals; i_start += dimReverseAD) {
+        const unsigned int n_directions = std::min<unsigned int>(dimReverseAD, n_residuals - i_start);
+        for (unsigned int r = 0; r < n_directions; ++r) y_b[i_start+r][r] = 1.0;
+        th.evalReverse(y_b, x_b);
+        for (unsigned int r = 0; r < n_directions; ++r) {
+            y_b[i_start+r][r] = 0.0;
+            for (unsigned int k = 0; k < n_inputs; ++k) jacobian(i_start+r,k) = x_b[k][r].getValue();
+        }
+    }
+
+    // Forward sweeps seeding the inputs, followed by the reverse sweep of the dual-weighted residual.
+    hessian.values.reinit(n_inputs, n_inputs);
+    y_b[n_residuals][0] = 1.0;
+    for (unsigned int j_start = 0; j_start < n_inputs; j_start += dimForwardAD) {
+        const unsigned int n_directions = std::min<unsigned int>(dimForwardAD, n_inputs - j_start);
+        for (unsigned int k = 0; k < n_inputs; ++k) x[k] = input_values[k];
+        for (unsigned int d = 0; d < n_directions; ++d) x[j_start+d].gradient()[d] = 1.0;
+        th.evalPrimal(x, y);
+        th.evalReverse(y_b, x_b);
+        for (unsigned int k = 0; k < n_inputs; ++k) {
+            for (unsigned int d = 0; d < n_directions; ++d) hessian.values(k,j_start+d) = x_b[k][0].getGradient()[d];
+        }
+    }
+
+    th.deletePrimalVector(x);
+    th.deletePrimalVector(y);
+    th.deleteGradientVector(x_b);
+    th.deleteGradientVector(y_b);
+}
+
 template <int dim, typename real, int n_components>
 void evaluate_finite_element_values (
     const std::vector<dealii::Point<dim>> &unit_points,
@@ -552,6 +624,106 @@ void evaluate_covariant_metric_jacobian (
 
 }
 
+template <int dim, int nstate, typename real>
+template <typename real2>
+void DGWeak<dim,nstate,real>::evaluate_metric_terms(
+    const std::vector<real2> &coords_coeff,
+    const dealii::FESystem<dim,dim> &fe_metric,
+    const dealii::Quadrature<dim> &quadrature,
+    const int face_number,
+    const bool use_covariant_metric_jacobian,
+    const bool compute_metric_derivatives,
+    typename DGBase<dim,real>::MetricTermsCache *const metric_terms_cache,
+    const unsigned int slot,
+    std::vector<real2> &jacobian_determinant,
+    std::vector<dealii::Tensor<2,dim,real2>> &jacobian_transpose_inverse,
+    std::vector<real2> &JxW,
+    std::vector<dealii::Tensor<1,dim,real2>> &phys_unit_normal,
+    std::vector<real2> &surface_jacobian_determinant)
+{
+    const unsigned int n_quad_pts = quadrature.size();
+    const bool is_face = (face_number >= 0);
+
+    if constexpr (!std::is_same<real2,real>::value) {
+        if (!compute_metric_derivatives) {
+            // Evaluate the metric terms with the node values only and use them as constants.
+            const unsigned int n_metric_dofs = coords_coeff.size();
+            std::vector<real> coords_coeff_values(n_metric_dofs);
+            for (unsigned int idof = 0; idof < n_metric_dofs; ++idof) {
+                coords_coeff_values[idof] = getValue<real2>(coords_coeff[idof]);
+            }
+            std::vector<real> jacobian_determinant_values(n_quad_pts);
+            std::vector<dealii::Tensor<2,dim,real>> jacobian_transpose_inverse_values(n_quad_pts);
+            std::vector<real> JxW_values(n_quad_pts);
+            std::vector<dealii::Tensor<1,dim,real>> phys_unit_normal_values(is_face ? n_quad_pts : 0);
+            std::vector<real> surface_jacobian_determinant_values(is_face ? n_quad_pts : 0);
+            evaluate_metric_terms<real> (
+                coords_coeff_values, fe_metric, quadrature, face_number,
+                use_covariant_metric_jacobian, compute_metric_derivatives,
+                metric_terms_cache, slot,
+                jacobian_determinant_values, jacobian_transpose_inverse_values,
+                JxW_values, phys_unit_normal_values, surface_jacobian_determinant_values);
+            for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+                jacobian_determinant[iquad] = jacobian_determinant_values[iquad];
+                for (int row=0;row<dim;++row) {
+                    for (int col=0;col<dim;++col) {
+                        jacobian_transpose_inverse[iquad][row][col] = jacobian_transpose_inverse_values[iquad][row][col];
+                    }
+                }
+                JxW[iquad] = JxW_values[iquad];
+                if (is_face) {
+                    for (int d=0;d<dim;++d) {
+                        phys_unit_normal[iquad][d] = phys_unit_normal_values[iquad][d];
+                    }
+                    surface_jacobian_determinant[iquad] = surface_jacobian_determinant_values[iquad];
+                }
+            }
+            return;
+        }
+    }
+
+    if constexpr (std::is_same<real2,real>::value) {
+        if (metric_terms_cache && metric_terms_cache->load(slot, jacobian_determinant, jacobian_transpose_inverse,
+                                                           JxW, phys_unit_normal, surface_jacobian_determinant)) return;
+    }
+
+    const std::vector<dealii::Tensor<2,dim,real2>> metric_jacobian = evaluate_metric_jacobian (quadrature.get_points(), coords_coeff, fe_metric);
+    for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+        jacobian_determinant[iquad] = dealii::determinant(metric_jacobian[iquad]);
+        jacobian_transpose_inverse[iquad] = dealii::transpose(dealii::invert(metric_jacobian[iquad]));
+    }
+    if constexpr (dim != 1) {
+        if (use_covariant_metric_jacobian) {
+            evaluate_covariant_metric_jacobian<dim,real2> ( quadrature, coords_coeff, fe_metric, jacobian_transpose_inverse, jacobian_determinant);
+        }
+    }
+
+    if (is_face) {
+        const dealii::Tensor<1,dim,real> unit_normal = dealii::GeometryInfo<dim>::unit_normal_vector[face_number];
+        for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+            const dealii::Tensor<1,dim,real2> normal = vmult(jacobian_transpose_inverse[iquad], unit_normal);
+            const real2 area = norm(normal);
+            // Technically the normals have jac_det multiplied.
+            // However, we use normalized normals by convention, so the the term
+            // ends up appearing in the surface jacobian.
+            for (int d=0;d<dim;++d) {
+                phys_unit_normal[iquad][d] = normal[d] / area;
+            }
+            surface_jacobian_determinant[iquad] = area*jacobian_determinant[iquad];
+            JxW[iquad] = surface_jacobian_determinant[iquad] * quadrature.weight(iquad);
+        }
+    } else {
+        for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+            JxW[iquad] = jacobian_determinant[iquad] * quadrature.weight(iquad);
+        }
+    }
+
+    if constexpr (std::is_same<real2,real>::value) {
+        if (metric_terms_cache) metric_terms_cache->store(slot, jacobian_determinant, jacobian_transpose_inverse,
+                                                          JxW, phys_unit_normal, surface_jacobian_determinant);
+    }
+}
+
 template <int dim, int nstate, typename real>
 void DGWeak<dim,nstate,real>::assemble_volume_term_explicit(
     typename dealii::DoFHandler<dim>::active_cell_iterator cell,
@@ -1187,97 +1359,37 @@ void DGWeak<dim,nstate,real>::assemble_boundary_term(
     const std::vector<dealii::Point<dim,real>> &unit_quad_pts = face_quadrature.get_points();
     std::vector<dealii::Point<dim,real2>> real_quad_pts(unit_quad_pts.size());
 
-    std::vector<dealii::Tensor<2,dim,real2>> metric_jacobian = evaluate_metric_jacobian (unit_quad_pts, coords_coeff, fe_metric);
-    std::vector<real2> jac_det(n_quad_pts);
-    std::vector<real2> surface_jac_det(n_quad_pts);
-    std::vector<dealii::Tensor<2,dim,real2>> jac_inv_tran(n_quad_pts);
-
-    const dealii::Tensor<1,dim,real> unit_normal = dealii::GeometryInfo<dim>::unit_normal_vector[face_number];
-    std::vector<dealii::Tensor<1,dim,real2>> phys_unit_normal(n_quad_pts);
-
     for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
-        if (compute_metric_derivatives) {
-            for (int d=0;d<dim;++d) { real_quad_pts[iquad][d] = 0;}
-            for (unsigned int idof = 0; idof < n_metric_dofs; ++idof) {
-                const int iaxis = fe_metric.system_to_component_index(idof).first;
-                real_quad_pts[iquad][iaxis] += coords_coeff[idof] * fe_metric.shape_value(idof,unit_quad_pts[iquad]);
-            }
-
-            const real2 jacobian_determinant = dealii::determinant(metric_jacobian[iquad]);
-            const dealii::Tensor<2,dim,real2> jacobian_transpose_inverse = dealii::transpose(dealii::invert(metric_jacobian[iquad]));
-
-            jac_det[iquad] = jacobian_determinant;
-            jac_inv_tran[iquad] = jacobian_transpose_inverse;
-
-            const dealii::Tensor<1,dim,real2> normal = vmult(jacobian_transpose_inverse, unit_normal);
-            const real2 area = norm(normal);
-
-            surface_jac_det[iquad] = norm(normal)*jac_det[iquad];
-            // Technically the normals have jac_det multiplied.
-            // However, we use normalized normals by convention, so the the term
-            // ends up appearing in the surface jacobian.
-            for (int d=0;d<dim;++d) { 
-                phys_unit_normal[iquad][d] = normal[d] / area;
-            }
-
-            // Exact mapping
-            // real_quad_pts[iquad] = fe_values_boundary.quadrature_point(iquad);
-            // surface_jac_det[iquad] = fe_values_boundary.JxW(iquad) / face_quadrature.weight(iquad);
-            // phys_unit_normal[iquad] = fe_values_boundary.normal_vector(iquad);
-
-        } else {
-            real_quad_pts[iquad] = fe_values_boundary.quadrature_point(iquad);
-            surface_jac_det[iquad] = fe_values_boundary.JxW(iquad) / face_quadrature.weight(iquad);
-            phys_unit_normal[iquad] = fe_values_boundary.normal_vector(iquad);
+        for (int d=0;d<dim;++d) { real_quad_pts[iquad][d] = 0;}
+        for (unsigned int idof = 0; idof < n_metric_dofs; ++idof) {
+            const int iaxis = fe_metric.system_to_component_index(idof).first;
+            real_quad_pts[iquad][iaxis] += coords_coeff[idof] * fe_metric.shape_value(idof,unit_quad_pts[iquad]);
         }
-
     }
-#ifdef KOPRIVA_METRICS_BOUNDARY
-    auto old_jac_det = jac_det;
-    auto old_jac_inv_tran = jac_inv_tran;
-
-    if constexpr (dim != 1) {
-        evaluate_covariant_metric_jacobian<dim,real2> ( face_quadrature, coords_coeff, fe_metric, jac_inv_tran, jac_det);
-    }
-
-    //for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
-    //    //if (abs(old_jac_det[iquad] - jac_det[iquad]) > 1e-10) {
-    //        std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
-    //        std::cout << "Not the same jac det int, iquad " << iquad << std::endl;
-    //        std::cout << old_jac_det[iquad] << std::endl;
-    //        std::cout << jac_det[iquad] << std::endl;
-    //    //}
-    //    for (int row=0;row<dim;++row) {
-    //        for (int col=0;col<dim;++col) {
-    //            //if (abs(old_jac_inv_tran[iquad][row][col] - jac_inv_tran[iquad][row][col]) > 1e-10) {
-    //                std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
-    //                std::cout << "Not the same jac inv tran int, iquad " << iquad << " row " << row << " col " << col << std::endl;
-    //                std::cout << old_jac_inv_tran[iquad][row][col] << std::endl;
-    //                std::cout << jac_inv_tran[iquad][row][col] << std::endl;
-    //            }
-    //        //}
-    //    }
-    //}
-#endif
 
+    std::vector<real2> jac_det(n_quad_pts);
+    std::vector<dealii::Tensor<2,dim,real2>> jac_inv_tran(n_quad_pts);
+    std::vector<dealii::Tensor<1,dim,real2>> phys_unit_normal(n_quad_pts);
+    std::vector<real2> surface_jac_det(n_quad_pts);
     std::vector<real2> faceJxW(n_quad_pts);
-
-    for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
-        if (compute_metric_derivatives) {
-            const dealii::Tensor<1,dim,real2> normal = vmult(jac_inv_tran[iquad], unit_normal);
-            const real2 area = norm(normal);
-
-            surface_jac_det[iquad] = norm(normal)*jac_det[iquad];
-            // Technically the normals have jac_det multiplied.
-            // However, we use normalized normals by convention, so the the term
-            // ends up appearing in the surface jacobian.
-            for (int d=0;d<dim;++d) { 
-                phys_unit_normal[iquad][d] = normal[d] / area;
-            }
-        }
-
-        faceJxW[iquad] = surface_jac_det[iquad] * face_quadrature.weight(iquad);
-    }
+#ifdef KOPRIVA_METRICS_BOUNDARY
+    const bool use_covariant_metric_jacobian = true;
+#else
+    const bool use_covariant_metric_jacobian = false;
+#endif
+    const unsigned int face_slot = current_cell_index * dealii::GeometryInfo<dim>::faces_per_cell + face_number;
+    evaluate_metric_terms<real2> (
+        coords_coeff, fe_metric, face_quadrature, face_number,
+        use_covariant_metric_jacobian, compute_metric_derivatives,
+        &(this->face_metric_terms_cache), face_slot,
+        jac_det, jac_inv_tran, faceJxW, phys_unit_normal, surface_jac_det);
+
+    // Exact mapping
+    // for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+    //     real_quad_pts[iquad] = fe_values_boundary.quadrature_point(iquad);
+    //     surface_jac_det[iquad] = fe_values_boundary.JxW(iquad) / face_quadrature.weight(iquad);
+    //     phys_unit_normal[iquad] = fe_values_boundary.normal_vector(iquad);
+    // }
 
     dealii::FullMatrix<real> interpolation_operator(n_soln_dofs,n_quad_pts);
     for (unsigned int idof=0; idof<n_soln_dofs; ++idof) {
@@ -1291,24 +1403,17 @@ void DGWeak<dim,nstate,real>::assemble_boundary_term(
     }
     for (unsigned int idof=0; idof<n_soln_dofs; ++idof) {
         for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
-            if (compute_metric_derivatives) {
-                const dealii::Tensor<1,dim,real> ref_shape_grad = fe_soln.shape_grad(idof,unit_quad_pts[iquad]);
-                const dealii::Tensor<1,dim,real2> phys_shape_grad = vmult(jac_inv_tran[iquad], ref_shape_grad);
-                for (int d=0;d<dim;++d) {
-                    gradient_operator[d][idof][iquad] = phys_shape_grad[d];
-                }
-
-                // Exact mapping
-                // for (int d=0;d<dim;++d) {
-                //     const unsigned int istate = fe_soln.system_to_component_index(idof).first;
-                //     gradient_operator[d][idof][iquad] = fe_values_boundary.shape_grad_component(idof, iquad, istate)[d];
-                // }
-            } else {
-                for (int d=0;d<dim;++d) {
-                    const unsigned int istate = fe_soln.system_to_component_index(idof).first;
-                    gradient_operator[d][idof][iquad] = fe_values_boundary.shape_grad_component(idof, iquad, istate)[d];
-                }
+            const dealii::Tensor<1,dim,real> ref_shape_grad = fe_soln.shape_grad(idof,unit_quad_pts[iquad]);
+            const dealii::Tensor<1,dim,real2> phys_shape_grad = vmult(jac_inv_tran[iquad], ref_shape_grad);
+            for (int d=0;d<dim;++d) {
+                gradient_operator[d][idof][iquad] = phys_shape_grad[d];
             }
+
+            // Exact mapping
+            // for (int d=0;d<dim;++d) {
+            //     const unsigned int istate = fe_soln.system_to_component_index(idof).first;
+            //     gradient_operator[d][idof][iquad] = fe_values_boundary.shape_grad_component(idof, iquad, istate)[d];
+            // }
         }
     }
 
@@ -1525,7 +1630,7 @@ void DGWeak<dim,nstate,real>::assemble_boundary_term_derivatives(
     const unsigned int n_metric_dofs = fe_metric.dofs_per_cell;
 
     (void) compute_dRdW; (void) compute_dRdX; (void) compute_d2R;
-    const bool compute_metric_derivatives = true;//(!compute_dRdX && !compute_d2R) ? false : true;
+    const bool compute_metric_derivatives = (!compute_dRdX && !compute_d2R) ? false : true;
     AssertDimension (n_soln_dofs, soln_dof_indices.size());
 
     std::vector< adtype > soln_coeff(n_soln_dofs);
@@ -1679,7 +1784,7 @@ void DGWeak<dim,nstate,real>::assemble_boundary_codi_taped_derivatives(
     const unsigned int n_metric_dofs = fe_metric.dofs_per_cell;
 
     (void) compute_dRdW; (void) compute_dRdX; (void) compute_d2R;
-    const bool compute_metric_derivatives = true;//(!compute_dRdX && !compute_d2R) ? false : true;
+    const bool compute_metric_derivatives = (!compute_dRdX && !compute_d2R) ? false : true;
     AssertDimension (n_soln_dofs, soln_dof_indices.size());
 
     std::vector< adtype > soln_coeff(n_soln_dofs);
@@ -1748,7 +1853,8 @@ void DGWeak<dim,nstate,real>::assemble_boundary_codi_taped_derivatives(
         for (unsigned int itest=0; itest<n_soln_dofs; ++itest) {
             th.registerOutput(rhs[itest]);
         }
-    } else if (compute_d2R) {
+    }
+    if (compute_d2R) {
         th.registerOutput(dual_dot_residual);
     }
     if (compute_dRdW || compute_dRdX || compute_d2R) {
@@ -1760,44 +1866,34 @@ void DGWeak<dim,nstate,real>::assemble_boundary_codi_taped_derivatives(
         AssertIsFinite(local_rhs_cell(itest));
     }
 
-    if (compute_dRdW) {
-        typename TH::JacobianType& jac = th.createJacobian();
-        th.evalJacobian(jac);
-        for (unsigned int itest=0; itest<n_soln_dofs; ++itest) {
-
+    const auto add_jacobian = [&] (const auto &jac) {
+        if (compute_dRdW) {
             std::vector<real> residual_derivatives(n_soln_dofs);
-            for (unsigned int idof = 0; idof < n_soln_dofs; ++idof) {
-                const unsigned int i_dx = idof+w_start;
-                residual_derivatives[idof] = jac(itest,i_dx);
-                AssertIsFinite(residual_derivatives[idof]);
+            for (unsigned int itest=0; itest<n_soln_dofs; ++itest) {
+                for (unsigned int idof = 0; idof < n_soln_dofs; ++idof) {
+                    const unsigned int i_dx = idof+w_start;
+                    residual_derivatives[idof] = jac(itest,i_dx);
+                    AssertIsFinite(residual_derivatives[idof]);
+                }
+                const bool elide_zero_values = false;
+                this->system_matrix.add(soln_dof_indices[itest], soln_dof_indices, residual_derivatives, elide_zero_values);
             }
-            const bool elide_zero_values = false;
-            this->system_matrix.add(soln_dof_indices[itest], soln_dof_indices, residual_derivatives, elide_zero_values);
         }
-        th.deleteJacobian(jac);
-
-    }
-
-    if (compute_dRdX) {
-        typename TH::JacobianType& jac = th.createJacobian();
-        th.evalJacobian(jac);
-        for (unsigned int itest=0; itest<n_soln_dofs; ++itest) {
+        if (compute_dRdX) {
             std::vector<real> residual_derivatives(n_metric_dofs);
-            for (unsigned int idof = 0; idof < n_metric_dofs; ++idof) {
-                const unsigned int i_dx = idof+x_start;
-                residual_derivatives[idof] = jac(itest,i_dx);
+            for (unsigned int itest=0; itest<n_soln_dofs; ++itest) {
+                for (unsigned int idof = 0; idof < n_metric_dofs; ++idof) {
+                    const unsigned int i_dx = idof+x_start;
+                    residual_derivatives[idof] = jac(itest,i_dx);
+                }
+                this->dRdXv.add(soln_dof_indices[itest], metric_dof_indices, residual_derivatives);
             }
-            this->dRdXv.add(soln_dof_indices[itest], metric_dof_indices, residual_derivatives);
         }
-        th.deleteJacobian(jac);
-    }
+    };
 
-
-    if (compute_d2R) {
-        typename TH::HessianType& hes = th.createHessian();
-        th.evalHessian(hes);
-
-        int i_dependent = (compute_dRdW || compute_dRdX) ? n_soln_dofs : 0;
+    const auto add_hessian = [&] (const auto &hes) {
+        // The dual-weighted residual is the only output differentiated twice.
+        const int i_dependent = 0;
 
         std::vector<real> dWidW(n_soln_dofs);
         std::vector<real> dWidX(n_metric_dofs);
@@ -1830,8 +1926,39 @@ void DGWeak<dim,nstate,real>::assemble_boundary_codi_taped_derivatives(
             }
             this->d2RdXdX.add(metric_dof_indices[idof], metric_dof_indices, dXidX);
         }
-
-        th.deleteHessian(hes);
+    };
+
+    if (compute_d2R && (compute_dRdW || compute_dRdX)) {
+        // Fused assembly, where the recording is differentiated for every requested derivative.
+        if constexpr (std::is_same<adtype,codi_HessianComputationType>::value) {
+            const Telemetry::ScopedTimer ad_timer("ad_jacobian_hessian");
+            std::vector<double> input_values;
+            for (const auto &coeff : soln_coeff) input_values.push_back(getValue<adtype>(coeff));
+            for (const auto &coeff : coords_coeff) input_values.push_back(getValue<adtype>(coeff));
+            dealii::FullMatrix<double> jac;
+            DualWeightedResidualHessian hes;
+            evaluate_residual_jacobian_and_dual_hessian(th, input_values, n_soln_dofs, jac, hes);
+            add_jacobian(jac);
+            add_hessian(hes);
+        } else {
+            // Also instantiated with codi_JacobianComputationType, so this cannot be a static_assert.
+            AssertThrow(false, dealii::ExcMessage("The second derivatives need codi_HessianComputationType."));
+        }
+    } else {
+        if (compute_dRdW || compute_dRdX) {
+            const Telemetry::ScopedTimer ad_timer("ad_jacobian");
+            typename TH::JacobianType& jac = th.createJacobian();
+            th.evalJacobian(jac);
+            add_jacobian(jac);
+            th.deleteJacobian(jac);
+        }
+        if (compute_d2R) {
+            const Telemetry::ScopedTimer ad_timer("ad_hessian");
+            typename TH::HessianType& hes = th.createHessian();
+            th.evalHessian(hes);
+            add_hessian(hes);
+            th.deleteHessian(hes);
+        }
     }
     for (unsigned int idof = 0; idof < n_soln_dofs; ++idof) {
         adtype::getGlobalTape().deactivateValue(soln_coeff[idof]);
@@ -1868,7 +1995,7 @@ void DGWeak<dim,nstate,real>::assemble_boundary_residual(
     (void) compute_dRdX;
     (void) compute_d2R;
 
-    const bool compute_metric_derivatives = true; //= (!compute_dRdX && !compute_d2R) ? false : true;
+    const bool compute_metric_derivatives = (!compute_dRdX && !compute_d2R) ? false : true;
     AssertDimension (n_soln_dofs, soln_dof_indices.size());
 
     std::vector< real > soln_coeff(n_soln_dofs);
@@ -2040,6 +2167,7 @@ void DGWeak<dim,nstate,real>::assemble_face_term(
     using ADArrayTensor1 = std::array< Tensor1D, nstate >;
 
     (void) face_data_set_int; (void) face_data_set_ext;
+    (void) fe_values_int; (void) fe_values_ext;
     dealii::Quadrature<dim> face_quadrature_int, face_quadrature_ext;
     if constexpr (dim < 3) {
         face_quadrature_int = face_subface_int.second == -1 ?
@@ -2083,22 +2211,41 @@ void DGWeak<dim,nstate,real>::assemble_face_term(
     }
 
 
-    (void) compute_dRdW; (void) compute_dRdX; (void) compute_d2R;
-    const bool compute_metric_derivatives = true; //(!compute_dRdX && !compute_d2R) ? false : true;
+    const bool compute_metric_derivatives = (!compute_dRdX && !compute_d2R) ? false : true;
 
     const std::vector<dealii::Point<dim,double>> &unit_quad_pts_int = face_quadrature_int.get_points();
     const std::vector<dealii::Point<dim,double>> &unit_quad_pts_ext = face_quadrature_ext.get_points();
 
 
 
-    // Use the metric Jacobian from the interior cell
-    std::vector<Tensor2D> metric_jac_int = evaluate_metric_jacobian (unit_quad_pts_int, coords_coeff_int, fe_metric);
-    std::vector<Tensor2D> metric_jac_ext = evaluate_metric_jacobian (unit_quad_pts_ext, coords_coeff_ext, fe_metric);
-    std::vector<Tensor2D> jac_inv_tran_int(n_face_quad_pts);
-    std::vector<Tensor2D> jac_inv_tran_ext(n_face_quad_pts);
+    std::vector<real2> jacobian_determinant_int(n_face_quad_pts);
+    std::vector<real2> jacobian_determinant_ext(n_face_quad_pts);
+    std::vector<Tensor2D> jacobian_transpose_inverse_int(n_face_quad_pts);
+    std::vector<Tensor2D> jacobian_transpose_inverse_ext(n_face_quad_pts);
+    std::vector<real2> faceJxW_int(n_face_quad_pts), faceJxW_ext(n_face_quad_pts);
+    std::vector<Tensor1D> phys_unit_normal_int(n_face_quad_pts), phys_unit_normal_ext(n_face_quad_pts);
+    std::vector<real2> surface_jacobian_determinant_int(n_face_quad_pts), surface_jacobian_determinant_ext(n_face_quad_pts);
 
-    const dealii::Tensor<1,dim,real> unit_normal_int = dealii::GeometryInfo<dim>::unit_normal_vector[face_subface_int.first];
-    const dealii::Tensor<1,dim,real> unit_normal_ext = dealii::GeometryInfo<dim>::unit_normal_vector[face_subface_ext.first];
+#ifdef KOPRIVA_METRICS_FACE
+    const bool use_covariant_metric_jacobian = true;
+#else
+    const bool use_covariant_metric_jacobian = false;
+#endif
+    // Only the metric terms of full faces are cached, subfaces are always evaluated.
+    const unsigned int face_slot_int = current_cell_index * dealii::GeometryInfo<dim>::faces_per_cell + face_subface_int.first;
+    const unsigned int face_slot_ext = neighbor_cell_index * dealii::GeometryInfo<dim>::faces_per_cell + face_subface_ext.first;
+    evaluate_metric_terms<real2> (
+        coords_coeff_int, fe_metric, face_quadrature_int, face_subface_int.first,
+        use_covariant_metric_jacobian, compute_metric_derivatives,
+        (face_subface_int.second == -1) ? &(this->face_metric_terms_cache) : nullptr, face_slot_int,
+        jacobian_determinant_int, jacobian_transpose_inverse_int,
+        faceJxW_int, phys_unit_normal_int, surface_jacobian_determinant_int);
+    evaluate_metric_terms<real2> (
+        coords_coeff_ext, fe_metric, face_quadrature_ext, face_subface_ext.first,
+        use_covariant_metric_jacobian, compute_metric_derivatives,
+        (face_subface_ext.second == -1) ? &(this->face_metric_terms_cache) : nullptr, face_slot_ext,
+        jacobian_determinant_ext, jacobian_transpose_inverse_ext,
+        faceJxW_ext, phys_unit_normal_ext, surface_jacobian_determinant_ext);
 
     // Use quadrature points of neighbor cell
     // Might want to use the maximum n_quad_pts1 and n_quad_pts2
@@ -2140,72 +2287,9 @@ void DGWeak<dim,nstate,real>::assemble_face_term(
         }
     }
 
-    std::vector<real2> jacobian_determinant_int(n_face_quad_pts);
-    std::vector<real2> jacobian_determinant_ext(n_face_quad_pts);
-    std::vector<Tensor2D> jacobian_transpose_inverse_int(n_face_quad_pts);
-    std::vector<Tensor2D> jacobian_transpose_inverse_ext(n_face_quad_pts);
-
-    for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
-        if (compute_metric_derivatives) {
-            jacobian_determinant_int[iquad] = dealii::determinant(metric_jac_int[iquad]);
-            jacobian_determinant_ext[iquad] = dealii::determinant(metric_jac_ext[iquad]);
-
-            jacobian_transpose_inverse_int[iquad] = dealii::transpose(dealii::invert(metric_jac_int[iquad]));
-            jacobian_transpose_inverse_ext[iquad] = dealii::transpose(dealii::invert(metric_jac_ext[iquad]));
-        }
-    }
-
-#ifdef KOPRIVA_METRICS_FACE
-    auto old_jacobian_determinant_int = jacobian_determinant_int;
-    auto old_jacobian_determinant_ext = jacobian_determinant_ext;
-    auto old_jacobian_transpose_inverse_int = jacobian_transpose_inverse_int;
-    auto old_jacobian_transpose_inverse_ext = jacobian_transpose_inverse_ext;
-
-    if constexpr (dim != 1) {
-        evaluate_covariant_metric_jacobian<dim,real2> ( face_quadrature_int, coords_coeff_int, fe_metric, jacobian_transpose_inverse_int, jacobian_determinant_int);
-        evaluate_covariant_metric_jacobian<dim,real2> ( face_quadrature_ext, coords_coeff_ext, fe_metric, jacobian_transpose_inverse_ext, jacobian_determinant_ext);
-    }
-
-    //for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
-    //    //if (abs(old_jacobian_determinant_int[iquad] - jacobian_determinant_int[iquad]) > 1e-10) {
-    //        std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
-    //        std::cout << "Not the same jac det int, iquad " << iquad << std::endl;
-    //        std::cout << old_jacobian_determinant_int[iquad] << std::endl;
-    //        std::cout << jacobian_determinant_int[iquad] << std::endl;
-    //    //}
-    //    //if (abs(old_jacobian_determinant_ext[iquad] - jacobian_determinant_ext[iquad]) > 1e-10) {
-    //        std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
-    //        std::cout << "Not the same jac det ext, iquad " << iquad << std::endl;
-    //        std::cout << old_jacobian_determinant_ext[iquad] << std::endl;
-    //        std::cout << jacobian_determinant_ext[iquad] << std::endl;
-    //    //}
-    //    for (int row=0;row<dim;++row) {
-    //        for (int col=0;col<dim;++col) {
-    //            //if (abs(old_jacobian_transpose_inverse_int[iquad][row][col] - jacobian_transpose_inverse_int[iquad][row][col]) > 1e-10) {
-    //                std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
-    //                std::cout << "Not the same jac inv tran int, iquad " << iquad << " row " << row << " col " << col << std::endl;
-    //                std::cout << old_jacobian_transpose_inverse_int[iquad][row][col] << std::endl;
-    //                std::cout << jacobian_transpose_inverse_int[iquad][row][col] << std::endl;
-    //            }
-    //        //}
-    //    }
-    //    for (int row=0;row<dim;++row) {
-    //        for (int col=0;col<dim;++col) {
-    //            //if (abs(old_jacobian_transpose_inverse_ext[iquad][row][col] - jacobian_transpose_inverse_ext[iquad][row][col]) > 1e-10) {
-    //                std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
-    //                std::cout << "Not the same jac inv tran ext, iquad " << iquad << " row " << row << " col " << col << std::endl;
-    //                std::cout << old_jacobian_transpose_inverse_ext[iquad][row][col] << std::endl;
-    //                std::cout << jacobian_transpose_inverse_ext[iquad][row][col] << std::endl;
-    //            //}
-    //        }
-    //    }
-    //}
-#endif
-
     check_same_coords<dim,real2>(unit_quad_pts_int, unit_quad_pts_ext, coords_coeff_int, coords_coeff_ext, fe_metric, 1e-10);
 
     // Compute metrics
-    std::vector<Tensor1D> phys_unit_normal_int(n_face_quad_pts), phys_unit_normal_ext(n_face_quad_pts);
     std::vector<real2> surface_jac_det(n_face_quad_pts);
     std::vector<real2> faceJxW(n_face_quad_pts);
 
@@ -2219,125 +2303,79 @@ void DGWeak<dim,nstate,real>::assemble_face_term(
 
     for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
 
-        real2 surface_jac_det_int, surface_jac_det_ext;
-
-        if (compute_metric_derivatives) {
-
-            const real2 jac_det_int = jacobian_determinant_int[iquad];
-            const real2 jac_det_ext = jacobian_determinant_ext[iquad];
-
-            const Tensor2D jac_inv_tran_int = jacobian_transpose_inverse_int[iquad];
-            const Tensor2D jac_inv_tran_ext = jacobian_transpose_inverse_ext[iquad];
-
-            const Tensor1D normal_int = vmult(jac_inv_tran_int, unit_normal_int);
-            const Tensor1D normal_ext = vmult(jac_inv_tran_ext, unit_normal_ext);
-            const real2 area_int = norm(normal_int);
-            const real2 area_ext = norm(normal_ext);
-
-            // Technically the normals have jac_det multiplied.
-            // However, we use normalized normals by convention, so the the term
-            // ends up appearing in the surface jacobian.
-
-            for (int d=0;d<dim;++d) {
-                phys_unit_normal_int[iquad][d] = normal_int[d] / area_int;
-            }
-            for (int d=0;d<dim;++d) {
-                phys_unit_normal_ext[iquad][d] = normal_ext[d] / area_ext;
-            }
-
-            surface_jac_det_int = area_int*jac_det_int;
-            surface_jac_det_ext = area_ext*jac_det_ext;
-
-
-            if (std::is_same<double,real2>::value) {
-                bool valid_metrics = true;
-                // surface_jac_det is the 'volume' compression/expansion of the face w.r.t. the reference cell,
-                // analogous to volume jacobian determinant.
-                //
-                // When the cells have the same coarseness, their surface Jacobians must be the same.
-                //
-                // When the cells do not have the same coarseness, their surface Jacobians will not be the same.
-                // Therefore, we must use the Jacobians coming from the smaller face since it accurately represents
-                // the surface area being integrated.
-                if (face_subface_int.second == -1 && face_subface_ext.second == -1) {
-                    if(abs(surface_jac_det_int-surface_jac_det_ext) > 1e-12) {
-                        std::cout << std::endl;
-                        std::cout << "iquad " << iquad << " Non-matching surface jacobians "
-                            << surface_jac_det_int << " " << surface_jac_det_ext<< std::endl;
-
-                        assert(abs(surface_jac_det_int-surface_jac_det_ext) < 1e-12);
-                        valid_metrics = false;
-                    }
-                }
-                real2 diff_norm = 0;
-                for (int d=0;d<dim;++d) {
-                    const real2 diff = phys_unit_normal_int[iquad][d]+phys_unit_normal_ext[iquad][d];
-                    diff_norm += diff*diff;
-                }
-                diff_norm = sqrt(diff_norm);
-                if (diff_norm > 1e-10) {
-                    std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
-                    std::cout << "Non-matching normals. Error norm: " << diff_norm << std::endl;
-                    for (int d=0;d<dim;++d) {
-                        //assert(abs(phys_unit_normal_int[iquad][d]+phys_unit_normal_ext[iquad][d]) < 1e-10);
-                        std::cout << " normal_int["<<d<<"] : " << phys_unit_normal_int[iquad][d] 
-                                  << " normal_ext["<<d<<"] : " << phys_unit_normal_ext[iquad][d]
-                                  << std::endl;
-                    }
+        const Tensor2D jac_inv_tran_int = jacobian_transpose_inverse_int[iquad];
+        const Tensor2D jac_inv_tran_ext = jacobian_transpose_inverse_ext[iquad];
+
+        const real2 surface_jac_det_int = surface_jacobian_determinant_int[iquad];
+        const real2 surface_jac_det_ext = surface_jacobian_determinant_ext[iquad];
+
+
+        if (std::is_same<double,real2>::value) {
+            bool valid_metrics = true;
+            // surface_jac_det is the 'volume' compression/expansion of the face w.r.t. the reference cell,
+            // analogous to volume jacobian determinant.
+            //
+            // When the cells have the same coarseness, their surface Jacobians must be the same.
+            //
+            // When the cells do not have the same coarseness, their surface Jacobians will not be the same.
+            // Therefore, we must use the Jacobians coming from the smaller face since it accurately represents
+            // the surface area being integrated.
+            if (face_subface_int.second == -1 && face_subface_ext.second == -1) {
+                if(abs(surface_jac_det_int-surface_jac_det_ext) > 1e-12) {
+                    std::cout << std::endl;
+                    std::cout << "iquad " << iquad << " Non-matching surface jacobians "
+                        << surface_jac_det_int << " " << surface_jac_det_ext<< std::endl;
+
+                    assert(abs(surface_jac_det_int-surface_jac_det_ext) < 1e-12);
                     valid_metrics = false;
                 }
-                if (!valid_metrics) {
-                    //for (unsigned int itest_int=0; itest_int<n_soln_dofs_int; ++itest_int) {
-                    //   rhs_int[itest_int] += 1e20;
-                    //}
-                    //for (unsigned int itest_ext=0; itest_ext<n_soln_dofs_ext; ++itest_ext) {
-                    //   rhs_ext[itest_ext] += 1e20;
-                    //}
-                }
-
             }
-            //phys_unit_normal_ext[iquad] = -phys_unit_normal_int[iquad];//normal_ext / area_ext; Must use opposite normal to be consistent with explicit
-
-            for (unsigned int idof=0; idof<n_soln_dofs_int; ++idof) {
-                interpolation_operator_int[idof][iquad] = fe_int.shape_value(idof,unit_quad_pts_int[iquad]);
-                dealii::Tensor<1,dim,real> ref_shape_grad = fe_int.shape_grad(idof,unit_quad_pts_int[iquad]);
-                const Tensor1D phys_shape_grad = vmult(jac_inv_tran_int, ref_shape_grad);
-                for (int d=0;d<dim;++d) {
-                    gradient_operator_int[d][idof][iquad] = phys_shape_grad[d];
-                }
+            real2 diff_norm = 0;
+            for (int d=0;d<dim;++d) {
+                const real2 diff = phys_unit_normal_int[iquad][d]+phys_unit_normal_ext[iquad][d];
+                diff_norm += diff*diff;
             }
-            for (unsigned int idof=0; idof<n_soln_dofs_ext; ++idof) {
-                interpolation_operator_ext[idof][iquad] = fe_ext.shape_value(idof,unit_quad_pts_ext[iquad]);
-                dealii::Tensor<1,dim,real> ref_shape_grad = fe_ext.shape_grad(idof,unit_quad_pts_ext[iquad]);
-                const Tensor1D phys_shape_grad = vmult(jac_inv_tran_ext, ref_shape_grad);
+            diff_norm = sqrt(diff_norm);
+            if (diff_norm > 1e-10) {
+                std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
+                std::cout << "Non-matching normals. Error norm: " << diff_norm << std::endl;
                 for (int d=0;d<dim;++d) {
-                    gradient_operator_ext[d][idof][iquad] = phys_shape_grad[d];
+                    //assert(abs(phys_unit_normal_int[iquad][d]+phys_unit_normal_ext[iquad][d]) < 1e-10);
+                    std::cout << " normal_int["<<d<<"] : " << phys_unit_normal_int[iquad][d] 
+                              << " normal_ext["<<d<<"] : " << phys_unit_normal_ext[iquad][d]
+                              << std::endl;
                 }
+                valid_metrics = false;
             }
-
-        } else {
-            for (unsigned int idof=0; idof<n_soln_dofs_int; ++idof) {
-                interpolation_operator_int[idof][iquad] = fe_int.shape_value(idof,unit_quad_pts_int[iquad]);
+            if (!valid_metrics) {
+                //for (unsigned int itest_int=0; itest_int<n_soln_dofs_int; ++itest_int) {
+                //   rhs_int[itest_int] += 1e20;
+                //}
+                //for (unsigned int itest_ext=0; itest_ext<n_soln_dofs_ext; ++itest_ext) {
+                //   rhs_ext[itest_ext] += 1e20;
+                //}
             }
-            for (unsigned int idof=0; idof<n_soln_dofs_ext; ++idof) {
-                interpolation_operator_ext[idof][iquad] = fe_ext.shape_value(idof,unit_quad_pts_ext[iquad]);
+
+        }
+        //phys_unit_normal_ext[iquad] = -phys_unit_normal_int[iquad];//normal_ext / area_ext; Must use opposite normal to be consistent with explicit
+
+        for (unsigned int idof=0; idof<n_soln_dofs_int; ++idof) {
+            interpolation_operator_int[idof][iquad] = fe_int.shape_value(idof,unit_quad_pts_int[iquad]);
+            dealii::Tensor<1,dim,real> ref_shape_grad = fe_int.shape_grad(idof,unit_quad_pts_int[iquad]);
+            const Tensor1D phys_shape_grad = vmult(jac_inv_tran_int, ref_shape_grad);
+            for (int d=0;d<dim;++d) {
+                gradient_operator_int[d][idof][iquad] = phys_shape_grad[d];
             }
+        }
+        for (unsigned int idof=0; idof<n_soln_dofs_ext; ++idof) {
+            interpolation_operator_ext[idof][iquad] = fe_ext.shape_value(idof,unit_quad_pts_ext[iquad]);
+            dealii::Tensor<1,dim,real> ref_shape_grad = fe_ext.shape_grad(idof,unit_quad_pts_ext[iquad]);
+            const Tensor1D phys_shape_grad = vmult(jac_inv_tran_ext, ref_shape_grad);
             for (int d=0;d<dim;++d) {
-                for (unsigned int idof=0; idof<n_soln_dofs_int; ++idof) {
-                    const unsigned int istate = fe_int.system_to_component_index(idof).first;
-                    gradient_operator_int[d][idof][iquad] = fe_values_int.shape_grad_component(idof, iquad, istate)[d];
-                }
-                for (unsigned int idof=0; idof<n_soln_dofs_ext; ++idof) {
-                    const unsigned int istate = fe_ext.system_to_component_index(idof).first;
-                    gradient_operator_ext[d][idof][iquad] = fe_values_ext.shape_grad_component(idof, iquad, istate)[d];
-                }
+                gradient_operator_ext[d][idof][iquad] = phys_shape_grad[d];
             }
-            surface_jac_det_int = fe_values_int.JxW(iquad)/face_quadrature_int.weight(iquad);
-            surface_jac_det_ext = fe_values_ext.JxW(iquad)/face_quadrature_ext.weight(iquad);
-
-            phys_unit_normal_int[iquad] = fe_values_int.normal_vector(iquad);
-            phys_unit_normal_ext[iquad] = -phys_unit_normal_int[iquad]; // Must use opposite normal to be consistent with explicit
         }
+
         // When the cells do not have the same coarseness, their surface Jacobians will not be the same.
         // Therefore, we must use the Jacobians coming from the smaller face since it accurately represents
         // the surface area being computed.
@@ -2710,7 +2748,9 @@ void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
                 const unsigned int i_dx = idof+w_ext_start;
                 residual_derivatives[idof] = rhs_int[itest_int].dx(i_dx).val();
             }
-            this->system_matrix.add(soln_dof_indices_int[itest_int], soln_dof_indices_ext, residual_derivatives, elide_zero_values);
+            if (!this->is_cell_block_jacobian()) {
+                this->system_matrix.add(soln_dof_indices_int[itest_int], soln_dof_indices_ext, residual_derivatives, elide_zero_values);
+            }
         }
 
         for (unsigned int itest_ext=0; itest_ext<n_soln_dofs_ext; ++itest_ext) {
@@ -2721,7 +2761,9 @@ void DGWeak<dim,nstate,real>::assemble_face_term_derivatives(
                 residual_derivatives[idof] = rhs_ext[itest_ext].dx(i_dx).val();
             }
             const bool elide_zero_values = false;
-            this->system_matrix.add(soln_dof_indices_ext[itest_ext], soln_dof_indices_int, residual_derivatives, elide_zero_values);
+            if (!this->is_cell_block_jacobian()) {
+                this->system_matrix.add(soln_dof_indices_ext[itest_ext], soln_dof_indices_int, residual_derivatives, elide_zero_values);
+            }
 
             // dR_ext_dW_ext
             residual_derivatives.resize(n_soln_dofs_ext);
@@ -3034,7 +3076,8 @@ void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
         for (unsigned int itest=0; itest<n_soln_dofs_ext; ++itest) {
             th.registerOutput(rhs_ext[itest]);
         }
-    } else if (compute_d2R) {
+    }
+    if (compute_d2R) {
         th.registerOutput(dual_dot_residual);
     }
     if (compute_dRdW || compute_dRdX || compute_d2R) {
@@ -3049,10 +3092,7 @@ void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
         local_rhs_ext_cell[itest_ext] += getValue<adtype>(rhs_ext[itest_ext]);
     }
 
-    if (compute_dRdW || compute_dRdX) {
-        typename TH::JacobianType& jac = th.createJacobian();
-        th.evalJacobian(jac);
-
+    const auto add_jacobian = [&] (const auto &jac) {
         if (compute_dRdW) {
             std::vector<real> residual_derivatives(n_soln_dofs_int);
 
@@ -3074,7 +3114,9 @@ void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
                     const unsigned int i_dx = idof+w_ext_start;
                     residual_derivatives[idof] = jac(i_dependent,i_dx);
                 }
-                this->system_matrix.add(soln_dof_indices_int[itest_int], soln_dof_indices_ext, residual_derivatives, elide_zero_values);
+                if (!this->is_cell_block_jacobian()) {
+                    this->system_matrix.add(soln_dof_indices_int[itest_int], soln_dof_indices_ext, residual_derivatives, elide_zero_values);
+                }
             }
 
             for (unsigned int itest_ext=0; itest_ext<n_soln_dofs_ext; ++itest_ext) {
@@ -3088,7 +3130,9 @@ void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
                     residual_derivatives[idof] = jac(i_dependent,i_dx);
                 }
                 const bool elide_zero_values = false;
-                this->system_matrix.add(soln_dof_indices_ext[itest_ext], soln_dof_indices_int, residual_derivatives, elide_zero_values);
+                if (!this->is_cell_block_jacobian()) {
+                    this->system_matrix.add(soln_dof_indices_ext[itest_ext], soln_dof_indices_int, residual_derivatives, elide_zero_values);
+                }
 
                 // dR_ext_dW_ext
                 residual_derivatives.resize(n_soln_dofs_ext);
@@ -3141,19 +3185,15 @@ void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
                 this->dRdXv.add(soln_dof_indices_ext[itest_ext], metric_dof_indices_ext, residual_derivatives);
             }
         }
+    };
 
-        th.deleteJacobian(jac);
-    }
-
-    if (compute_d2R) {
-        typename TH::HessianType& hes = th.createHessian();
-        th.evalHessian(hes);
-
+    const auto add_hessian = [&] (const auto &hes) {
         std::vector<real> dWidW(n_soln_dofs_int);
         std::vector<real> dWidX(n_metric_dofs);
         std::vector<real> dXidX(n_metric_dofs);
 
-        int i_dependent = (compute_dRdW || compute_dRdX) ? n_soln_dofs_int + n_soln_dofs_ext : 0;
+        // The dual-weighted residual is the only output differentiated twice.
+        const int i_dependent = 0;
 
         for (unsigned int idof=0; idof<n_soln_dofs_int; ++idof) {
 
@@ -3259,8 +3299,41 @@ void DGWeak<dim,nstate,real>::assemble_face_codi_taped_derivatives(
             }
             this->d2RdXdX.add(metric_dof_indices_ext[idof], metric_dof_indices_ext, dXidX);
         }
-
-        th.deleteHessian(hes);
+    };
+
+    if (compute_d2R && (compute_dRdW || compute_dRdX)) {
+        // Fused assembly, where the recording is differentiated for every requested derivative.
+        if constexpr (std::is_same<adtype,codi_HessianComputationType>::value) {
+            const Telemetry::ScopedTimer ad_timer("ad_jacobian_hessian");
+            std::vector<double> input_values;
+            for (const auto &coeff : soln_coeff_int) input_values.push_back(getValue<adtype>(coeff));
+            for (const auto &coeff : soln_coeff_ext) input_values.push_back(getValue<adtype>(coeff));
+            for (const auto &coeff : coords_coeff_int) input_values.push_back(getValue<adtype>(coeff));
+            for (const auto &coeff : coords_coeff_ext) input_values.push_back(getValue<adtype>(coeff));
+            dealii::FullMatrix<double> jac;
+            DualWeightedResidualHessian hes;
+            evaluate_residual_jacobian_and_dual_hessian(th, input_values, n_soln_dofs_int + n_soln_dofs_ext, jac, hes);
+            add_jacobian(jac);
+            add_hessian(hes);
+        } else {
+            // Also instantiated with codi_JacobianComputationType, so this cannot be a static_assert.
+            AssertThrow(false, dealii::ExcMessage("The second derivatives need codi_HessianComputationType."));
+        }
+    } else {
+        if (compute_dRdW || compute_dRdX) {
+            const Telemetry::ScopedTimer ad_timer("ad_jacobian");
+            typename TH::JacobianType& jac = th.createJacobian();
+            th.evalJacobian(jac);
+            add_jacobian(jac);
+            th.deleteJacobian(jac);
+        }
+        if (compute_d2R) {
+            const Telemetry::ScopedTimer ad_timer("ad_hessian");
+            typename TH::HessianType& hes = th.createHessian();
+            th.evalHessian(hes);
+            add_hessian(hes);
+            th.deleteHessian(hes);
+        }
     }
 
     for (unsigned int idof = 0; idof < n_soln_dofs_int; ++idof) {
@@ -3405,7 +3478,7 @@ void DGWeak<dim,nstate,real>::assemble_volume_term(
     const bool compute_metric_derivatives,
     const dealii::FEValues<dim,dim> &fe_values_vol)
 {
-    (void) current_cell_index;
+    (void) fe_values_vol;
     using Array = std::array<real2, nstate>;
     using Tensor1D = dealii::Tensor<1,dim,real2>;
     using Tensor2D = dealii::Tensor<2,dim,real2>;
@@ -3424,73 +3497,21 @@ void DGWeak<dim,nstate,real>::assemble_volume_term(
     const unsigned int n_metric_dofs = fe_metric.dofs_per_cell;
 
     // Evaluate metric terms
-    std::vector<Tensor2D> metric_jacobian;
-    if (compute_metric_derivatives) metric_jacobian = evaluate_metric_jacobian ( points, coords_coeff, fe_metric);
     std::vector<real2> jac_det(n_quad_pts);
     std::vector<Tensor2D> jac_inv_tran(n_quad_pts);
-    for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
-
-        if (compute_metric_derivatives) {
-            const real2 jacobian_determinant = dealii::determinant(metric_jacobian[iquad]);
-            jac_det[iquad] = jacobian_determinant;
-
-            const Tensor2D jacobian_transpose_inverse = dealii::transpose(dealii::invert(metric_jacobian[iquad]));
-            jac_inv_tran[iquad] = jacobian_transpose_inverse;
-        } else {
-            jac_det[iquad] = fe_values_vol.JxW(iquad) / quadrature.weight(iquad);
-        }
-    }
+    std::vector<real2> JxW(n_quad_pts);
+    std::vector<Tensor1D> unused_unit_normal;
+    std::vector<real2> unused_surface_jac_det;
 #ifdef KOPRIVA_METRICS_VOL
-    auto old_jac_inv_tran = jac_inv_tran;
-    auto old_jac_det = jac_det;
-    if constexpr (dim != 1) {
-        evaluate_covariant_metric_jacobian<dim,real2> ( quadrature, coords_coeff, fe_metric, jac_inv_tran, jac_det);
-    }
-    for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
-        if (abs(old_jac_det[iquad] - jac_det[iquad])/abs(old_jac_det[iquad]) > 1e-10) {
-            std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
-            std::cout << "Not the same jac det, iquad " << iquad << std::endl;
-            std::cout << old_jac_det[iquad] << std::endl;
-            std::cout << jac_det[iquad] << std::endl;
-        }
-        //for (int row=0;row<dim;++row) {
-        //    for (int col=0;col<dim;++col) {
-        //        if (abs(old_jac_inv_tran[iquad][row][col] - jac_inv_tran[iquad][row][col]) > 1e-10) {
-        //            std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
-        //            std::cout << "Not the same jac inv tran, iquad " << iquad << " row " << row << " col " << col << std::endl;
-        //            std::cout << old_jac_inv_tran[iquad][row][col] << std::endl;
-        //            std::cout << jac_inv_tran[iquad][row][col] << std::endl;
-        //        }
-        //    }
-        //}
-        //real2 mnorm = 0;
-        //for (int row=0;row<dim;++row) {
-        //    for (int col=0;col<dim;++col) {
-        //        real2 val = (old_jac_inv_tran[iquad][row][col] - jac_inv_tran[iquad][row][col]);
-        //        mnorm += val*val;
-        //    }
-        //}
-        //mnorm = sqrt(mnorm);
-        //if (mnorm > 1e-10) {
-        //    std::cout << "Not the same jac inv tran, iquad " << iquad << std::endl;
-        //    for (int row=0;row<dim;++row) {
-        //        for (int col=0;col<dim;++col) {
-        //            std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
-        //            std::cout << old_jac_inv_tran[iquad][row][col] << " ";
-        //        }
-        //        std::cout << std::endl;
-        //    }
-        //    std::cout << std::endl;
-        //    for (int row=0;row<dim;++row) {
-        //        for (int col=0;col<dim;++col) {
-        //            std::cout << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
-        //            std::cout << jac_inv_tran[iquad][row][col] << " ";
-        //        }
-        //        std::cout << std::endl;
-        //    }
-        //}
-    }
+    const bool use_covariant_metric_jacobian = true;
+#else
+    const bool use_covariant_metric_jacobian = false;
 #endif
+    evaluate_metric_terms<real2> (
+        coords_coeff, fe_metric, quadrature, -1,
+        use_covariant_metric_jacobian, compute_metric_derivatives,
+        &(this->volume_metric_terms_cache), current_cell_index,
+        jac_det, jac_inv_tran, JxW, unused_unit_normal, unused_surface_jac_det);
 
 
     // Build operators.
@@ -3513,31 +3534,24 @@ void DGWeak<dim,nstate,real>::assemble_volume_term(
     }
     for (unsigned int idof=0; idof<n_soln_dofs; ++idof) {
          for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
-             if (compute_metric_derivatives) {
-                 //const dealii::Tensor<1,dim,real2> phys_shape_grad = dealii::contract<1,0>(jac_inv_tran[iquad], fe_soln.shape_grad(idof,points[iquad]));
-                 const dealii::Tensor<1,dim,real2> ref_shape_grad = fe_soln.shape_grad(idof,points[iquad]);
-                 dealii::Tensor<1,dim,real2> phys_shape_grad;
-                 for (int dr=0;dr<dim;++dr) {
-                     phys_shape_grad[dr] = 0.0;
-                     for (int dc=0;dc<dim;++dc) {
-                         phys_shape_grad[dr] += jac_inv_tran[iquad][dr][dc] * ref_shape_grad[dc];
-                     }
-                 }
-                 for (int d=0;d<dim;++d) {
-                     gradient_operator[d][idof][iquad] = phys_shape_grad[d];
-                 }
-
-                 // Exact mapping
-                 // for (int d=0;d<dim;++d) {
-                 //     const unsigned int istate = fe_soln.system_to_component_index(idof).first;
-                 //     gradient_operator[d][idof][iquad] = fe_values_vol.shape_grad_component(idof, iquad, istate)[d];
-                 // }
-             } else {
-                 for (int d=0;d<dim;++d) {
-                     const unsigned int istate = fe_soln.system_to_component_index(idof).first;
-                     gradient_operator[d][idof][iquad] = fe_values_vol.shape_grad_component(idof, iquad, istate)[d];
+             //const dealii::Tensor<1,dim,real2> phys_shape_grad = dealii::contract<1,0>(jac_inv_tran[iquad], fe_soln.shape_grad(idof,points[iquad]));
+             const dealii::Tensor<1,dim,real2> ref_shape_grad = fe_soln.shape_grad(idof,points[iquad]);
+             dealii::Tensor<1,dim,real2> phys_shape_grad;
+             for (int dr=0;dr<dim;++dr) {
+                 phys_shape_grad[dr] = 0.0;
+                 for (int dc=0;dc<dim;++dc) {
+                     phys_shape_grad[dr] += jac_inv_tran[iquad][dr][dc] * ref_shape_grad[dc];
                  }
              }
+             for (int d=0;d<dim;++d) {
+                 gradient_operator[d][idof][iquad] = phys_shape_grad[d];
+             }
+
+             // Exact mapping
+             // for (int d=0;d<dim;++d) {
+             //     const unsigned int istate = fe_soln.system_to_component_index(idof).first;
+             //     gradient_operator[d][idof][iquad] = fe_values_vol.shape_grad_component(idof, iquad, istate)[d];
+             // }
          }
      }
 
@@ -3625,6 +3639,23 @@ void DGWeak<dim,nstate,real>::assemble_volume_term(
         }
     }
 
+    // The residual assembly of the weak form skips the explicit volume term,
+    // the cell volume and its largest stable time step are therefore evaluated here.
+    std::vector< std::array<real,nstate> > soln_at_q_values(n_quad_pts);
+    real cell_volume = 0.0;
+    real max_artificial_diss = 0.0;
+    for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
+        for (int istate=0; istate<nstate; ++istate) {
+            soln_at_q_values[iquad][istate] = getValue<real2>(soln_at_q[iquad][istate]);
+        }
+        cell_volume = cell_volume + getValue<real2>(JxW[iquad]);
+        max_artificial_diss = std::max(artificial_diss_coeff_at_q[iquad], max_artificial_diss);
+    }
+    const real diameter = cell->diameter();
+    const real cell_radius = 0.5 * cell_volume / std::pow(diameter,dim-1);
+    this->cell_volume[current_cell_index] = cell_volume;
+    this->max_dt_cell[current_cell_index] = DGBaseState<dim,nstate,real>::evaluate_CFL ( soln_at_q_values, max_artificial_diss, cell_radius, fe_soln.tensor_degree());
+
     // Weak form
     // The right-hand side sends all the term to the side of the source term
     // Therefore,
@@ -3639,7 +3670,7 @@ void DGWeak<dim,nstate,real>::assemble_volume_term(
 
         for (unsigned int iquad=0; iquad<n_quad_pts; ++iquad) {
 
-            const real2 JxW_iquad = jac_det[iquad] * quadrature.weight(iquad);
+            const real2 JxW_iquad = JxW[iquad];
 
             for (int d=0;d<dim;++d) {
                 // Convective
@@ -3696,7 +3727,7 @@ void DGWeak<dim,nstate,real>::assemble_volume_term_derivatives(
     }
 
     (void) compute_dRdW; (void) compute_dRdX; (void) compute_d2R;
-    const bool compute_metric_derivatives = true;//(!compute_dRdX && !compute_d2R) ? false : true;
+    const bool compute_metric_derivatives = (!compute_dRdX && !compute_d2R) ? false : true;
 
     unsigned int w_start, w_end, x_start, x_end;
     automatic_differentiation_indexing_1( compute_dRdW, compute_dRdX, compute_d2R,
@@ -3858,7 +3889,7 @@ void DGWeak<dim,nstate,real>::assemble_volume_codi_taped_derivatives(
     }
 
     (void) compute_dRdW; (void) compute_dRdX; (void) compute_d2R;
-    const bool compute_metric_derivatives = true;//(!compute_dRdX && !compute_d2R) ? false : true;
+    const bool compute_metric_derivatives = (!compute_dRdX && !compute_d2R) ? false : true;
 
     unsigned int w_start, w_end, x_start, x_end;
     automatic_differentiation_indexing_1( compute_dRdW, compute_dRdX, compute_d2R,
@@ -3907,7 +3938,8 @@ void DGWeak<dim,nstate,real>::assemble_volume_codi_taped_derivatives(
         for (unsigned int itest=0; itest<n_soln_dofs; ++itest) {
             th.registerOutput(rhs[itest]);
         }
-    } else if (compute_d2R) {
+    }
+    if (compute_d2R) {
         th.registerOutput(dual_dot_residual);
     }
     if (compute_dRdW || compute_dRdX || compute_d2R) {
@@ -3919,44 +3951,34 @@ void DGWeak<dim,nstate,real>::assemble_volume_codi_taped_derivatives(
         AssertIsFinite(local_rhs_cell(itest));
     }
 
-    if (compute_dRdW) {
-        typename TH::JacobianType& jac = th.createJacobian();
-        th.evalJacobian(jac);
-        for (unsigned int itest=0; itest<n_soln_dofs; ++itest) {
-
+    const auto add_jacobian = [&] (const auto &jac) {
+        if (compute_dRdW) {
             std::vector<real> residual_derivatives(n_soln_dofs);
-            for (unsigned int idof = 0; idof < n_soln_dofs; ++idof) {
-                const unsigned int i_dx = idof+w_start;
-                residual_derivatives[idof] = jac(itest,i_dx);
-                AssertIsFinite(residual_derivatives[idof]);
+            for (unsigned int itest=0; itest<n_soln_dofs; ++itest) {
+                for (unsigned int idof = 0; idof < n_soln_dofs; ++idof) {
+                    const unsigned int i_dx = idof+w_start;
+                    residual_derivatives[idof] = jac(itest,i_dx);
+                    AssertIsFinite(residual_derivatives[idof]);
+                }
+                const bool elide_zero_values = false;
+                this->system_matrix.add(soln_dof_indices[itest], soln_dof_indices, residual_derivatives, elide_zero_values);
             }
-            const bool elide_zero_values = false;
-            this->system_matrix.add(soln_dof_indices[itest], soln_dof_indices, residual_derivatives, elide_zero_values);
         }
-        th.deleteJacobian(jac);
-
-    }
-
-    if (compute_dRdX) {
-        typename TH::JacobianType& jac = th.createJacobian();
-        th.evalJacobian(jac);
-        for (unsigned int itest=0; itest<n_soln_dofs; ++itest) {
+        if (compute_dRdX) {
             std::vector<real> residual_derivatives(n_metric_dofs);
-            for (unsigned int idof = 0; idof < n_metric_dofs; ++idof) {
-                const unsigned int i_dx = idof+x_start;
-                residual_derivatives[idof] = jac(itest,i_dx);
+            for (unsigned int itest=0; itest<n_soln_dofs; ++itest) {
+                for (unsigned int idof = 0; idof < n_metric_dofs; ++idof) {
+                    const unsigned int i_dx = idof+x_start;
+                    residual_derivatives[idof] = jac(itest,i_dx);
+                }
+                this->dRdXv.add(soln_dof_indices[itest], metric_dof_indices, residual_derivatives);
             }
-            this->dRdXv.add(soln_dof_indices[itest], metric_dof_indices, residual_derivatives);
         }
-        th.deleteJacobian(jac);
-    }
+    };
 
-
-    if (compute_d2R) {
-        typename TH::HessianType& hes = th.createHessian();
-        th.evalHessian(hes);
-
-        int i_dependent = (compute_dRdW || compute_dRdX) ? n_soln_dofs : 0;
+    const auto add_hessian = [&] (const auto &hes) {
+        // The dual-weighted residual is the only output differentiated twice.
+        const int i_dependent = 0;
 
         std::vector<real> dWidW(n_soln_dofs);
         std::vector<real> dWidX(n_metric_dofs);
@@ -3989,8 +4011,39 @@ void DGWeak<dim,nstate,real>::assemble_volume_codi_taped_derivatives(
             }
             this->d2RdXdX.add(metric_dof_indices[idof], metric_dof_indices, dXidX);
         }
-
-        th.deleteHessian(hes);
+    };
+
+    if (compute_d2R && (compute_dRdW || compute_dRdX)) {
+        // Fused assembly, where the recording is differentiated for every requested derivative.
+        if constexpr (std::is_same<adtype,codi_HessianComputationType>::value) {
+            const Telemetry::ScopedTimer ad_timer("ad_jacobian_hessian");
+            std::vector<double> input_values;
+            for (const auto &coeff : soln_coeff) input_values.push_back(getValue<adtype>(coeff));
+            for (const auto &coeff : coords_coeff) input_values.push_back(getValue<adtype>(coeff));
+            dealii::FullMatrix<double> jac;
+            DualWeightedResidualHessian hes;
+            evaluate_residual_jacobian_and_dual_hessian(th, input_values, n_soln_dofs, jac, hes);
+            add_jacobian(jac);
+            add_hessian(hes);
+        } else {
+            // Also instantiated with codi_JacobianComputationType, so this cannot be a static_assert.
+            AssertThrow(false, dealii::ExcMessage("The second derivatives need codi_HessianComputationType."));
+        }
+    } else {
+        if (compute_dRdW || compute_dRdX) {
+            const Telemetry::ScopedTimer ad_timer("ad_jacobian");
+            typename TH::JacobianType& jac = th.createJacobian();
+            th.evalJacobian(jac);
+            add_jacobian(jac);
+            th.deleteJacobian(jac);
+        }
+        if (compute_d2R) {
+            const Telemetry::ScopedTimer ad_timer("ad_hessian");
+            typename TH::HessianType& hes = th.createHessian();
+            th.evalHessian(hes);
+            add_hessian(hes);
+            th.deleteHessian(hes);
+        }
     }
 
     for (unsigned int idof = 0; idof < n_soln_dofs; ++idof) {
@@ -4022,7 +4075,7 @@ void DGWeak<dim,nstate,real>::assemble_volume_residual(
     (void) compute_d2R;
     assert( !compute_dRdW && !compute_dRdX && !compute_d2R);
     (void) compute_dRdW; (void) compute_dRdX; (void) compute_d2R;
-    const bool compute_metric_derivatives = true;//(!compute_dRdX && !compute_d2R) ? false : true;
+    const bool compute_metric_derivatives = (!compute_dRdX && !compute_d2R) ? false : true;
 
     const dealii::FESystem<dim> &fe_metric = this->high_order_grid->fe_system;
     const unsigned int n_metric_dofs = fe_metric.dofs_per_cell;
@@ -25,8 +25,39 @@ public:
 
     ~DGWeak(); ///< Destructor.
 
+    /// The metric terms of the weak form are evaluated from the grid nodes or read from the metric terms caches.
+    bool assembly_uses_fe_values_geometry () const override { return false; }
+
 private:
 
+    /// Evaluates the determinants and the transposed inverses of the metric Jacobians at the given points of a cell.
+    /** The JxW values are the products of the quadrature weights with the Jacobian determinants.
+     *  On the face @p face_number of the cell, the physical unit normals and the surface Jacobian
+     *  determinants are also evaluated, and the JxW values use the surface Jacobian determinants.
+     *  A negative @p face_number denotes the cell volume, in which case @p phys_unit_normal and
+     *  @p surface_jacobian_determinant are left untouched.
+     *
+     *  When @p compute_metric_derivatives is false, only the values of @p coords_coeff are used,
+     *  such that the metric terms do not carry any derivative with respect to the grid nodes.
+     *  The values of the metric terms are then read from, or stored into, the @p slot of @p metric_terms_cache
+     *  unless @p metric_terms_cache is a nullptr.
+     */
+    template <typename real2>
+    void evaluate_metric_terms(
+        const std::vector<real2> &coords_coeff,
+        const dealii::FESystem<dim,dim> &fe_metric,
+        const dealii::Quadrature<dim> &quadrature,
+        const int face_number,
+        const bool use_covariant_metric_jacobian,
+        const bool compute_metric_derivatives,
+        typename DGBase<dim,real>::MetricTermsCache *const metric_terms_cache,
+        const unsigned int slot,
+        std::vector<real2> &jacobian_determinant,
+        std::vector<dealii::Tensor<2,dim,real2>> &jacobian_transpose_inverse,
+        std::vector<real2> &JxW,
+        std::vector<dealii::Tensor<1,dim,real2>> &phys_unit_normal,
+        std::vector<real2> &surface_jacobian_determinant);
+
     /// Main function responsible for evaluating the integral over the cell volume and the specified derivatives.
     /** This function templates the solution and metric coefficients in order to possible AD the residual.
      */
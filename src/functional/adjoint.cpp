@@ -2,8 +2,6 @@
 #include <iostream>
 #include <fstream>
 
-#include <Epetra_RowMatrixTransposer.h>
-
 #include <deal.II/dofs/dof_tools.h>
 
 #include <deal.II/lac/la_parallel_vector.h>
@@ -124,6 +122,7 @@ void Adjoint<dim, nstate, real>::coarse_to_fine()
     dg.solution.zero_out_ghosts();
     solution_transfer.interpolate(dg.solution);
     dg.solution.update_ghost_values();
+    dg.solution_modified();
 
     adjoint_state = AdjointEnum::fine;
 }
@@ -145,6 +144,7 @@ void Adjoint<dim, nstate, real>::fine_to_coarse()
     dg.solution.zero_out_ghosts();
 
     dg.solution = solution_coarse;
+    dg.solution_modified();
 
     adjoint_state = AdjointEnum::coarse;
 }
@@ -166,15 +166,7 @@ dealii::LinearAlgebra::distributed::Vector<real> Adjoint<dim, nstate, real>::fin
     dg.assemble_residual(true);
     dg.system_matrix *= -1.0;
 
-    dealii::TrilinosWrappers::SparseMatrix system_matrix_transpose;
-    Epetra_CrsMatrix *system_matrix_transpose_tril;
-
-    Epetra_RowMatrixTransposer epmt(const_cast<Epetra_CrsMatrix *>(&dg.system_matrix.trilinos_matrix()));
-    epmt.CreateTranspose(false, system_matrix_transpose_tril);
-    system_matrix_transpose.reinit(*system_matrix_transpose_tril,true);
-    delete system_matrix_transpose_tril;
-    solve_linear(system_matrix_transpose, dIdw_fine, adjoint_fine, dg.all_parameters->linear_solver_param);
-    // solve_linear(dg.system_matrix, dIdw_fine, adjoint_fine, dg.all_parameters->linear_solver_param);
+    solve_linear_transpose(dg.system_matrix, dIdw_fine, adjoint_fine, dg.all_parameters->linear_solver_param);
 
     return adjoint_fine;
 }
@@ -196,14 +188,7 @@ dealii::LinearAlgebra::distributed::Vector<real> Adjoint<dim, nstate, real>::coa
     dg.assemble_residual(true);
     dg.system_matrix *= -1.0;
 
-    dealii::TrilinosWrappers::SparseMatrix system_matrix_transpose;
-    Epetra_CrsMatrix *system_matrix_transpose_tril;
-
-    Epetra_RowMatrixTransposer epmt(const_cast<Epetra_CrsMatrix *>(&dg.system_matrix.trilinos_matrix()));
-    epmt.CreateTranspose(false, system_matrix_transpose_tril);
-    system_matrix_transpose.reinit(*system_matrix_transpose_tril);
-    solve_linear(system_matrix_transpose, dIdw_coarse, adjoint_coarse, dg.all_parameters->linear_solver_param);
-    // solve_linear(dg.system_matrix, dIdw_coarse, adjoint_coarse, dg.all_parameters->linear_solver_param);
+    solve_linear_transpose(dg.system_matrix, dIdw_coarse, adjoint_coarse, dg.all_parameters->linear_solver_param);
 
     return adjoint_coarse;
 }
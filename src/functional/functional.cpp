@@ -17,6 +17,7 @@
 #include "physics/physics_factory.h"
 #include "dg/dg.h"
 #include "functional.h"
+#include "telemetry/telemetry.h"
 
 /// Returns y = Ax.
 /** Had to rewrite this instead of 
@@ -66,33 +67,7 @@ Functional<dim,nstate,real>::Functional(
     using FadType = Sacado::Fad::DFad<real>;
     using FadFadType = Sacado::Fad::DFad<FadType>;
     physics_fad_fad = Physics::PhysicsFactory<dim,nstate,FadFadType>::create_Physics(dg->all_parameters);
-
-    init_vectors();
 }
-template <int dim, int nstate, typename real>
-void Functional<dim,nstate,real>::init_vectors()
-{
-    solution_value.reinit(dg->solution);
-    solution_value *= 0.0;
-    volume_nodes_value.reinit(dg->high_order_grid->volume_nodes);
-    volume_nodes_value *= 0.0;
-
-    solution_dIdW.reinit(dg->solution);
-    solution_dIdW *= 0.0;
-    volume_nodes_dIdW.reinit(dg->high_order_grid->volume_nodes);
-    volume_nodes_dIdW *= 0.0;
-
-    solution_dIdX.reinit(dg->solution);
-    solution_dIdX *= 0.0;
-    volume_nodes_dIdX.reinit(dg->high_order_grid->volume_nodes);
-    volume_nodes_dIdX *= 0.0;
-
-    solution_d2I.reinit(dg->solution);
-    solution_d2I *= 0.0;
-    volume_nodes_d2I.reinit(dg->high_order_grid->volume_nodes);
-    volume_nodes_d2I *= 0.0;
-}
-
 template <int dim, int nstate, typename real>
 Functional<dim,nstate,real>::Functional(
     std::shared_ptr<PHiLiP::DGBase<dim,real>> _dg,
@@ -107,13 +82,14 @@ Functional<dim,nstate,real>::Functional(
 template <int dim, int nstate, typename real>
 void Functional<dim,nstate,real>::set_state(const dealii::LinearAlgebra::distributed::Vector<real> &solution_set)
 {
-    dg->solution = solution_set;
+    dg->set_solution(solution_set);
 }
 
 template <int dim, int nstate, typename real>
 void Functional<dim,nstate,real>::set_geom(const dealii::LinearAlgebra::distributed::Vector<real> &volume_nodes_set)
 {
     dg->high_order_grid->volume_nodes = volume_nodes_set;
+    dg->high_order_grid->volume_nodes_modified();
 }
 
 template <int dim, int nstate, typename real>
@@ -422,105 +398,38 @@ Sacado::Fad::DFad<Sacado::Fad::DFad<real>> Functional<dim, nstate, real>::evalua
 template <int dim, int nstate, typename real>
 void Functional<dim, nstate, real>::need_compute(bool &compute_value, bool &compute_dIdW, bool &compute_dIdX, bool &compute_d2I)
 {
+    const StateVersions state_versions = dg->get_state_versions();
     if (compute_value) {
         pcout << " with value...";
-
-        if (dg->solution.size() == solution_value.size() 
-            && dg->high_order_grid->volume_nodes.size() == volume_nodes_value.size()) {
-
-            auto diff_sol = dg->solution;
-            diff_sol -= solution_value;
-            const double l2_norm_sol = diff_sol.l2_norm();
-
-            if (l2_norm_sol == 0.0) {
-
-                auto diff_node = dg->high_order_grid->volume_nodes;
-                diff_node -= volume_nodes_value;
-                const double l2_norm_node = diff_node.l2_norm();
-
-                if (l2_norm_node == 0.0) {
-                    pcout << " which is already assembled...";
-                    compute_value = false;
-                }
-            }
+        if (value_stamp.is_current(state_versions)) {
+            pcout << " which is already assembled...";
+            compute_value = false;
         }
-        solution_value = dg->solution;
-        volume_nodes_value = dg->high_order_grid->volume_nodes;
+        value_stamp.set(state_versions);
     }
     if (compute_dIdW) {
         pcout << " with dIdW...";
-
-        if (dg->solution.size() == solution_dIdW.size() 
-            && dg->high_order_grid->volume_nodes.size() == volume_nodes_dIdW.size()) {
-
-            auto diff_sol = dg->solution;
-            diff_sol -= solution_dIdW;
-            const double l2_norm_sol = diff_sol.l2_norm();
-
-            if (l2_norm_sol == 0.0) {
-
-                auto diff_node = dg->high_order_grid->volume_nodes;
-                diff_node -= volume_nodes_dIdW;
-                const double l2_norm_node = diff_node.l2_norm();
-
-                if (l2_norm_node == 0.0) {
-                    pcout << " which is already assembled...";
-                    compute_dIdW = false;
-                }
-            }
+        if (dIdW_stamp.is_current(state_versions)) {
+            pcout << " which is already assembled...";
+            compute_dIdW = false;
         }
-        solution_dIdW = dg->solution;
-        volume_nodes_dIdW = dg->high_order_grid->volume_nodes;
+        dIdW_stamp.set(state_versions);
     }
     if (compute_dIdX) {
         pcout << " with dIdX...";
-
-        if (dg->solution.size() == solution_dIdX.size() 
-            && dg->high_order_grid->volume_nodes.size() == volume_nodes_dIdX.size()) {
-            auto diff_sol = dg->solution;
-            diff_sol -= solution_dIdX;
-            const double l2_norm_sol = diff_sol.l2_norm();
-
-            if (l2_norm_sol == 0.0) {
-
-                auto diff_node = dg->high_order_grid->volume_nodes;
-                diff_node -= volume_nodes_dIdX;
-                const double l2_norm_node = diff_node.l2_norm();
-
-                if (l2_norm_node == 0.0) {
-                    pcout << " which is already assembled...";
-                    compute_dIdX = false;
-                }
-            }
+        if (dIdX_stamp.is_current(state_versions)) {
+            pcout << " which is already assembled...";
+            compute_dIdX = false;
         }
-        solution_dIdX = dg->solution;
-        volume_nodes_dIdX = dg->high_order_grid->volume_nodes;
+        dIdX_stamp.set(state_versions);
     }
     if (compute_d2I) {
         pcout << " with d2IdWdW, d2IdWdX, d2IdXdX...";
-
-        if (dg->solution.size() == solution_d2I.size() 
-            && dg->high_order_grid->volume_nodes.size() == volume_nodes_d2I.size()) {
-
-            auto diff_sol = dg->solution;
-            diff_sol -= solution_d2I;
-            const double l2_norm_sol = diff_sol.l2_norm();
-
-            if (l2_norm_sol == 0.0) {
-
-                auto diff_node = dg->high_order_grid->volume_nodes;
-                diff_node -= volume_nodes_d2I;
-                const double l2_norm_node = diff_node.l2_norm();
-
-                if (l2_norm_node == 0.0) {
-
-                    pcout << " which is already assembled...";
-                    compute_d2I = false;
-                }
-            }
+        if (d2I_stamp.is_current(state_versions)) {
+            pcout << " which is already assembled...";
+            compute_d2I = false;
         }
-        solution_d2I = dg->solution;
-        volume_nodes_d2I = dg->high_order_grid->volume_nodes;
+        d2I_stamp.set(state_versions);
     }
 }
 
@@ -530,6 +439,7 @@ real Functional<dim, nstate, real>::evaluate_functional(
     const bool compute_dIdX,
     const bool compute_d2I)
 {
+    const Telemetry::ScopedTimer timer("functional");
     using FadType = Sacado::Fad::DFad<real>;
     using FadFadType = Sacado::Fad::DFad<FadType>;
 
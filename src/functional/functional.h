@@ -128,36 +128,18 @@ public:
     dealii::TrilinosWrappers::SparseMatrix d2IdXdX;
 
 private:
-    /// Initializes/allocates the vectors used to check if we recompute
-    /// the functional or its derivatives.
-    void init_vectors();
-    /// Modal coefficients of the solution used to compute dIdW last
+    /// State at which the functional value was last evaluated.
+    /// Will be used to avoid recomputing the value.
+    EvaluationStamp value_stamp;
+    /// State at which dIdW was last evaluated.
     /// Will be used to avoid recomputing dIdW.
-    dealii::LinearAlgebra::distributed::Vector<double> solution_value;
-    /// Modal coefficients of the grid nodes used to compute dIdW last
-    /// Will be used to avoid recomputing dIdW.
-    dealii::LinearAlgebra::distributed::Vector<double> volume_nodes_value;
-
-    /// Modal coefficients of the solution used to compute dIdW last
-    /// Will be used to avoid recomputing dIdW.
-    dealii::LinearAlgebra::distributed::Vector<double> solution_dIdW;
-    /// Modal coefficients of the grid nodes used to compute dIdW last
-    /// Will be used to avoid recomputing dIdW.
-    dealii::LinearAlgebra::distributed::Vector<double> volume_nodes_dIdW;
-
-    /// Modal coefficients of the solution used to compute dIdX last
-    /// Will be used to avoid recomputing dIdX.
-    dealii::LinearAlgebra::distributed::Vector<double> solution_dIdX;
-    /// Modal coefficients of the grid nodes used to compute dIdX last
+    EvaluationStamp dIdW_stamp;
+    /// State at which dIdX was last evaluated.
     /// Will be used to avoid recomputing dIdX.
-    dealii::LinearAlgebra::distributed::Vector<double> volume_nodes_dIdX;
-
-    /// Modal coefficients of the solution used to compute d2I last
-    /// Will be used to avoid recomputing d2I.
-    dealii::LinearAlgebra::distributed::Vector<double> solution_d2I;
-    /// Modal coefficients of the grid nodes used to compute d2I last
+    EvaluationStamp dIdX_stamp;
+    /// State at which d2I was last evaluated.
     /// Will be used to avoid recomputing d2I.
-    dealii::LinearAlgebra::distributed::Vector<double> volume_nodes_d2I;
+    EvaluationStamp d2I_stamp;
 
 protected:
     /// Allocate and setup the derivative vectors/matrices.
@@ -176,7 +158,7 @@ protected:
 
 protected:
     /// Checks which derivatives actually need to be recomputed.
-    /** If the stored solution and mesh are the same as the one used to previously
+    /** If the solution and mesh versions are the same as the ones used to previously
      *  compute the derivative, then we do not need to recompute them.
      */
     void need_compute(bool &compute_value, bool &compute_dIdW, bool &compute_dIdX, bool &compute_d2I);
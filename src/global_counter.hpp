@@ -1,10 +0,0 @@
-#ifndef GLOBAL_COUNTER_H_
-#define GLOBAL_COUNTER_H_
-
-extern unsigned int n_vmult;
-extern unsigned int dRdW_form;
-extern unsigned int dRdW_mult;
-extern unsigned int dRdX_mult;
-extern unsigned int d2R_mult;
-
-#endif
@@ -0,0 +1,255 @@
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/lac/exceptions.h>
+
+#include <Epetra_LocalMap.h>
+#include <Epetra_Vector.h>
+
+#include "block_gmres.h"
+
+namespace PHiLiP {
+
+namespace {
+/// Orthonormalizes the columns of @p W with modified Gram-Schmidt such that W = Q R.
+/** W is overwritten by Q and @p R is the s-by-s upper triangular factor in column-major order.
+ *  Columns that are linearly dependent on the previous ones are zeroed out and have a zero diagonal in R.
+ */
+void orthonormalize_columns (Epetra_MultiVector &W, std::vector<double> &R)
+{
+    const int s = W.NumVectors();
+    R.assign(s*s, 0.0);
+    std::vector<double> initial_norms(s);
+    W.Norm2(initial_norms.data());
+    for (int k = 0; k < s; ++k) {
+        Epetra_Vector &wk = *W(k);
+        for (int l = 0; l < k; ++l) {
+            double r_lk;
+            wk.Dot(*W(l), &r_lk);
+            R[l + k*s] = r_lk;
+            wk.Update(-r_lk, *W(l), 1.0);
+        }
+        double norm;
+        wk.Norm2(&norm);
+        if (norm <= 10.0 * std::numeric_limits<double>::epsilon() * initial_norms[k]) {
+            wk.PutScalar(0.0);
+            norm = 0.0;
+        } else {
+            wk.Scale(1.0/norm);
+        }
+        R[k + k*s] = norm;
+    }
+}
+
+/// Givens rotation acting on rows (row-1, row) of the least-squares problem.
+struct GivensRotation
+{
+    int row; ///< Second row of the rotation.
+    double c; ///< Cosine.
+    double s; ///< Sine.
+
+    /// Applies the rotation on a column-major matrix with leading dimension @p ld, on columns [first_col, last_col).
+    void apply (std::vector<double> &matrix, const int ld, const int first_col, const int last_col) const
+    {
+        for (int col = first_col; col < last_col; ++col) {
+            double &x = matrix[row-1 + col*ld];
+            double &y = matrix[row   + col*ld];
+            const double x_new =  c*x + s*y;
+            const double y_new = -s*x + c*y;
+            x = x_new;
+            y = y_new;
+        }
+    }
+};
+
+/// Computes the rotation zeroing out @p b against @p a.
+GivensRotation compute_givens (const int row, const double a, const double b)
+{
+    if (b == 0.0) return {row, 1.0, 0.0};
+    if (std::abs(b) > std::abs(a)) {
+        const double t = a/b;
+        const double s = 1.0/std::sqrt(1.0+t*t);
+        return {row, s*t, s};
+    }
+    const double t = b/a;
+    const double c = 1.0/std::sqrt(1.0+t*t);
+    return {row, c, c*t};
+}
+} // anonymous namespace
+
+std::pair<unsigned int, double>
+solve_block_gmres (
+    const Epetra_Operator &system_operator,
+    const Epetra_Operator *const preconditioner,
+    const Epetra_MultiVector &right_hand_sides,
+    Epetra_MultiVector &solutions,
+    const unsigned int n_blocks_before_restart,
+    const unsigned int max_iterations,
+    const double relative_tolerance)
+{
+    AssertThrow(n_blocks_before_restart > 0, dealii::ExcMessage("Block GMRES needs at least one block before restarting."));
+    const int s = right_hand_sides.NumVectors();
+    const int m = n_blocks_before_restart;
+    AssertDimension(solutions.NumVectors(), s);
+
+    std::vector<double> rhs_norms(s);
+    right_hand_sides.Norm2(rhs_norms.data());
+    std::vector<double> tolerances(s);
+    for (int k = 0; k < s; ++k) tolerances[k] = relative_tolerance * rhs_norms[k];
+
+    // Relative residual of the worst column, and whether all columns have converged.
+    std::vector<double> residual_norms(s);
+    const auto check_convergence = [&] (double &max_relative_residual) {
+        bool converged = true;
+        max_relative_residual = 0.0;
+        for (int k = 0; k < s; ++k) {
+            if (residual_norms[k] > tolerances[k]) converged = false;
+            if (rhs_norms[k] > 0.0) max_relative_residual = std::max(max_relative_residual, residual_norms[k]/rhs_norms[k]);
+        }
+        return converged;
+    };
+
+    const Epetra_BlockMap &map = right_hand_sides.Map();
+    const Epetra_LocalMap local_map(s, 0, right_hand_sides.Comm());
+
+    // Block Krylov basis.
+    std::vector<std::unique_ptr<Epetra_MultiVector>> V(m+1);
+    for (auto &v: V) v = std::make_unique<Epetra_MultiVector>(map, s);
+    Epetra_MultiVector W(map, s);
+    Epetra_MultiVector Z(map, s);
+    // Replicated s-by-s block of the Hessenberg matrix.
+    Epetra_MultiVector H_block(local_map, s);
+
+    // Band Hessenberg matrix and least-squares right-hand sides, both in column-major order.
+    const int n_rows = (m+1)*s;
+    std::vector<double> H(n_rows * m*s);
+    std::vector<double> G(n_rows * s);
+    std::vector<GivensRotation> rotations;
+    std::vector<double> R;
+
+    const auto compute_residual = [&] () {
+        int ierr = system_operator.Apply(solutions, W);
+        AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+        ierr = W.Update(1.0, right_hand_sides, -1.0);
+        AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+        W.Norm2(residual_norms.data());
+    };
+    const auto apply_preconditioner = [&] (const Epetra_MultiVector &src, Epetra_MultiVector &dst) {
+        if (preconditioner) {
+            const int ierr = preconditioner->ApplyInverse(src, dst);
+            AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+        } else {
+            dst = src;
+        }
+    };
+
+    double max_relative_residual;
+    compute_residual();
+    bool converged = check_convergence(max_relative_residual);
+    unsigned int iteration = 0;
+    while (!converged && iteration < max_iterations) {
+
+        // V_0 S_0 = R_0
+        *V[0] = W;
+        orthonormalize_columns(*V[0], R);
+        std::fill(H.begin(), H.end(), 0.0);
+        std::fill(G.begin(), G.end(), 0.0);
+        for (int k = 0; k < s; ++k) {
+            for (int r = 0; r <= k; ++r) G[r + k*n_rows] = R[r + k*s];
+        }
+        rotations.clear();
+
+        int n_blocks = 0;
+        for (int j = 0; j < m && iteration < max_iterations; ++j) {
+            ++iteration;
+            ++n_blocks;
+
+            // W = A M^{-1} V_j
+            apply_preconditioner(*V[j], Z);
+            const int ierr = system_operator.Apply(Z, W);
+            AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+
+            // Block classical Gram-Schmidt, done twice for stability.
+            for (int pass = 0; pass < 2; ++pass) {
+                for (int i = 0; i <= j; ++i) {
+                    H_block.Multiply('T', 'N', 1.0, *V[i], W, 0.0);
+                    W.Multiply('N', 'N', -1.0, *V[i], H_block, 1.0);
+                    for (int col = 0; col < s; ++col) {
+                        for (int row = 0; row < s; ++row) {
+                            H[(i*s+row) + (j*s+col)*n_rows] += H_block[col][row];
+                        }
+                    }
+                }
+            }
+            // V_{j+1} H_{j+1,j} = W
+            orthonormalize_columns(W, R);
+            *V[j+1] = W;
+            for (int col = 0; col < s; ++col) {
+                for (int row = 0; row <= col; ++row) {
+                    H[((j+1)*s+row) + (j*s+col)*n_rows] = R[row + col*s];
+                }
+            }
+
+            // Reduce the new columns to upper triangular form.
+            for (int col = j*s; col < (j+1)*s; ++col) {
+                for (const auto &rotation: rotations) rotation.apply(H, n_rows, col, col+1);
+                for (int row = col+s; row > col; --row) {
+                    const GivensRotation rotation = compute_givens(row, H[row-1 + col*n_rows], H[row + col*n_rows]);
+                    rotation.apply(H, n_rows, col, col+1);
+                    rotation.apply(G, n_rows, 0, s);
+                    rotations.push_back(rotation);
+                }
+            }
+
+            // Least-squares residual estimates.
+            for (int k = 0; k < s; ++k) {
+                double norm_squared = 0.0;
+                for (int row = (j+1)*s; row < (j+2)*s; ++row) norm_squared += G[row + k*n_rows] * G[row + k*n_rows];
+                residual_norms[k] = std::sqrt(norm_squared);
+            }
+            if (check_convergence(max_relative_residual)) break;
+        }
+
+        // Back substitution of the triangular system, dropping the directions that were found dependent.
+        const int n = n_blocks*s;
+        double max_diagonal = 0.0;
+        for (int i = 0; i < n; ++i) max_diagonal = std::max(max_diagonal, std::abs(H[i + i*n_rows]));
+        const double dependent_diagonal = 10.0 * std::numeric_limits<double>::epsilon() * max_diagonal;
+        std::vector<double> Y(G.begin(), G.begin() + n_rows*s);
+        for (int k = 0; k < s; ++k) {
+            double *y = &Y[k*n_rows];
+            for (int i = n-1; i >= 0; --i) {
+                const double diagonal = H[i + i*n_rows];
+                if (std::abs(diagonal) <= dependent_diagonal) {
+                    y[i] = 0.0;
+                    continue;
+                }
+                y[i] /= diagonal;
+                for (int row = 0; row < i; ++row) y[row] -= H[row + i*n_rows] * y[i];
+            }
+        }
+
+        // X = X + M^{-1} sum_i V_i Y_i
+        W.PutScalar(0.0);
+        for (int i = 0; i < n_blocks; ++i) {
+            for (int col = 0; col < s; ++col) {
+                for (int row = 0; row < s; ++row) {
+                    H_block[col][row] = Y[(i*s+row) + col*n_rows];
+                }
+            }
+            W.Multiply('N', 'N', 1.0, *V[i], H_block, 1.0);
+        }
+        apply_preconditioner(W, Z);
+        solutions.Update(1.0, Z, 1.0);
+
+        compute_residual();
+        converged = check_convergence(max_relative_residual);
+    }
+
+    return {iteration, max_relative_residual};
+}
+
+} // PHiLiP namespace
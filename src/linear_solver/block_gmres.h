@@ -0,0 +1,44 @@
+#ifndef __BLOCK_GMRES_H__
+#define __BLOCK_GMRES_H__
+
+#include <utility>
+
+#include <Epetra_Operator.h>
+#include <Epetra_MultiVector.h>
+
+namespace PHiLiP {
+
+/// Solves A X = B for all the columns of B together with a right-preconditioned block GMRES.
+/** All the right-hand sides share a single block Krylov space, such that each application of the
+ *  operator and of the preconditioner acts on all the columns at once, and the search directions
+ *  found for one right-hand side also serve the others.
+ *
+ *  The Krylov basis is restarted every @p n_blocks_before_restart block iterations, which requires
+ *  storing (n_blocks_before_restart+1) times the number of columns of B vectors. Callers with many
+ *  right-hand sides should therefore solve them in chunks.
+ *
+ *  Linearly dependent directions, including zero right-hand sides, are dropped from the basis.
+ *
+ *  @param[in] system_operator Operator A.
+ *  @param[in] preconditioner Preconditioner applied through ApplyInverse(). No preconditioning if nullptr.
+ *  @param[in] right_hand_sides Multi-vector B.
+ *  @param[in,out] solutions Multi-vector X, containing the initial guess on input.
+ *  @param[in] n_blocks_before_restart Number of block iterations before restarting.
+ *  @param[in] max_iterations Maximum number of block iterations.
+ *  @param[in] relative_tolerance Each column k is converged when ||B_k - A X_k|| <= relative_tolerance * ||B_k||.
+ *
+ *  Returns the number of block iterations and the largest relative residual.
+ */
+std::pair<unsigned int, double>
+solve_block_gmres (
+    const Epetra_Operator &system_operator,
+    const Epetra_Operator *const preconditioner,
+    const Epetra_MultiVector &right_hand_sides,
+    Epetra_MultiVector &solutions,
+    const unsigned int n_blocks_before_restart,
+    const unsigned int max_iterations,
+    const double relative_tolerance);
+
+} // PHiLiP namespace
+
+#endif
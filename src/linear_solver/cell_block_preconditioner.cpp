@@ -0,0 +1,371 @@
+#include <algorithm>
+#include <map>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/lac/trilinos_index_access.h>
+
+#include <Epetra_BLAS.h>
+#include <Epetra_LAPACK.h>
+#include <Epetra_Vector.h>
+
+#include "cell_block_preconditioner.h"
+
+namespace PHiLiP {
+
+CellBlockPreconditioner::CellBlockPreconditioner(const PreconditionerEnum preconditioner_type)
+    : preconditioner_type(preconditioner_type)
+    , matrix(nullptr)
+    , use_transpose(false)
+{
+    Assert(preconditioner_type == PreconditionerEnum::block_jacobi || preconditioner_type == PreconditionerEnum::block_ilu,
+           dealii::ExcMessage("CellBlockPreconditioner only supports block_jacobi and block_ilu."));
+}
+
+int CellBlockPreconditioner::block_size (const int iblock) const
+{
+    return block_start[iblock+1] - block_start[iblock];
+}
+
+unsigned int CellBlockPreconditioner::n_blocks () const
+{
+    return block_start.empty() ? 0 : block_start.size()-1;
+}
+
+int CellBlockPreconditioner::find_neighbour (const int iblock, const int jblock) const
+{
+    const auto first = neighbour_blocks.begin() + neighbour_start[iblock];
+    const auto last  = neighbour_blocks.begin() + neighbour_start[iblock+1];
+    const auto it = std::lower_bound(first, last, jblock);
+    if (it == last || *it != jblock) return -1;
+    return static_cast<int>(it - neighbour_blocks.begin());
+}
+
+void CellBlockPreconditioner::initialize (const Epetra_CrsMatrix &input_matrix)
+{
+    matrix = &input_matrix;
+    const Epetra_Map &row_map = matrix->RowMap();
+    const Epetra_Map &col_map = matrix->ColMap();
+    const int n_rows = matrix->NumMyRows();
+
+    // Local row of each local column, -1 if the column is owned by another process.
+    std::vector<int> col_to_row(col_map.NumMyElements());
+    for (int col = 0; col < col_map.NumMyElements(); ++col) {
+        const dealii::TrilinosWrappers::types::int_type global_col = dealii::TrilinosWrappers::global_index(col_map, col);
+        col_to_row[col] = row_map.LID(global_col);
+    }
+
+    // Group the rows sharing the same sparsity pattern into cell blocks.
+    // Blocks are numbered by order of appearance to follow the DoF ordering.
+    std::vector<int> row_block(n_rows);
+    int n_blocks_local = 0;
+    {
+        std::map<std::vector<int>, int> pattern_to_block;
+        std::vector<int> pattern;
+        for (int row = 0; row < n_rows; ++row) {
+            int n_entries; double *values; int *indices;
+            matrix->ExtractMyRowView(row, n_entries, values, indices);
+            pattern.assign(indices, indices+n_entries);
+            std::sort(pattern.begin(), pattern.end());
+            const auto inserted = pattern_to_block.emplace(pattern, n_blocks_local);
+            if (inserted.second) ++n_blocks_local;
+            row_block[row] = inserted.first->second;
+        }
+    }
+
+    block_start.assign(n_blocks_local+1, 0);
+    for (int row = 0; row < n_rows; ++row) ++block_start[row_block[row]+1];
+    for (int iblock = 0; iblock < n_blocks_local; ++iblock) block_start[iblock+1] += block_start[iblock];
+
+    block_rows.resize(n_rows);
+    std::vector<int> row_position(n_rows);
+    {
+        std::vector<int> n_filled(n_blocks_local, 0);
+        for (int row = 0; row < n_rows; ++row) {
+            const int iblock = row_block[row];
+            row_position[row] = n_filled[iblock]++;
+            block_rows[block_start[iblock] + row_position[row]] = row;
+        }
+    }
+
+    diagonal_start.assign(n_blocks_local+1, 0);
+    for (int iblock = 0; iblock < n_blocks_local; ++iblock) {
+        const std::size_t n = block_size(iblock);
+        diagonal_start[iblock+1] = diagonal_start[iblock] + n*n;
+    }
+    diagonal_blocks.assign(diagonal_start.back(), 0.0);
+    pivots.assign(n_rows, 0);
+
+    const bool use_block_ilu = (preconditioner_type == PreconditionerEnum::block_ilu);
+    neighbour_start.assign(n_blocks_local+1, 0);
+    neighbour_blocks.clear();
+    off_diagonal_start.assign(1, 0);
+    if (use_block_ilu) {
+        // Since all the rows of a block share the same pattern, the first row gives the neighbours.
+        std::vector<int> neighbours;
+        for (int iblock = 0; iblock < n_blocks_local; ++iblock) {
+            int n_entries; double *values; int *indices;
+            matrix->ExtractMyRowView(block_rows[block_start[iblock]], n_entries, values, indices);
+            neighbours.clear();
+            for (int ientry = 0; ientry < n_entries; ++ientry) {
+                const int row = col_to_row[indices[ientry]];
+                if (row < 0) continue;
+                const int jblock = row_block[row];
+                if (jblock != iblock) neighbours.push_back(jblock);
+            }
+            std::sort(neighbours.begin(), neighbours.end());
+            neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+
+            neighbour_start[iblock+1] = neighbour_start[iblock] + neighbours.size();
+            for (const int jblock : neighbours) {
+                neighbour_blocks.push_back(jblock);
+                const std::size_t n_block_entries = block_size(iblock) * block_size(jblock);
+                off_diagonal_start.push_back(off_diagonal_start.back() + n_block_entries);
+            }
+        }
+    }
+    off_diagonal_blocks.assign(off_diagonal_start.back(), 0.0);
+
+    // Scatter the matrix entries into the dense blocks.
+    for (int row = 0; row < n_rows; ++row) {
+        const int iblock = row_block[row];
+        const int n_i = block_size(iblock);
+        const int irow = row_position[row];
+        int n_entries; double *values; int *indices;
+        matrix->ExtractMyRowView(row, n_entries, values, indices);
+        for (int ientry = 0; ientry < n_entries; ++ientry) {
+            const int col_row = col_to_row[indices[ientry]];
+            if (col_row < 0) continue;
+            const int jblock = row_block[col_row];
+            const int jcol = row_position[col_row];
+            if (jblock == iblock) {
+                diagonal_blocks[diagonal_start[iblock] + jcol*n_i + irow] = values[ientry];
+            } else if (use_block_ilu) {
+                const int ineighbour = find_neighbour(iblock, jblock);
+                off_diagonal_blocks[off_diagonal_start[ineighbour] + jcol*n_i + irow] = values[ientry];
+            }
+        }
+    }
+
+    if (use_block_ilu) {
+        factorize_block_ilu();
+    } else {
+        Epetra_LAPACK lapack;
+        for (int iblock = 0; iblock < n_blocks_local; ++iblock) {
+            const int n_i = block_size(iblock);
+            int info = 0;
+            lapack.GETRF(n_i, n_i, &diagonal_blocks[diagonal_start[iblock]], n_i, &pivots[block_start[iblock]], &info);
+            AssertThrow(info == 0, dealii::ExcMessage("Singular diagonal block in CellBlockPreconditioner."));
+        }
+    }
+}
+
+void CellBlockPreconditioner::factorize_block_ilu ()
+{
+    Epetra_BLAS blas;
+    Epetra_LAPACK lapack;
+    std::vector<double> transposed_block;
+
+    const int n_blocks_local = n_blocks();
+    for (int iblock = 0; iblock < n_blocks_local; ++iblock) {
+        const int n_i = block_size(iblock);
+        double *diagonal_i = &diagonal_blocks[diagonal_start[iblock]];
+
+        for (int ineighbour = neighbour_start[iblock]; ineighbour < neighbour_start[iblock+1]; ++ineighbour) {
+            const int jblock = neighbour_blocks[ineighbour];
+            if (jblock > iblock) break;
+            const int n_j = block_size(jblock);
+
+            // L_ij = A_ij A_jj^{-1}, evaluated as the multiple right-hand side solve A_jj^T L_ij^T = A_ij^T.
+            double *block_ij = &off_diagonal_blocks[off_diagonal_start[ineighbour]];
+            transposed_block.resize(n_i*n_j);
+            for (int irow = 0; irow < n_i; ++irow) {
+                for (int jcol = 0; jcol < n_j; ++jcol) {
+                    transposed_block[irow*n_j + jcol] = block_ij[jcol*n_i + irow];
+                }
+            }
+            int info = 0;
+            lapack.GETRS('T', n_j, n_i, &diagonal_blocks[diagonal_start[jblock]], n_j, &pivots[block_start[jblock]], transposed_block.data(), n_j, &info);
+            for (int irow = 0; irow < n_i; ++irow) {
+                for (int jcol = 0; jcol < n_j; ++jcol) {
+                    block_ij[jcol*n_i + irow] = transposed_block[irow*n_j + jcol];
+                }
+            }
+
+            // A_ik -= L_ij U_jk for the blocks k > j within the pattern of block i.
+            for (int jneighbour = neighbour_start[jblock]; jneighbour < neighbour_start[jblock+1]; ++jneighbour) {
+                const int kblock = neighbour_blocks[jneighbour];
+                if (kblock < jblock) continue;
+                const int n_k = block_size(kblock);
+                const double *block_jk = &off_diagonal_blocks[off_diagonal_start[jneighbour]];
+
+                double *block_ik = nullptr;
+                if (kblock == iblock) {
+                    block_ik = diagonal_i;
+                } else {
+                    const int kneighbour = find_neighbour(iblock, kblock);
+                    if (kneighbour < 0) continue; // Fill-in is dropped.
+                    block_ik = &off_diagonal_blocks[off_diagonal_start[kneighbour]];
+                }
+                blas.GEMM('N', 'N', n_i, n_k, n_j, -1.0, block_ij, n_i, block_jk, n_j, 1.0, block_ik, n_i);
+            }
+        }
+
+        int info = 0;
+        lapack.GETRF(n_i, n_i, diagonal_i, n_i, &pivots[block_start[iblock]], &info);
+        AssertThrow(info == 0, dealii::ExcMessage("Singular diagonal block in CellBlockPreconditioner."));
+    }
+}
+
+int CellBlockPreconditioner::ApplyInverse (const Epetra_MultiVector &X, Epetra_MultiVector &Y) const
+{
+    Assert(matrix != nullptr, dealii::ExcMessage("CellBlockPreconditioner has not been initialized."));
+    Epetra_BLAS blas;
+    Epetra_LAPACK lapack;
+
+    const int n_vectors = X.NumVectors();
+    const int n_blocks_local = n_blocks();
+
+    // Gather the vectors block by block, each block being a column-major n_i x n_vectors matrix.
+    workspace.resize(block_rows.size() * n_vectors);
+    for (int iblock = 0; iblock < n_blocks_local; ++iblock) {
+        const int n_i = block_size(iblock);
+        double *w_i = &workspace[block_start[iblock]*n_vectors];
+        for (int ivec = 0; ivec < n_vectors; ++ivec) {
+            for (int irow = 0; irow < n_i; ++irow) {
+                w_i[ivec*n_i + irow] = X[ivec][block_rows[block_start[iblock]+irow]];
+            }
+        }
+    }
+
+    if (preconditioner_type == PreconditionerEnum::block_ilu && use_transpose) {
+        // Forward substitution with U^T, scattering the solved block into the blocks that follow.
+        for (int iblock = 0; iblock < n_blocks_local; ++iblock) {
+            const int n_i = block_size(iblock);
+            double *w_i = &workspace[block_start[iblock]*n_vectors];
+            int info = 0;
+            lapack.GETRS('T', n_i, n_vectors, &diagonal_blocks[diagonal_start[iblock]], n_i, &pivots[block_start[iblock]], w_i, n_i, &info);
+            for (int ineighbour = neighbour_start[iblock]; ineighbour < neighbour_start[iblock+1]; ++ineighbour) {
+                const int kblock = neighbour_blocks[ineighbour];
+                if (kblock < iblock) continue;
+                const int n_k = block_size(kblock);
+                double *w_k = &workspace[block_start[kblock]*n_vectors];
+                blas.GEMM('T', 'N', n_k, n_vectors, n_i, -1.0, &off_diagonal_blocks[off_diagonal_start[ineighbour]], n_i, w_i, n_i, 1.0, w_k, n_k);
+            }
+        }
+        // Backward substitution with the unit L^T, scattering the solved block into the blocks that precede.
+        for (int iblock = n_blocks_local-1; iblock >= 0; --iblock) {
+            const int n_i = block_size(iblock);
+            const double *w_i = &workspace[block_start[iblock]*n_vectors];
+            for (int ineighbour = neighbour_start[iblock]; ineighbour < neighbour_start[iblock+1]; ++ineighbour) {
+                const int jblock = neighbour_blocks[ineighbour];
+                if (jblock > iblock) break;
+                const int n_j = block_size(jblock);
+                double *w_j = &workspace[block_start[jblock]*n_vectors];
+                blas.GEMM('T', 'N', n_j, n_vectors, n_i, -1.0, &off_diagonal_blocks[off_diagonal_start[ineighbour]], n_i, w_i, n_i, 1.0, w_j, n_j);
+            }
+        }
+    } else if (preconditioner_type == PreconditionerEnum::block_ilu) {
+        // Forward substitution with the unit block lower triangular factor.
+        for (int iblock = 0; iblock < n_blocks_local; ++iblock) {
+            const int n_i = block_size(iblock);
+            double *w_i = &workspace[block_start[iblock]*n_vectors];
+            for (int ineighbour = neighbour_start[iblock]; ineighbour < neighbour_start[iblock+1]; ++ineighbour) {
+                const int jblock = neighbour_blocks[ineighbour];
+                if (jblock > iblock) break;
+                const int n_j = block_size(jblock);
+                const double *w_j = &workspace[block_start[jblock]*n_vectors];
+                blas.GEMM('N', 'N', n_i, n_vectors, n_j, -1.0, &off_diagonal_blocks[off_diagonal_start[ineighbour]], n_i, w_j, n_j, 1.0, w_i, n_i);
+            }
+        }
+        // Backward substitution with the block upper triangular factor.
+        for (int iblock = n_blocks_local-1; iblock >= 0; --iblock) {
+            const int n_i = block_size(iblock);
+            double *w_i = &workspace[block_start[iblock]*n_vectors];
+            for (int ineighbour = neighbour_start[iblock]; ineighbour < neighbour_start[iblock+1]; ++ineighbour) {
+                const int kblock = neighbour_blocks[ineighbour];
+                if (kblock < iblock) continue;
+                const int n_k = block_size(kblock);
+                const double *w_k = &workspace[block_start[kblock]*n_vectors];
+                blas.GEMM('N', 'N', n_i, n_vectors, n_k, -1.0, &off_diagonal_blocks[off_diagonal_start[ineighbour]], n_i, w_k, n_k, 1.0, w_i, n_i);
+            }
+            int info = 0;
+            lapack.GETRS('N', n_i, n_vectors, &diagonal_blocks[diagonal_start[iblock]], n_i, &pivots[block_start[iblock]], w_i, n_i, &info);
+        }
+    } else {
+        for (int iblock = 0; iblock < n_blocks_local; ++iblock) {
+            const int n_i = block_size(iblock);
+            double *w_i = &workspace[block_start[iblock]*n_vectors];
+            int info = 0;
+            lapack.GETRS(use_transpose ? 'T' : 'N', n_i, n_vectors, &diagonal_blocks[diagonal_start[iblock]], n_i, &pivots[block_start[iblock]], w_i, n_i, &info);
+        }
+    }
+
+    // Scatter back.
+    for (int iblock = 0; iblock < n_blocks_local; ++iblock) {
+        const int n_i = block_size(iblock);
+        const double *w_i = &workspace[block_start[iblock]*n_vectors];
+        for (int ivec = 0; ivec < n_vectors; ++ivec) {
+            for (int irow = 0; irow < n_i; ++irow) {
+                Y[ivec][block_rows[block_start[iblock]+irow]] = w_i[ivec*n_i + irow];
+            }
+        }
+    }
+    return 0;
+}
+
+void CellBlockPreconditioner::vmult (
+    dealii::LinearAlgebra::distributed::Vector<double> &dst,
+    const dealii::LinearAlgebra::distributed::Vector<double> &src) const
+{
+    Epetra_Vector src_epetra(View, OperatorDomainMap(), const_cast<double *>(src.begin()));
+    Epetra_Vector dst_epetra(View, OperatorRangeMap(), dst.begin());
+    ApplyInverse(src_epetra, dst_epetra);
+}
+
+int CellBlockPreconditioner::SetUseTranspose (bool use_transpose_input)
+{
+    use_transpose = use_transpose_input;
+    return 0;
+}
+
+int CellBlockPreconditioner::Apply (const Epetra_MultiVector &/*X*/, Epetra_MultiVector &/*Y*/) const
+{
+    return -1;
+}
+
+double CellBlockPreconditioner::NormInf () const
+{
+    return -1.0;
+}
+
+const char * CellBlockPreconditioner::Label () const
+{
+    return (preconditioner_type == PreconditionerEnum::block_ilu) ? "PHiLiP block ILU(0)" : "PHiLiP block Jacobi";
+}
+
+bool CellBlockPreconditioner::UseTranspose () const
+{
+    return use_transpose;
+}
+
+bool CellBlockPreconditioner::HasNormInf () const
+{
+    return false;
+}
+
+const Epetra_Comm & CellBlockPreconditioner::Comm () const
+{
+    return matrix->Comm();
+}
+
+const Epetra_Map & CellBlockPreconditioner::OperatorDomainMap () const
+{
+    return matrix->OperatorDomainMap();
+}
+
+const Epetra_Map & CellBlockPreconditioner::OperatorRangeMap () const
+{
+    return matrix->OperatorRangeMap();
+}
+
+} // PHiLiP namespace
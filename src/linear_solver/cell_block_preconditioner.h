@@ -0,0 +1,136 @@
+#ifndef __CELL_BLOCK_PRECONDITIONER_H__
+#define __CELL_BLOCK_PRECONDITIONER_H__
+
+#include <vector>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <Epetra_Operator.h>
+#include <Epetra_CrsMatrix.h>
+#include <Epetra_MultiVector.h>
+#include <Epetra_Map.h>
+#include <Epetra_Comm.h>
+
+#include "parameters/parameters_linear_solver.h"
+
+namespace PHiLiP {
+
+/// Dense cell-block preconditioner for DG Jacobians.
+/** The DG Jacobian is made of dense blocks of size nstate*(p+1)^dim coupling a cell with itself
+ *  and its face neighbours. All the rows of a cell therefore share the exact same sparsity pattern,
+ *  which is used to recover the cell blocks directly from the Epetra matrix, independently of
+ *  the DoF renumbering and of the (hp-varying) block sizes.
+ *
+ *  The diagonal and off-diagonal blocks are stored contiguously in column-major order such that
+ *  the factorization and the triangular solves are done with LAPACK/BLAS-3 calls on each block.
+ *
+ *  Two factorizations are available:
+ *  - block_jacobi: Only the diagonal blocks are LU-factored.
+ *  - block_ilu: Block ILU(0) where the fill-in outside of the cell-neighbour blocks is dropped.
+ *
+ *  Couplings with cells owned by other processes are dropped, resulting in a non-overlapping
+ *  additive Schwarz preconditioner in parallel.
+ *
+ *  SetUseTranspose(true) applies the inverse of the transposed factors instead, which preconditions
+ *  the transposed (adjoint) system without factoring the transposed matrix.
+ *
+ *  Can be given to AztecOO through SetPrecOperator() or to deal.II solvers through vmult().
+ */
+class CellBlockPreconditioner : public Epetra_Operator
+{
+public:
+    /// Type of block factorization.
+    using PreconditionerEnum = Parameters::LinearSolverParam::PreconditionerEnum;
+
+    /// Constructor.
+    /** @param[in] preconditioner_type Either block_jacobi or block_ilu.
+     */
+    CellBlockPreconditioner(const PreconditionerEnum preconditioner_type);
+
+    /// Destructor.
+    ~CellBlockPreconditioner() {};
+
+    /// Extracts the cell blocks of @p matrix and factorizes them.
+    /** The matrix must outlive the preconditioner since its maps and communicator are used.
+     */
+    void initialize (const Epetra_CrsMatrix &matrix);
+
+    /// Number of cell blocks owned by this process.
+    unsigned int n_blocks () const;
+
+    /// Applies the preconditioner on deal.II vectors, dst = M^{-1} src.
+    void vmult (dealii::LinearAlgebra::distributed::Vector<double> &dst,
+                const dealii::LinearAlgebra::distributed::Vector<double> &src) const;
+
+    /// Whether ApplyInverse() applies the inverse of the transposed factors.
+    int SetUseTranspose (bool use_transpose) override;
+    /// Application of the approximate matrix is not supported. Returns -1.
+    int Apply (const Epetra_MultiVector &X, Epetra_MultiVector &Y) const override;
+    /// Applies the preconditioner, Y = M^{-1} X. X and Y may alias.
+    int ApplyInverse (const Epetra_MultiVector &X, Epetra_MultiVector &Y) const override;
+    /// Not available. Returns -1.
+    double NormInf () const override;
+    /// Label of the operator.
+    const char * Label () const override;
+    /// Whether ApplyInverse() applies the inverse of the transposed factors.
+    bool UseTranspose () const override;
+    /// Always false.
+    bool HasNormInf () const override;
+    /// Communicator of the factored matrix.
+    const Epetra_Comm & Comm () const override;
+    /// Domain map of the factored matrix.
+    const Epetra_Map & OperatorDomainMap () const override;
+    /// Range map of the factored matrix.
+    const Epetra_Map & OperatorRangeMap () const override;
+
+private:
+    /// Block Jacobi or block ILU(0).
+    const PreconditionerEnum preconditioner_type;
+
+    /// Factored matrix.
+    const Epetra_CrsMatrix *matrix;
+
+    /// Whether ApplyInverse() applies the inverse of the transposed factors.
+    bool use_transpose;
+
+    /// Index of the first row of each block within block_rows. Size n_blocks+1.
+    std::vector<int> block_start;
+    /// Local rows grouped by block.
+    std::vector<int> block_rows;
+
+    /// Start of each diagonal block within diagonal_blocks. Size n_blocks+1.
+    std::vector<std::size_t> diagonal_start;
+    /// LU-factored diagonal blocks, stored contiguously in column-major order.
+    std::vector<double> diagonal_blocks;
+    /// LAPACK pivots of the diagonal blocks, indexed as block_rows.
+    std::vector<int> pivots;
+
+    /// Index of the first neighbour of each block within neighbour_blocks. Size n_blocks+1.
+    /** Only used by block_ilu. */
+    std::vector<int> neighbour_start;
+    /// Sorted neighbour blocks of each block.
+    std::vector<int> neighbour_blocks;
+    /// Start of each off-diagonal block within off_diagonal_blocks.
+    std::vector<std::size_t> off_diagonal_start;
+    /// Off-diagonal blocks of the block ILU(0) factors, stored contiguously in column-major order.
+    /** The blocks with a neighbour index smaller than the block index hold the L factor, while
+     *  the others hold the U factor.
+     */
+    std::vector<double> off_diagonal_blocks;
+
+    /// Gathered block vectors used during ApplyInverse.
+    mutable std::vector<double> workspace;
+
+    /// Size of block @p iblock.
+    int block_size (const int iblock) const;
+
+    /// Returns the index of @p jblock within neighbour_blocks of @p iblock, -1 if not a neighbour.
+    int find_neighbour (const int iblock, const int jblock) const;
+
+    /// Computes the block ILU(0) factorization from the assembled blocks.
+    void factorize_block_ilu ();
+};
+
+} // PHiLiP namespace
+
+#endif
@@ -6,12 +6,16 @@
 
 #include "Ifpack.h"
 #include <Ifpack_ILU.h>
+#include <Amesos.h>
+#include <Amesos_BaseSolver.h>
+#include <Epetra_LinearProblem.h>
 
 #include <deal.II/lac/solver_gmres.h>
 
 #include "linear_solver.h"
+#include "cell_block_preconditioner.h"
 
-#include "global_counter.hpp"
+#include "telemetry/telemetry.h"
 
 namespace PHiLiP {
 
@@ -109,6 +113,33 @@ public:
     };
 };
 
+namespace {
+/// Adds the estimated work of @p n_products local sparse matrix-vector products to the active telemetry region.
+/** Each stored entry costs a multiply-add, and loads an 8-byte value and a 4-byte column index. */
+void add_matrix_vector_products_work (const dealii::TrilinosWrappers::SparseMatrix &matrix, const unsigned int n_products)
+{
+    const double n_local_nonzeros = matrix.trilinos_matrix().NumMyNonzeros();
+    Telemetry::add_work(2.0 * n_local_nonzeros * n_products, 12.0 * n_local_nonzeros * n_products);
+}
+
+/// Creates the dense DG cell-block preconditioner of LinearSolverParam::preconditioner_type, to be initialized.
+/** The p-multigrid preconditioner needs the DG hierarchy and is only available through
+ *  LinearSolver::set_preconditioner(). Otherwise, block_ilu is used instead.
+ */
+std::unique_ptr<CellBlockPreconditioner> create_block_preconditioner (const Parameters::LinearSolverParam &param)
+{
+    using PreconditionerEnum = Parameters::LinearSolverParam::PreconditionerEnum;
+    Assert(param.preconditioner_type != PreconditionerEnum::ilu, dealii::ExcMessage("ILU is not a cell-block preconditioner."));
+    PreconditionerEnum block_preconditioner_type = param.preconditioner_type;
+    if (block_preconditioner_type == PreconditionerEnum::p_multigrid) {
+        dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+        pcout << " p-multigrid preconditioner needs the DG hierarchy, using block_ilu instead." << std::endl;
+        block_preconditioner_type = PreconditionerEnum::block_ilu;
+    }
+    return std::make_unique<CellBlockPreconditioner>(block_preconditioner_type);
+}
+} // anonymous namespace
+
 std::pair<unsigned int, double>
 solve_linear3 (
     const dealii::TrilinosWrappers::SparseMatrix &system_matrix,
@@ -170,6 +201,18 @@ solve_linear (
     dealii::LinearAlgebra::distributed::Vector<double> &solution,
     const Parameters::LinearSolverParam &param)
 {
+    return solve_linear (system_matrix, right_hand_side, solution, param, nullptr);
+}
+
+std::pair<unsigned int, double>
+solve_linear (
+    const dealii::TrilinosWrappers::SparseMatrix &system_matrix,
+    dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
+    dealii::LinearAlgebra::distributed::Vector<double> &solution,
+    const Parameters::LinearSolverParam &param,
+    Epetra_Operator *const preconditioner)
+{
+    const Telemetry::ScopedTimer timer("linear_solve");
 
     // if (pcout.is_active()) system_matrix.print(pcout.get_stream(), true);
     // if (pcout.is_active()) solution.print(pcout.get_stream());
@@ -232,7 +275,18 @@ solve_linear (
         solver.SetAztecOption(AZ_overlap, 1);
         solver.SetAztecOption(AZ_reorder, 1); // RCM re-ordering
         const int ilut_fill = param.ilut_fill;
-        if (ilut_fill < -99) {
+        // Dense DG cell-block preconditioner. Declared here since AztecOO only stores a pointer to it.
+        std::unique_ptr<CellBlockPreconditioner> cell_block_preconditioner;
+        using PreconditionerEnum = Parameters::LinearSolverParam::PreconditionerEnum;
+        if (preconditioner) {
+            solver.SetPrecOperator(preconditioner);
+        } else if (param.preconditioner_type != PreconditionerEnum::ilu) {
+            const Telemetry::ScopedTimer preconditioner_timer("preconditioner_setup");
+            cell_block_preconditioner = create_block_preconditioner(param);
+            cell_block_preconditioner->initialize(system_matrix.trilinos_matrix());
+            // Overrides AZ_precond with the user-defined preconditioner.
+            solver.SetPrecOperator(cell_block_preconditioner.get());
+        } else if (ilut_fill < -99) {
             // // Jacobi preconditioner.
             //solver.SetAztecOption(AZ_precond, AZ_Jacobi);
             //solver.SetAztecOption(AZ_poly_ord, 1);
@@ -276,10 +330,11 @@ solve_linear (
               << " Current RHS norm: " << right_hand_side.l2_norm()
               << " Linear solution norm: " << solution.l2_norm() << std::endl;
 
-        //n_vmult += 3*solver.NumIters();
-        //dRdW_mult += 3*solver.NumIters();
-        n_vmult += 7*solver.NumIters();
-        dRdW_mult += 7*solver.NumIters();
+        //Telemetry::add_to_counter(Telemetry::n_vmult, 3*solver.NumIters());
+        //Telemetry::add_to_counter(Telemetry::dRdW_mult, 3*solver.NumIters());
+        Telemetry::add_to_counter(Telemetry::n_vmult, 7*solver.NumIters());
+        Telemetry::add_to_counter(Telemetry::dRdW_mult, 7*solver.NumIters());
+        add_matrix_vector_products_work(system_matrix, n_iterations);
 
         //std::abort();
         return {solver.NumIters(), solver.TrueResidual()};
@@ -288,4 +343,416 @@ solve_linear (
 }
 
 
+namespace {
+/// Wraps an Epetra_Operator preconditioner such that deal.II solvers can apply it on deal.II vectors.
+/** A nullptr results in the identity. */
+class EpetraPreconditionerWrapper
+{
+public:
+    /// Constructor.
+    EpetraPreconditionerWrapper(const Epetra_Operator *const preconditioner)
+    : preconditioner(preconditioner)
+    {};
+
+    /// Applies the preconditioner, dst = M^{-1} src.
+    void vmult (dealii::LinearAlgebra::distributed::Vector<double> &dst,
+                const dealii::LinearAlgebra::distributed::Vector<double> &src) const
+    {
+        if (!preconditioner) {
+            dst = src;
+            return;
+        }
+        Epetra_Vector src_view(View, preconditioner->OperatorDomainMap(), const_cast<double *>(src.begin()));
+        Epetra_Vector dst_view(View, preconditioner->OperatorRangeMap(), dst.begin());
+        const int ierr = preconditioner->ApplyInverse(src_view, dst_view);
+        AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+    };
+
+private:
+    /// Wrapped preconditioner.
+    const Epetra_Operator *const preconditioner;
+};
+
+/// Wraps a matrix such that deal.II solvers apply its transpose.
+class TransposedMatrix
+{
+public:
+    /// Constructor.
+    TransposedMatrix(const dealii::TrilinosWrappers::SparseMatrix &matrix)
+    : matrix(matrix)
+    {};
+
+    /// Applies the transpose, dst = A^T src.
+    void vmult (dealii::LinearAlgebra::distributed::Vector<double> &dst,
+                const dealii::LinearAlgebra::distributed::Vector<double> &src) const
+    {
+        matrix.Tvmult(dst, src);
+    };
+
+private:
+    /// Wrapped matrix.
+    const dealii::TrilinosWrappers::SparseMatrix &matrix;
+};
+
+/// Wraps a LinearSolver::VmultFunction such that deal.II solvers can apply it.
+class FunctionOperator
+{
+public:
+    /// Constructor.
+    FunctionOperator(const LinearSolver::VmultFunction &vmult_function)
+    : vmult_function(vmult_function)
+    {};
+
+    /// Applies the operator, dst = A src.
+    void vmult (dealii::LinearAlgebra::distributed::Vector<double> &dst,
+                const dealii::LinearAlgebra::distributed::Vector<double> &src) const
+    {
+        vmult_function(dst, src);
+    };
+
+private:
+    /// Wrapped operator.
+    const LinearSolver::VmultFunction &vmult_function;
+};
+
+/// Creates the Ifpack ILU(k)/ILUT preconditioner of @p epetra_matrix, to be initialized and computed.
+/** Same settings as AztecOO's domain decomposition in solve_linear(). */
+std::unique_ptr<Ifpack_Preconditioner> create_ilu_preconditioner (
+    const Parameters::LinearSolverParam &param,
+    const Epetra_CrsMatrix &epetra_matrix)
+{
+    const int overlap = 1;
+    Epetra_CrsMatrix *ifpack_matrix = const_cast<Epetra_CrsMatrix *>(&epetra_matrix);
+    const std::string ilu_type = (param.ilut_fill < 1) ? "ILU" : "ILUT";
+    std::unique_ptr<Ifpack_Preconditioner> ilu_preconditioner(Ifpack().Create(ilu_type, ifpack_matrix, overlap));
+    AssertThrow(ilu_preconditioner != nullptr, dealii::ExcMessage("Ifpack could not create the ILU preconditioner."));
+
+    Teuchos::ParameterList parameter_list;
+    if (param.ilut_fill < 1) {
+        parameter_list.set("fact: level-of-fill", std::abs(param.ilut_fill));
+    } else {
+        parameter_list.set("fact: ilut level-of-fill", static_cast<double>(param.ilut_fill));
+        parameter_list.set("fact: drop tolerance", param.ilut_drop);
+    }
+    parameter_list.set("fact: absolute threshold", param.ilut_atol);
+    parameter_list.set("fact: relative threshold", param.ilut_rtol);
+    parameter_list.set("schwarz: reordering type", "rcm");
+
+    const int ierr = ilu_preconditioner->SetParameters(parameter_list);
+    AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+    return ilu_preconditioner;
+}
+} // anonymous namespace
+
+LinearSolver::LinearSolver (const Parameters::LinearSolverParam &param)
+    : param(param)
+    , solver_control(param.max_iterations, param.linear_residual, false, false)
+    , external_preconditioner(nullptr)
+    , preconditioner(nullptr)
+    , preconditioned_matrix(nullptr)
+    , preconditioned_nonzeros(-1)
+    , update_requested(true)
+    , n_solves_since_update(0)
+    , reference_iterations(0)
+    , n_updates(0)
+{
+    if (param.linear_solver_type == Parameters::LinearSolverParam::LinearSolverEnum::gmres) {
+        const bool right_preconditioning = true;
+        const bool use_default_residual = true;
+        const bool force_re_orthogonalization = false;
+        typename dealii::SolverGMRES<VectorType>::AdditionalData add_data_gmres(
+            param.restart_number, right_preconditioning, use_default_residual, force_re_orthogonalization);
+        solver_gmres = std::make_unique<dealii::SolverGMRES<VectorType>>(solver_control, vector_memory, add_data_gmres);
+    }
+}
+
+void LinearSolver::set_preconditioner (
+    Epetra_Operator *const preconditioner,
+    const std::function<void (const dealii::TrilinosWrappers::SparseMatrix &)> &update_preconditioner)
+{
+    external_preconditioner = preconditioner;
+    update_external_preconditioner = update_preconditioner;
+    force_preconditioner_update();
+}
+
+void LinearSolver::force_preconditioner_update ()
+{
+    update_requested = true;
+}
+
+void LinearSolver::invalidate_preconditioner ()
+{
+    ilu_preconditioner.reset();
+    block_preconditioner.reset();
+    preconditioner = nullptr;
+    preconditioned_matrix = nullptr;
+    preconditioned_nonzeros = -1;
+    force_preconditioner_update();
+}
+
+unsigned int LinearSolver::n_preconditioner_updates () const
+{
+    return n_updates;
+}
+
+bool LinearSolver::preconditioner_needs_update (const dealii::TrilinosWrappers::SparseMatrix &system_matrix) const
+{
+    if (update_requested) return true;
+    if (n_solves_since_update >= param.preconditioner_update_lag) return true;
+
+    // Sparsity change. Re-allocations that keep the address and the number of non-zeros
+    // must be signaled through invalidate_preconditioner().
+    const Epetra_CrsMatrix &epetra_matrix = system_matrix.trilinos_matrix();
+    if (&epetra_matrix != preconditioned_matrix) return true;
+    if (epetra_matrix.NumGlobalNonzeros64() != preconditioned_nonzeros) return true;
+
+    return false;
+}
+
+void LinearSolver::update_preconditioner (const dealii::TrilinosWrappers::SparseMatrix &system_matrix)
+{
+    const Telemetry::ScopedTimer timer("preconditioner_setup");
+
+    const Epetra_CrsMatrix &epetra_matrix = system_matrix.trilinos_matrix();
+    const bool sparsity_changed = (&epetra_matrix != preconditioned_matrix)
+                                  || (epetra_matrix.NumGlobalNonzeros64() != preconditioned_nonzeros);
+
+    using PreconditionerEnum = Parameters::LinearSolverParam::PreconditionerEnum;
+    if (external_preconditioner) {
+        update_external_preconditioner(system_matrix);
+        preconditioner = external_preconditioner;
+    } else if (param.preconditioner_type != PreconditionerEnum::ilu) {
+        // The cell blocks are re-extracted at every initialization.
+        if (!block_preconditioner) block_preconditioner = create_block_preconditioner(param);
+        block_preconditioner->initialize(epetra_matrix);
+        preconditioner = block_preconditioner.get();
+    } else if (param.ilut_fill < -99) {
+        // No preconditioner.
+        preconditioner = nullptr;
+    } else {
+        if (sparsity_changed || !ilu_preconditioner) {
+            ilu_preconditioner = create_ilu_preconditioner(param, epetra_matrix);
+        }
+        // Initialize() also re-imports the overlapping rows, whose values may have changed.
+        int ierr = ilu_preconditioner->Initialize();
+        AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+        ierr = ilu_preconditioner->Compute();
+        AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+        preconditioner = ilu_preconditioner.get();
+    }
+
+    preconditioned_matrix = &epetra_matrix;
+    preconditioned_nonzeros = epetra_matrix.NumGlobalNonzeros64();
+    update_requested = false;
+    n_solves_since_update = 0;
+    reference_iterations = 0;
+    ++n_updates;
+}
+
+template <typename OperatorType>
+bool LinearSolver::solve_gmres (
+    const OperatorType &system_operator,
+    const VectorType &right_hand_side,
+    VectorType &solution)
+{
+    solution *= 0.0;
+    const EpetraPreconditionerWrapper preconditioner_wrapper(preconditioner);
+    bool converged = true;
+    try {
+        solver_gmres->solve(system_operator, solution, right_hand_side, preconditioner_wrapper);
+    } catch (const dealii::SolverControl::NoConvergence &e) {
+        converged = false;
+    }
+    return converged;
+}
+
+template <typename OperatorType>
+std::pair<unsigned int, double>
+LinearSolver::solve_preconditioned (
+    const dealii::TrilinosWrappers::SparseMatrix &preconditioner_matrix,
+    const OperatorType &system_operator,
+    VectorType &right_hand_side,
+    VectorType &solution,
+    const bool retry_with_updated_preconditioner)
+{
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+
+    const double rhs_norm = right_hand_side.l2_norm();
+    const double linear_residual = param.linear_residual * rhs_norm;
+    solver_control.set_max_steps(param.max_iterations);
+    solver_control.set_tolerance(linear_residual);
+    pcout << " Solving linear system with max_iterations = " << param.max_iterations
+          << " and linear residual tolerance: " << linear_residual << std::endl;
+
+    bool updated = false;
+    if (preconditioner_needs_update(preconditioner_matrix)) {
+        update_preconditioner(preconditioner_matrix);
+        updated = true;
+    }
+
+    bool converged = solve_gmres(system_operator, right_hand_side, solution);
+    unsigned int n_iterations = solver_control.last_step();
+
+    // A lagged preconditioner may simply be too stale.
+    if (!converged && !updated) {
+        if (retry_with_updated_preconditioner) {
+            pcout << " Linear solver did not converge with a preconditioner lagged by " << n_solves_since_update
+                  << " solves. Updating the preconditioner." << std::endl;
+            update_preconditioner(preconditioner_matrix);
+            converged = solve_gmres(system_operator, right_hand_side, solution);
+            n_iterations += solver_control.last_step();
+        } else {
+            update_requested = true;
+        }
+    }
+    if (!converged) pcout << " Linear solver did not converge." << std::endl;
+    ++n_solves_since_update;
+
+    const unsigned int last_iterations = solver_control.last_step();
+    if (n_solves_since_update == 1) {
+        reference_iterations = last_iterations;
+    } else if (last_iterations > param.preconditioner_stall_ratio * reference_iterations) {
+        update_requested = true;
+    }
+
+    pcout << " Linear solver took " << n_iterations
+          << " iterations resulting in a linear residual of " << solver_control.last_value() << std::endl
+          << " Preconditioner updates: " << n_updates
+          << " Current RHS norm: " << rhs_norm
+          << " Linear solution norm: " << solution.l2_norm() << std::endl;
+
+    return {n_iterations, solver_control.last_value()};
+}
+
+std::pair<unsigned int, double>
+LinearSolver::solve (
+    const dealii::TrilinosWrappers::SparseMatrix &system_matrix,
+    VectorType &right_hand_side,
+    VectorType &solution)
+{
+    if (param.linear_solver_type == Parameters::LinearSolverParam::LinearSolverEnum::direct) {
+        return solve_linear (system_matrix, right_hand_side, solution, param);
+    }
+    const Telemetry::ScopedTimer timer("linear_solve");
+
+    const bool retry_with_updated_preconditioner = true;
+    const std::pair<unsigned int, double> result = solve_preconditioned (system_matrix, system_matrix, right_hand_side, solution, retry_with_updated_preconditioner);
+
+    Telemetry::add_to_counter(Telemetry::n_vmult, result.first);
+    Telemetry::add_to_counter(Telemetry::dRdW_mult, result.first);
+    add_matrix_vector_products_work(system_matrix, result.first);
+    return result;
+}
+
+std::pair<unsigned int, double>
+LinearSolver::solve (
+    const dealii::TrilinosWrappers::SparseMatrix &preconditioner_matrix,
+    const VmultFunction &system_vmult,
+    VectorType &right_hand_side,
+    VectorType &solution)
+{
+    AssertThrow(solver_gmres, dealii::ExcMessage("Operators that are not assembled can only be solved with GMRES."));
+    const Telemetry::ScopedTimer timer("linear_solve");
+
+    // The preconditioner matrix is only assembled when the preconditioner needs an update,
+    // such that updating it again from the same matrix would not help.
+    const bool retry_with_updated_preconditioner = false;
+    const FunctionOperator system_operator(system_vmult);
+    return solve_preconditioned (preconditioner_matrix, system_operator, right_hand_side, solution, retry_with_updated_preconditioner);
+}
+
+std::pair<unsigned int, double>
+solve_linear_transpose (
+    const dealii::TrilinosWrappers::SparseMatrix &system_matrix,
+    dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
+    dealii::LinearAlgebra::distributed::Vector<double> &solution,
+    const Parameters::LinearSolverParam &param,
+    Epetra_Operator *const preconditioner)
+{
+    const Telemetry::ScopedTimer timer("linear_solve");
+
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+    const Epetra_CrsMatrix &epetra_matrix = system_matrix.trilinos_matrix();
+
+    if (param.linear_solver_type == Parameters::LinearSolverParam::LinearSolverEnum::direct) {
+        // The solution lives in the range of the matrix, and the right-hand side in its domain.
+        Epetra_Vector x(View, epetra_matrix.RangeMap(), solution.begin());
+        Epetra_Vector b(View, epetra_matrix.DomainMap(), right_hand_side.begin());
+        Epetra_LinearProblem linear_problem(const_cast<Epetra_CrsMatrix *>(&epetra_matrix), &x, &b);
+
+        std::unique_ptr<Amesos_BaseSolver> direct_solver(Amesos().Create("Amesos_Klu", linear_problem));
+        AssertThrow(direct_solver != nullptr, dealii::ExcMessage("Amesos could not create the KLU solver."));
+        int ierr = direct_solver->SetUseTranspose(true);
+        AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+        ierr = direct_solver->SymbolicFactorization();
+        AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+        ierr = direct_solver->NumericFactorization();
+        AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+        ierr = direct_solver->Solve();
+        AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+        return {0, 0.0};
+    }
+
+    // Preconditioners built here. The transposed solves reuse the factors of the matrix itself.
+    std::unique_ptr<CellBlockPreconditioner> cell_block_preconditioner;
+    std::unique_ptr<Ifpack_Preconditioner> ilu_preconditioner;
+    Epetra_Operator *transposed_preconditioner = preconditioner;
+    using PreconditionerEnum = Parameters::LinearSolverParam::PreconditionerEnum;
+    if (!transposed_preconditioner) {
+        const Telemetry::ScopedTimer preconditioner_timer("preconditioner_setup");
+        if (param.preconditioner_type != PreconditionerEnum::ilu) {
+            cell_block_preconditioner = create_block_preconditioner(param);
+            cell_block_preconditioner->initialize(epetra_matrix);
+            transposed_preconditioner = cell_block_preconditioner.get();
+        } else if (param.ilut_fill >= -99) {
+            ilu_preconditioner = create_ilu_preconditioner(param, epetra_matrix);
+            int ierr = ilu_preconditioner->Initialize();
+            AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+            ierr = ilu_preconditioner->Compute();
+            AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+            transposed_preconditioner = ilu_preconditioner.get();
+        }
+    }
+    if (transposed_preconditioner) {
+        const int ierr = transposed_preconditioner->SetUseTranspose(true);
+        AssertThrow(ierr == 0, dealii::ExcMessage("The preconditioner does not support transposed solves."));
+    }
+
+    const double rhs_norm = right_hand_side.l2_norm();
+    const double linear_residual = param.linear_residual * rhs_norm;
+    pcout << " Solving transposed linear system with max_iterations = " << param.max_iterations
+          << " and linear residual tolerance: " << linear_residual << std::endl;
+
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+    dealii::SolverControl solver_control(param.max_iterations, linear_residual, false, false);
+    const bool right_preconditioning = true;
+    const bool use_default_residual = true;
+    const bool force_re_orthogonalization = false;
+    typename dealii::SolverGMRES<VectorType>::AdditionalData add_data_gmres(
+        param.restart_number, right_preconditioning, use_default_residual, force_re_orthogonalization);
+    dealii::SolverGMRES<VectorType> solver_gmres(solver_control, add_data_gmres);
+
+    solution *= 0.0;
+    const TransposedMatrix transposed_matrix(system_matrix);
+    const EpetraPreconditionerWrapper preconditioner_wrapper(transposed_preconditioner);
+    try {
+        solver_gmres.solve(transposed_matrix, solution, right_hand_side, preconditioner_wrapper);
+    } catch (const dealii::SolverControl::NoConvergence &e) {
+        pcout << " Linear solver did not converge." << std::endl;
+    }
+    // An external preconditioner is also used for the forward solves.
+    if (transposed_preconditioner) transposed_preconditioner->SetUseTranspose(false);
+
+    Telemetry::add_to_counter(Telemetry::n_vmult, solver_control.last_step());
+    Telemetry::add_to_counter(Telemetry::dRdW_mult, solver_control.last_step());
+    add_matrix_vector_products_work(system_matrix, solver_control.last_step());
+
+    pcout << " Linear solver took " << solver_control.last_step()
+          << " iterations resulting in a linear residual of " << solver_control.last_value() << std::endl
+          << " Current RHS norm: " << rhs_norm
+          << " Linear solution norm: " << solution.l2_norm() << std::endl;
+
+    return {solver_control.last_step(), solver_control.last_value()};
+}
+
 } // PHiLiP namespace
@@ -1,13 +1,26 @@
 #ifndef __LINEAR_SOLVER_H__
 #define __LINEAR_SOLVER_H__
 
+#include <functional>
+#include <memory>
+
 #include <deal.II/lac/trilinos_sparse_matrix.h>
 #include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_gmres.h>
+#include <deal.II/lac/vector_memory.h>
+
+#include <Epetra_Operator.h>
+#include <Epetra_CrsMatrix.h>
+#include <Ifpack_Preconditioner.h>
+
 #include "parameters/all_parameters.h"
+#include "cell_block_preconditioner.h"
 
 namespace PHiLiP {
 
-    /// Still need to make a LinearSolver class for our problems
+    /// Solves a single linear system, building the preconditioner from scratch.
+    /// Repeated solves with similar matrices should use the LinearSolver class instead.
     /// Note that right hand side should be const
     /// however, the Trilinos wrapper gives and error when trying to
     /// map it. This is probably because the Trilinos function 
@@ -18,12 +31,171 @@ namespace PHiLiP {
                        dealii::LinearAlgebra::distributed::Vector<double> &solution,
                        const Parameters::LinearSolverParam &param);
 
+    /// Same as above, but GMRES uses the given @p preconditioner instead of building one from @p param.
+    /** Used for preconditioners that need more than the matrix, such as the p-multigrid hierarchy.
+     *  If @p preconditioner is a nullptr, the preconditioner is built from @p param.
+     */
+    std::pair<unsigned int, double>
+        solve_linear ( const dealii::TrilinosWrappers::SparseMatrix &system_matrix,
+                       dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
+                       dealii::LinearAlgebra::distributed::Vector<double> &solution,
+                       const Parameters::LinearSolverParam &param,
+                       Epetra_Operator *const preconditioner);
+
+    /// Solves the transposed system, system_matrix^T * solution = right_hand_side, without forming the transpose.
+    /** Used for the adjoint problems. GMRES applies the matrix through Tvmult() and the preconditioner
+     *  through the transposed triangular solves of the factors of @p system_matrix itself. The direct
+     *  solver solves with the transposed LU factors.
+     *
+     *  @p preconditioner, if given, must support SetUseTranspose(true). Otherwise, the preconditioner
+     *  is built from @p param as in solve_linear().
+     */
+    std::pair<unsigned int, double>
+        solve_linear_transpose ( const dealii::TrilinosWrappers::SparseMatrix &system_matrix,
+                                 dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
+                                 dealii::LinearAlgebra::distributed::Vector<double> &solution,
+                                 const Parameters::LinearSolverParam &param,
+                                 Epetra_Operator *const preconditioner = nullptr);
+
     std::pair<unsigned int, double>
     solve_linear_2 ( const dealii::TrilinosWrappers::SparseMatrix &system_matrix,
                    const dealii::LinearAlgebra::distributed::Vector<double> &right_hand_side,
                    dealii::LinearAlgebra::distributed::Vector<double> &solution,
                    const Parameters::LinearSolverParam &param);
 
+    /// Linear solver keeping its preconditioner and GMRES workspace between solves.
+    /** Meant for sequences of similar systems such as the pseudo-time steps of the implicit
+     *  ODE solver, where the Jacobian barely changes once the solution starts to converge.
+     *
+     *  The preconditioner is only updated when
+     *  - the matrix object or its number of non-zeros changed, i.e. its sparsity pattern changed,
+     *  - LinearSolverParam::preconditioner_update_lag solves were done since the last update,
+     *  - the previous solve exceeded LinearSolverParam::preconditioner_stall_ratio times the
+     *    iterations of the first solve following the last update,
+     *  - GMRES did not converge with a lagged preconditioner, in which case the system is
+     *    solved again with an updated preconditioner.
+     *
+     *  The GMRES solver and its vector memory persist such that the Krylov vectors are only
+     *  allocated once.
+     *
+     *  The direct solver type is forwarded to solve_linear().
+     */
+    class LinearSolver
+    {
+    public:
+        /// Vector type of the right-hand side and the solution.
+        using VectorType = dealii::LinearAlgebra::distributed::Vector<double>;
+        /// Application of an operator that is not assembled, dst = A * src.
+        using VmultFunction = std::function<void (VectorType &dst, const VectorType &src)>;
+
+        /// Constructor.
+        LinearSolver (const Parameters::LinearSolverParam &param);
+
+        /// Destructor.
+        ~LinearSolver() {};
+
+        /// Uses an external preconditioner instead of the one built from LinearSolverParam.
+        /** @p update_preconditioner is called with the system matrix whenever the preconditioner
+         *  needs to be updated. Used for preconditioners that need more than the matrix, such as
+         *  the p-multigrid hierarchy, which must outlive the LinearSolver.
+         */
+        void set_preconditioner (
+            Epetra_Operator *const preconditioner,
+            const std::function<void (const dealii::TrilinosWrappers::SparseMatrix &)> &update_preconditioner);
+
+        /// Solves system_matrix * solution = right_hand_side with zero initial guess.
+        /** Returns the number of iterations and the final linear residual. */
+        std::pair<unsigned int, double>
+        solve ( const dealii::TrilinosWrappers::SparseMatrix &system_matrix,
+                VectorType &right_hand_side,
+                VectorType &solution);
+
+        /// Solves A * solution = right_hand_side, where A is only applied through @p system_vmult.
+        /** Used by the Jacobian-free solvers. The preconditioner is built from @p preconditioner_matrix,
+         *  an approximation of A which only needs to be assembled when preconditioner_needs_update()
+         *  is true. A solve that did not converge therefore flags the preconditioner for an update
+         *  at the next solve, instead of updating it again from the same matrix.
+         *
+         *  Returns the number of iterations and the final linear residual.
+         */
+        std::pair<unsigned int, double>
+        solve ( const dealii::TrilinosWrappers::SparseMatrix &preconditioner_matrix,
+                const VmultFunction &system_vmult,
+                VectorType &right_hand_side,
+                VectorType &solution);
+
+        /// Whether the preconditioner must be updated before solving with @p system_matrix.
+        bool preconditioner_needs_update (const dealii::TrilinosWrappers::SparseMatrix &system_matrix) const;
+
+        /// Updates the preconditioner at the next solve.
+        void force_preconditioner_update ();
+
+        /// Discards the preconditioner such that it is rebuilt from scratch at the next solve.
+        /** Must be called whenever the system matrix is re-allocated, since a new matrix may
+         *  reuse the address and the number of non-zeros of the previous one.
+         */
+        void invalidate_preconditioner ();
+
+        /// Number of preconditioner updates since construction.
+        unsigned int n_preconditioner_updates () const;
+
+    private:
+        /// Linear solver parameters.
+        const Parameters::LinearSolverParam param;
+
+        /// Convergence control of the persistent GMRES solver.
+        dealii::SolverControl solver_control;
+        /// Memory pool holding the Krylov vectors between the solves.
+        dealii::GrowingVectorMemory<VectorType> vector_memory;
+        /// Persistent GMRES solver.
+        std::unique_ptr<dealii::SolverGMRES<VectorType>> solver_gmres;
+
+        /// Scalar ILU(k)/ILUT preconditioner used when LinearSolverParam::preconditioner_type is ilu.
+        std::unique_ptr<Ifpack_Preconditioner> ilu_preconditioner;
+        /// Dense cell-block preconditioner used when LinearSolverParam::preconditioner_type is a block type.
+        std::unique_ptr<CellBlockPreconditioner> block_preconditioner;
+        /// External preconditioner given through set_preconditioner().
+        Epetra_Operator *external_preconditioner;
+        /// Updates the external preconditioner.
+        std::function<void (const dealii::TrilinosWrappers::SparseMatrix &)> update_external_preconditioner;
+        /// Preconditioner currently in use. A nullptr results in an unpreconditioned GMRES.
+        Epetra_Operator *preconditioner;
+
+        /// Matrix used for the last preconditioner update.
+        const Epetra_CrsMatrix *preconditioned_matrix;
+        /// Number of non-zeros of the matrix used for the last preconditioner update.
+        long long int preconditioned_nonzeros;
+
+        bool update_requested; ///< Whether the preconditioner must be updated at the next solve.
+        unsigned int n_solves_since_update; ///< Number of solves since the last preconditioner update.
+        unsigned int reference_iterations; ///< Iterations of the first solve following the last update.
+        unsigned int n_updates; ///< Number of preconditioner updates since construction.
+
+        /// Re-computes the preconditioner from @p system_matrix.
+        void update_preconditioner (const dealii::TrilinosWrappers::SparseMatrix &system_matrix);
+
+        /// Runs the persistent GMRES on @p system_operator with the current preconditioner.
+        /** Returns false if GMRES did not converge. */
+        template <typename OperatorType>
+        bool solve_gmres (
+            const OperatorType &system_operator,
+            const VectorType &right_hand_side,
+            VectorType &solution);
+
+        /// Solves with @p system_operator after updating the preconditioner from @p preconditioner_matrix if needed.
+        /** If @p retry_with_updated_preconditioner, a solve that did not converge with a lagged
+         *  preconditioner is done again with an updated one.
+         */
+        template <typename OperatorType>
+        std::pair<unsigned int, double>
+        solve_preconditioned (
+            const dealii::TrilinosWrappers::SparseMatrix &preconditioner_matrix,
+            const OperatorType &system_operator,
+            VectorType &right_hand_side,
+            VectorType &solution,
+            const bool retry_with_updated_preconditioner);
+    };
+
 } // PHiLiP namespace
 
 #endif
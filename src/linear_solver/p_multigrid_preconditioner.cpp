@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <map>
+#include <string>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/fe/fe_tools.h>
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/trilinos_sparsity_pattern.h>
+
+#include <Amesos.h>
+#include <Epetra_Vector.h>
+
+#include "p_multigrid_preconditioner.h"
+
+namespace PHiLiP {
+
+template <int dim, typename real>
+PMultigridPreconditioner<dim,real>::PMultigridPreconditioner(
+    std::shared_ptr<DGBase<dim,real>> dg_input,
+    const Parameters::LinearSolverParam &param)
+    : dg(dg_input)
+    , n_smoothing_steps(param.p_multigrid_smoothing_steps)
+    , smoother_damping(param.p_multigrid_smoother_damping)
+    , coarse_solver_type(param.p_multigrid_coarse_solver)
+    , fine_matrix(nullptr)
+{
+    build_prolongations(param.p_multigrid_coarse_degree);
+}
+
+template <int dim, typename real>
+unsigned int PMultigridPreconditioner<dim,real>::n_levels () const
+{
+    return prolongations.size() + 1;
+}
+
+template <int dim, typename real>
+void PMultigridPreconditioner<dim,real>::build_prolongations (const unsigned int coarse_degree)
+{
+    const MPI_Comm mpi_communicator = MPI_COMM_WORLD;
+    const dealii::hp::FECollection<dim> &fe_collection = dg->fe_collection;
+
+    // FE index used for each polynomial degree. When using collocated nodes, the p=1 FE appears twice,
+    // in which case the last one is used for the cells coarsened to p=1.
+    std::map<unsigned int, unsigned int> fe_index_of_degree;
+    for (unsigned int fe_index = 0; fe_index < fe_collection.size(); ++fe_index) {
+        fe_index_of_degree[fe_collection[fe_index].degree] = fe_index;
+    }
+    const unsigned int coarsest_level_degree = std::max(coarse_degree, fe_index_of_degree.begin()->first);
+
+    unsigned int max_cell_degree = 0;
+    std::vector<unsigned int> fine_fe_indices;
+    std::vector<std::vector<dealii::types::global_dof_index>> fine_cell_dofs;
+    for (const auto &cell : dg->dof_handler.active_cell_iterators()) {
+        if (!cell->is_locally_owned()) continue;
+        const unsigned int fe_index = cell->active_fe_index();
+        max_cell_degree = std::max(max_cell_degree, fe_collection[fe_index].degree);
+        fine_fe_indices.push_back(fe_index);
+        fine_cell_dofs.emplace_back(fe_collection[fe_index].n_dofs_per_cell());
+        cell->get_dof_indices(fine_cell_dofs.back());
+    }
+    max_cell_degree = dealii::Utilities::MPI::max(max_cell_degree, mpi_communicator);
+    dealii::IndexSet fine_locally_owned = dg->locally_owned_dofs;
+
+    prolongations.clear();
+    std::map<std::pair<unsigned int, unsigned int>, dealii::FullMatrix<double>> interpolation_matrices;
+    for (unsigned int fine_level_degree = max_cell_degree; fine_level_degree > coarsest_level_degree; --fine_level_degree) {
+        const unsigned int coarse_level_degree = fine_level_degree - 1;
+        AssertThrow(fe_index_of_degree.count(coarse_level_degree) == 1,
+                    dealii::ExcMessage("The FE collection has no FE of the p-multigrid level degree."));
+        const unsigned int coarse_level_fe_index = fe_index_of_degree.at(coarse_level_degree);
+
+        // Number the coarse DoFs contiguously within each process.
+        std::vector<unsigned int> coarse_fe_indices(fine_fe_indices.size());
+        unsigned long long n_locally_owned_coarse_dofs = 0;
+        for (unsigned int icell = 0; icell < fine_fe_indices.size(); ++icell) {
+            // Cells with a degree already lower than the level degree keep their FE.
+            const bool is_coarsened = fe_collection[fine_fe_indices[icell]].degree > coarse_level_degree;
+            coarse_fe_indices[icell] = is_coarsened ? coarse_level_fe_index : fine_fe_indices[icell];
+            n_locally_owned_coarse_dofs += fe_collection[coarse_fe_indices[icell]].n_dofs_per_cell();
+        }
+        unsigned long long coarse_dofs_offset = 0;
+        MPI_Exscan(&n_locally_owned_coarse_dofs, &coarse_dofs_offset, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, mpi_communicator);
+        if (dealii::Utilities::MPI::this_mpi_process(mpi_communicator) == 0) coarse_dofs_offset = 0;
+        const unsigned long long n_coarse_dofs = dealii::Utilities::MPI::sum(n_locally_owned_coarse_dofs, mpi_communicator);
+
+        dealii::IndexSet coarse_locally_owned(n_coarse_dofs);
+        coarse_locally_owned.add_range(coarse_dofs_offset, coarse_dofs_offset + n_locally_owned_coarse_dofs);
+        coarse_locally_owned.compress();
+
+        std::vector<std::vector<dealii::types::global_dof_index>> coarse_cell_dofs(fine_fe_indices.size());
+        dealii::types::global_dof_index next_coarse_dof = coarse_dofs_offset;
+        for (unsigned int icell = 0; icell < fine_fe_indices.size(); ++icell) {
+            coarse_cell_dofs[icell].resize(fe_collection[coarse_fe_indices[icell]].n_dofs_per_cell());
+            for (auto &dof : coarse_cell_dofs[icell]) dof = next_coarse_dof++;
+        }
+
+        // Interpolation of the coarse polynomials into the fine FE of each cell.
+        auto get_interpolation_matrix = [&](const unsigned int coarse_index, const unsigned int fine_index) -> const dealii::FullMatrix<double> & {
+            const auto key = std::make_pair(coarse_index, fine_index);
+            auto it = interpolation_matrices.find(key);
+            if (it != interpolation_matrices.end()) return it->second;
+            dealii::FullMatrix<double> &interpolation = interpolation_matrices[key];
+            interpolation.reinit(fe_collection[fine_index].n_dofs_per_cell(), fe_collection[coarse_index].n_dofs_per_cell());
+            if (coarse_index == fine_index) {
+                for (unsigned int i = 0; i < interpolation.m(); ++i) interpolation(i,i) = 1.0;
+            } else {
+                dealii::FETools::get_interpolation_matrix(fe_collection[coarse_index], fe_collection[fine_index], interpolation);
+            }
+            return interpolation;
+        };
+
+        const double zero_tolerance = 1e-14;
+        dealii::TrilinosWrappers::SparsityPattern sparsity_pattern(fine_locally_owned, coarse_locally_owned, mpi_communicator);
+        for (unsigned int icell = 0; icell < fine_fe_indices.size(); ++icell) {
+            const dealii::FullMatrix<double> &interpolation = get_interpolation_matrix(coarse_fe_indices[icell], fine_fe_indices[icell]);
+            for (unsigned int i = 0; i < interpolation.m(); ++i) {
+                for (unsigned int j = 0; j < interpolation.n(); ++j) {
+                    if (std::abs(interpolation(i,j)) > zero_tolerance) sparsity_pattern.add(fine_cell_dofs[icell][i], coarse_cell_dofs[icell][j]);
+                }
+            }
+        }
+        sparsity_pattern.compress();
+
+        auto prolongation = std::make_unique<dealii::TrilinosWrappers::SparseMatrix>();
+        prolongation->reinit(sparsity_pattern);
+        for (unsigned int icell = 0; icell < fine_fe_indices.size(); ++icell) {
+            const dealii::FullMatrix<double> &interpolation = get_interpolation_matrix(coarse_fe_indices[icell], fine_fe_indices[icell]);
+            for (unsigned int i = 0; i < interpolation.m(); ++i) {
+                for (unsigned int j = 0; j < interpolation.n(); ++j) {
+                    if (std::abs(interpolation(i,j)) > zero_tolerance) prolongation->set(fine_cell_dofs[icell][i], coarse_cell_dofs[icell][j], interpolation(i,j));
+                }
+            }
+        }
+        prolongation->compress(dealii::VectorOperation::insert);
+        prolongations.push_back(std::move(prolongation));
+
+        fine_fe_indices = coarse_fe_indices;
+        fine_cell_dofs = coarse_cell_dofs;
+        fine_locally_owned = coarse_locally_owned;
+    }
+}
+
+template <int dim, typename real>
+const dealii::TrilinosWrappers::SparseMatrix & PMultigridPreconditioner<dim,real>::level_matrix (const unsigned int ilevel) const
+{
+    if (ilevel == 0) return *fine_matrix;
+    return *(coarse_matrices[ilevel-1]);
+}
+
+template <int dim, typename real>
+void PMultigridPreconditioner<dim,real>::initialize (const dealii::TrilinosWrappers::SparseMatrix &matrix)
+{
+    fine_matrix = &matrix;
+
+    coarse_matrices.clear();
+    smoothers.clear();
+    for (unsigned int ilevel = 0; ilevel < n_levels()-1; ++ilevel) {
+        auto smoother = std::make_unique<CellBlockPreconditioner>(Parameters::LinearSolverParam::PreconditionerEnum::block_jacobi);
+        smoother->initialize(level_matrix(ilevel).trilinos_matrix());
+        smoothers.push_back(std::move(smoother));
+
+        // Galerkin coarse operator P^T A P
+        dealii::TrilinosWrappers::SparseMatrix matrix_times_prolongation;
+        level_matrix(ilevel).mmult(matrix_times_prolongation, *(prolongations[ilevel]));
+        auto coarse_matrix = std::make_unique<dealii::TrilinosWrappers::SparseMatrix>();
+        prolongations[ilevel]->Tmmult(*coarse_matrix, matrix_times_prolongation);
+        coarse_matrices.push_back(std::move(coarse_matrix));
+    }
+
+    const dealii::TrilinosWrappers::SparseMatrix &coarsest_matrix = level_matrix(n_levels()-1);
+    coarse_direct_solver.reset();
+    coarse_problem.reset();
+    coarse_amg.reset();
+    if (coarse_solver_type == Parameters::LinearSolverParam::PMultigridCoarseSolverEnum::coarse_amg) {
+        dealii::TrilinosWrappers::PreconditionAMG::AdditionalData amg_data;
+        amg_data.elliptic = false;
+        coarse_amg = std::make_unique<dealii::TrilinosWrappers::PreconditionAMG>();
+        coarse_amg->initialize(coarsest_matrix, amg_data);
+    } else {
+        coarse_problem = std::make_unique<Epetra_LinearProblem>();
+        coarse_problem->SetOperator(const_cast<Epetra_CrsMatrix *>(&coarsest_matrix.trilinos_matrix()));
+        Amesos factory;
+        coarse_direct_solver.reset(factory.Create("Amesos_Klu", *coarse_problem));
+        AssertThrow(coarse_direct_solver, dealii::ExcMessage("Amesos_Klu is not available for the p-multigrid coarse solve."));
+        const int symbolic_error = coarse_direct_solver->SymbolicFactorization();
+        AssertThrow(symbolic_error == 0, dealii::ExcMessage("Symbolic factorization of the p-multigrid coarse operator failed with error "
+                                                            + std::to_string(symbolic_error) + "."));
+        const int numeric_error = coarse_direct_solver->NumericFactorization();
+        AssertThrow(numeric_error == 0, dealii::ExcMessage("Numeric factorization of the p-multigrid coarse operator failed with error "
+                                                           + std::to_string(numeric_error) + "."));
+    }
+
+    const int n_vectors = 1;
+    allocate_work_vectors(n_vectors);
+}
+
+template <int dim, typename real>
+void PMultigridPreconditioner<dim,real>::allocate_work_vectors (const int n_vectors) const
+{
+    level_rhs.clear();
+    level_solutions.clear();
+    level_residuals.clear();
+    level_corrections.clear();
+    for (unsigned int ilevel = 0; ilevel < n_levels(); ++ilevel) {
+        const Epetra_Map &map = (ilevel == 0) ? fine_matrix->trilinos_matrix().OperatorDomainMap()
+                                              : prolongations[ilevel-1]->trilinos_matrix().DomainMap();
+        level_rhs.push_back(std::make_unique<Epetra_MultiVector>(map, n_vectors));
+        // The solution of the fine level is the output of ApplyInverse().
+        level_solutions.push_back((ilevel == 0) ? nullptr : std::make_unique<Epetra_MultiVector>(map, n_vectors));
+        if (ilevel == n_levels()-1) continue;
+        level_residuals.push_back(std::make_unique<Epetra_MultiVector>(map, n_vectors));
+        level_corrections.push_back(std::make_unique<Epetra_MultiVector>(map, n_vectors));
+    }
+}
+
+template <int dim, typename real>
+int PMultigridPreconditioner<dim,real>::coarse_solve (const Epetra_MultiVector &rhs, Epetra_MultiVector &solution) const
+{
+    if (coarse_amg) {
+        return coarse_amg->trilinos_operator().ApplyInverse(rhs, solution);
+    }
+    coarse_problem->SetLHS(&solution);
+    coarse_problem->SetRHS(const_cast<Epetra_MultiVector *>(&rhs));
+    return coarse_direct_solver->Solve();
+}
+
+template <int dim, typename real>
+int PMultigridPreconditioner<dim,real>::v_cycle (const unsigned int ilevel, const Epetra_MultiVector &rhs, Epetra_MultiVector &solution) const
+{
+    if (ilevel == n_levels()-1) {
+        return coarse_solve(rhs, solution);
+    }
+
+    const Epetra_CrsMatrix &matrix = level_matrix(ilevel).trilinos_matrix();
+    const Epetra_CrsMatrix &prolongation = prolongations[ilevel]->trilinos_matrix();
+    Epetra_MultiVector &residual = *(level_residuals[ilevel]);
+    Epetra_MultiVector &correction = *(level_corrections[ilevel]);
+
+    solution.PutScalar(0.0);
+    auto smooth = [&]() {
+        for (unsigned int istep = 0; istep < n_smoothing_steps; ++istep) {
+            matrix.Multiply(false, solution, residual);
+            residual.Update(1.0, rhs, -1.0);
+            smoothers[ilevel]->ApplyInverse(residual, correction);
+            solution.Update(smoother_damping, correction, 1.0);
+        }
+    };
+
+    // Pre-smoothing
+    smooth();
+
+    // Coarse-grid correction
+    matrix.Multiply(false, solution, residual);
+    residual.Update(1.0, rhs, -1.0);
+    Epetra_MultiVector &coarse_rhs = *(level_rhs[ilevel+1]);
+    Epetra_MultiVector &coarse_solution = *(level_solutions[ilevel+1]);
+    prolongation.Multiply(true, residual, coarse_rhs);
+    const int coarse_error = v_cycle(ilevel+1, coarse_rhs, coarse_solution);
+    if (coarse_error != 0) return coarse_error;
+    prolongation.Multiply(false, coarse_solution, correction);
+    solution.Update(1.0, correction, 1.0);
+
+    // Post-smoothing
+    smooth();
+
+    return 0;
+}
+
+template <int dim, typename real>
+int PMultigridPreconditioner<dim,real>::ApplyInverse (const Epetra_MultiVector &X, Epetra_MultiVector &Y) const
+{
+    Assert(fine_matrix != nullptr, dealii::ExcMessage("PMultigridPreconditioner has not been initialized."));
+    if (level_rhs.empty() || level_rhs[0]->NumVectors() != X.NumVectors()) allocate_work_vectors(X.NumVectors());
+
+    // X is only copied if it aliases Y, since Y is zeroed before the V-cycle reads X.
+    const bool is_aliased = (X[0] == Y[0]);
+    if (is_aliased) level_rhs[0]->Scale(1.0, X);
+    const Epetra_MultiVector &rhs = is_aliased ? *(level_rhs[0]) : X;
+    return v_cycle(0, rhs, Y);
+}
+
+template <int dim, typename real>
+void PMultigridPreconditioner<dim,real>::vmult (
+    dealii::LinearAlgebra::distributed::Vector<double> &dst,
+    const dealii::LinearAlgebra::distributed::Vector<double> &src) const
+{
+    Epetra_Vector src_epetra(View, OperatorDomainMap(), const_cast<double *>(src.begin()));
+    Epetra_Vector dst_epetra(View, OperatorRangeMap(), dst.begin());
+    ApplyInverse(src_epetra, dst_epetra);
+}
+
+template <int dim, typename real>
+int PMultigridPreconditioner<dim,real>::SetUseTranspose (bool use_transpose)
+{
+    return use_transpose ? -1 : 0;
+}
+
+template <int dim, typename real>
+int PMultigridPreconditioner<dim,real>::Apply (const Epetra_MultiVector &/*X*/, Epetra_MultiVector &/*Y*/) const
+{
+    return -1;
+}
+
+template <int dim, typename real>
+double PMultigridPreconditioner<dim,real>::NormInf () const
+{
+    return -1.0;
+}
+
+template <int dim, typename real>
+const char * PMultigridPreconditioner<dim,real>::Label () const
+{
+    return "PHiLiP p-multigrid";
+}
+
+template <int dim, typename real>
+bool PMultigridPreconditioner<dim,real>::UseTranspose () const
+{
+    return false;
+}
+
+template <int dim, typename real>
+bool PMultigridPreconditioner<dim,real>::HasNormInf () const
+{
+    return false;
+}
+
+template <int dim, typename real>
+const Epetra_Comm & PMultigridPreconditioner<dim,real>::Comm () const
+{
+    return fine_matrix->trilinos_matrix().Comm();
+}
+
+template <int dim, typename real>
+const Epetra_Map & PMultigridPreconditioner<dim,real>::OperatorDomainMap () const
+{
+    return fine_matrix->trilinos_matrix().OperatorDomainMap();
+}
+
+template <int dim, typename real>
+const Epetra_Map & PMultigridPreconditioner<dim,real>::OperatorRangeMap () const
+{
+    return fine_matrix->trilinos_matrix().OperatorRangeMap();
+}
+
+template class PMultigridPreconditioner<PHILIP_DIM, double>;
+
+} // PHiLiP namespace
@@ -0,0 +1,142 @@
+#ifndef __P_MULTIGRID_PRECONDITIONER_H__
+#define __P_MULTIGRID_PRECONDITIONER_H__
+
+#include <memory>
+#include <vector>
+
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/trilinos_sparse_matrix.h>
+#include <deal.II/lac/trilinos_precondition.h>
+
+#include <Epetra_Operator.h>
+#include <Epetra_MultiVector.h>
+#include <Epetra_LinearProblem.h>
+#include <Amesos_BaseSolver.h>
+
+#include "parameters/parameters_linear_solver.h"
+#include "dg/dg.h"
+#include "cell_block_preconditioner.h"
+
+namespace PHiLiP {
+
+/// p-multigrid preconditioner built on the polynomial degrees of the DG FE collection.
+/** Level 0 is the fine DG discretization. Each coarser level lowers the polynomial degree of the
+ *  cells by one, down to LinearSolverParam::p_multigrid_coarse_degree. Cells with a degree already
+ *  lower than the level degree keep their degree such that hp-meshes are supported.
+ *
+ *  The prolongation from a coarse level to the next finer one interpolates the coarse polynomials
+ *  into the finer FE of each cell, which is exact since the spaces are nested.
+ *  The coarse operators are the Galerkin projections P^T A P such that only the fine matrix
+ *  needs to be assembled.
+ *
+ *  A V-cycle is applied using damped block-Jacobi sweeps on the cell blocks as a smoother,
+ *  and a sparse direct or AMG solve on the coarsest level.
+ *
+ *  The coarse DoFs are numbered contiguously per process, following the active cells,
+ *  such that the prolongation operators are local to each process.
+ */
+template <int dim, typename real>
+class PMultigridPreconditioner : public Epetra_Operator
+{
+public:
+    /// Constructor. Builds the prolongation operators from the current degrees of @p dg_input.
+    /** Must be re-constructed if the mesh or the polynomial degrees change.
+     */
+    PMultigridPreconditioner(
+        std::shared_ptr<DGBase<dim,real>> dg_input,
+        const Parameters::LinearSolverParam &param);
+
+    /// Destructor.
+    ~PMultigridPreconditioner() {};
+
+    /// Builds the coarse operators, the smoothers and the coarse solver from @p matrix.
+    /** The matrix must outlive the preconditioner and have the DoF distribution of the DG.
+     */
+    void initialize (const dealii::TrilinosWrappers::SparseMatrix &matrix);
+
+    /// Number of levels, including the fine level.
+    unsigned int n_levels () const;
+
+    /// Applies one V-cycle on deal.II vectors, dst = M^{-1} src.
+    void vmult (dealii::LinearAlgebra::distributed::Vector<double> &dst,
+                const dealii::LinearAlgebra::distributed::Vector<double> &src) const;
+
+    /// Transpose is not supported. Returns -1 if @p use_transpose is true.
+    int SetUseTranspose (bool use_transpose) override;
+    /// Application of the approximate matrix is not supported. Returns -1.
+    int Apply (const Epetra_MultiVector &X, Epetra_MultiVector &Y) const override;
+    /// Applies one V-cycle, Y = M^{-1} X. X and Y may alias.
+    int ApplyInverse (const Epetra_MultiVector &X, Epetra_MultiVector &Y) const override;
+    /// Not available. Returns -1.
+    double NormInf () const override;
+    /// Label of the operator.
+    const char * Label () const override;
+    /// Always false.
+    bool UseTranspose () const override;
+    /// Always false.
+    bool HasNormInf () const override;
+    /// Communicator of the fine matrix.
+    const Epetra_Comm & Comm () const override;
+    /// Domain map of the fine matrix.
+    const Epetra_Map & OperatorDomainMap () const override;
+    /// Range map of the fine matrix.
+    const Epetra_Map & OperatorRangeMap () const override;
+
+private:
+    /// Smart pointer to DGBase providing the FE collection and the DoF distribution.
+    std::shared_ptr<DGBase<dim,real>> dg;
+
+    const unsigned int n_smoothing_steps; ///< Number of pre- and post-smoothing sweeps.
+    const double smoother_damping; ///< Damping of the block-Jacobi sweeps.
+    /// Direct or AMG solve on the coarsest level.
+    const Parameters::LinearSolverParam::PMultigridCoarseSolverEnum coarse_solver_type;
+
+    /// Fine matrix.
+    const dealii::TrilinosWrappers::SparseMatrix *fine_matrix;
+
+    /// Prolongation operators, where prolongations[ilevel] maps level ilevel+1 onto level ilevel.
+    std::vector<std::unique_ptr<dealii::TrilinosWrappers::SparseMatrix>> prolongations;
+    /// Galerkin operators of the coarse levels, where coarse_matrices[ilevel-1] is the operator of level ilevel.
+    std::vector<std::unique_ptr<dealii::TrilinosWrappers::SparseMatrix>> coarse_matrices;
+    /// Block-Jacobi smoothers of all the levels but the coarsest.
+    std::vector<std::unique_ptr<CellBlockPreconditioner>> smoothers;
+
+    /// Linear problem holding the coarsest operator for the direct solver.
+    std::unique_ptr<Epetra_LinearProblem> coarse_problem;
+    /// Factorized coarsest operator.
+    std::unique_ptr<Amesos_BaseSolver> coarse_direct_solver;
+    /// AMG of the coarsest operator.
+    std::unique_ptr<dealii::TrilinosWrappers::PreconditionAMG> coarse_amg;
+
+    /// Builds the prolongation operators.
+    void build_prolongations (const unsigned int coarse_degree);
+
+    /// Operator of level @p ilevel.
+    const dealii::TrilinosWrappers::SparseMatrix & level_matrix (const unsigned int ilevel) const;
+
+    /// Work vectors of the V-cycle, allocated by initialize() such that ApplyInverse() does not allocate.
+    /** Mutable since the Epetra_Operator interface requires ApplyInverse() to be const.
+     *  level_rhs[0] only holds a copy of the fine right-hand side when it aliases the output.
+     *  level_solutions[0] is null since the fine solution is the output of ApplyInverse().
+     *  The residuals and corrections are not needed on the coarsest level.
+     */
+    mutable std::vector<std::unique_ptr<Epetra_MultiVector>> level_rhs;
+    mutable std::vector<std::unique_ptr<Epetra_MultiVector>> level_solutions; ///< See level_rhs.
+    mutable std::vector<std::unique_ptr<Epetra_MultiVector>> level_residuals; ///< See level_rhs.
+    mutable std::vector<std::unique_ptr<Epetra_MultiVector>> level_corrections; ///< See level_rhs.
+
+    /// (Re-)allocates the work vectors of all the levels for @p n_vectors right-hand sides.
+    void allocate_work_vectors (const int n_vectors) const;
+
+    /// Applies a V-cycle on level @p ilevel with zero initial guess.
+    /** Returns the non-zero error code of the coarse solve if it failed, 0 otherwise.
+     */
+    int v_cycle (const unsigned int ilevel, const Epetra_MultiVector &rhs, Epetra_MultiVector &solution) const;
+
+    /// Solves the coarsest level. Returns the error code of the AMG or direct solve.
+    int coarse_solve (const Epetra_MultiVector &rhs, Epetra_MultiVector &solution) const;
+};
+
+} // PHiLiP namespace
+
+#endif
@@ -1,4 +1,5 @@
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/multithread_info.h>
 
 #include <deal.II/base/logstream.h>
 #include <deal.II/base/parameter_handler.h>
@@ -11,7 +12,7 @@
 #include "ode_solver/ode_solver.h"
 #include "parameters/all_parameters.h"
 
-#include "global_counter.hpp"
+#include "telemetry/telemetry.h"
 
 int main (int argc, char *argv[])
 {
@@ -19,12 +20,6 @@ int main (int argc, char *argv[])
 //     feenableexcept(FE_INVALID | FE_OVERFLOW); // catch nan
 // #endif
 
-    n_vmult = 0;
-    dRdW_form = 0;
-    dRdW_mult = 0;
-    dRdX_mult = 0;
-    d2R_mult = 0;
-
     dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
     const int n_mpi = dealii::Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
     const int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
@@ -59,11 +54,32 @@ int main (int argc, char *argv[])
 
         AssertDimension(all_parameters.dimension, PHILIP_DIM);
 
+        if (all_parameters.use_threaded_assembly) {
+            // MPI_InitFinalize limited each process to a single thread.
+            const unsigned int n_threads = (all_parameters.n_threads_per_process == 0) ?
+                                           dealii::numbers::invalid_unsigned_int
+                                           : all_parameters.n_threads_per_process;
+            dealii::MultithreadInfo::set_thread_limit(n_threads);
+            pcout << "Using " << dealii::MultithreadInfo::n_threads() << " threads per processor for the assembly..." << std::endl;
+        }
+
+        const bool use_telemetry = !all_parameters.telemetry_report_filename.empty()
+                                   || !all_parameters.telemetry_iteration_report_filename.empty();
+        if (use_telemetry) PHiLiP::Telemetry::enable();
+
         const int max_dim = PHILIP_DIM;
         const int max_nstate = 5;
         std::unique_ptr<PHiLiP::Tests::TestsBase> test = PHiLiP::Tests::TestsFactory<max_dim,max_nstate>::create_test(&all_parameters);
         test_error = test->run_test();
 
+        if (use_telemetry) {
+            PHiLiP::Telemetry::disable();
+            if (!all_parameters.telemetry_report_filename.empty()) {
+                pcout << "Writing telemetry report " << all_parameters.telemetry_report_filename << "..." << std::endl;
+                PHiLiP::Telemetry::write_report(all_parameters.telemetry_report_filename, MPI_COMM_WORLD);
+            }
+        }
+
         pcout << "Finished test with test error code: " << test_error << std::endl;
     }
     catch (std::exception &exc)
@@ -352,6 +352,7 @@ void FreeFormDeformation<dim>
     high_order_grid.volume_nodes = high_order_grid.initial_volume_nodes;
     high_order_grid.volume_nodes += volume_displacements;
     high_order_grid.volume_nodes.update_ghost_values();
+    high_order_grid.volume_nodes_modified();
 }
 
 template<int dim>
@@ -632,6 +633,7 @@ FreeFormDeformation<dim>
         // Reset FFD
         control_pts[ictl] = old_ffd_point;
         high_order_grid.volume_nodes = old_volume_nodes;
+        high_order_grid.volume_nodes_modified();
 
         // Perturb
         {
@@ -646,6 +648,7 @@ FreeFormDeformation<dim>
         // Reset FFD
         control_pts[ictl] = old_ffd_point;
         high_order_grid.volume_nodes = old_volume_nodes;
+        high_order_grid.volume_nodes_modified();
 
         auto dXvdXp_i = nodes_p;
         dXvdXp_i -= nodes_m;
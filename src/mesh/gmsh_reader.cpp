@@ -1,7 +1,16 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <map>
+#include <type_traits>
 
+#include <deal.II/base/conditional_ostream.h>
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/base/utilities.h>
 
 #include <deal.II/grid/grid_in.h> // Mostly just for their exceptions
@@ -19,6 +28,7 @@
 
 #include "high_order_grid.h"
 #include "gmsh_reader.hpp"
+#include "telemetry/telemetry.h"
 
 
 namespace PHiLiP {
@@ -54,78 +64,6 @@ assign_1d_boundary_ids( const std::map<unsigned int, dealii::types::boundary_id>
     }
 }
 
-template <int dim>
-void rotate_indices(std::vector<unsigned int> &numbers, const unsigned int n_indices_per_direction, const char direction)
-{
-  const unsigned int n = n_indices_per_direction;
-  unsigned int       s = n;
-  for (unsigned int i = 1; i < dim; ++i)
-    s *= n;
-  numbers.resize(s);
-
-  unsigned int l = 0;
-
-  if (dim == 1)
-    {
-      // Mirror around midpoint
-      for (unsigned int i = n; i > 0;)
-        numbers[l++] = --i;
-    }
-  else
-    {
-      switch (direction)
-        {
-          // Rotate xy-plane
-          // counter-clockwise
-          case 'z':
-            for (unsigned int iz = 0; iz < ((dim > 2) ? n : 1); ++iz)
-              for (unsigned int j = 0; j < n; ++j)
-                for (unsigned int i = 0; i < n; ++i)
-                  {
-                    unsigned int k = n * i - j + n - 1 + n * n * iz;
-                    numbers[l++]   = k;
-                  }
-            break;
-          // Rotate xy-plane
-          // clockwise
-          case 'Z':
-            for (unsigned int iz = 0; iz < ((dim > 2) ? n : 1); ++iz)
-              for (unsigned int iy = 0; iy < n; ++iy)
-                for (unsigned int ix = 0; ix < n; ++ix)
-                  {
-                    unsigned int k = n * ix - iy + n - 1 + n * n * iz;
-                    numbers[k]     = l++;
-                  }
-            break;
-          // Rotate yz-plane
-          // counter-clockwise
-          case 'x':
-            Assert(dim > 2, dealii::ExcDimensionMismatch(dim, 3));
-            for (unsigned int iz = 0; iz < n; ++iz)
-              for (unsigned int iy = 0; iy < n; ++iy)
-                for (unsigned int ix = 0; ix < n; ++ix)
-                  {
-                    unsigned int k = n * (n * iy - iz + n - 1) + ix;
-                    numbers[l++]   = k;
-                  }
-            break;
-          // Rotate yz-plane
-          // clockwise
-          case 'X':
-            Assert(dim > 2, dealii::ExcDimensionMismatch(dim, 3));
-            for (unsigned int iz = 0; iz < n; ++iz)
-              for (unsigned int iy = 0; iy < n; ++iy)
-                for (unsigned int ix = 0; ix < n; ++ix)
-                  {
-                    unsigned int k = n * (n * iy - iz + n - 1) + ix;
-                    numbers[k]     = l++;
-                  }
-            break;
-          default:
-            Assert(false, dealii::ExcNotImplemented());
-        }
-    }
-}
 
 template <int dim, int spacedim>
 void
@@ -138,182 +76,228 @@ assign_1d_boundary_ids(const std::map<unsigned int, dealii::types::boundary_id>
 }
 
 
-void open_file_toRead(const std::string filepath, std::ifstream& file_in)
+/// Reads the words and numbers of a Gmsh file held in memory.
+/** The numbers are either parsed from text or copied from the binary blocks of the file, depending on
+ *  the file type given by the $MeshFormat section. Whole arrays, such as the coordinates or the
+ *  connectivity of a block, are therefore copied at once from binary files.
+ */
+class GmshFileCursor
 {
-    file_in.open(filepath);
-    if(!file_in) {
-        std::cout << "Could not open file "<< filepath << std::endl;
-        std::abort();
+public:
+    /// Constructor. The last character of @p buffer must be '\0' such that text numbers are always terminated.
+    explicit GmshFileCursor (const std::vector<char> &buffer)
+        : binary(false)
+        , position(buffer.data())
+        , end(buffer.data() + buffer.size() - 1)
+    { }
+
+    bool binary; ///< Whether the numbers of the sections are stored in binary.
+
+    /// Whether the end of the file has been reached.
+    bool at_end ()
+    {
+        skip_whitespace();
+        return position >= end;
     }
-}
 
+    /// Reads a whitespace-delimited word, such as a section marker.
+    /** Also consumes the line break following the word, after which binary data may start. */
+    std::string read_word ()
+    {
+        skip_whitespace();
+        const char *first = position;
+        while (position < end && !std::isspace(static_cast<unsigned char>(*position))) ++position;
+        const std::string word(first, position);
+        skip_line_end();
+        return word;
+    }
 
-void read_gmsh_entities(std::ifstream &infile, std::array<std::map<int, int>, 4> &tag_maps)
-{
-    std::string  line;
-    // if the next block is of kind $Entities, parse it
-    unsigned long n_points, n_curves, n_surfaces, n_volumes;
-
-    infile >> n_points >> n_curves >> n_surfaces >> n_volumes;
-    int entity_tag;
-    unsigned int n_physicals;
-    double box_min_x, box_min_y, box_min_z, box_max_x, box_max_y, box_max_z;
-    (void) box_min_x; (void) box_min_y; (void) box_min_z;
-    (void) box_max_x; (void) box_max_y; (void) box_max_z;
-    for (unsigned int i = 0; i < n_points; ++i) {
-        // parse point ids
-
-        // we only care for 'tag' as key for tag_maps[0]
-        infile >> entity_tag >> box_min_x >> box_min_y >> box_min_z >> n_physicals;
-
-        // if there is a physical tag, we will use it as boundary id below
-        AssertThrow(n_physicals < 2, dealii::ExcMessage("More than one tag is not supported!"));
-        // if there is no physical tag, use 0 as default
-        int physical_tag = 0;
-        for (unsigned int j = 0; j < n_physicals; ++j) {
-            infile >> physical_tag;
-        }
-        //std::cout << "Entity point tag " << entity_tag << " with physical tag " << physical_tag << std::endl;
-        tag_maps[0][entity_tag] = physical_tag;
+    /// Consumes a single line break, if present.
+    void skip_line_end ()
+    {
+        if (position < end && *position == '\r') ++position;
+        if (position < end && *position == '\n') ++position;
     }
-    for (unsigned int i = 0; i < n_curves; ++i) {
-        // parse curve ids
-
-        // we only care for 'tag' as key for tag_maps[1]
-        infile >> entity_tag >> box_min_x >> box_min_y >> box_min_z >> box_max_x >> box_max_y >> box_max_z >> n_physicals;
-        // if there is a physical tag, we will use it as boundary id below
-        AssertThrow(n_physicals < 2, dealii::ExcMessage("More than one tag is not supported!"));
-        // if there is no physical tag, use 0 as default
-        int physical_tag = 0;
-        for (unsigned int j = 0; j < n_physicals; ++j) {
-            infile >> physical_tag;
-        }
-        tag_maps[1][entity_tag] = physical_tag;
-        //std::cout << "Entity curve tag " << entity_tag << " with physical tag " << physical_tag << std::endl;
-        // we don't care about the points associated to a curve, but have
-        // to parse them anyway because their format is unstructured
-        infile >> n_points;
-        for (unsigned int j = 0; j < n_points; ++j) {
-            infile >> entity_tag;
-        }
+
+    /// Reads a number stored as type T.
+    template <typename T>
+    T read ()
+    {
+        T value;
+        read(1, &value);
+        return value;
     }
-    for (unsigned int i = 0; i < n_surfaces; ++i) {
-        // parse surface ids
-
-        // we only care for 'tag' as key for tag_maps[2]
-        infile >> entity_tag >> box_min_x >> box_min_y >> box_min_z >> box_max_x >> box_max_y >> box_max_z >> n_physicals;
-        // if there is a physical tag, we will use it as boundary id below
-        AssertThrow(n_physicals < 2, dealii::ExcMessage("More than one tag is not supported!"));
-        // if there is no physical tag, use 0 as default
-        int physical_tag = 0;
-        for (unsigned int j = 0; j < n_physicals; ++j) {
-          infile >> physical_tag;
+
+    /// Reads @p n numbers stored as type T.
+    template <typename T>
+    void read (const std::size_t n, T *values)
+    {
+        if (binary) {
+            const std::size_t n_bytes = n * sizeof(T);
+            AssertThrow(position + n_bytes <= end, dealii::ExcMessage("Unexpected end of the Gmsh file."));
+            std::memcpy(values, position, n_bytes);
+            position += n_bytes;
+            return;
         }
-        //std::cout << "Entity surface tag " << entity_tag << " with physical tag " << physical_tag << std::endl;
-        tag_maps[2][entity_tag] = physical_tag;
-        // we don't care about the curves associated to a surface, but
-        // have to parse them anyway because their format is unstructured
-        infile >> n_curves;
-        for (unsigned int j = 0; j < n_curves; ++j) {
-          infile >> entity_tag;
+        for (std::size_t i = 0; i < n; ++i) {
+            skip_whitespace();
+            char *number_end;
+            if constexpr (std::is_floating_point<T>::value) {
+                values[i] = static_cast<T>(std::strtod(position, &number_end));
+            } else if constexpr (std::is_signed<T>::value) {
+                values[i] = static_cast<T>(std::strtoll(position, &number_end, 10));
+            } else {
+                values[i] = static_cast<T>(std::strtoull(position, &number_end, 10));
+            }
+            AssertThrow(number_end != position, dealii::ExcMessage("Expected a number in the Gmsh file."));
+            position = number_end;
         }
     }
-    for (unsigned int i = 0; i < n_volumes; ++i) {
-        // parse volume ids
-
-        // we only care for 'tag' as key for tag_maps[3]
-        infile >> entity_tag >> box_min_x >> box_min_y >> box_min_z >> box_max_x >> box_max_y >> box_max_z >> n_physicals;
-        // if there is a physical tag, we will use it as boundary id below
-        AssertThrow(n_physicals < 2,
-                    dealii::ExcMessage("More than one tag is not supported!"));
-        // if there is no physical tag, use 0 as default
-        int physical_tag = 0;
-        for (unsigned int j = 0; j < n_physicals; ++j) {
-            infile >> physical_tag;
-        }
-        //std::cout << "Entity volume tag " << entity_tag << " with physical tag " << physical_tag << std::endl;
-        tag_maps[3][entity_tag] = physical_tag;
-        // we don't care about the surfaces associated to a volume, but
-        // have to parse them anyway because their format is unstructured
-        infile >> n_surfaces;
-        for (unsigned int j = 0; j < n_surfaces; ++j) {
-            infile >> entity_tag;
-        }
+
+    /// Skips the rest of the section @p section_name, such as "$PhysicalNames", including its end marker.
+    void skip_section (const std::string &section_name)
+    {
+        const std::string end_marker = "$End" + section_name.substr(1);
+        const char *found = std::search(position, end, end_marker.begin(), end_marker.end());
+        AssertThrow(found != end, dealii::ExcMessage("Could not find " + end_marker + " in the Gmsh file."));
+        position = found + end_marker.size();
     }
-    infile >> line;
-    //AssertThrow(line == "$EndEntities", PHiLiP::ExcInvalidGMSHInput(line));
-}
 
-template<int spacedim>
-void read_gmsh_nodes( std::ifstream &infile, std::vector<dealii::Point<spacedim>> &vertices, std::map<int, int> &vertex_indices )
-{
-    std::string  line;
-    // now read the nodes list
-    unsigned int n_entity_blocks, n_vertices;
-    int min_node_tag;
-    int max_node_tag;
-    infile >> n_entity_blocks >> n_vertices >> min_node_tag >> max_node_tag;
-    std::cout << "Reading nodes..." << std::endl;
-    //std::cout << "Number of entity blocks: " << n_entity_blocks << " with a total of " << n_vertices << " vertices." << std::endl;
-
-    vertices.resize(n_vertices);
-  
-    unsigned int global_vertex = 0;
-    for (unsigned int entity_block = 0; entity_block < n_entity_blocks; ++entity_block) {
-        int           parametric;
-        unsigned long numNodes;
-
-        // for gmsh_file_format 4.1 the order of tag and dim is reversed,
-        // but we are ignoring both anyway.
-        int tagEntity, dimEntity;
-        infile >> tagEntity >> dimEntity >> parametric >> numNodes;
-
-        //std::cout << "Entity block: " << entity_block << " with tag " << tagEntity << " in " << dimEntity << " dimension with " << numNodes << " nodes. Parametric: " << parametric << std::endl;
-
-        std::vector<int> vertex_numbers;
-
-        for (unsigned long vertex_per_entity = 0; vertex_per_entity < numNodes; ++vertex_per_entity) {
-            int vertex_number;
-            infile >> vertex_number;
-            //std::cout << vertex_number << std::endl;
-            vertex_numbers.push_back(vertex_number);
-        }
+private:
+    /// Skips spaces and line breaks.
+    void skip_whitespace ()
+    {
+        while (position < end && std::isspace(static_cast<unsigned char>(*position))) ++position;
+    }
 
-        for (unsigned long vertex_per_entity = 0; vertex_per_entity < numNodes; ++vertex_per_entity, ++global_vertex) {
-            // read vertex
-            double x[3];
-            infile >> x[0] >> x[1] >> x[2];
-            //std::cout << x[0] << " " << x[1] << " " << x[2] << " ";
-            //if (parametric == 0) std::cout << std::endl;
+    const char *position; ///< Current position in the buffer.
+    const char *const end; ///< End of the file, excluding the terminating '\0'.
+};
 
+/// Grid read from a Gmsh file.
+/** Stored as flat arrays such that it can be read by a single process and broadcast to the others.
+ */
+struct GmshGrid
+{
+    unsigned int grid_order = 0; ///< Order of the cells.
+    std::vector<double> node_coordinates; ///< 3 coordinates per node.
+    std::vector<unsigned int> cell_nodes; ///< Node indices of each cell in the Gmsh ordering.
+    std::vector<unsigned int> cell_material_ids; ///< Physical tag of each cell.
+    std::vector<unsigned int> boundary_line_vertices; ///< Vertex indices of each boundary line.
+    std::vector<unsigned int> boundary_line_ids; ///< Physical tag of each boundary line.
+    std::vector<unsigned int> boundary_quad_vertices; ///< Vertex indices of each boundary quadrilateral.
+    std::vector<unsigned int> boundary_quad_ids; ///< Physical tag of each boundary quadrilateral.
+
+    /// Broadcasts the grid read by the process @p root.
+    void broadcast (const MPI_Comm mpi_communicator, const int root)
+    {
+        MPI_Bcast(&grid_order, 1, MPI_UNSIGNED, root, mpi_communicator);
+        broadcast_vector(node_coordinates, mpi_communicator, root);
+        broadcast_vector(cell_nodes, mpi_communicator, root);
+        broadcast_vector(cell_material_ids, mpi_communicator, root);
+        broadcast_vector(boundary_line_vertices, mpi_communicator, root);
+        broadcast_vector(boundary_line_ids, mpi_communicator, root);
+        broadcast_vector(boundary_quad_vertices, mpi_communicator, root);
+        broadcast_vector(boundary_quad_ids, mpi_communicator, root);
+    }
 
-            for (unsigned int d = 0; d < spacedim; ++d) {
-                vertices[global_vertex](d) = x[d];
-            }
+private:
+    /// Broadcasts the entries of @p values in chunks small enough for the int counts of MPI.
+    template <typename T>
+    static void broadcast_vector (std::vector<T> &values, const MPI_Comm mpi_communicator, const int root)
+    {
+        unsigned long long size = values.size();
+        MPI_Bcast(&size, 1, MPI_UNSIGNED_LONG_LONG, root, mpi_communicator);
+        values.resize(size);
+
+        char *bytes = reinterpret_cast<char*>(values.data());
+        const std::size_t n_bytes = size * sizeof(T);
+        const std::size_t max_chunk = 1 << 30;
+        for (std::size_t offset = 0; offset < n_bytes; offset += max_chunk) {
+            const int chunk = static_cast<int>(std::min(max_chunk, n_bytes - offset));
+            MPI_Bcast(bytes + offset, chunk, MPI_BYTE, root, mpi_communicator);
+        }
+    }
+};
 
-            int vertex_number;
-            vertex_number = vertex_numbers[vertex_per_entity];
-            // store mapping
-            vertex_indices[vertex_number] = global_vertex;
+void read_gmsh_entities(GmshFileCursor &cursor, std::array<std::map<int, int>, 4> &tag_maps)
+{
+    // Number of points, curves, surfaces and volumes.
+    std::uint64_t n_entities[4];
+    cursor.read(4, n_entities);
+
+    for (unsigned int entity_dim = 0; entity_dim < 4; ++entity_dim) {
+        for (std::uint64_t i = 0; i < n_entities[entity_dim]; ++i) {
+            // we only care for 'tag' as key for tag_maps[entity_dim]
+            const int entity_tag = cursor.read<int>();
+
+            // Coordinates of a point, or bounding box of the other entities
+            double box[6];
+            cursor.read(entity_dim == 0 ? 3 : 6, box);
+
+            const std::uint64_t n_physicals = cursor.read<std::uint64_t>();
+            // if there is a physical tag, we will use it as boundary id below
+            AssertThrow(n_physicals < 2, dealii::ExcMessage("More than one tag is not supported!"));
+            // if there is no physical tag, use 0 as default
+            int physical_tag = 0;
+            for (std::uint64_t j = 0; j < n_physicals; ++j) {
+                physical_tag = cursor.read<int>();
+            }
+            tag_maps[entity_dim][entity_tag] = physical_tag;
 
+            // we don't care about the bounding entities, but have
+            // to parse them anyway because their format is unstructured
+            if (entity_dim > 0) {
+                const std::uint64_t n_bounding = cursor.read<std::uint64_t>();
+                for (std::uint64_t j = 0; j < n_bounding; ++j) cursor.read<int>();
+            }
+        }
+    }
+}
 
-            // ignore parametric coordinates
-            if (parametric != 0) {
-                int n_parametric = dimEntity;
-                if (dimEntity == 0) n_parametric = 1;
-                double uvw[3];
-                for (int d=0; d<n_parametric; ++d) {
-                    infile >> uvw[d];
-                    //std::cout << uvw[d] << " ";
+void read_gmsh_nodes(GmshFileCursor &cursor, GmshGrid &grid, std::vector<unsigned int> &node_tag_to_index)
+{
+    std::uint64_t n_entity_blocks, n_nodes, min_node_tag, max_node_tag;
+    n_entity_blocks = cursor.read<std::uint64_t>();
+    n_nodes = cursor.read<std::uint64_t>();
+    min_node_tag = cursor.read<std::uint64_t>();
+    max_node_tag = cursor.read<std::uint64_t>();
+    (void) min_node_tag;
+    std::cout << "Reading " << n_nodes << " nodes..." << std::endl;
+
+    grid.node_coordinates.resize(3 * n_nodes);
+    node_tag_to_index.assign(max_node_tag + 1, dealii::numbers::invalid_unsigned_int);
+
+    std::vector<std::uint64_t> node_tags;
+    std::uint64_t first_node = 0;
+    for (std::uint64_t entity_block = 0; entity_block < n_entity_blocks; ++entity_block) {
+        const int entity_dim = cursor.read<int>();
+        const int entity_tag = cursor.read<int>(); (void) entity_tag;
+        const int parametric = cursor.read<int>();
+        const std::uint64_t n_block_nodes = cursor.read<std::uint64_t>();
+        AssertThrow(first_node + n_block_nodes <= n_nodes, dealii::ExcMessage("Too many nodes in the Gmsh file."));
+
+        node_tags.resize(n_block_nodes);
+        cursor.read(n_block_nodes, node_tags.data());
+        for (std::uint64_t i = 0; i < n_block_nodes; ++i) {
+            AssertThrow(node_tags[i] <= max_node_tag, dealii::ExcMessage("Invalid node tag in the Gmsh file."));
+            node_tag_to_index[node_tags[i]] = first_node + i;
+        }
 
-                }
-                //std::cout << std::endl;
-                (void)uvw;
+        double *coordinates = &grid.node_coordinates[3 * first_node];
+        if (parametric == 0) {
+            cursor.read(3 * n_block_nodes, coordinates);
+        } else {
+            // ignore parametric coordinates, which follow the coordinates of each node
+            double uvw[3];
+            for (std::uint64_t i = 0; i < n_block_nodes; ++i) {
+                cursor.read(3, coordinates + 3*i);
+                cursor.read(entity_dim, uvw);
             }
         }
+        first_node += n_block_nodes;
     }
-    AssertDimension(global_vertex, n_vertices);
-    std::cout << "Finished reading nodes." << std::endl;
+    AssertDimension(first_node, n_nodes);
 }
 
 unsigned int gmsh_cell_type_to_order(unsigned int cell_type)
@@ -344,57 +328,145 @@ unsigned int gmsh_cell_type_to_order(unsigned int cell_type)
     return cell_order;
 }
 
-template<int dim>
-unsigned int find_grid_order(std::ifstream &infile)
+template <int dim>
+void read_gmsh_elements(
+    GmshFileCursor &cursor,
+    const std::array<std::map<int, int>, 4> &tag_maps,
+    const std::vector<unsigned int> &node_tag_to_index,
+    GmshGrid &grid)
 {
-    auto entity_file_position = infile.tellg();
-
-    unsigned int grid_order = 0;
-
-    unsigned int n_entity_blocks, n_cells;
-    int min_ele_tag, max_ele_tag;
-    infile >> n_entity_blocks >> n_cells >> min_ele_tag >> max_ele_tag;
-
-    std::cout << "Finding grid order..." << std::endl;
-    std::cout << n_entity_blocks << " entity blocks with a total of " << n_cells << " cells. " << std::endl;
-
-    std::vector<unsigned int> vertices_id;
-
-    unsigned int global_cell = 0;
-    for (unsigned int entity_block = 0; entity_block < n_entity_blocks; ++entity_block) {
-        unsigned long numElements;
-        int           cell_type;
-
-        int tagEntity, dimEntity;
-        infile >> dimEntity >> tagEntity >> cell_type >> numElements;
-        //std::cout << "Entity block " << entity_block << " of dimension " << dimEntity << " with tag " << tagEntity << " and celltype = " << cell_type << " containing " << numElements << " elements. " << std::endl;
-
-        const unsigned int cell_order = gmsh_cell_type_to_order(cell_type);
-        const unsigned int nodes_per_element = std::pow(cell_order + 1, dimEntity);
-
-        grid_order = std::max(cell_order, grid_order);
-
-        vertices_id.resize(nodes_per_element);
+    std::uint64_t n_entity_blocks, n_elements, min_element_tag, max_element_tag;
+    n_entity_blocks = cursor.read<std::uint64_t>();
+    n_elements = cursor.read<std::uint64_t>();
+    min_element_tag = cursor.read<std::uint64_t>();
+    max_element_tag = cursor.read<std::uint64_t>();
+    (void) min_element_tag; (void) max_element_tag;
+    std::cout << "Reading " << n_elements << " elements..." << std::endl;
+
+    const auto node_index = [&node_tag_to_index] (const std::uint64_t node_tag) {
+        const unsigned int index = (node_tag < node_tag_to_index.size()) ? node_tag_to_index[node_tag] : dealii::numbers::invalid_unsigned_int;
+        AssertThrow(index != dealii::numbers::invalid_unsigned_int, dealii::ExcMessage("Element refers to an invalid node tag."));
+        return index;
+    };
+
+    // Tag followed by the node tags of each element of a block.
+    std::vector<std::uint64_t> element_data;
+    std::uint64_t global_element = 0;
+    for (std::uint64_t entity_block = 0; entity_block < n_entity_blocks; ++entity_block) {
+        const int entity_dim = cursor.read<int>();
+        const int entity_tag = cursor.read<int>();
+        const int element_type = cursor.read<int>();
+        const std::uint64_t n_block_elements = cursor.read<std::uint64_t>();
+
+        const unsigned int element_order = gmsh_cell_type_to_order(element_type);
+        AssertThrow(element_order > 0 || element_type == MSH_PNT,
+                    dealii::ExcMessage("Unsupported Gmsh element type " + std::to_string(element_type)
+                                       + ". Only lines, quadrilaterals and hexahedra are supported."));
+        const unsigned int nodes_per_element = (element_type == MSH_PNT) ? 1 : dealii::Utilities::pow(element_order + 1, entity_dim);
+        const unsigned int vertices_per_element = dealii::Utilities::pow(2, entity_dim);
+
+        element_data.resize(n_block_elements * (1 + nodes_per_element));
+        cursor.read(element_data.size(), element_data.data());
+        global_element += n_block_elements;
+
+        const auto physical_tag = tag_maps[entity_dim].find(entity_tag);
+        const unsigned int material_id = (physical_tag != tag_maps[entity_dim].end()) ? physical_tag->second : 0;
+
+        if (entity_dim == dim) {
+            // Found cells
+            if (grid.grid_order == 0) grid.grid_order = element_order;
+            AssertThrow(element_order == grid.grid_order, dealii::ExcMessage("All the cells of the Gmsh grid must have the same order."));
+
+            for (std::uint64_t ielement = 0; ielement < n_block_elements; ++ielement) {
+                const std::uint64_t *element_nodes = &element_data[ielement * (1 + nodes_per_element) + 1];
+                for (unsigned int i = 0; i < nodes_per_element; ++i) {
+                    grid.cell_nodes.push_back(node_index(element_nodes[i]));
+                }
+                grid.cell_material_ids.push_back(material_id);
+            }
+        } else if ((entity_dim == 1 || entity_dim == 2) && entity_dim < dim) {
+            // Boundary info, only the vertices of the faces are needed
+            auto &boundary_vertices = (entity_dim == 1) ? grid.boundary_line_vertices : grid.boundary_quad_vertices;
+            auto &boundary_ids = (entity_dim == 1) ? grid.boundary_line_ids : grid.boundary_quad_ids;
+            for (std::uint64_t ielement = 0; ielement < n_block_elements; ++ielement) {
+                const std::uint64_t *element_nodes = &element_data[ielement * (1 + nodes_per_element) + 1];
+                for (unsigned int i = 0; i < vertices_per_element; ++i) {
+                    boundary_vertices.push_back(node_index(element_nodes[i]));
+                }
+                boundary_ids.push_back(material_id);
+            }
+        }
+        // Points only carry boundary indicators in 1D, which does not use Gmsh grids.
+    }
+    AssertDimension(global_element, n_elements);
+}
 
-        for (unsigned int cell_per_entity = 0; cell_per_entity < numElements; ++cell_per_entity, ++global_cell) {
-            // note that since infile the input file we found the number of p1_cells at the top, there
-            // should still be input here, so check this:
-            AssertThrow(infile, dealii::ExcIO());
+/// Reads the whole Gmsh 4.1 file at once and parses it in memory.
+/** Supports both the ASCII and binary formats.
+ */
+template <int dim>
+GmshGrid read_gmsh_file(const std::string &filename)
+{
+    std::ifstream infile(filename, std::ios::binary | std::ios::ate);
+    if(!infile) {
+        std::cout << "Could not open file "<< filename << std::endl;
+        std::abort();
+    }
+    const std::streamsize file_size = infile.tellg();
+    infile.seekg(0, std::ios::beg);
+    std::vector<char> buffer(file_size + 1);
+    infile.read(buffer.data(), file_size);
+    AssertThrow(infile, dealii::ExcIO());
+    buffer[file_size] = '\0';
 
-            int tag;
-            infile >> tag;
+    GmshFileCursor cursor(buffer);
 
-            for (unsigned int i = 0; i < nodes_per_element; ++i) {
-                infile >> vertices_id[i];
+    // This array stores maps from the 'entities' to the 'physical tags' for
+    // points, curves, surfaces and volumes. We use this information later to
+    // assign boundary ids.
+    std::array<std::map<int, int>, 4> tag_maps;
+    // Node index of each node tag.
+    std::vector<unsigned int> node_tag_to_index;
+
+    GmshGrid grid;
+    bool found_elements = false;
+    while (!found_elements && !cursor.at_end()) {
+        const std::string section = cursor.read_word();
+        if (section == "$MeshFormat") {
+            const double version = cursor.read<double>();
+            const int file_type = cursor.read<int>();
+            const int data_size = cursor.read<int>();
+            AssertThrow(version == 4.1, dealii::ExcMessage("Only the Gmsh 4.1 file format is supported."));
+            AssertThrow(data_size == sizeof(double), dealii::ExcNotImplemented());
+            if (file_type == 1) {
+                cursor.skip_line_end();
+                cursor.binary = true;
+                const int one = cursor.read<int>();
+                AssertThrow(one == 1, dealii::ExcMessage("The binary Gmsh file was written with a different endianness."));
             }
-        } // End of cell per entity
-    } // End of entity block
-
-    infile.seekg(entity_file_position);
+        } else if (section == "$Entities") {
+            read_gmsh_entities(cursor, tag_maps);
+        } else if (section == "$Nodes") {
+            read_gmsh_nodes(cursor, grid, node_tag_to_index);
+        } else if (section == "$Elements") {
+            AssertThrow(!node_tag_to_index.empty(), dealii::ExcMessage("The Gmsh $Nodes must come before the $Elements."));
+            read_gmsh_elements<dim>(cursor, tag_maps, node_tag_to_index, grid);
+            found_elements = true;
+        } else {
+            // $PhysicalNames, $PartitionedEntities, and any other section are ignored
+            AssertThrow(section.size() > 1 && section[0] == '$', dealii::ExcMessage("Unexpected " + section + " in the Gmsh file."));
+            cursor.skip_section(section);
+            continue;
+        }
+        // Assert we reached the end of the block
+        const std::string end_marker = cursor.read_word();
+        AssertThrow(end_marker == "$End" + section.substr(1), dealii::ExcMessage("Expected $End" + section.substr(1) + " but found " + end_marker));
+    }
+    AssertThrow(found_elements, dealii::ExcMessage("No $Elements found in the Gmsh file."));
+    AssertThrow(grid.grid_order > 0, dealii::ExcMessage("No cells found in the Gmsh file."));
+    std::cout << "Found grid order = " << grid.grid_order << std::endl;
 
-    AssertDimension(global_cell, n_cells);
-    std::cout << "Found grid order = " << grid_order << std::endl;
-    return grid_order;
+    return grid;
 }
 
 unsigned int ijk_to_num(const unsigned int i,
@@ -426,9 +498,6 @@ gmsh_hierarchic_to_lexicographic(const unsigned int degree)
         return h2l;
     }
 
-    // polynomial degree
-    const unsigned int dofs_per_line = degree - 1;
-
     // the following lines of code are somewhat odd, due to the way the
     // hierarchic numbering is organized. if someone would really want to
     // understand these lines, you better draw some pictures where you
@@ -515,91 +584,72 @@ gmsh_hierarchic_to_lexicographic(const unsigned int degree)
 
           break;
     } case 3: {
-
-        Assert(false, dealii::ExcNotImplemented());
+        // Gmsh numbers the nodes shell by shell: the 8 vertices, the interior nodes of the 12 edges,
+        // the interior nodes of the 6 faces numbered as quadrilaterals, and then the nodes of the
+        // inner hexahedron, numbered the same way.
+        const unsigned int edges[12][2] = { {0,1}, {0,3}, {0,4}, {1,2}, {1,5}, {2,3},
+                                            {2,6}, {3,7}, {4,5}, {4,7}, {5,6}, {6,7} };
+        const unsigned int faces[6][4] = { {0,3,2,1}, {0,1,5,4}, {0,4,7,3},
+                                           {1,2,6,5}, {2,3,7,6}, {4,5,6,7} };
 
         unsigned int next_index = 0;
-        // first the eight vertices
-        h2l[next_index++] = 0;                        // 0
-        h2l[next_index++] = (1) * degree;             // 1
-        h2l[next_index++] = (n)*degree;               // 2
-        h2l[next_index++] = (n + 1) * degree;         // 3
-        h2l[next_index++] = (n * n) * degree;         // 4
-        h2l[next_index++] = (n * n + 1) * degree;     // 5
-        h2l[next_index++] = (n * n + n) * degree;     // 6
-        h2l[next_index++] = (n * n + n + 1) * degree; // 7
-
-        // line 0
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          h2l[next_index++] = (i + 1) * n;
-        // line 1
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          h2l[next_index++] = n - 1 + (i + 1) * n;
-        // line 2
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          h2l[next_index++] = 1 + i;
-        // line 3
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          h2l[next_index++] = 1 + i + n * (n - 1);
-
-        // line 4
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          h2l[next_index++] = (n - 1) * n * n + (i + 1) * n;
-        // line 5
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          h2l[next_index++] = (n - 1) * (n * n + 1) + (i + 1) * n;
-        // line 6
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          h2l[next_index++] = n * n * (n - 1) + i + 1;
-        // line 7
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          h2l[next_index++] = n * n * (n - 1) + i + 1 + n * (n - 1);
-
-        // line 8
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          h2l[next_index++] = (i + 1) * n * n;
-        // line 9
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          h2l[next_index++] = n - 1 + (i + 1) * n * n;
-        // line 10
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          h2l[next_index++] = (i + 1) * n * n + n * (n - 1);
-        // line 11
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          h2l[next_index++] = n - 1 + (i + 1) * n * n + n * (n - 1);
-
-
-        // inside quads
-        // face 0
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          for (unsigned int j = 0; j < dofs_per_line; ++j)
-            h2l[next_index++] = (i + 1) * n * n + n * (j + 1);
-        // face 1
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          for (unsigned int j = 0; j < dofs_per_line; ++j)
-            h2l[next_index++] = (i + 1) * n * n + n - 1 + n * (j + 1);
-        // face 2, note the orientation!
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          for (unsigned int j = 0; j < dofs_per_line; ++j)
-            h2l[next_index++] = (j + 1) * n * n + i + 1;
-        // face 3, note the orientation!
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          for (unsigned int j = 0; j < dofs_per_line; ++j)
-            h2l[next_index++] = (j + 1) * n * n + n * (n - 1) + i + 1;
-        // face 4
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          for (unsigned int j = 0; j < dofs_per_line; ++j)
-            h2l[next_index++] = n * (i + 1) + j + 1;
-        // face 5
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          for (unsigned int j = 0; j < dofs_per_line; ++j)
-            h2l[next_index++] = (n - 1) * n * n + n * (i + 1) + j + 1;
-
-        // inside hex
-        for (unsigned int i = 0; i < dofs_per_line; ++i)
-          for (unsigned int j = 0; j < dofs_per_line; ++j)
-            for (unsigned int k = 0; k < dofs_per_line; ++k)
-              h2l[next_index++] = n * n * (i + 1) + n * (j + 1) + k + 1;
+        for (int start = 0, end = n-1; start <= end; ++start, --end) {
+            const int shell_degree = end - start;
+            if (shell_degree == 0) {
+                h2l[next_index++] = ijk_to_num(start, start, start, n);
+                break;
+            }
+
+            // Lexicographic coordinates of the vertices of the shell
+            int vertices[8][3];
+            for (unsigned int v = 0; v < 8; ++v) {
+                vertices[v][0] = (v == 1 || v == 2 || v == 5 || v == 6) ? end : start;
+                vertices[v][1] = (v == 2 || v == 3 || v == 6 || v == 7) ? end : start;
+                vertices[v][2] = (v >= 4) ? end : start;
+            }
+            // Lexicographic index of the node at vertices[origin] + a*u + b*v
+            const auto node = [&] (const unsigned int origin, const int *u, const int *v, const int a, const int b) {
+                const int *x = vertices[origin];
+                return ijk_to_num(x[0] + a*u[0] + b*v[0], x[1] + a*u[1] + b*v[1], x[2] + a*u[2] + b*v[2], n);
+            };
+            const auto unit_direction = [&] (const unsigned int from, const unsigned int to, int *direction) {
+                for (int d = 0; d < 3; ++d) direction[d] = (vertices[to][d] - vertices[from][d]) / shell_degree;
+            };
+            const int zero[3] = {0, 0, 0};
+
+            // First the eight vertices
+            for (unsigned int v = 0; v < 8; ++v) {
+                h2l[next_index++] = node(v, zero, zero, 0, 0);
+            }
+            // Edges, from their first to their second vertex
+            for (const auto &edge : edges) {
+                int u[3];
+                unit_direction(edge[0], edge[1], u);
+                for (int a = 1; a < shell_degree; ++a) {
+                    h2l[next_index++] = node(edge[0], u, zero, a, 0);
+                }
+            }
+            // Faces, as quadrilaterals along their first and last edges
+            for (const auto &face : faces) {
+                int u[3], v[3];
+                unit_direction(face[0], face[1], u);
+                unit_direction(face[0], face[3], v);
+                for (int face_start = 1, face_end = shell_degree-1; face_start <= face_end; ++face_start, --face_end) {
+                    if (face_start == face_end) {
+                        h2l[next_index++] = node(face[0], u, v, face_start, face_start);
+                        break;
+                    }
+                    h2l[next_index++] = node(face[0], u, v, face_start, face_start);
+                    h2l[next_index++] = node(face[0], u, v, face_end,   face_start);
+                    h2l[next_index++] = node(face[0], u, v, face_end,   face_end);
+                    h2l[next_index++] = node(face[0], u, v, face_start, face_end);
+                    for (int a = face_start+1; a < face_end; ++a) h2l[next_index++] = node(face[0], u, v, a, face_start);
+                    for (int b = face_start+1; b < face_end; ++b) h2l[next_index++] = node(face[0], u, v, face_end, b);
+                    for (int a = face_end-1; a > face_start; --a) h2l[next_index++] = node(face[0], u, v, a, face_end);
+                    for (int b = face_end-1; b > face_start; --b) h2l[next_index++] = node(face[0], u, v, face_start, b);
+                }
+            }
+        }
 
         Assert(next_index == dofs_per_cell, dealii::ExcInternalError());
 
@@ -630,313 +680,119 @@ void fe_q_node_number(const unsigned int index,
     k = index;
 }
 
+/// Lexicographic node index of a Gmsh cell matching each lexicographic node index of a deal.II cell.
+/** One map for each of the symmetries of the square or cube, that is each permutation of the axes
+ *  combined with each reflection. The identity comes first.
+ */
+template <int dim>
+std::vector<std::vector<unsigned int>> lexicographic_symmetries(const unsigned int n_per_line)
+{
+    const unsigned int n_nodes = dealii::Utilities::fixed_power<dim>(n_per_line);
+
+    std::vector<std::vector<unsigned int>> symmetries;
+    std::array<unsigned int, dim> axes;
+    for (int d = 0; d < dim; ++d) axes[d] = d;
+    do {
+        for (unsigned int reflections = 0; reflections < (1u << dim); ++reflections) {
+            std::vector<unsigned int> symmetry(n_nodes);
+            for (unsigned int index = 0; index < n_nodes; ++index) {
+                // Coordinate d of the deal.II node becomes coordinate axes[d] of the Gmsh node.
+                std::array<unsigned int, dim> mapped_ijk;
+                unsigned int remainder = index;
+                for (int d = 0; d < dim; ++d) {
+                    const unsigned int i = remainder % n_per_line;
+                    remainder /= n_per_line;
+                    mapped_ijk[axes[d]] = ((reflections >> d) & 1) ? n_per_line - 1 - i : i;
+                }
+                unsigned int mapped_index = 0;
+                for (int d = dim-1; d >= 0; --d) mapped_index = mapped_index * n_per_line + mapped_ijk[d];
+                symmetry[index] = mapped_index;
+            }
+            symmetries.push_back(symmetry);
+        }
+    } while (std::next_permutation(axes.begin(), axes.end()));
+
+    return symmetries;
+}
+
 template <int dim, int spacedim>
 std::shared_ptr< HighOrderGrid<dim, double> >
 read_gmsh(std::string filename, int requested_grid_order)
 {
-
-    //for (unsigned int deg = 1; deg < 7; ++deg) {
-    //    std::cout << "DEGREE " << deg << std::endl;
-    //    std::vector<unsigned int> h2l = gmsh_hierarchic_to_lexicographic<dim>(deg);
-    //    std::vector<unsigned int> l2h = dealii::Utilities::invert_permutation(h2l);
-
-    //    unsigned int n = deg+1;
-    //    std::cout << "L2H "  << std::endl;
-    //    for (int j=n-1; j>=0; --j) {
-    //        for (unsigned int i=0; i<n; ++i) {
-    //            const unsigned int ij = ij_to_num(i,j,n);
-    //            std::cout << l2h[ij] << " ";
-    //        }
-    //        std::cout << std::endl;
-    //    }
-
-    //    std::cout << std::endl << std::endl;
-    //}
-    //std::abort();
-
-    Assert(dim==2, dealii::ExcInternalError());
-    std::ifstream infile;
-
-    open_file_toRead(filename, infile);
-  
-    std::string  line;
-    // This array stores maps from the 'entities' to the 'physical tags' for
-    // points, curves, surfaces and volumes. We use this information later to
-    // assign boundary ids.
-    std::array<std::map<int, int>, 4> tag_maps;
-  
-  
-    infile >> line;
-  
-    //Assert(tria != nullptr, dealii::ExcNoTriangulationSelected());
-  
-    // first determine file format
-    unsigned int gmsh_file_format = 0;
-    if (line == "$MeshFormat") {
-      gmsh_file_format = 20;
-    } else {
-      //AssertThrow(false, dealii::ExcInvalidGMSHInput(line));
-    }
-  
-  
-    // if file format is 2.0 or greater then we also have to read the rest of the
-    // header
-    if (gmsh_file_format == 20) {
-        double       version;
-        unsigned int file_type, data_size;
-  
-        infile >> version >> file_type >> data_size;
-  
-        Assert((version == 4.1), dealii::ExcNotImplemented());
-        gmsh_file_format = static_cast<unsigned int>(version * 10);
-  
-  
-        Assert(file_type == 0, dealii::ExcNotImplemented());
-        Assert(data_size == sizeof(double), dealii::ExcNotImplemented());
-  
-  
-        // read the end of the header and the first line of the nodes description
-        // to synch ourselves with the format 1 handling above
-        infile >> line;
-        //AssertThrow(line == "$EndMeshFormat", PHiLiP::ExcInvalidGMSHInput(line));
-  
-  
-        infile >> line;
-        // if the next block is of kind $PhysicalNames, ignore it
-        if (line == "$PhysicalNames") {
-            do {
-                infile >> line;
-            } while (line != "$EndPhysicalNames");
-            infile >> line;
-        }
-  
-  
-        // if the next block is of kind $Entities, parse it
-        if (line == "$Entities") read_gmsh_entities(infile, tag_maps);
-        infile >> line;
-  
-        // if the next block is of kind $PartitionedEntities, ignore it
-        if (line == "$PartitionedEntities") {
-            do {
-                infile >> line;
-            } while (line != "$EndPartitionedEntities");
-            infile >> line;
+    const Telemetry::ScopedTimer timer("read_gmsh");
+    const MPI_Comm mpi_communicator = MPI_COMM_WORLD;
+    const int mpi_rank = dealii::Utilities::MPI::this_mpi_process(mpi_communicator);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+
+    // The first process reads the file and sends the grid to the others, which need the whole coarse grid anyway.
+    GmshGrid gmsh_grid;
+    if (mpi_rank == 0) gmsh_grid = read_gmsh_file<dim>(filename);
+    gmsh_grid.broadcast(mpi_communicator, 0);
+
+    const unsigned int grid_order = gmsh_grid.grid_order;
+    const unsigned int vertices_per_cell = dealii::GeometryInfo<dim>::vertices_per_cell;
+    const unsigned int nodes_per_cell = dealii::Utilities::fixed_power<dim>(grid_order + 1);
+    const unsigned int n_cells = gmsh_grid.cell_material_ids.size();
+    AssertDimension(gmsh_grid.cell_nodes.size(), n_cells * nodes_per_cell);
+
+    std::vector<dealii::Point<spacedim>> vertices(gmsh_grid.node_coordinates.size() / 3);
+    for (unsigned int i = 0; i < vertices.size(); ++i) {
+        for (unsigned int d = 0; d < spacedim; ++d) {
+            vertices[i](d) = gmsh_grid.node_coordinates[3*i + d];
         }
-  
-        // but the next thing should,
-        // infile any case, be the list of
-        // nodes:
-        //AssertThrow(line == "$Nodes", PHiLiP::ExcInvalidGMSHInput(line));
     }
-  
-    std::vector<dealii::Point<spacedim>> vertices;
-    // set up mapping between numbering
-    // infile msh-file (nod) and infile the
-    // vertices vector
-    std::map<int, int> vertex_indices;
-    read_gmsh_nodes( infile, vertices, vertex_indices );
-  
-    // Assert we reached the end of the block
-    infile >> line;
-    static const std::string end_nodes_marker = "$EndNodes";
-    //AssertThrow(line == end_nodes_marker, PHiLiP::ExcInvalidGMSHInput(line));
-  
-    // Now read infile next bit
-    infile >> line;
-    static const std::string begin_elements_marker = "$Elements";
-    //AssertThrow(line == begin_elements_marker, PHiLiP::ExcInvalidGMSHInput(line));
-
-    const unsigned int grid_order = find_grid_order<dim>(infile);
-  
+
     using Triangulation = dealii::parallel::distributed::Triangulation<dim>;
     std::shared_ptr<Triangulation> triangulation = std::make_shared<Triangulation>(
-        MPI_COMM_WORLD,
+        mpi_communicator,
         typename dealii::Triangulation<dim>::MeshSmoothing(
             dealii::Triangulation<dim>::smoothing_on_refinement |
             dealii::Triangulation<dim>::smoothing_on_coarsening));
 
     auto high_order_grid = std::make_shared<HighOrderGrid<dim, double>>(grid_order, triangulation);
-  
-    unsigned int n_entity_blocks, n_cells;
-    int min_ele_tag, max_ele_tag;
-    infile >> n_entity_blocks >> n_cells >> min_ele_tag >> max_ele_tag;
-    // set up array of p1_cells and subcells (faces). In 1d, there is currently no
-    // standard way infile deal.II to pass boundary indicators attached to individual
-    // vertices, so do this by hand via the boundary_ids_1d array
-
-    std::vector<dealii::CellData<dim>> p1_cells;
-    std::vector<dealii::CellData<dim>> high_order_cells;
-    dealii::CellData<dim> temp_high_order_cells;
-
-    dealii::SubCellData                                subcelldata;
-    std::map<unsigned int, dealii::types::boundary_id> boundary_ids_1d;
-
-  
-  
-    unsigned int global_cell = 0;
-    for (unsigned int entity_block = 0; entity_block < n_entity_blocks; ++entity_block) {
-        unsigned int  material_id;
-        unsigned long numElements;
-        int           cell_type;
-
-        // for gmsh_file_format 4.1 the order of tag and dim is reversed,
-        int tagEntity, dimEntity;
-        infile >> dimEntity >> tagEntity >> cell_type >> numElements;
-        material_id = tag_maps[dimEntity][tagEntity];
-
-        const unsigned int cell_order = gmsh_cell_type_to_order(cell_type);
-
-        unsigned int vertices_per_element = std::pow(2, dimEntity);
-        unsigned int nodes_per_element = std::pow(cell_order + 1, dimEntity);
-
-
-        for (unsigned int cell_per_entity = 0; cell_per_entity < numElements; ++cell_per_entity, ++global_cell) {
-
-            // ignore tag
-            int tag;
-            infile >> tag;
-
-            if (dimEntity == dim) {
-                // Found a cell
-
-                // Allocate and read indices
-                p1_cells.emplace_back(vertices_per_element);
-                high_order_cells.emplace_back(vertices_per_element);
-
-                auto &p1_vertices_id = p1_cells.back().vertices;
-                auto &high_order_vertices_id = high_order_cells.back().vertices;
-
-                p1_vertices_id.resize(vertices_per_element);
-                high_order_vertices_id.resize(nodes_per_element);
-
-                for (unsigned int i = 0; i < nodes_per_element; ++i) {
-                    infile >> high_order_vertices_id[i];
-                }
-                for (unsigned int i = 0; i < vertices_per_element; ++i) {
-                    p1_vertices_id[i] = high_order_vertices_id[i];
-                }
-
-                // to make sure that the cast won't fail
-                Assert(material_id <= std::numeric_limits<dealii::types::material_id>::max(),
-                       dealii::ExcIndexRange( material_id, 0, std::numeric_limits<dealii::types::material_id>::max()));
-                // we use only material_ids infile the range from 0 to dealii::numbers::invalid_material_id-1
-                AssertIndexRange(material_id, dealii::numbers::invalid_material_id);
-
-                p1_cells.back().material_id = material_id;
-
-                // transform from ucd to consecutive numbering
-                for (unsigned int i = 0; i < vertices_per_element; ++i) {
-                    //AssertThrow( vertex_indices.find(p1_cells.back().vertices[i]) != vertex_indices.end(),
-                    //  dealii::ExcInvalidVertexIndexGmsh(global_cell, elm_number, p1_cells.back().vertices[i]));
-
-                    // vertex with this index exists
-                    p1_vertices_id[i] = vertex_indices[p1_cells.back().vertices[i]];
-                }
-                for (unsigned int i = 0; i < nodes_per_element; ++i) {
-                    high_order_vertices_id[i] = vertex_indices[high_order_cells.back().vertices[i]];
-                }
-            } else if (dimEntity == 1 && dimEntity < dim) {
-                // Boundary info
-                subcelldata.boundary_lines.emplace_back(vertices_per_element);
-                auto &p1_vertices_id = subcelldata.boundary_lines.back().vertices;
-                p1_vertices_id.resize(vertices_per_element);
-
-                temp_high_order_cells.vertices.resize(nodes_per_element);
-
-                for (unsigned int i = 0; i < nodes_per_element; ++i) {
-                    infile >> temp_high_order_cells.vertices[i];
-                }
-                for (unsigned int i = 0; i < vertices_per_element; ++i) {
-                    p1_vertices_id[i] = temp_high_order_cells.vertices[i];
-                }
 
-                // to make sure that the cast won't fail
-                Assert(material_id <= std::numeric_limits<dealii::types::boundary_id>::max(),
-                       dealii::ExcIndexRange( material_id, 0, std::numeric_limits<dealii::types::boundary_id>::max()));
-                // we use only boundary_ids infile the range from 0 to dealii::numbers::internal_face_boundary_id-1
-                AssertIndexRange(material_id, dealii::numbers::internal_face_boundary_id);
-
-                subcelldata.boundary_lines.back().boundary_id = static_cast<dealii::types::boundary_id>(material_id);
-
-                // transform from ucd to consecutive numbering
-                for (unsigned int &vertex : subcelldata.boundary_lines.back().vertices) {
-                    if (vertex_indices.find(vertex) != vertex_indices.end()) {
-                      vertex = vertex_indices[vertex];
-                    } else {
-                        // no such vertex index
-                        //AssertThrow(false, dealii::ExcInvalidVertexIndex(cell_per_entity, vertex));
-                        vertex = dealii::numbers::invalid_unsigned_int;
-                        std::abort();
-                    }
-                }
-            } else if (dimEntity == 2 && dimEntity < dim) {
-                // boundary info
-                subcelldata.boundary_quads.emplace_back(vertices_per_element);
-                auto &p1_vertices_id = subcelldata.boundary_quads.back().vertices;
-                p1_vertices_id.resize(vertices_per_element);
+    // set up array of p1_cells and subcells (faces), whose vertices are the first nodes of the Gmsh elements
+    std::vector<dealii::CellData<dim>> p1_cells(n_cells);
+    for (unsigned int icell = 0; icell < n_cells; ++icell) {
+        const unsigned int material_id = gmsh_grid.cell_material_ids[icell];
+        // we use only material_ids in the range from 0 to dealii::numbers::invalid_material_id-1
+        AssertIndexRange(material_id, dealii::numbers::invalid_material_id);
 
-                temp_high_order_cells.vertices.resize(nodes_per_element);
+        p1_cells[icell].vertices.resize(vertices_per_cell);
+        for (unsigned int i = 0; i < vertices_per_cell; ++i) {
+            p1_cells[icell].vertices[i] = gmsh_grid.cell_nodes[icell * nodes_per_cell + i];
+        }
+        p1_cells[icell].material_id = material_id;
+    }
 
-                for (unsigned int i = 0; i < nodes_per_element; ++i) {
-                    infile >> temp_high_order_cells.vertices[i];
-                }
-                for (unsigned int i = 0; i < vertices_per_element; ++i) {
-                    p1_vertices_id[i] = temp_high_order_cells.vertices[i];
-                }
+    dealii::SubCellData subcelldata;
+    for (unsigned int iline = 0; iline < gmsh_grid.boundary_line_ids.size(); ++iline) {
+        const unsigned int boundary_id = gmsh_grid.boundary_line_ids[iline];
+        // we use only boundary_ids in the range from 0 to dealii::numbers::internal_face_boundary_id-1
+        AssertIndexRange(boundary_id, dealii::numbers::internal_face_boundary_id);
+
+        subcelldata.boundary_lines.emplace_back(2);
+        auto &line = subcelldata.boundary_lines.back();
+        line.vertices.resize(2);
+        for (unsigned int i = 0; i < 2; ++i) line.vertices[i] = gmsh_grid.boundary_line_vertices[2*iline + i];
+        line.boundary_id = static_cast<dealii::types::boundary_id>(boundary_id);
+    }
+    for (unsigned int iquad = 0; iquad < gmsh_grid.boundary_quad_ids.size(); ++iquad) {
+        const unsigned int boundary_id = gmsh_grid.boundary_quad_ids[iquad];
+        AssertIndexRange(boundary_id, dealii::numbers::internal_face_boundary_id);
+
+        subcelldata.boundary_quads.emplace_back(4);
+        auto &quad = subcelldata.boundary_quads.back();
+        quad.vertices.resize(4);
+        for (unsigned int i = 0; i < 4; ++i) quad.vertices[i] = gmsh_grid.boundary_quad_vertices[4*iquad + i];
+        quad.boundary_id = static_cast<dealii::types::boundary_id>(boundary_id);
+    }
 
-                // to make sure that the cast won't fail
-                Assert(material_id <= std::numeric_limits<dealii::types::boundary_id>::max(),
-                       dealii::ExcIndexRange( material_id, 0, std::numeric_limits<dealii::types::boundary_id>::max()));
-                // we use only boundary_ids infile the range from 0 to dealii::numbers::internal_face_boundary_id-1
-                AssertIndexRange(material_id, dealii::numbers::internal_face_boundary_id);
-
-                subcelldata.boundary_quads.back().boundary_id = static_cast<dealii::types::boundary_id>(material_id);
-
-                // transform from gmsh to consecutive numbering
-                for (unsigned int &vertex : subcelldata.boundary_quads.back().vertices) {
-                    if (vertex_indices.find(vertex) != vertex_indices.end()) {
-                      vertex = vertex_indices[vertex];
-                    } else {
-                        // no such vertex index
-                        //Assert(false, dealii::ExcInvalidVertexIndex(cell_per_entity, vertex));
-                        vertex = dealii::numbers::invalid_unsigned_int;
-                    }
-                }
-            } else if (cell_type == MSH_PNT) {
-              // read the indices of nodes given
-              unsigned int node_index = 0;
-              infile >> node_index;
-
-              // We only care about boundary indicators assigned to individual
-              // vertices infile 1d (because otherwise the vertices are not faces)
-              if (dim == 1) {
-                  boundary_ids_1d[vertex_indices[node_index]] = material_id;
-              }
-            } else {
-              //AssertThrow(false, dealii::ExcGmshUnsupportedGeometry(cell_type));
-            }
-        } // End of cell per entity
-    } // End of entity block
-    AssertDimension(global_cell, n_cells);
-
-    // Assert we reached the end of the block
-    infile >> line;
-    static const std::string end_elements_marker[] = {"$ENDELM", "$EndElements"};
-    //AssertThrow(line == end_elements_marker[gmsh_file_format == 10 ? 0 : 1],
-    //            PHiLiP::ExcInvalidGMSHInput(line));
-  
     // check that no forbidden arrays are used
     Assert(subcelldata.check_consistency(dim), dealii::ExcInternalError());
-  
-  
-    AssertThrow(infile, dealii::ExcIO());
-  
-  
-    // // check that we actually read some p1_cells.
-    // AssertThrow(p1_cells.size() > 0, dealii::ExcGmshNoCellInformation());
-  
+
     // do some clean-up on vertices...
-    auto all_vertices = vertices;
+    const auto all_vertices = vertices;
     dealii::GridTools::delete_unused_vertices(vertices, p1_cells, subcelldata);
     // ... and p1_cells
     if (dim == spacedim) {
@@ -949,181 +805,66 @@ read_gmsh(std::string filename, int requested_grid_order)
 
     dealii::GridOut gridout;
     gridout.write_mesh_per_processor_as_vtu(*(high_order_grid->triangulation), "tria");
-  
-    // in 1d, we also have to attach boundary ids to vertices, which does not
-    // currently work through the call above
-    if (dim == 1) {
-        assign_1d_boundary_ids(boundary_ids_1d, *triangulation);
-    }
 
     high_order_grid->initialize_with_triangulation_manifold();
 
     std::vector<unsigned int> deal_h2l = dealii::FETools::hierarchic_to_lexicographic_numbering<dim>(grid_order);
-    std::vector<unsigned int> deal_l2h = dealii::Utilities::invert_permutation(deal_h2l);
-
     std::vector<unsigned int> gmsh_h2l = gmsh_hierarchic_to_lexicographic<dim>(grid_order);
-    std::vector<unsigned int> gmsh_l2h = dealii::Utilities::invert_permutation(gmsh_h2l);
-
-    // Visualize indexing
-    // for (unsigned int deg = 1; deg < 7; ++deg) {
-    //     std::cout << "DEGREE " << deg << std::endl;
-    //     {
-    //         std::vector<unsigned int> h2l = gmsh_hierarchic_to_lexicographic<dim>(deg);
-    //         std::vector<unsigned int> l2h = dealii::Utilities::invert_permutation(h2l);
-
-    //         unsigned int n = deg+1;
-    //         std::cout << "GMSH L2H "  << std::endl;
-    //         for (int j=n-1; j>=0; --j) {
-    //             for (unsigned int i=0; i<n; ++i) {
-    //                 const unsigned int ij = ij_to_num(i,j,n);
-    //                 std::cout << l2h[ij] << " ";
-    //             }
-    //             std::cout << std::endl;
-    //         }
-
-    //         std::cout << std::endl << std::endl;
-    //     }
-    //     {
-    //         std::vector<unsigned int> h2l = dealii::FETools::hierarchic_to_lexicographic_numbering<dim>(deg);
-    //         std::vector<unsigned int> l2h = dealii::Utilities::invert_permutation(h2l);
-
-    //         unsigned int n = deg+1;
-    //         std::cout << "DEAL L2H "  << std::endl;
-    //         for (int j=n-1; j>=0; --j) {
-    //             for (unsigned int i=0; i<n; ++i) {
-    //                 const unsigned int ij = ij_to_num(i,j,n);
-    //                 std::cout << l2h[ij] << " ";
-    //             }
-    //             std::cout << std::endl;
-    //         }
-
-    //         std::cout << std::endl << std::endl;
-    //     }
-    // }
-    // std::abort();
+
+    // The deal.II cells may have been rotated or reflected with respect to the Gmsh elements
+    const std::vector<std::vector<unsigned int>> symmetries = lexicographic_symmetries<dim>(grid_order+1);
 
     int icell = 0;
     std::vector<dealii::types::global_dof_index> dof_indices(high_order_grid->fe_system.dofs_per_cell);
-
-    //for (unsigned int i=0; i<all_vertices.size(); ++i) {
-    //    std::cout << " i " << i 
-    //              << " maps to global id " 
-    //              << " vertices high_order_vertices_id[i] << " point " << all_vertices[high_order_vertices_id[i]] << std::endl;
-    //}
+    std::vector<unsigned int> high_order_vertices_id_lexico(nodes_per_cell);
     for (const auto &cell : high_order_grid->dof_handler_grid.active_cell_iterators()) {
         if (cell->is_locally_owned()) {
-            auto &high_order_vertices_id = high_order_cells[icell].vertices;
-
-            //for (unsigned int i=0; i<high_order_vertices_id.size(); ++i) {
-            //    std::cout << " I " << high_order_vertices_id[i] << " point " << all_vertices[high_order_vertices_id[i]] << std::endl;
-            //}
-            cell->get_dof_indices(dof_indices);
-
-            //std::cout << " cell " << icell << " with vertices: " << std::endl;
-            //for (unsigned int i=0; i < cell->n_vertices(); ++i) {
-            //    std::cout << cell->vertex(i) << std::endl;
-            //}
-            //std::cout << " highordercell with vertices: " << std::endl;
-
-            std::vector<unsigned int> rotate_z90degree;
-            rotate_indices<dim>(rotate_z90degree, grid_order+1, 'Z');
-
-            bool good_rotation = false;
-
-            auto high_order_vertices_id_lexico = high_order_vertices_id;
-            for (unsigned int ihierachic=0; ihierachic<high_order_vertices_id.size(); ++ihierachic) {
+            const unsigned int *high_order_vertices_id = &gmsh_grid.cell_nodes[icell * nodes_per_cell];
+            for (unsigned int ihierachic=0; ihierachic<nodes_per_cell; ++ihierachic) {
                 const unsigned int lexico_id = gmsh_h2l[ihierachic];
                 high_order_vertices_id_lexico[lexico_id] = high_order_vertices_id[ihierachic];
             }
 
-            //auto high_order_vertices_id_rotated = high_order_cells[icell].vertices;
-            auto high_order_vertices_id_rotated = high_order_vertices_id_lexico;
-            for (int zr = 0; zr < 4; ++zr) {
-                
-                std::vector<int> matching(cell->n_vertices());
-                for (unsigned int i_vertex=0; i_vertex < cell->n_vertices(); ++i_vertex) {
-
-                    const unsigned int base_index = i_vertex;
-                    const unsigned int lexicographic_index = deal_h2l[base_index];
-
-                    //const unsigned int gmsh_hierarchical_index = gmsh_l2h[lexicographic_index];
-                    //const unsigned int vertex_id = high_order_vertices_id_rotated[gmsh_hierarchical_index];
-                    const unsigned int vertex_id = high_order_vertices_id_rotated[lexicographic_index];
-                    const dealii::Point<dim,double> high_order_vertex = all_vertices[vertex_id];
-                    //std::cout << high_order_vertex << std::endl;
-
-                    bool found = false;
-                    for (unsigned int i=0; i < cell->n_vertices(); ++i) {
-                        if (cell->vertex(i) == high_order_vertex) {
-                            //std::cout << " cell vertex " << i << " matches HO vertex " << i_vertex << std::endl;
-                            found = true;
-                        }
-                    }
-                    if (!found) {
-                        std::cout << "Wrong cell... High order nodes do not match the cell's vertices." << std::endl;
-                        std::abort();
-                    }
-
-                    matching[i_vertex] = (high_order_vertex == cell->vertex(i_vertex)) ? 0 : 1;
-                }
+            cell->get_dof_indices(dof_indices);
 
+            // Find the symmetry bringing the vertices of the Gmsh element onto the ones of the cell
+            const std::vector<unsigned int> *cell_symmetry = nullptr;
+            for (const auto &symmetry : symmetries) {
                 bool all_matching = true;
-                for (unsigned int i=0; i < cell->n_vertices(); ++i) {
-                    if (matching[i] == 1) all_matching = false;
+                for (unsigned int i_vertex = 0; i_vertex < cell->n_vertices() && all_matching; ++i_vertex) {
+                    const unsigned int lexicographic_index = deal_h2l[i_vertex];
+                    const unsigned int vertex_id = high_order_vertices_id_lexico[symmetry[lexicographic_index]];
+                    all_matching = (all_vertices[vertex_id] == cell->vertex(i_vertex));
                 }
-                good_rotation = all_matching;
-                if (good_rotation) {
-                    //std::cout << "Found rotation cell..." << std::endl;
+                if (all_matching) {
+                    cell_symmetry = &symmetry;
                     break;
                 }
-
-                //std::cout << "Rotating indices " << std::endl;
-                high_order_vertices_id = high_order_vertices_id_rotated;
-                for (unsigned int i=0; i<high_order_vertices_id.size(); ++i) {
-                    high_order_vertices_id_rotated[i] = high_order_vertices_id[rotate_z90degree[i]];
-                }
             }
-            if (!good_rotation) {
+            if (!cell_symmetry) {
                 std::cout << "Couldn't find rotation..." << std::endl;
                 std::abort();
-            } 
-
-
+            }
 
-            for (unsigned int i_vertex = 0; i_vertex < high_order_vertices_id.size(); ++i_vertex) {
+            for (unsigned int i_vertex = 0; i_vertex < nodes_per_cell; ++i_vertex) {
 
                 const unsigned int base_index = i_vertex;
                 const unsigned int lexicographic_index = deal_h2l[base_index];
-                //const unsigned int gmsh_hierarchical_index = gmsh_l2h[lexicographic_index];
-                //const unsigned int vertex_id = high_order_vertices_id[gmsh_hierarchical_index];
-                const unsigned int vertex_id = high_order_vertices_id_rotated[lexicographic_index];
+                const unsigned int vertex_id = high_order_vertices_id_lexico[(*cell_symmetry)[lexicographic_index]];
                 const dealii::Point<dim,double> vertex = all_vertices[vertex_id];
 
-                //std::cout << "i_vertex " << i_vertex << " point: " << vertex << std::endl;
-
                 for (int d = 0; d < dim; ++d) {
                     const unsigned int comp = d;
                     const unsigned int shape_index = high_order_grid->dof_handler_grid.get_fe().component_to_system_index(comp, base_index);
                     const unsigned int idof_global = dof_indices[shape_index];
-
-                    //std::cout << " icell " << icell
-                    //          << " i_vertex " << i_vertex
-                    //          << " i_dim " << d
-                    //          << " base_index " << base_index
-                    //          << " shape_index " << shape_index 
-                    //          << " idof_global " << idof_global
-                    //          << " lexicographic_index " << lexicographic_index
-                    //          //<< " gmsh_hierarchical_index " << gmsh_hierarchical_index
-                    //          << " vertex_id " << vertex_id
-                    //          << std::endl;
                     high_order_grid->volume_nodes[idof_global] = vertex[d];
                 }
-                //std::cout << std::endl;
             }
         }
         icell++;
     }
     high_order_grid->volume_nodes.update_ghost_values();
+    high_order_grid->volume_nodes_modified();
     high_order_grid->ensure_conforming_mesh();
 
     
@@ -1148,6 +889,7 @@ read_gmsh(std::string filename, int requested_grid_order)
         high_order_grid->volume_nodes.update_ghost_values();
         dealii::FETools::interpolate(dof_handler_equidistant, equidistant_nodes, high_order_grid->dof_handler_grid, high_order_grid->volume_nodes);
         high_order_grid->volume_nodes.update_ghost_values();
+        high_order_grid->volume_nodes_modified();
         high_order_grid->ensure_conforming_mesh();
     }
 
@@ -1183,6 +925,7 @@ read_gmsh(std::string filename, int requested_grid_order)
             grid->volume_nodes.update_ghost_values();
             dealii::FETools::interpolate(dof_handler_equidistant, equidistant_nodes, grid->dof_handler_grid, grid->volume_nodes);
             grid->volume_nodes.update_ghost_values();
+            grid->volume_nodes_modified();
             grid->ensure_conforming_mesh();
         }
         grid->update_surface_nodes();
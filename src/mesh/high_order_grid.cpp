@@ -126,10 +126,21 @@ void HighOrderGrid<dim,real>::ensure_conforming_mesh() {
     hanging_node_constraints.distribute(volume_nodes);
 
     volume_nodes.update_ghost_values();
+    volume_nodes_modified();
 
     update_mapping_fe_field();
 }
 
+template <int dim, typename real>
+void HighOrderGrid<dim,real>::volume_nodes_modified() {
+    ++volume_nodes_version;
+}
+
+template <int dim, typename real>
+unsigned int HighOrderGrid<dim,real>::get_volume_nodes_version() const {
+    return volume_nodes_version;
+}
+
 template <int dim, typename real>
 void HighOrderGrid<dim,real>::update_mapping_fe_field() {
     const dealii::ComponentMask mask(dim, true);
@@ -151,6 +162,7 @@ HighOrderGrid<dim,real>::allocate()
     ghost_dofs_grid = locally_relevant_dofs_grid;
     ghost_dofs_grid.subtract_set(locally_owned_dofs_grid);
     volume_nodes.reinit(locally_owned_dofs_grid, ghost_dofs_grid, mpi_communicator);
+    volume_nodes_modified();
 }
 
 //template <int dim, typename real>
@@ -1007,18 +1019,32 @@ void HighOrderGrid<dim,real>::execute_coarsening_and_refinement(const bool outpu
     //}
 }
 
-template <typename T>
-std::vector<T> flatten(const std::vector<std::vector<T>>& v) {
-    std::size_t total_size = 0;
-    for (const auto& sub : v) {
-        total_size += sub.size();
-    }
-    std::vector<T> result;
-    result.reserve(total_size);
-    for (const auto& sub : v) {
-        result.insert(result.end(), sub.begin(), sub.end());
-    }
-    return result;
+template <int dim, typename real>
+void HighOrderGrid<dim,real>::prepare_for_serialization() {
+#if PHILIP_DIM==1
+    AssertThrow(false, dealii::ExcMessage("Serialization requires a distributed triangulation, which is not used in 1D."));
+#else
+    old_volume_nodes = volume_nodes;
+    old_volume_nodes.update_ghost_values();
+    solution_transfer.prepare_for_serialization(old_volume_nodes);
+#endif
+}
+
+template <int dim, typename real>
+void HighOrderGrid<dim,real>::deserialize() {
+#if PHILIP_DIM==1
+    AssertThrow(false, dealii::ExcMessage("Serialization requires a distributed triangulation, which is not used in 1D."));
+#else
+    allocate();
+    volume_nodes.zero_out_ghosts();
+    solution_transfer.deserialize(volume_nodes);
+    volume_nodes.update_ghost_values();
+    volume_nodes_modified();
+
+    update_surface_nodes();
+    update_mapping_fe_field();
+    reset_initial_nodes();
+#endif
 }
 
 template <int dim, typename real>
@@ -1026,8 +1052,10 @@ void HighOrderGrid<dim,real>::update_surface_nodes() {
 
     update_surface_indices();
 
+    const unsigned int n_locally_owned_surface_nodes = locally_owned_surface_nodes_indices.size();
+    // First surface index owned by this process.
+    unsigned int low_range = 0;
     {
-        const unsigned int n_locally_owned_surface_nodes = locally_owned_surface_nodes_indices.size();
         // Copy local surface node locations
         locally_owned_surface_nodes.clear();
         locally_owned_surface_nodes.resize(n_locally_owned_surface_nodes);
@@ -1040,37 +1068,19 @@ void HighOrderGrid<dim,real>::update_surface_nodes() {
         n_locally_owned_surface_nodes_per_mpi.resize(n_mpi);
         MPI_Allgather(&n_locally_owned_surface_nodes, 1, MPI::UNSIGNED, &(n_locally_owned_surface_nodes_per_mpi[0]), 1, MPI::UNSIGNED, MPI_COMM_WORLD);
 
-        std::vector<std::vector<real>> vector_locally_owned_surface_nodes(n_mpi);
-        std::vector<std::vector<unsigned int>> vector_locally_owned_surface_indices(n_mpi);
-        std::vector<MPI_Request> request(n_mpi);
-        for (int i_mpi=0; i_mpi<n_mpi; ++i_mpi) {
-            vector_locally_owned_surface_nodes[i_mpi].resize(n_locally_owned_surface_nodes_per_mpi[i_mpi]);
-            vector_locally_owned_surface_indices[i_mpi].resize(n_locally_owned_surface_nodes_per_mpi[i_mpi]);
-            if (i_mpi == mpi_rank) {
-                vector_locally_owned_surface_nodes[i_mpi] = locally_owned_surface_nodes;
-                vector_locally_owned_surface_indices[i_mpi] = locally_owned_surface_nodes_indices;
-            }
-        }
-
-        for (int i_mpi=0; i_mpi<n_mpi; ++i_mpi) {
-            MPI_Bcast(&(vector_locally_owned_surface_nodes[i_mpi][0]), n_locally_owned_surface_nodes_per_mpi[i_mpi], MPI_DOUBLE, i_mpi, MPI_COMM_WORLD);
-            MPI_Bcast(&(vector_locally_owned_surface_indices[i_mpi][0]), n_locally_owned_surface_nodes_per_mpi[i_mpi], MPI::UNSIGNED, i_mpi, MPI_COMM_WORLD);
-        }
-
-        all_surface_nodes = flatten(vector_locally_owned_surface_nodes);
-        all_surface_indices = flatten(vector_locally_owned_surface_indices);
-
-        unsigned int low_range = 0;
+        // Each process owns a contiguous range of the surface nodes, ordered by rank.
         for (int i_mpi=0; i_mpi<mpi_rank; ++i_mpi) {
             low_range += n_locally_owned_surface_nodes_per_mpi[i_mpi];
         }
         const unsigned int high_range = low_range + n_locally_owned_surface_nodes_per_mpi[mpi_rank];
 
-        const unsigned int n_surface_nodes = all_surface_nodes.size();
+        unsigned int n_surface_nodes = 0;
+        for (int i_mpi=0; i_mpi<n_mpi; ++i_mpi) {
+            n_surface_nodes += n_locally_owned_surface_nodes_per_mpi[i_mpi];
+        }
         locally_owned_surface_nodes_indexset.clear();
         locally_owned_surface_nodes_indexset.set_size(n_surface_nodes);
         locally_owned_surface_nodes_indexset.add_range(low_range, high_range);
-
     }
 
     {
@@ -1082,47 +1092,32 @@ void HighOrderGrid<dim,real>::update_surface_nodes() {
         for (auto index = locally_relevant_surface_nodes_indices.begin(); index != locally_relevant_surface_nodes_indices.end(); index++) {
             locally_relevant_surface_nodes[i++] = volume_nodes[*index];
         }
-
-        std::vector<unsigned int> n_locally_relevant_surface_nodes_per_mpi(n_mpi);
-        MPI_Allgather(&n_locally_relevant_surface_nodes, 1, MPI::UNSIGNED, &(n_locally_relevant_surface_nodes_per_mpi[0]), 1, MPI::UNSIGNED, MPI_COMM_WORLD);
-
     }
 
     // Find ghost_surface_nodes_indexset for the surface_nodes vector.
+    // A surface node is owned by the process owning its volume node. The surface indices are therefore
+    // stored in a vector laid out as the volume_nodes, whose ghost exchange only communicates with the
+    // neighbouring processes.
     {
-        const unsigned int n_surface_nodes = all_surface_nodes.size();
+        dealii::LinearAlgebra::distributed::Vector<int> volume_to_surface_indices;
+        volume_to_surface_indices.reinit(locally_owned_dofs_grid, ghost_dofs_grid, MPI_COMM_WORLD);
+        volume_to_surface_indices = -1;
+        for (unsigned int i = 0; i < n_locally_owned_surface_nodes; ++i) {
+            volume_to_surface_indices[locally_owned_surface_nodes_indices[i]] = low_range + i;
+        }
+        volume_to_surface_indices.update_ghost_values();
+
         ghost_surface_nodes_indexset.clear();
-        ghost_surface_nodes_indexset.set_size(n_surface_nodes);
+        ghost_surface_nodes_indexset.set_size(locally_owned_surface_nodes_indexset.size());
         for (auto index = locally_relevant_surface_nodes_indices.begin(); index != locally_relevant_surface_nodes_indices.end(); ++index) {
-            auto it = std::find (locally_owned_surface_nodes_indices.begin(), locally_owned_surface_nodes_indices.end(), *index);
-            if (it == locally_owned_surface_nodes_indices.end()) {
-                // If not in locally_owned_surface_nodes_indexset then, it must be a ghost entry
-                bool found = false;
-                for (unsigned int i = 0; i < all_surface_indices.size(); i++) {
-                    if (all_surface_indices[i] == *index) {
-                        ghost_surface_nodes_indexset.add_index(i);
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) {
-                    std::cout << "Could not find index " << *index << " in the surface indices... Aborting. " << std::endl;
-                    std::cout << "All surface_indices: " << std::endl;
-                    for (unsigned int i = 0; i < all_surface_indices.size(); i++) {
-                        std::cout << "i " << i << " all_surface_indices[i] " << all_surface_indices[i] << std::endl;
-                    }
-                    std::cout << "Locally relevant surface nodes indices: " << std::endl;
-                    for (unsigned int i = 0; i < locally_relevant_surface_nodes_indices.size(); i++) {
-                        std::cout << "i " << i << " locally_relevant_surface_nodes_indices[i] " << locally_relevant_surface_nodes_indices[i] << std::endl;
-                    }
-                    std::cout << "Locally owned surface nodes indices: " << std::endl;
-                    for (unsigned int i = 0; i < locally_owned_surface_nodes_indices.size(); i++) {
-                        std::cout << "i " << i << " locally_owned_surface_nodes_indices[i] " << locally_owned_surface_nodes_indices[i] << std::endl;
-                    }
-
-                    std::abort();
-                }
-            }
+            if (locally_owned_dofs_grid.is_element(*index)) continue;
+
+            // If not in locally_owned_surface_nodes_indexset then, it must be a ghost entry
+            const int surface_index = volume_to_surface_indices[*index];
+            AssertThrow(surface_index >= 0,
+                dealii::ExcMessage("Could not find the surface index of the volume node " + std::to_string(*index)
+                                   + " owned by another process."));
+            ghost_surface_nodes_indexset.add_index(surface_index);
         }
     }
 
@@ -1143,6 +1138,27 @@ void HighOrderGrid<dim,real>::update_surface_nodes() {
 }
 
 
+template <int dim, typename real>
+void HighOrderGrid<dim,real>::gather_all_surface_nodes()
+{
+    std::vector<int> n_per_mpi(n_mpi), offsets(n_mpi, 0);
+    for (int i_mpi=0; i_mpi<n_mpi; ++i_mpi) {
+        n_per_mpi[i_mpi] = n_locally_owned_surface_nodes_per_mpi[i_mpi];
+        if (i_mpi > 0) offsets[i_mpi] = offsets[i_mpi-1] + n_per_mpi[i_mpi-1];
+    }
+    const unsigned int n_surface_nodes = locally_owned_surface_nodes_indexset.size();
+
+    all_surface_nodes.resize(n_surface_nodes);
+    MPI_Allgatherv(locally_owned_surface_nodes.data(), n_per_mpi[mpi_rank], MPI_DOUBLE,
+                   all_surface_nodes.data(), n_per_mpi.data(), offsets.data(), MPI_DOUBLE, mpi_communicator);
+
+    std::vector<unsigned long long> locally_owned_indices(locally_owned_surface_nodes_indices.begin(), locally_owned_surface_nodes_indices.end());
+    std::vector<unsigned long long> all_indices(n_surface_nodes);
+    MPI_Allgatherv(locally_owned_indices.data(), n_per_mpi[mpi_rank], MPI_UNSIGNED_LONG_LONG,
+                   all_indices.data(), n_per_mpi.data(), offsets.data(), MPI_UNSIGNED_LONG_LONG, mpi_communicator);
+    all_surface_indices.assign(all_indices.begin(), all_indices.end());
+}
+
 template <int dim, typename real>
 void HighOrderGrid<dim,real>::update_map_nodes_surf_to_vol()
 {
@@ -1156,22 +1172,18 @@ void HighOrderGrid<dim,real>::update_map_nodes_surf_to_vol()
     const dealii::IndexSet &col_part = surface_nodes.get_partitioner()->locally_owned_range();
 
     dealii::DynamicSparsityPattern dsp(n_rows, n_cols, row_part);
-    for (unsigned int i_col = 0; i_col < n_cols; ++i_col) {
-        if (col_part.is_element(i_col)) {
-            const unsigned int i_row = surface_to_volume_indices[i_col];
-            dsp.add(i_row, i_col);
-        }
+    for (const auto i_col : col_part) {
+        const unsigned int i_row = surface_to_volume_indices[i_col];
+        dsp.add(i_row, i_col);
     }
 
     dealii::SparsityTools::distribute_sparsity_pattern(dsp, row_part, mpi_communicator, locally_relevant_dofs);
 
     map_nodes_surf_to_vol.reinit(row_part, col_part, dsp, mpi_communicator);
 
-    for (unsigned int i_col = 0; i_col < n_cols; ++i_col) {
-        if (col_part.is_element(i_col)) {
-            const unsigned int i_row = surface_to_volume_indices[i_col];
-            map_nodes_surf_to_vol.set(i_row, i_col, 1.0);
-        }
+    for (const auto i_col : col_part) {
+        const unsigned int i_row = surface_to_volume_indices[i_col];
+        map_nodes_surf_to_vol.set(i_row, i_col, 1.0);
     }
     map_nodes_surf_to_vol.compress(dealii::VectorOperation::insert);
 }
@@ -107,6 +107,14 @@ public:
      */
     VectorType volume_nodes;
 
+    /// Flags the volume_nodes as modified.
+    /** Must be called after modifying the volume_nodes such that the quantities depending on them,
+     *  such as the metric terms cached by the DG residual assembly, are re-evaluated.
+     */
+    void volume_nodes_modified();
+
+    /// Number of times the volume_nodes have been flagged as modified.
+    unsigned int get_volume_nodes_version() const;
 
     /** Distributed ghosted vector of surface nodes.
      */
@@ -175,14 +183,25 @@ public:
     /** Same as locally_owned_surface_nodes except that it stores a global vector of all the
      *  surface nodes that will be needed to evaluate the A matrix in the RBF
      *  deformation dxv = A * coeff = A * (Minv*dxs)
+     *
+     *  Only filled by gather_all_surface_nodes() since it is replicated on every process.
      */
     std::vector<real> all_surface_nodes;
     /** List of global surface node indices including those across different processors.
      *  Ordering corresponds to all_surface_nodes.
+     *  Only filled by gather_all_surface_nodes().
      *  TODO: Might want to make this a std::pair.
      */
     std::vector<dealii::types::global_dof_index> all_surface_indices;
 
+    /// Replicates all the surface nodes and their volume indices on every process.
+    /** Fills all_surface_nodes and all_surface_indices from the current locally owned surface nodes.
+     *  Meant for the global deformations, such as the RBF, that need every surface node. The memory
+     *  and communication grow with the total number of surface nodes times the number of processes,
+     *  such that it is not done by update_surface_nodes().
+     */
+    void gather_all_surface_nodes();
+
     /// List of surface node indices
     std::vector<dealii::types::global_dof_index> locally_owned_surface_nodes_indices;
 
@@ -226,6 +245,9 @@ public:
 
 
     /// Update list of surface nodes (all_locally_relevant_surface_nodes).
+    /** The surface_nodes vector is distributed, and its ghost entries are found by a ghost exchange
+     *  of the volume_nodes layout, which only communicates between neighbouring processes.
+     */
     void update_surface_nodes();
 
     /** Transforms the surface_nodes vector using a std::function tranformation.
@@ -302,6 +324,16 @@ public:
      */
     void execute_coarsening_and_refinement(const bool output_mesh = false);
 
+    /// Attaches the volume_nodes to the triangulation such that they are written by dealii::parallel::distributed::Triangulation::save().
+    /** Only available for distributed triangulations, see DGBase::save_checkpoint().
+     */
+    void prepare_for_serialization();
+    /// Recovers the volume_nodes attached to a triangulation that has just been loaded.
+    /** Must be called after dealii::parallel::distributed::Triangulation::load(), in the same order
+     *  the data was attached. The initial nodes are reset to the recovered nodes, see reset_initial_nodes().
+     */
+    void deserialize();
+
     /// Use Lagrange polynomial to represent the spatial location.
     const dealii::FE_Q<dim>     fe_q;
     /// Using system of polynomials to represent the x, y, and z directions.
@@ -337,8 +369,12 @@ protected:
     /// Used for the SolutionTransfer when performing grid adaptation.
     VectorType old_volume_nodes;
 
+    /// Incremented by volume_nodes_modified().
+    unsigned int volume_nodes_version = 0;
+
     /** Transfers the coarse curved curve onto the fine curved grid.
-     *  Used in prepare_for_coarsening_and_refinement() and execute_coarsening_and_refinement()
+     *  Used in prepare_for_coarsening_and_refinement() and execute_coarsening_and_refinement(),
+     *  as well as prepare_for_serialization() and deserialize().
      */
     SolutionTransfer solution_transfer;
 
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <deal.II/lac/constrained_linear_operator.h>
 
 #include <deal.II/dofs/dof_tools.h>
@@ -16,7 +18,13 @@
 
 #include <deal.II/lac/trilinos_sparse_matrix.h>
 
+#include <Amesos.h>
+#include <Epetra_MultiVector.h>
+#include <Epetra_Vector.h>
+
 #include "meshmover_linear_elasticity.hpp"
+#include "linear_solver/block_gmres.h"
+#include "telemetry/telemetry.h"
 
 namespace PHiLiP {
 namespace MeshMover {
@@ -58,7 +66,8 @@ namespace MeshMover {
         const DoFHandlerType &_dof_handler,
         const dealii::LinearAlgebra::distributed::Vector<int> &_boundary_ids_vector,
         const dealii::LinearAlgebra::distributed::Vector<double> &_boundary_displacements_vector)
-      : triangulation(_triangulation)
+      : multiple_rhs_solver(MultipleRHSSolverEnum::block_gmres)
+      , triangulation(_triangulation)
       , mapping_fe_field(mapping_fe_field)
       , dof_handler(_dof_handler)
       , quadrature_formula(dof_handler.get_fe().degree + 1)
@@ -98,6 +107,7 @@ namespace MeshMover {
     dealii::LinearAlgebra::distributed::Vector<real>
     LinearElasticity<dim,real>::get_volume_displacements()
     {
+        const Telemetry::ScopedTimer timer("mesh_motion");
         pcout << "Solving linear elasticity problem for volume displacements..." << std::endl;
         solve_timestep();
         // displacement_solution = 0;
@@ -362,6 +372,7 @@ namespace MeshMover {
         const dealii::LinearAlgebra::distributed::Vector<double> &input_vector,
         dealii::LinearAlgebra::distributed::Vector<double> &output_vector)
     {
+        const Telemetry::ScopedTimer timer("mesh_motion_sensitivity");
         pcout << "Applying [dXvdXs] onto a vector..." << std::endl;
         assert(input_vector.size() == output_vector.size());
 
@@ -374,6 +385,18 @@ namespace MeshMover {
 
         assemble_system();
 
+        if (multiple_rhs_solver == MultipleRHSSolverEnum::direct) {
+            factorize_system_matrix();
+            const Epetra_CrsMatrix &epetra_matrix = factored_matrix.trilinos_matrix();
+            Epetra_Vector rhs(View, epetra_matrix.RangeMap(), const_cast<double *>(input_vector.begin()));
+            Epetra_Vector solution(View, epetra_matrix.DomainMap(), output_vector.begin());
+            direct_problem->SetRHS(&rhs);
+            direct_problem->SetLHS(&solution);
+            const int ierr = direct_solver->Solve();
+            AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+            return;
+        }
+
         const bool log_history = (this_mpi_process == 0);
         dealii::SolverControl solver_control(20000, 1e-14 * input_vector_norm, log_history);
         //dealii::SolverControl solver_control(20000, 1e-14, log_history);
@@ -446,6 +469,7 @@ namespace MeshMover {
         std::vector<dealii::LinearAlgebra::distributed::Vector<double>> &list_of_vectors,
         dealii::TrilinosWrappers::SparseMatrix &output_matrix)
     {
+        const Telemetry::ScopedTimer timer("mesh_motion_sensitivity");
         assemble_system();
 
         const unsigned int n_rows = dof_handler.n_dofs();
@@ -470,89 +494,106 @@ namespace MeshMover {
 
         output_matrix.reinit(row_part, col_part, full_sp, mpi_communicator);
 
-        //dealii::TrilinosWrappers::PreconditionJacobi      precondition;
-        //precondition.initialize(system_matrix);
+        dXvdXs.clear();
+        pcout << "Applying for [dXvdXs] onto " << list_of_vectors.size() << " vectors..." << std::endl;
+        if (n_cols == 0) return;
 
-        //dealii::TrilinosWrappers::PreconditionILU  precondition;
-        //const int ilu_fill = 2;
-        //dealii::TrilinosWrappers::PreconditionILU::AdditionalData precond_settings(ilu_fill, 0., 1.0, 1);
-        //precondition.initialize(system_matrix, precond_settings);
+        const Epetra_CrsMatrix &epetra_matrix = system_matrix.trilinos_matrix();
 
+        // The factorization or the preconditioner is shared by all the right-hand sides.
         dealii::TrilinosWrappers::PreconditionILUT  precondition;
-        const unsigned int ilut_fill=50;
-        const double ilut_drop=0.0;//1e-15;
-        const double ilut_atol=0.0;//1e-6;
-        const double ilut_rtol=1.0;//1.00001;
-        const unsigned int overlap=1;
-        dealii::TrilinosWrappers::PreconditionILUT::AdditionalData precond_settings(ilut_drop, ilut_fill, ilut_atol, ilut_rtol, overlap);
-        precondition.initialize(system_matrix, precond_settings);
-
-
-        //const double 	omega = 1;
-        //const double 	min_diagonal = 1e-8;
-        //const unsigned int 	overlap = 1;
-        //const unsigned int 	n_sweeps = 1;
-        //dealii::TrilinosWrappers::PreconditionSSOR::AdditionalData precond_settings(omega, min_diagonal, overlap, n_sweeps);
-        //dealii::TrilinosWrappers::PreconditionSSOR  precondition;
-        //precondition.initialize(system_matrix, precond_settings);
-
-        using trilinos_vector_type = dealii::LinearAlgebra::distributed::Vector<double>;
-        using payload_type = dealii::TrilinosWrappers::internal::LinearOperatorImplementation::TrilinosPayload;
-        const auto op_a = dealii::linear_operator<trilinos_vector_type,trilinos_vector_type,payload_type>(system_matrix);
-
-        dXvdXs.clear();
-        pcout << "Applying for [dXvdXs] onto " << list_of_vectors.size() << " vectors..." << std::endl;
+        if (multiple_rhs_solver == MultipleRHSSolverEnum::direct) {
+            factorize_system_matrix();
+        } else {
+            const unsigned int ilut_fill=50;
+            const double ilut_drop=0.0;//1e-15;
+            const double ilut_atol=0.0;//1e-6;
+            const double ilut_rtol=1.0;//1.00001;
+            const unsigned int overlap=1;
+            dealii::TrilinosWrappers::PreconditionILUT::AdditionalData precond_settings(ilut_drop, ilut_fill, ilut_atol, ilut_rtol, overlap);
+            precondition.initialize(system_matrix, precond_settings);
+        }
 
-        unsigned int col = 0;
+        const unsigned int n_local_rows = locally_owned_dofs.n_elements();
         dealii::LinearAlgebra::distributed::Vector<double> output_vector;
         output_vector.reinit(list_of_vectors[0]);
-        for (auto &input_vector: list_of_vectors) {
-
-            pcout << " Vector " << col << " out of " << list_of_vectors.size() << std::endl;
-
-            dealii::deallog.depth_console(0);
+        const unsigned int n_rhs = n_rhs_per_block;
+        for (unsigned int first_col = 0; first_col < n_cols; first_col += n_rhs) {
+
+            const unsigned int n_block_cols = std::min(n_rhs, n_cols - first_col);
+            pcout << " Vectors " << first_col << " to " << first_col + n_block_cols - 1 << " out of " << n_cols << std::endl;
+
+            Epetra_MultiVector rhs_block(epetra_matrix.RangeMap(), n_block_cols);
+            Epetra_MultiVector solution_block(epetra_matrix.DomainMap(), n_block_cols);
+            for (unsigned int icol = 0; icol < n_block_cols; ++icol) {
+                const auto &input_vector = list_of_vectors[first_col + icol];
+                for (unsigned int i = 0; i < n_local_rows; ++i) {
+                    rhs_block[icol][i] = input_vector.local_element(i);
+                }
+            }
 
-            double input_vector_norm = input_vector.l2_norm();
-            if (input_vector_norm == 0.0) {
-                pcout << "Zero input vector. Zero output vector." << std::endl;
-                output_vector = 0.0;
+            if (multiple_rhs_solver == MultipleRHSSolverEnum::direct) {
+                direct_problem->SetRHS(&rhs_block);
+                direct_problem->SetLHS(&solution_block);
+                const int ierr = direct_solver->Solve();
+                AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
             } else {
-                const bool log_history = (this_mpi_process == 0);
-                dealii::SolverControl solver_control(20000, 1e-14 * input_vector_norm, log_history);
-                //dealii::SolverControl solver_control(20000, 1e-14, log_history);
-                solver_control.log_frequency(100);
-                const int max_n_tmp_vectors=200;
-                const bool right_preconditioning=true;
-                const bool use_default_residual=true;
-                const bool force_re_orthogonalization=false;
-                dealii::SolverGMRES<dealii::LinearAlgebra::distributed::Vector<double>>::AdditionalData gmres_settings(max_n_tmp_vectors, right_preconditioning, use_default_residual, force_re_orthogonalization);
-                dealii::SolverGMRES<dealii::LinearAlgebra::distributed::Vector<double>> solver(solver_control, gmres_settings);
-
-                //dealii::SolverBicgstab<dealii::LinearAlgebra::distributed::Vector<double>> solver(solver_control);
-
-                dealii::deallog.depth_console(2);
-                solver.solve(op_a, output_vector, input_vector, precondition);
-                pcout << "dXvdXvs Solver took " << solver_control.last_step() << " steps. "
-                      << "Residual: " << solver_control.last_value() << ". "
-                      << std::endl;
-
-                solver.solve(op_a, output_vector, input_vector, precondition);
-                pcout << "dXvdXvs Solver took " << solver_control.last_step() << " steps. "
-                      << "Residual: " << solver_control.last_value() << ". "
+                // Keep about as many Krylov vectors as the single right-hand side GMRES.
+                const unsigned int max_n_tmp_vectors = 200;
+                const unsigned int n_blocks_before_restart = std::max(1u, max_n_tmp_vectors / n_rhs - 1);
+                const unsigned int max_iterations = 20000;
+                const double relative_tolerance = 1e-14;
+                const std::pair<unsigned int, double> result = solve_block_gmres(
+                    epetra_matrix, &precondition.trilinos_operator(),
+                    rhs_block, solution_block,
+                    n_blocks_before_restart, max_iterations, relative_tolerance);
+                pcout << "dXvdXvs block GMRES took " << result.first << " steps. "
+                      << "Largest relative residual: " << result.second << ". "
                       << std::endl;
             }
 
-            dXvdXs.push_back(output_vector);
+            for (unsigned int icol = 0; icol < n_block_cols; ++icol) {
+                for (unsigned int i = 0; i < n_local_rows; ++i) {
+                    output_vector.local_element(i) = solution_block[icol][i];
+                }
+                output_vector.update_ghost_values();
+                dXvdXs.push_back(output_vector);
 
-            for (const auto &row: dof_handler.locally_owned_dofs()) {
-                output_matrix.set(row, col, dXvdXs[col][row]);
+                const unsigned int col = first_col + icol;
+                for (const auto &row: dof_handler.locally_owned_dofs()) {
+                    output_matrix.set(row, col, dXvdXs[col][row]);
+                }
             }
-            col++;
         }
         output_matrix.compress(dealii::VectorOperation::insert);
 
     }
 
+    template <int dim, typename real>
+    void LinearElasticity<dim,real>::factorize_system_matrix()
+    {
+        // assemble_system() always re-allocates system_matrix, the factorization is
+        // therefore only re-computed when the assembled values actually changed.
+        const bool same_matrix = direct_solver
+                                 && factored_matrix.n_nonzero_elements() == system_matrix.n_nonzero_elements()
+                                 && factored_matrix.frobenius_norm() == system_matrix.frobenius_norm();
+        if (same_matrix) return;
+
+        pcout << "    Factorizing MeshMover::LinearElasticity system..." << std::endl;
+        factored_matrix.copy_from(system_matrix);
+
+        direct_problem = std::make_unique<Epetra_LinearProblem>();
+        direct_problem->SetOperator(const_cast<Epetra_CrsMatrix *>(&factored_matrix.trilinos_matrix()));
+        Amesos factory;
+        direct_solver.reset(factory.Create("Amesos_Klu", *direct_problem));
+        AssertThrow(direct_solver, dealii::ExcMessage("Amesos_Klu is not available for the LinearElasticity direct solver."));
+
+        int ierr = direct_solver->SymbolicFactorization();
+        AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+        ierr = direct_solver->NumericFactorization();
+        AssertThrow(ierr == 0, dealii::ExcTrilinosError(ierr));
+    }
+
     template <int dim, typename real>
     void
     LinearElasticity<dim,real>
@@ -560,6 +601,7 @@ namespace MeshMover {
         const dealii::LinearAlgebra::distributed::Vector<double> &input_vector,
         dealii::LinearAlgebra::distributed::Vector<double> &output_vector)
     {
+        const Telemetry::ScopedTimer timer("mesh_motion_sensitivity");
         pcout << "Applying [transpose(dXvdXvs)] onto a vector..." << std::endl;
 
         double input_vector_norm = input_vector.l2_norm();
@@ -880,6 +922,7 @@ namespace MeshMover {
     template <int dim, typename real>
     void LinearElasticity<dim,real>::evaluate_dXvdXs()
     {
+        const Telemetry::ScopedTimer timer("mesh_motion_sensitivity");
         std::vector<dealii::LinearAlgebra::distributed::Vector<double>> unit_rhs_vector;
         const unsigned int n_dirichlet_constraints = boundary_displacements_vector.size();
         dXvdXs.clear();
@@ -1,8 +1,13 @@
 #ifndef __MESHMOVER_LINEAR_ELASTICITY_H__
 #define __MESHMOVER_LINEAR_ELASTICITY_H__
 
+#include <memory>
+
 #include <deal.II/lac/trilinos_sparse_matrix.h>
 
+#include <Epetra_LinearProblem.h>
+#include <Amesos_BaseSolver.h>
+
 #include "parameters/all_parameters.h"
 
 #include "high_order_grid.h"
@@ -56,12 +61,26 @@ namespace MeshMover
          */
   void evaluate_dXvdXs();
 
+        /// Types of solvers used by apply_dXvdXvs() with multiple right-hand sides.
+        enum MultipleRHSSolverEnum {
+            block_gmres, ///< Block GMRES on chunks of right-hand sides sharing one ILUT preconditioner.
+            direct       ///< Sparse LU factorization, computed once and reused for all right-hand sides.
+        };
+        /// Solver used by apply_dXvdXvs() with multiple right-hand sides. Defaults to block_gmres.
+        /** With direct, the factorization is also used by the single right-hand side apply_dXvdXvs()
+         *  and kept as long as the assembled system does not change.
+         */
+        MultipleRHSSolverEnum multiple_rhs_solver;
+
         /** Apply the analytical derivatives of volume displacements with respect
          *  to surface displacements onto a set of various right-hand sides.
          *  Note that the right-hand-side is of size n_volume_nodes.
          *  If the right-hand-side are the surface node displacements indexed in a
          *  volume node vector, the result is a displacement vector of the volume
          *  volume_nodes (which include the prescribed surface nodes).
+         *
+         *  The right-hand sides are solved together, in chunks of n_rhs_per_block,
+         *  using the solver given by multiple_rhs_solver.
          */
         void
         apply_dXvdXvs(std::vector<dealii::LinearAlgebra::distributed::Vector<double>> &list_of_vectors, dealii::TrilinosWrappers::SparseMatrix &output_matrix);
@@ -126,6 +145,20 @@ namespace MeshMover
          */
         unsigned int solve_linear_problem();
 
+        /// Number of right-hand sides solved together by apply_dXvdXvs().
+        /** The block GMRES restarts such that its basis holds about as many vectors as the single GMRES. */
+        static const unsigned int n_rhs_per_block = 16;
+
+        /// Factorizes the assembled system_matrix, unless the current factorization is of the same matrix.
+        void factorize_system_matrix();
+        /// Copy of the system matrix held by the direct solver.
+        /** A copy is needed since assemble_system() re-allocates system_matrix. */
+        dealii::TrilinosWrappers::SparseMatrix factored_matrix;
+        /// Linear problem of the direct solver.
+        std::unique_ptr<Epetra_LinearProblem> direct_problem;
+        /// Sparse LU factorization of factored_matrix.
+        std::unique_ptr<Amesos_BaseSolver> direct_solver;
+
         const Triangulation &triangulation; ///< Triangulation on which this acts.
         /// MappingFEField corresponding to curved mesh.
         const std::shared_ptr<dealii::MappingFEField<dim,dim,VectorType,DoFHandlerType>> mapping_fe_field;
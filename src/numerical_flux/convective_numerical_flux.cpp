@@ -226,10 +226,15 @@ template class NumericalFluxConvective<PHILIP_DIM, 3, double>;
 template class NumericalFluxConvective<PHILIP_DIM, 4, double>;
 template class NumericalFluxConvective<PHILIP_DIM, 5, double>;
 template class NumericalFluxConvective<PHILIP_DIM, 1, FadType >;
+template class NumericalFluxConvective<PHILIP_DIM, 1, SFadType<PHILIP_DIM, 1> >;
 template class NumericalFluxConvective<PHILIP_DIM, 2, FadType >;
+template class NumericalFluxConvective<PHILIP_DIM, 2, SFadType<PHILIP_DIM, 2> >;
 template class NumericalFluxConvective<PHILIP_DIM, 3, FadType >;
+template class NumericalFluxConvective<PHILIP_DIM, 3, SFadType<PHILIP_DIM, 3> >;
 template class NumericalFluxConvective<PHILIP_DIM, 4, FadType >;
+template class NumericalFluxConvective<PHILIP_DIM, 4, SFadType<PHILIP_DIM, 4> >;
 template class NumericalFluxConvective<PHILIP_DIM, 5, FadType >;
+template class NumericalFluxConvective<PHILIP_DIM, 5, SFadType<PHILIP_DIM, 5> >;
 template class NumericalFluxConvective<PHILIP_DIM, 1, RadType >;
 template class NumericalFluxConvective<PHILIP_DIM, 2, RadType >;
 template class NumericalFluxConvective<PHILIP_DIM, 3, RadType >;
@@ -253,10 +258,15 @@ template class LaxFriedrichs<PHILIP_DIM, 3, double>;
 template class LaxFriedrichs<PHILIP_DIM, 4, double>;
 template class LaxFriedrichs<PHILIP_DIM, 5, double>;
 template class LaxFriedrichs<PHILIP_DIM, 1, FadType >;
+template class LaxFriedrichs<PHILIP_DIM, 1, SFadType<PHILIP_DIM, 1> >;
 template class LaxFriedrichs<PHILIP_DIM, 2, FadType >;
+template class LaxFriedrichs<PHILIP_DIM, 2, SFadType<PHILIP_DIM, 2> >;
 template class LaxFriedrichs<PHILIP_DIM, 3, FadType >;
+template class LaxFriedrichs<PHILIP_DIM, 3, SFadType<PHILIP_DIM, 3> >;
 template class LaxFriedrichs<PHILIP_DIM, 4, FadType >;
+template class LaxFriedrichs<PHILIP_DIM, 4, SFadType<PHILIP_DIM, 4> >;
 template class LaxFriedrichs<PHILIP_DIM, 5, FadType >;
+template class LaxFriedrichs<PHILIP_DIM, 5, SFadType<PHILIP_DIM, 5> >;
 template class LaxFriedrichs<PHILIP_DIM, 1, RadType >;
 template class LaxFriedrichs<PHILIP_DIM, 2, RadType >;
 template class LaxFriedrichs<PHILIP_DIM, 3, RadType >;
@@ -275,6 +285,7 @@ template class LaxFriedrichs<PHILIP_DIM, 5, RadFadType >;
 
 template class Roe<PHILIP_DIM, PHILIP_DIM+2, double>;
 template class Roe<PHILIP_DIM, PHILIP_DIM+2, FadType >;
+template class Roe<PHILIP_DIM, PHILIP_DIM+2, SFadType<PHILIP_DIM, PHILIP_DIM+2> >;
 template class Roe<PHILIP_DIM, PHILIP_DIM+2, RadType >;
 template class Roe<PHILIP_DIM, PHILIP_DIM+2, FadFadType >;
 template class Roe<PHILIP_DIM, PHILIP_DIM+2, RadFadType >;
@@ -45,10 +45,15 @@ template class SplitFormNumFlux<PHILIP_DIM, 3, double>;
 template class SplitFormNumFlux<PHILIP_DIM, 4, double>;
 template class SplitFormNumFlux<PHILIP_DIM, 5, double>;
 template class SplitFormNumFlux<PHILIP_DIM, 1, FadType >;
+template class SplitFormNumFlux<PHILIP_DIM, 1, SFadType<PHILIP_DIM, 1> >;
 template class SplitFormNumFlux<PHILIP_DIM, 2, FadType >;
+template class SplitFormNumFlux<PHILIP_DIM, 2, SFadType<PHILIP_DIM, 2> >;
 template class SplitFormNumFlux<PHILIP_DIM, 3, FadType >;
+template class SplitFormNumFlux<PHILIP_DIM, 3, SFadType<PHILIP_DIM, 3> >;
 template class SplitFormNumFlux<PHILIP_DIM, 4, FadType >;
+template class SplitFormNumFlux<PHILIP_DIM, 4, SFadType<PHILIP_DIM, 4> >;
 template class SplitFormNumFlux<PHILIP_DIM, 5, FadType >;
+template class SplitFormNumFlux<PHILIP_DIM, 5, SFadType<PHILIP_DIM, 5> >;
 template class SplitFormNumFlux<PHILIP_DIM, 1, RadType >;
 template class SplitFormNumFlux<PHILIP_DIM, 2, RadType >;
 template class SplitFormNumFlux<PHILIP_DIM, 3, RadType >;
@@ -233,10 +233,15 @@ template class NumericalFluxDissipative<PHILIP_DIM, 3, double>;
 template class NumericalFluxDissipative<PHILIP_DIM, 4, double>;
 template class NumericalFluxDissipative<PHILIP_DIM, 5, double>;
 template class NumericalFluxDissipative<PHILIP_DIM, 1, FadType >;
+template class NumericalFluxDissipative<PHILIP_DIM, 1, SFadType<PHILIP_DIM, 1> >;
 template class NumericalFluxDissipative<PHILIP_DIM, 2, FadType >;
+template class NumericalFluxDissipative<PHILIP_DIM, 2, SFadType<PHILIP_DIM, 2> >;
 template class NumericalFluxDissipative<PHILIP_DIM, 3, FadType >;
+template class NumericalFluxDissipative<PHILIP_DIM, 3, SFadType<PHILIP_DIM, 3> >;
 template class NumericalFluxDissipative<PHILIP_DIM, 4, FadType >;
+template class NumericalFluxDissipative<PHILIP_DIM, 4, SFadType<PHILIP_DIM, 4> >;
 template class NumericalFluxDissipative<PHILIP_DIM, 5, FadType >;
+template class NumericalFluxDissipative<PHILIP_DIM, 5, SFadType<PHILIP_DIM, 5> >;
 template class NumericalFluxDissipative<PHILIP_DIM, 1, RadType >;
 template class NumericalFluxDissipative<PHILIP_DIM, 2, RadType >;
 template class NumericalFluxDissipative<PHILIP_DIM, 3, RadType >;
@@ -260,10 +265,15 @@ template class SymmetricInternalPenalty<PHILIP_DIM, 3, double>;
 template class SymmetricInternalPenalty<PHILIP_DIM, 4, double>;
 template class SymmetricInternalPenalty<PHILIP_DIM, 5, double>;
 template class SymmetricInternalPenalty<PHILIP_DIM, 1, FadType >;
+template class SymmetricInternalPenalty<PHILIP_DIM, 1, SFadType<PHILIP_DIM, 1> >;
 template class SymmetricInternalPenalty<PHILIP_DIM, 2, FadType >;
+template class SymmetricInternalPenalty<PHILIP_DIM, 2, SFadType<PHILIP_DIM, 2> >;
 template class SymmetricInternalPenalty<PHILIP_DIM, 3, FadType >;
+template class SymmetricInternalPenalty<PHILIP_DIM, 3, SFadType<PHILIP_DIM, 3> >;
 template class SymmetricInternalPenalty<PHILIP_DIM, 4, FadType >;
+template class SymmetricInternalPenalty<PHILIP_DIM, 4, SFadType<PHILIP_DIM, 4> >;
 template class SymmetricInternalPenalty<PHILIP_DIM, 5, FadType >;
+template class SymmetricInternalPenalty<PHILIP_DIM, 5, SFadType<PHILIP_DIM, 5> >;
 template class SymmetricInternalPenalty<PHILIP_DIM, 1, RadType >;
 template class SymmetricInternalPenalty<PHILIP_DIM, 2, RadType >;
 template class SymmetricInternalPenalty<PHILIP_DIM, 3, RadType >;
@@ -286,10 +296,15 @@ template class BassiRebay2<PHILIP_DIM, 3, double>;
 template class BassiRebay2<PHILIP_DIM, 4, double>;
 template class BassiRebay2<PHILIP_DIM, 5, double>;
 template class BassiRebay2<PHILIP_DIM, 1, FadType >;
+template class BassiRebay2<PHILIP_DIM, 1, SFadType<PHILIP_DIM, 1> >;
 template class BassiRebay2<PHILIP_DIM, 2, FadType >;
+template class BassiRebay2<PHILIP_DIM, 2, SFadType<PHILIP_DIM, 2> >;
 template class BassiRebay2<PHILIP_DIM, 3, FadType >;
+template class BassiRebay2<PHILIP_DIM, 3, SFadType<PHILIP_DIM, 3> >;
 template class BassiRebay2<PHILIP_DIM, 4, FadType >;
+template class BassiRebay2<PHILIP_DIM, 4, SFadType<PHILIP_DIM, 4> >;
 template class BassiRebay2<PHILIP_DIM, 5, FadType >;
+template class BassiRebay2<PHILIP_DIM, 5, SFadType<PHILIP_DIM, 5> >;
 template class BassiRebay2<PHILIP_DIM, 1, RadType >;
 template class BassiRebay2<PHILIP_DIM, 2, RadType >;
 template class BassiRebay2<PHILIP_DIM, 3, RadType >;
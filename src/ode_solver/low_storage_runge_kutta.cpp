@@ -0,0 +1,147 @@
+#include <deal.II/base/exceptions.h>
+
+#include "low_storage_runge_kutta.h"
+
+namespace PHiLiP {
+namespace ODE {
+
+LowStorageRungeKutta::LowStorageRungeKutta (const Parameters::ODESolverParam::RungeKuttaSchemeEnum scheme)
+{
+    using RKEnum = Parameters::ODESolverParam::RungeKuttaSchemeEnum;
+    switch (scheme) {
+        case RKEnum::forward_euler:
+            name = "Forward Euler";
+            form = ketcheson_3Sstar;
+            order = 1;
+            gamma1 = { 1.0 };
+            gamma2 = { 0.0 };
+            gamma3 = { 0.0 };
+            beta   = { 1.0 };
+            delta  = { 0.0 };
+            break;
+        case RKEnum::ssp_rk3:
+            // Shu-Osher form u^(i) = a u^n + (1-a) (u^(i-1) + b dt F(u^(i-1)))
+            name = "SSP-RK(3,3)";
+            form = ketcheson_3Sstar;
+            order = 3;
+            gamma1 = { 1.0, 0.25, 2.0/3.0 };
+            gamma2 = { 0.0, 0.0,  0.0 };
+            gamma3 = { 0.0, 0.75, 1.0/3.0 };
+            beta   = { 1.0, 0.25, 2.0/3.0 };
+            delta  = { 0.0, 0.0,  0.0 };
+            break;
+        case RKEnum::ssp_rk_4_3:
+            name = "SSP-RK(4,3)";
+            set_ssp_n2_3(2);
+            break;
+        case RKEnum::ssp_rk_9_3:
+            name = "SSP-RK(9,3)";
+            set_ssp_n2_3(3);
+            break;
+        case RKEnum::ssp_rk_16_3:
+            name = "SSP-RK(16,3)";
+            set_ssp_n2_3(4);
+            break;
+        case RKEnum::carpenter_kennedy_rk4_5:
+            name = "Carpenter-Kennedy RK4(5)";
+            form = williamson_2N;
+            order = 4;
+            A = { 0.0,
+                  -567301805773.0/1357537059087.0,
+                  -2404267990393.0/2016746695238.0,
+                  -3550918686646.0/2091501179385.0,
+                  -1275806237668.0/842570457699.0 };
+            B = { 1432997174477.0/9575080441755.0,
+                  5161836677717.0/13612068292357.0,
+                  1720146321549.0/2090206949498.0,
+                  3134564353537.0/4481467310338.0,
+                  2277821191437.0/14882151754819.0 };
+            break;
+        default:
+            AssertThrow(false, dealii::ExcMessage("Unknown Runge-Kutta scheme."));
+    }
+}
+
+void LowStorageRungeKutta::set_ssp_n2_3 (const unsigned int n)
+{
+    // Every stage is a forward Euler step of size dt/r, except the stage n(n+1)/2 which is
+    // averaged with the solution saved after (n-1)(n-2)/2 stages.
+    form = ketcheson_3Sstar;
+    order = 3;
+    const unsigned int n_stages = n*n;
+    const double r = n*n - n;
+    gamma1.assign(n_stages, 1.0);
+    gamma2.assign(n_stages, 0.0);
+    gamma3.assign(n_stages, 0.0);
+    beta.assign(n_stages, 1.0/r);
+    delta.assign(n_stages, 0.0);
+
+    delta[(n-1)*(n-2)/2] = 1.0;
+
+    const unsigned int averaged_stage = n*(n+1)/2 - 1;
+    gamma1[averaged_stage] = (n-1.0)/(2.0*n-1.0);
+    gamma2[averaged_stage] = n/(2.0*n-1.0);
+    beta[averaged_stage] = (n-1.0)/((2.0*n-1.0)*r);
+}
+
+unsigned int LowStorageRungeKutta::n_stages () const
+{
+    return (form == williamson_2N) ? A.size() : beta.size();
+}
+
+bool LowStorageRungeKutta::uses_register_2 () const
+{
+    if (form == williamson_2N) return true;
+    for (const double g : gamma2) if (g != 0.0) return true;
+    return false;
+}
+
+bool LowStorageRungeKutta::uses_register_3 () const
+{
+    if (form == williamson_2N) return false;
+    for (const double g : gamma3) if (g != 0.0) return true;
+    return false;
+}
+
+double LowStorageRungeKutta::stage_derivative_factor (const unsigned int istage) const
+{
+    return (form == williamson_2N) ? 1.0 : beta[istage];
+}
+
+void LowStorageRungeKutta::initialize_registers (const unsigned int n, const double *S1, double *S2, double *S3) const
+{
+    if (S2) for (unsigned int i = 0; i < n; ++i) S2[i] = 0.0;
+    if (S3) for (unsigned int i = 0; i < n; ++i) S3[i] = S1[i];
+}
+
+void LowStorageRungeKutta::begin_stage (const unsigned int istage, const unsigned int n, const double *S1, double *S2) const
+{
+    if (form == williamson_2N || delta[istage] == 0.0) return;
+    const double d = delta[istage];
+    for (unsigned int i = 0; i < n; ++i) S2[i] += d * S1[i];
+}
+
+void LowStorageRungeKutta::end_stage (const unsigned int istage, const unsigned int n, double *S1, double *S2, const double *S3, const double *stage_derivative) const
+{
+    if (form == williamson_2N) {
+        const double a = A[istage], b = B[istage];
+        for (unsigned int i = 0; i < n; ++i) {
+            S2[i] = a * S2[i] + stage_derivative[i];
+            S1[i] += b * S2[i];
+        }
+        return;
+    }
+    const double g1 = gamma1[istage], g2 = gamma2[istage], g3 = gamma3[istage];
+    if (g2 == 0.0 && g3 == 0.0) {
+        for (unsigned int i = 0; i < n; ++i) S1[i] = g1 * S1[i] + stage_derivative[i];
+    } else if (g2 == 0.0) {
+        for (unsigned int i = 0; i < n; ++i) S1[i] = g1 * S1[i] + g3 * S3[i] + stage_derivative[i];
+    } else if (g3 == 0.0) {
+        for (unsigned int i = 0; i < n; ++i) S1[i] = g1 * S1[i] + g2 * S2[i] + stage_derivative[i];
+    } else {
+        for (unsigned int i = 0; i < n; ++i) S1[i] = g1 * S1[i] + g2 * S2[i] + g3 * S3[i] + stage_derivative[i];
+    }
+}
+
+} // ODE namespace
+} // PHiLiP namespace
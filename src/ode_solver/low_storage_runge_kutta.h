@@ -0,0 +1,83 @@
+#ifndef __LOW_STORAGE_RUNGE_KUTTA_H__
+#define __LOW_STORAGE_RUNGE_KUTTA_H__
+
+#include <string>
+#include <vector>
+
+#include "parameters/parameters_ode_solver.h"
+
+namespace PHiLiP {
+namespace ODE {
+
+/// Explicit Runge-Kutta scheme written in a low-storage form.
+/** Instead of storing every stage, the schemes only update a few registers S1, S2, S3, where S1 holds
+ *  the solution and the stage derivatives dt*F(S1) are consumed as soon as they are evaluated.
+ *
+ *  Two forms are supported:
+ *  - williamson_2N: With dt*F evaluated at S1,
+ *    \f[ S_2 = A_i S_2 + \Delta t F(S_1), \quad S_1 = S_1 + B_i S_2 \f]
+ *  - ketcheson_3Sstar: Where S3 keeps the solution at the beginning of the step,
+ *    \f[ S_2 = S_2 + \delta_i S_1, \quad
+ *        S_1 = \gamma_{1,i} S_1 + \gamma_{2,i} S_2 + \gamma_{3,i} S_3 + \beta_i \Delta t F(S_1) \f]
+ *
+ *  The registers are plain arrays of the locally owned entries such that each stage is a single fused loop.
+ *
+ *  References:
+ *  - Williamson, Low-storage Runge-Kutta schemes, JCP 1980.
+ *  - Carpenter and Kennedy, Fourth-order 2N-storage Runge-Kutta schemes, NASA TM-109112, 1994.
+ *  - Ketcheson, Highly efficient strong stability preserving Runge-Kutta methods with low-storage
+ *    implementations, SISC 2008.
+ *  - Ketcheson, Runge-Kutta methods with minimum storage implementations, JCP 2010.
+ */
+class LowStorageRungeKutta
+{
+public:
+    /// Low-storage forms.
+    enum StorageForm {
+        williamson_2N,
+        ketcheson_3Sstar
+    };
+
+    /// Constructor. Looks up the coefficients of the given scheme.
+    explicit LowStorageRungeKutta (const Parameters::ODESolverParam::RungeKuttaSchemeEnum scheme);
+
+    std::string name; ///< Name of the scheme.
+    StorageForm form; ///< Low-storage form of the coefficients.
+    unsigned int order; ///< Order of accuracy.
+
+    /// Number of stages, and therefore of residual evaluations per step.
+    unsigned int n_stages () const;
+    /// Whether the register S2 is used.
+    bool uses_register_2 () const;
+    /// Whether the register S3 is used.
+    bool uses_register_3 () const;
+
+    /// Factor multiplying dt*F(S1) in stage @p istage.
+    /** Allows the caller to scale the stage derivative, for example with local time steps. */
+    double stage_derivative_factor (const unsigned int istage) const;
+
+    /// Initializes S2 and S3 from the solution S1 at the beginning of a step.
+    /** Unused registers may be nullptr. */
+    void initialize_registers (const unsigned int n, const double *S1, double *S2, double *S3) const;
+
+    /// Register updates of stage @p istage required before evaluating F(S1).
+    void begin_stage (const unsigned int istage, const unsigned int n, const double *S1, double *S2) const;
+
+    /// Register updates of stage @p istage given the scaled stage derivative.
+    /** @p stage_derivative must be stage_derivative_factor(istage)*dt*F(S1). */
+    void end_stage (const unsigned int istage, const unsigned int n, double *S1, double *S2, const double *S3, const double *stage_derivative) const;
+
+private:
+    /// Coefficients of the williamson_2N form.
+    std::vector<double> A, B;
+    /// Coefficients of the ketcheson_3Sstar form.
+    std::vector<double> gamma1, gamma2, gamma3, beta, delta;
+
+    /// Sets the coefficients of the SSP(n^2,3) schemes of Ketcheson (2008).
+    void set_ssp_n2_3 (const unsigned int n);
+};
+
+} // ODE namespace
+} // PHiLiP namespace
+
+#endif
@@ -1,14 +1,48 @@
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
 #include <deal.II/distributed/solution_transfer.h>
 
 #include "ode_solver.h"
 
 #include "linear_solver/linear_solver.h"
 
+#include "telemetry/telemetry.h"
+
 namespace PHiLiP {
 namespace ODE {
 
 double global_step = 1.0;
 
+namespace {
+/// Restores the full sparsity of dRdW when leaving the scope of an ODE solve.
+/** The implicit solver may assemble only the cell blocks of dRdW, see Implicit_ODESolver::allocate_ode_system().
+ *  Other users of the system_matrix, such as the adjoint, need all the couplings of dRdW. Restoring it
+ *  on destruction also covers the early returns and the exceptions thrown during the solve.
+ */
+template <int dim, typename real>
+class FullJacobianSparsityRestorer
+{
+public:
+    /// Constructor.
+    explicit FullJacobianSparsityRestorer (DGBase<dim,real> &dg_input) : dg(dg_input) {}
+    /// Destructor restoring the full sparsity.
+    ~FullJacobianSparsityRestorer ()
+    {
+        try {
+            dg.set_cell_block_jacobian(false);
+        } catch (...) {
+            // A destructor must not throw, in particular while another exception is being handled.
+        }
+    }
+    FullJacobianSparsityRestorer (const FullJacobianSparsityRestorer &) = delete; ///< Not copyable.
+    FullJacobianSparsityRestorer & operator= (const FullJacobianSparsityRestorer &) = delete; ///< Not copyable.
+private:
+    DGBase<dim,real> &dg; ///< DG whose system_matrix sparsity is restored.
+};
+} // anonymous namespace
+
 template <int dim, typename real>
 ODESolver<dim,real>::ODESolver(std::shared_ptr< DGBase<dim, real> > dg_input)
     : current_time(0.0)
@@ -44,6 +78,7 @@ void ODESolver<dim,real>::initialize_steady_polynomial_ramping (const unsigned i
         dg->solution.zero_out_ghosts();
         solution_transfer.interpolate(dg->solution);
         dg->solution.update_ghost_values();
+        dg->solution_modified();
 
         // Solve steady state problem.
         steady_state();
@@ -69,19 +104,27 @@ int ODESolver<dim,real>::steady_state ()
     {
         std::abort();
     }
+    const FullJacobianSparsityRestorer<dim,real> full_sparsity_restorer(*dg);
     Parameters::ODESolverParam ode_param = ODESolver<dim,real>::all_parameters->ode_solver_param;
     pcout << " Performing steady state analysis... " << std::endl;
+    // The iteration count, CFL factor and initial residual norm are recovered along with the solution.
+    const bool restart = ode_param.restart_from_checkpoint && !restarted_from_checkpoint;
+    if (restart) read_checkpoint(ode_param.checkpoint_filename);
     allocate_ode_system ();
 
     this->residual_norm_decrease = 1; // Always do at least 1 iteration
     update_norm = 1; // Always do at least 1 iteration
-    this->current_iteration = 0;
-    if (ode_param.output_solution_every_x_steps >= 0) this->dg->output_results_vtk(this->current_iteration);
+    if (!restart) this->current_iteration = 0;
+    if (ode_param.output_solution_every_x_steps >= 0) output_solution(this->current_iteration);
 
     pcout << " Evaluating right-hand side and setting system_matrix to Jacobian before starting iterations... " << std::endl;
     this->dg->assemble_residual ();
-    initial_residual_norm = this->dg->get_residual_l2norm();
-    this->residual_norm = initial_residual_norm;
+    this->residual_norm = this->dg->get_residual_l2norm();
+    if (restart) {
+        this->residual_norm_decrease = this->residual_norm / this->initial_residual_norm;
+    } else {
+        initial_residual_norm = this->residual_norm;
+    }
     pcout << " ********************************************************** "
           << std::endl
           << " Initial absolute residual norm: " << this->residual_norm
@@ -89,7 +132,7 @@ int ODESolver<dim,real>::steady_state ()
 
     // Initial Courant-Friedrichs-Lax number
     const double initial_CFL = all_parameters->ode_solver_param.initial_time_step;
-    CFL_factor = 1.0;
+    if (!restart) CFL_factor = 1.0;
 
     auto initial_solution = dg->solution;
 
@@ -128,9 +171,14 @@ int ODESolver<dim,real>::steady_state ()
 
         double ramped_CFL = initial_CFL * CFL_factor;
         if (this->residual_norm_decrease < 1.0) {
-            ramped_CFL *= pow((1.0-std::log10(this->residual_norm_decrease)*ode_param.time_step_factor_residual), ode_param.time_step_factor_residual_exp);
+            if (ode_param.cfl_controller == Parameters::ODESolverParam::CFLControllerEnum::switched_evolution_relaxation) {
+                ramped_CFL *= pow(1.0/this->residual_norm_decrease, ode_param.switched_evolution_relaxation_exponent);
+            } else {
+                ramped_CFL *= pow((1.0-std::log10(this->residual_norm_decrease)*ode_param.time_step_factor_residual), ode_param.time_step_factor_residual_exp);
+            }
         }
         ramped_CFL = std::max(ramped_CFL,initial_CFL*CFL_factor);
+        ramped_CFL = std::min(ramped_CFL,ode_param.maximum_cfl);
         pcout << "Initial CFL = " << initial_CFL << ". Current CFL = " << ramped_CFL << std::endl;
 
         //if (this->residual_norm > 1e-9) this->dg->update_artificial_dissipation_discontinuity_sensor();
@@ -150,17 +198,23 @@ int ODESolver<dim,real>::steady_state ()
         //    this->dg->freeze_artificial_dissipation = true;
         //}
         const bool pseudotime = true;
-        step_in_time(ramped_CFL, pseudotime);
+        {
+            const Telemetry::ScopedTimer timer("ode_step");
+            step_in_time(ramped_CFL, pseudotime);
+        }
 
         this->dg->assemble_residual ();
 
         ++(this->current_iteration);
+        if (!all_parameters->telemetry_iteration_report_filename.empty()) {
+            Telemetry::append_iteration_report(all_parameters->telemetry_iteration_report_filename, this->current_iteration, mpi_communicator);
+        }
 
         if (ode_param.output_solution_every_x_steps > 0) {
             const bool is_output_iteration = (this->current_iteration % ode_param.output_solution_every_x_steps == 0);
             if (is_output_iteration) {
                 const int file_number = this->current_iteration / ode_param.output_solution_every_x_steps;
-                this->dg->output_results_vtk(file_number);
+                output_solution(file_number);
             }
         }
         // if (this->residual_norm > old_residual_norm) {
@@ -182,12 +236,18 @@ int ODESolver<dim,real>::steady_state ()
 
         convergence_error = this->residual_norm > ode_param.nonlinear_steady_residual_tolerance
                             && this->residual_norm_decrease > ode_param.nonlinear_steady_residual_tolerance;
+
+        if (ode_param.checkpoint_every_x_steps > 0
+            && this->current_iteration % ode_param.checkpoint_every_x_steps == 0) {
+            write_checkpoint(ode_param.checkpoint_filename);
+        }
     }
     if (this->residual_norm > 1e5
         || std::isnan(this->residual_norm)
         || CFL_factor <= 1e-2)
     {
         this->dg->solution = initial_solution;
+        this->dg->solution_modified();
 
         if(CFL_factor <= 1e-2) this->dg->right_hand_side.add(1.0);
     }
@@ -218,15 +278,21 @@ int ODESolver<dim,real>::advance_solution_time (double time_advance)
         std::abort();
     }
 
+    const FullJacobianSparsityRestorer<dim,real> full_sparsity_restorer(*dg);
     pcout
         << " Advancing solution by " << time_advance << " time units, using "
         << number_of_time_steps << " iterations of size dt=" << constant_time_step << " ... " << std::endl;
+    // Continues the time steps from the iteration and time recovered along with the solution.
+    const bool restart = ode_param.restart_from_checkpoint && !restarted_from_checkpoint;
+    if (restart) read_checkpoint(ode_param.checkpoint_filename);
     allocate_ode_system ();
 
-    this->current_iteration = 0;
+    if (!restart) {
+        this->current_iteration = 0;
 
-    // Output initial solution
-    this->dg->output_results_vtk(this->current_iteration);
+        // Output initial solution
+        output_solution(this->current_iteration);
+    }
 
     while (this->current_iteration < number_of_time_steps)
     {
@@ -246,23 +312,176 @@ int ODESolver<dim,real>::advance_solution_time (double time_advance)
     }
 
     const bool pseudotime = true;//false;
-    step_in_time(constant_time_step, pseudotime);
+    {
+        const Telemetry::ScopedTimer timer("ode_step");
+        step_in_time(constant_time_step, pseudotime);
+    }
 
 
     if (this->current_iteration%ode_param.print_iteration_modulo == 0) {
-        this->dg->output_results_vtk(this->current_iteration);
+        output_solution(this->current_iteration);
     }
         ++(this->current_iteration);
+        if (!all_parameters->telemetry_iteration_report_filename.empty()) {
+            Telemetry::append_iteration_report(all_parameters->telemetry_iteration_report_filename, this->current_iteration, mpi_communicator);
+        }
 
+        if (ode_param.checkpoint_every_x_steps > 0
+            && this->current_iteration % ode_param.checkpoint_every_x_steps == 0) {
+            write_checkpoint(ode_param.checkpoint_filename);
+        }
 
         //this->dg->output_results_vtk(this->current_iteration);
     }
+
     return 1;
 }
 
+template <int dim, typename real>
+void ODESolver<dim,real>::output_solution (const unsigned int file_number)
+{
+    const auto output_format = all_parameters->ode_solver_param.solution_output_format;
+    if (output_format == Parameters::ODESolverParam::SolutionOutputFormatEnum::binary_xdmf) {
+        dg->output_results_binary(file_number, this->current_time);
+    } else {
+        dg->output_results_vtk(file_number);
+    }
+}
+
+template <int dim, typename real>
+void ODESolver<dim,real>::write_checkpoint (const std::string &filename)
+{
+    pcout << " Writing checkpoint " << filename << " at iteration " << this->current_iteration << "... " << std::endl;
+
+    // The checkpoint is a directory holding the files written by
+    // dealii::parallel::distributed::Triangulation::save() and the ODE state.
+    // It is completely written in a temporary directory before replacing the previous one.
+    const std::string temporary_directory = filename + ".tmp";
+    const std::string previous_directory = filename + ".old";
+    const bool is_root = (dealii::Utilities::MPI::this_mpi_process(mpi_communicator) == 0);
+    if (is_root) {
+        std::filesystem::remove_all(temporary_directory);
+        std::filesystem::create_directories(temporary_directory);
+    }
+    MPI_Barrier(mpi_communicator);
+
+    dg->save_checkpoint(temporary_directory + "/checkpoint");
+
+    if (is_root) {
+        const std::string state_filename = temporary_directory + "/checkpoint.ode_state";
+        std::ofstream state_file(state_filename);
+        state_file << std::setprecision(17)
+                   << this->current_time << " "
+                   << this->current_iteration << " "
+                   << this->CFL_factor << " "
+                   << this->initial_residual_norm << std::endl;
+        state_file.close();
+        AssertThrow(state_file.good(), dealii::ExcMessage("Could not write " + state_filename));
+    }
+    // Make sure every process is done writing before replacing the previous checkpoint.
+    MPI_Barrier(mpi_communicator);
+    if (is_root) {
+        // A directory cannot atomically replace a non-empty one. If the run stops between the
+        // two renames, the previous checkpoint is left complete under previous_directory and
+        // read_checkpoint() falls back on it.
+        std::filesystem::remove_all(previous_directory);
+        if (std::filesystem::exists(filename)) std::filesystem::rename(filename, previous_directory);
+        std::filesystem::rename(temporary_directory, filename);
+        std::filesystem::remove_all(previous_directory);
+    }
+    MPI_Barrier(mpi_communicator);
+}
+
+template <int dim, typename real>
+void ODESolver<dim,real>::read_checkpoint (const std::string &filename)
+{
+    std::string directory = filename;
+    if (!std::filesystem::exists(directory) && std::filesystem::exists(filename + ".old")) {
+        pcout << " Checkpoint " << filename << " was not completely replaced, using the previous one." << std::endl;
+        directory = filename + ".old";
+    }
+    AssertThrow(std::filesystem::is_directory(directory), dealii::ExcMessage("Could not find the checkpoint " + filename));
+
+    pcout << " Restarting from checkpoint " << directory << "... " << std::endl;
+    dg->load_checkpoint(directory + "/checkpoint");
+
+    const std::string state_filename = directory + "/checkpoint.ode_state";
+    std::ifstream state_file(state_filename);
+    AssertThrow(state_file.good(), dealii::ExcMessage("Could not open " + state_filename));
+    state_file >> this->current_time
+               >> this->current_iteration
+               >> this->CFL_factor
+               >> this->initial_residual_norm;
+    AssertThrow(!state_file.fail(), dealii::ExcMessage("Could not read " + state_filename));
+
+    restarted_from_checkpoint = true;
+    pcout << " Restarted at iteration " << this->current_iteration << " and time " << this->current_time << std::endl;
+}
+
+template <int dim, typename real>
+JacobianFreeOperator<dim,real>::JacobianFreeOperator(
+    std::shared_ptr<DGBase<dim,real>> dg_input,
+    const dealii::TrilinosWrappers::SparseMatrix &mass_matrix_input,
+    const double mass_scaling_input,
+    const double perturbation_input)
+    : dg(dg_input)
+    , mass_matrix(mass_matrix_input)
+    , mass_scaling(mass_scaling_input)
+    , perturbation(perturbation_input)
+    , base_solution(dg->solution)
+    , base_right_hand_side(dg->right_hand_side)
+    , base_max_dt_cell(dg->max_dt_cell)
+    , base_solution_norm(dg->solution.l2_norm())
+{ }
+
+template <int dim, typename real>
+void JacobianFreeOperator<dim,real>::vmult (VectorType &dst, const VectorType &src) const
+{
+    // Mass matrix contribution
+    mass_matrix.vmult(dst, src);
+    dst *= mass_scaling;
+
+    const double src_norm = src.l2_norm();
+    if (src_norm == 0.0) return;
+
+    // Step size scaled such that the perturbation is relative to the solution magnitude
+    const double step = perturbation * (1.0 + base_solution_norm) / src_norm;
+
+    // Artificial dissipation is kept at its base value such that the perturbed residual is consistent.
+    const bool old_freeze_artificial_dissipation = dg->freeze_artificial_dissipation;
+    dg->freeze_artificial_dissipation = true;
+
+    // The perturbed solution gets its own version, and the base version is restored afterwards
+    // such that the quantities evaluated at the base solution, such as dRdW, remain valid.
+    const unsigned int base_solution_version = dg->get_solution_version();
+    dg->solution = base_solution;
+    dg->solution.add(step, src);
+    dg->solution.update_ghost_values();
+    dg->solution_modified();
+    dg->assemble_residual();
+
+    // dst = M/dt * v - (R(w + step*v) - R(w)) / step
+    dst.add(-1.0/step, dg->right_hand_side);
+    dst.add( 1.0/step, base_right_hand_side);
+
+    dg->solution = base_solution;
+    dg->solution.update_ghost_values();
+    dg->restore_solution_version(base_solution_version);
+    dg->right_hand_side = base_right_hand_side;
+    dg->max_dt_cell = base_max_dt_cell;
+    dg->freeze_artificial_dissipation = old_freeze_artificial_dissipation;
+
+    Telemetry::add_to_counter(Telemetry::n_vmult, 1);
+    Telemetry::add_to_counter(Telemetry::dRdW_mult, 1);
+}
+
 template <int dim, typename real>
 void Implicit_ODESolver<dim,real>::step_in_time (real dt, const bool pseudotime)
 {
+    if (ODESolver<dim,real>::all_parameters->ode_solver_param.use_jacobian_free_newton_krylov) {
+        step_in_time_jacobian_free(dt, pseudotime);
+        return;
+    }
     const bool compute_dRdW = true;
     this->dg->assemble_residual(compute_dRdW);
     this->current_time += dt;
@@ -287,11 +506,11 @@ void Implicit_ODESolver<dim,real>::step_in_time (real dt, const bool pseudotime)
         pcout << " Evaluating system update... " << std::endl;
     }
 
-    solve_linear (
+    invalidate_preconditioner_if_reallocated();
+    linear_solver->solve (
         this->dg->system_matrix,
         this->dg->right_hand_side,
-        this->solution_update,
-        this->ODESolver<dim,real>::all_parameters->linear_solver_param);
+        this->solution_update);
 
     //this->dg->solution += this->solution_update;
     global_step = linesearch();
@@ -299,6 +518,68 @@ void Implicit_ODESolver<dim,real>::step_in_time (real dt, const bool pseudotime)
     this->update_norm = this->solution_update.l2_norm();
 }
 
+template <int dim, typename real>
+void Implicit_ODESolver<dim,real>::step_in_time_jacobian_free (real dt, const bool pseudotime)
+{
+    const Parameters::ODESolverParam &ode_param = ODESolver<dim,real>::all_parameters->ode_solver_param;
+
+    // (M/dt - dRdW) is only assembled when the linear solver needs to update its preconditioner.
+    invalidate_preconditioner_if_reallocated();
+    if (linear_solver->preconditioner_needs_update(this->dg->system_matrix)) {
+        if ((ode_param.ode_output) == Parameters::OutputEnum::verbose &&
+            (this->current_iteration%ode_param.print_iteration_modulo) == 0 ) {
+            pcout << " Assembling the Jacobian-free preconditioner matrix... " << std::endl;
+        }
+        const bool compute_dRdW = true;
+        this->dg->assemble_residual(compute_dRdW);
+        this->dg->system_matrix *= -1.0;
+        if (pseudotime) {
+            const double CFL = dt;
+            this->dg->time_scaled_mass_matrices(CFL);
+            this->dg->add_time_scaled_mass_matrices();
+        } else {
+            this->dg->add_mass_matrices(1.0/dt);
+        }
+    } else {
+        // Only the residual and the cell time steps are needed by the Jacobian-free operator.
+        this->dg->assemble_residual();
+        if (pseudotime) {
+            const double CFL = dt;
+            this->dg->time_scaled_mass_matrices(CFL);
+        }
+    }
+    this->current_time += dt;
+
+    if ((ode_param.ode_output) == Parameters::OutputEnum::verbose &&
+        (this->current_iteration%ode_param.print_iteration_modulo) == 0 ) {
+        pcout << " Evaluating Jacobian-free system update... " << std::endl;
+    }
+
+    const dealii::TrilinosWrappers::SparseMatrix &mass_matrix = pseudotime ? this->dg->time_scaled_global_mass_matrix : this->dg->global_mass_matrix;
+    const double mass_scaling = pseudotime ? 1.0 : 1.0/dt;
+    const JacobianFreeOperator<dim,real> jacobian_free_operator(this->dg, mass_matrix, mass_scaling, ode_param.jacobian_free_perturbation);
+
+    using VectorType = typename JacobianFreeOperator<dim,real>::VectorType;
+    linear_solver->solve (
+        this->dg->system_matrix,
+        [&jacobian_free_operator] (VectorType &dst, const VectorType &src) { jacobian_free_operator.vmult(dst, src); },
+        this->dg->right_hand_side,
+        this->solution_update);
+
+    global_step = linesearch();
+
+    this->update_norm = this->solution_update.l2_norm();
+}
+
+template <int dim, typename real>
+void Implicit_ODESolver<dim,real>::invalidate_preconditioner_if_reallocated ()
+{
+    const unsigned int allocation_version = this->dg->get_allocation_version();
+    if (preconditioned_allocation_version == allocation_version) return;
+    linear_solver->invalidate_preconditioner();
+    preconditioned_allocation_version = allocation_version;
+}
+
 template <int dim, typename real>
 double Implicit_ODESolver<dim,real>::linesearch ()
 {
@@ -313,6 +594,7 @@ double Implicit_ODESolver<dim,real>::linesearch ()
     const double initial_residual = this->dg->get_residual_l2norm();
 
     this->dg->solution.add(step_length, this->solution_update);
+    this->dg->solution_modified();
     this->dg->assemble_residual ();
     double new_residual = this->dg->get_residual_l2norm();
     pcout << " Step length " << step_length << ". Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
@@ -322,6 +604,7 @@ double Implicit_ODESolver<dim,real>::linesearch ()
         step_length = step_length * step_reduction;
         this->dg->solution = old_solution;
         this->dg->solution.add(step_length, this->solution_update);
+        this->dg->solution_modified();
         this->dg->assemble_residual ();
         new_residual = this->dg->get_residual_l2norm();
         pcout << " Step length " << step_length << " . Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
@@ -332,6 +615,7 @@ double Implicit_ODESolver<dim,real>::linesearch ()
         step_length = 1.0;
         pcout << " Line search failed. Will accept any valid residual less than " << reduction_tolerance_2 << " times the current " << initial_residual << "residual. " << std::endl;
         this->dg->solution.add(step_length, this->solution_update);
+        this->dg->solution_modified();
         this->dg->assemble_residual ();
         new_residual = this->dg->get_residual_l2norm();
         pcout << " Step length " << step_length << " . Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
@@ -339,6 +623,7 @@ double Implicit_ODESolver<dim,real>::linesearch ()
             step_length = step_length * step_reduction;
             this->dg->solution = old_solution;
             this->dg->solution.add(step_length, this->solution_update);
+            this->dg->solution_modified();
             this->dg->assemble_residual ();
             new_residual = this->dg->get_residual_l2norm();
             pcout << " Step length " << step_length << " . Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
@@ -349,12 +634,14 @@ double Implicit_ODESolver<dim,real>::linesearch ()
         pcout << " Reached maximum number of linesearches. Terminating... " << std::endl;
         pcout << " Resetting solution and reducing CFL_factor by : " << this->CFL_factor << std::endl;
         this->dg->solution = old_solution;
+        this->dg->solution_modified();
         return 0.0;
     }
 
     if (iline == maxline) {
         step_length = -1.0;
         this->dg->solution.add(step_length, this->solution_update);
+        this->dg->solution_modified();
         this->dg->assemble_residual ();
         new_residual = this->dg->get_residual_l2norm();
         pcout << " Step length " << step_length << " . Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
@@ -362,6 +649,7 @@ double Implicit_ODESolver<dim,real>::linesearch ()
             step_length = step_length * step_reduction;
             this->dg->solution = old_solution;
             this->dg->solution.add(step_length, this->solution_update);
+            this->dg->solution_modified();
             this->dg->assemble_residual ();
             new_residual = this->dg->get_residual_l2norm();
             pcout << " Step length " << step_length << " . Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
@@ -372,6 +660,7 @@ double Implicit_ODESolver<dim,real>::linesearch ()
         pcout << " Line search failed. Trying to step in the opposite direction. " << std::endl;
         step_length = -1.0;
         this->dg->solution.add(step_length, this->solution_update);
+        this->dg->solution_modified();
         this->dg->assemble_residual ();
         new_residual = this->dg->get_residual_l2norm();
         pcout << " Step length " << step_length << " . Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
@@ -379,6 +668,7 @@ double Implicit_ODESolver<dim,real>::linesearch ()
             step_length = step_length * step_reduction;
             this->dg->solution = old_solution;
             this->dg->solution.add(step_length, this->solution_update);
+            this->dg->solution_modified();
             this->dg->assemble_residual ();
             new_residual = this->dg->get_residual_l2norm();
             pcout << " Step length " << step_length << " . Old residual: " << initial_residual << " New residual: " << new_residual << std::endl;
@@ -389,6 +679,7 @@ double Implicit_ODESolver<dim,real>::linesearch ()
         pcout << " Reached maximum number of linesearches. Terminating... " << std::endl;
         pcout << " Resetting solution and reducing CFL_factor by : " << this->CFL_factor << std::endl;
         this->dg->solution = old_solution;
+        this->dg->solution_modified();
         this->CFL_factor *= 0.5;
     }
 
@@ -400,75 +691,39 @@ void Explicit_ODESolver<dim,real>::step_in_time (real dt, const bool pseudotime)
 {
     // this->dg->assemble_residual (); // Not needed since it is called in the base class for time step
     this->current_time += dt;
-    const int rk_order = 3;
-    if (rk_order == 1) {
-        this->dg->global_inverse_mass_matrix.vmult(this->solution_update, this->dg->right_hand_side);
-        this->update_norm = this->solution_update.l2_norm();
-        if (pseudotime) {
-            const double CFL = dt;
-            this->dg->time_scale_solution_update( this->solution_update, CFL );
-            this->dg->solution.add(1.0,this->solution_update);
-        } else {
-            this->dg->solution.add(dt,this->solution_update);
-        }
-    } else if (rk_order == 3) {
-        // Stage 0
-        this->rk_stage[0] = this->dg->solution;
-
-        // Stage 1
-        pcout<< "Stage 1... " << std::flush;
-        this->dg->global_inverse_mass_matrix.vmult(this->solution_update, this->dg->right_hand_side);
-
-        this->rk_stage[1] = this->rk_stage[0];
-        //this->rk_stage[1].add(dt,this->solution_update);
-        if (pseudotime) {
-            const double CFL = dt;
-            this->dg->time_scale_solution_update( this->solution_update, CFL );
-            this->rk_stage[1].add(1.0,this->solution_update);
-        } else {
-            this->rk_stage[1].add(dt,this->solution_update);
-        }
 
-        // Stage 2
-        pcout<< "2... " << std::flush;
-        this->dg->solution = this->rk_stage[1];
-        this->dg->assemble_residual ();
-        this->dg->global_inverse_mass_matrix.vmult(this->solution_update, this->dg->right_hand_side);
-
-        this->rk_stage[2] = this->rk_stage[0];
-        this->rk_stage[2] *= 0.75;
-        this->rk_stage[2].add(0.25, this->rk_stage[1]);
-        //this->rk_stage[2].add(0.25*dt, this->solution_update);
+    // The registers are updated in place on the locally owned entries.
+    dealii::LinearAlgebra::distributed::Vector<double> &solution = this->dg->solution;
+    const unsigned int n_local = solution.locally_owned_elements().n_elements();
+    double *S1 = solution.begin();
+    const bool uses_register_2 = runge_kutta->uses_register_2();
+    double *S2 = uses_register_2 ? this->rk_stage[0].begin() : nullptr;
+    double *S3 = runge_kutta->uses_register_3() ? this->rk_stage[uses_register_2 ? 1 : 0].begin() : nullptr;
+    runge_kutta->initialize_registers(n_local, S1, S2, S3);
+
+    pcout<< "Stage " << std::flush;
+    const unsigned int n_stages = runge_kutta->n_stages();
+    for (unsigned int istage = 0; istage < n_stages; ++istage) {
+        pcout<< istage+1 << "... " << std::flush;
+        runge_kutta->begin_stage(istage, n_local, S1, S2);
+        this->dg->solution_modified();
+
+        if (istage > 0) this->dg->assemble_residual ();
+        this->dg->apply_inverse_mass_matrix(this->dg->right_hand_side, this->solution_update);
+        if (istage == 0) this->update_norm = this->solution_update.l2_norm();
+
+        const double stage_dt = runge_kutta->stage_derivative_factor(istage) * dt;
         if (pseudotime) {
-            const double CFL = 0.25*dt;
+            const double CFL = stage_dt;
             this->dg->time_scale_solution_update( this->solution_update, CFL );
-            this->rk_stage[2].add(1.0,this->solution_update);
         } else {
-            this->rk_stage[2].add(0.25*dt,this->solution_update);
+            this->solution_update *= stage_dt;
         }
-
-        // Stage 3
-        pcout<< "3... " << std::flush;
-        this->dg->solution = this->rk_stage[2];
-        this->dg->assemble_residual ();
-        this->dg->global_inverse_mass_matrix.vmult(this->solution_update, this->dg->right_hand_side);
-
-        this->rk_stage[3] = this->rk_stage[0];
-        this->rk_stage[3] *= 1.0/3.0;
-        this->rk_stage[3].add(2.0/3.0, this->rk_stage[2]);
-        //this->rk_stage[3].add(2.0/3.0*dt, this->solution_update);
-        if (pseudotime) {
-            const double CFL = (2.0/3.0)*dt;
-            this->dg->time_scale_solution_update( this->solution_update, CFL );
-            this->rk_stage[3].add(1.0,this->solution_update);
-        } else {
-            this->rk_stage[3].add((2.0/3.0)*dt,this->solution_update);
-        }
-
-        this->dg->solution = this->rk_stage[3];
-        pcout<< "done." << std::endl;
+        runge_kutta->end_stage(istage, n_local, S1, S2, S3, this->solution_update.begin());
     }
-
+    solution.update_ghost_values();
+    this->dg->solution_modified();
+    pcout<< "done." << std::endl;
 }
 
 template <int dim, typename real>
@@ -479,9 +734,14 @@ void Explicit_ODESolver<dim,real>::allocate_ode_system ()
     this->solution_update.reinit(this->dg->right_hand_side);
     this->dg->evaluate_mass_matrices(do_inverse_mass_matrix);
 
-    this->rk_stage.resize(4);
-    for (int i=0; i<4; i++) {
-        this->rk_stage[i].reinit(this->dg->solution);
+    runge_kutta = std::make_unique<LowStorageRungeKutta>(this->all_parameters->ode_solver_param.runge_kutta_scheme);
+    pcout << "Using " << runge_kutta->name << " with " << runge_kutta->n_stages() << " stages..." << std::endl;
+
+    // Only the registers S2 and S3 used by the scheme are allocated, in that order.
+    this->rk_stage.clear();
+    this->rk_stage.resize((runge_kutta->uses_register_2() ? 1 : 0) + (runge_kutta->uses_register_3() ? 1 : 0));
+    for (auto &stage : this->rk_stage) {
+        stage.reinit(this->dg->solution);
     }
 }
 template <int dim, typename real>
@@ -493,6 +753,31 @@ void Implicit_ODESolver<dim,real>::allocate_ode_system ()
 
     this->solution_update.reinit(this->dg->right_hand_side);
 
+    const Parameters::LinearSolverParam &linear_param = ODESolver<dim,real>::all_parameters->linear_solver_param;
+
+    // The block Jacobi preconditioner of the Jacobian-free operator only needs the cell blocks of dRdW.
+    const bool cell_block_jacobian = ODESolver<dim,real>::all_parameters->ode_solver_param.use_jacobian_free_newton_krylov
+                                     && linear_param.preconditioner_type == Parameters::LinearSolverParam::PreconditionerEnum::block_jacobi;
+    this->dg->set_cell_block_jacobian(cell_block_jacobian);
+    p_multigrid_preconditioner = nullptr;
+    if (linear_param.linear_solver_type == Parameters::LinearSolverParam::LinearSolverEnum::gmres
+        && linear_param.preconditioner_type == Parameters::LinearSolverParam::PreconditionerEnum::p_multigrid) {
+        p_multigrid_preconditioner = std::make_shared<PMultigridPreconditioner<dim,real>> (this->dg, linear_param);
+        pcout << "Using " << p_multigrid_preconditioner->n_levels() << " p-multigrid levels..." << std::endl;
+    }
+
+    if (!linear_solver) {
+        linear_solver = std::make_unique<LinearSolver> (linear_param);
+    } else {
+        linear_solver->invalidate_preconditioner();
+    }
+    preconditioned_allocation_version = this->dg->get_allocation_version();
+    if (p_multigrid_preconditioner) {
+        std::shared_ptr<PMultigridPreconditioner<dim,real>> p_multigrid = p_multigrid_preconditioner;
+        linear_solver->set_preconditioner (p_multigrid.get(),
+            [p_multigrid] (const dealii::TrilinosWrappers::SparseMatrix &matrix) { p_multigrid->initialize(matrix); });
+    }
+
 }
 
 //template <int dim, typename real>
@@ -528,6 +813,7 @@ std::shared_ptr<ODESolver<dim,real>> ODESolverFactory<dim,real>::create_ODESolve
 }
 
 template class ODESolver<PHILIP_DIM, double>;
+template class JacobianFreeOperator<PHILIP_DIM, double>;
 template class Explicit_ODESolver<PHILIP_DIM, double>;
 template class Implicit_ODESolver<PHILIP_DIM, double>;
 template class ODESolverFactory<PHILIP_DIM, double>;
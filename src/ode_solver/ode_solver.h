@@ -4,9 +4,14 @@
 #include <deal.II/base/conditional_ostream.h>
 
 #include <deal.II/lac/vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/trilinos_sparse_matrix.h>
 
 #include "parameters/all_parameters.h"
 #include "dg/dg.h"
+#include "linear_solver/p_multigrid_preconditioner.h"
+#include "linear_solver/linear_solver.h"
+#include "low_storage_runge_kutta.h"
 
 
 namespace PHiLiP {
@@ -69,6 +74,21 @@ public:
     /// Virtual function to evaluate solution update
     virtual void step_in_time(real dt, const bool pseudotime) = 0;
 
+    /// Outputs the solution in the format given by the parameters.
+    void output_solution (const unsigned int file_number);
+
+    /// Writes the DG checkpoint along with the current time, iteration and CFL state in the directory @p filename.
+    /** The files are first written in a temporary directory that then replaces the previous
+     *  checkpoint, such that a complete checkpoint remains if the run stops while writing.
+     *  The write is synchronous since it is a collective operation over the MPI processes.
+     */
+    void write_checkpoint (const std::string &filename);
+
+    /// Recovers the DG solution, grid, time, iteration and CFL state written by write_checkpoint().
+    /** Uses the previous checkpoint if the run stopped while replacing it.
+     */
+    void read_checkpoint (const std::string &filename);
+
     /// Virtual function to allocate the ODE system
     virtual void allocate_ode_system () = 0;
 
@@ -81,6 +101,11 @@ protected:
     double update_norm; ///< Norm of the solution update.
     double initial_residual_norm; ///< Initial residual norm.
 
+    /// Whether the solver already restarted from the checkpoint given by the parameters.
+    /** Subsequent solves, for example during polynomial ramping, then start from the current solution.
+     */
+    bool restarted_from_checkpoint = false;
+
     /// Evaluate stable time-step
     /** Currently not used */
     void compute_time_step();
@@ -88,8 +113,8 @@ protected:
     /// Solution update given by the ODE solver
     dealii::LinearAlgebra::distributed::Vector<double> solution_update;
 
-    /// Stores the various RK stages.
-    /** Currently hard-coded to RK4.
+    /// Stores the registers of the low-storage RK schemes besides the solution.
+    /** Only holds the registers used by the selected scheme.
      */
     std::vector<dealii::LinearAlgebra::distributed::Vector<double>> rk_stage;
 
@@ -106,6 +131,62 @@ public:
 
 }; // end of ODESolver class
 
+/// Jacobian-free operator representing the implicit system (M/dt - dRdW).
+/** The action of dRdW on a vector is approximated by a forward difference of the residual
+ *  \f[
+ *      \left. \frac{\partial \mathbf{R}}{\partial \mathbf{u}} \right|_{\mathbf{u}} \mathbf{v}
+ *      \approx \frac{\mathbf{R}(\mathbf{u} + \epsilon \mathbf{v}) - \mathbf{R}(\mathbf{u})}{\epsilon}
+ *  \f]
+ *  such that dRdW never needs to be assembled to apply the operator.
+ *  To be used with dealii::SolverBase class.
+ */
+template<int dim, typename real>
+class JacobianFreeOperator
+{
+public:
+    using VectorType = dealii::LinearAlgebra::distributed::Vector<double>; ///< Vector type used by the Krylov solver.
+
+    /// Constructor.
+    /** Stores the current solution and residual of \p dg_input about which the residual is linearized.
+     *  Therefore, the residual must have been assembled at the current solution.
+     */
+    JacobianFreeOperator(
+        std::shared_ptr<DGBase<dim,real>> dg_input,
+        const dealii::TrilinosWrappers::SparseMatrix &mass_matrix_input,
+        const double mass_scaling_input,
+        const double perturbation_input);
+
+    /// Application of (M/dt - dRdW) on vector src outputted into dst.
+    /** Const since dealii::SolverGMRES takes the operator by const reference. However, the perturbed
+     *  residual is evaluated by modifying the state of the DG, see the dg member.
+     *  The DG solution, residual and cell time steps are restored after each application.
+     */
+    void vmult (VectorType &dst, const VectorType &src) const;
+
+private:
+    /// Smart pointer to DGBase used to evaluate the perturbed residuals.
+    /** Mutable state of the operator: the const vmult() modifies the solution, residual, cell time steps
+     *  and artificial dissipation flag of the pointed DG, and restores them before returning.
+     *  The DG must therefore not be used concurrently with vmult().
+     */
+    const std::shared_ptr<DGBase<dim,real>> dg;
+    /// Mass matrix added to the operator.
+    const dealii::TrilinosWrappers::SparseMatrix &mass_matrix;
+    /// Scaling applied to the mass matrix, 1/dt or 1 if the mass matrix is already time-scaled.
+    const double mass_scaling;
+    /// Relative perturbation used to evaluate the finite-difference step.
+    const double perturbation;
+
+    /// Solution about which the residual is linearized.
+    const VectorType base_solution;
+    /// Residual evaluated at the base solution.
+    const VectorType base_right_hand_side;
+    /// Cell time steps evaluated at the base solution.
+    const dealii::Vector<double> base_max_dt_cell;
+    /// L2-norm of the base solution used to scale the finite-difference step.
+    const double base_solution_norm;
+};
+
 /// Implicit ODE solver derived from ODESolver.
 /** Currently works to find steady state of linear problems.
  *  Need to add mass matrix to operator to handle nonlinear problems
@@ -134,6 +215,7 @@ public:
     Implicit_ODESolver(std::shared_ptr<DGBase<dim, real>> dg_input)
     :
     ODESolver<dim,real>::ODESolver(dg_input)
+    , preconditioned_allocation_version(0)
     {};
     ~Implicit_ODESolver() {}; ///< Destructor.
     /// Allocates ODE system based on given DGBase.
@@ -144,6 +226,31 @@ protected:
     /// Advances the solution in time by \p dt.
     void step_in_time(real dt, const bool pseudotime = false) override;
 
+    /// Advances the solution in time by \p dt using the JacobianFreeOperator within GMRES.
+    /** The assembled (M/dt - dRdW) is only used to build the preconditioner of linear_solver,
+     *  and is therefore only re-assembled when linear_solver updates its preconditioner.
+     *  With the block_jacobi preconditioner, only the cell blocks of dRdW are allocated.
+     */
+    void step_in_time_jacobian_free(real dt, const bool pseudotime);
+
+    /// p-multigrid preconditioner used when LinearSolverParam::preconditioner_type is p_multigrid.
+    /** Its prolongation operators are built in allocate_ode_system() and its levels are
+     *  re-initialized whenever the system matrix is assembled.
+     */
+    std::shared_ptr<PMultigridPreconditioner<dim,real>> p_multigrid_preconditioner;
+    /// Linear solver keeping its preconditioner and Krylov vectors between the time steps.
+    /** Created by the first allocate_ode_system(). Its preconditioner is invalidated whenever
+     *  the DG system is re-allocated.
+     */
+    std::unique_ptr<LinearSolver> linear_solver;
+    /// DGBase::get_allocation_version() when the preconditioner of linear_solver was last invalidated.
+    unsigned int preconditioned_allocation_version;
+
+    /// Invalidates the preconditioner of linear_solver if the DG system has been re-allocated since.
+    /** The system may be re-allocated without allocate_ode_system(), e.g. by a mesh refinement.
+     */
+    void invalidate_preconditioner_if_reallocated ();
+
     /// Performs a linesearch to reduce the residual.
     /** It first does a backtracking linesearch to make sure the residual is reduced.
      *  If not found, a linesearch is made to check that the residual is valid.
@@ -179,7 +286,13 @@ public:
 
 protected:
     ///< Advances the solution in time by \p dt.
+    /** Uses the low-storage Runge-Kutta scheme selected by ODESolverParam::runge_kutta_scheme.
+     */
     void step_in_time(real dt, const bool pseudotime = false) override;
+
+    /// Coefficients of the Runge-Kutta scheme.
+    std::unique_ptr<LowStorageRungeKutta> runge_kutta;
+
     using ODESolver<dim,real>::pcout; ///< Parallel std::cout that only outputs on mpi_rank==0
 }; // end of Explicit_ODESolver class
 
@@ -5,11 +5,10 @@
 
 #include "ode_solver/ode_solver.h"
 
-#include <Epetra_RowMatrixTransposer.h>
 
 #include "Ifpack.h"
 
-#include "global_counter.hpp"
+#include "telemetry/telemetry.h"
 
 namespace PHiLiP {
 
@@ -25,7 +24,8 @@ FlowConstraints<dim>
     , ffd(_ffd)
     , ffd_design_variables_indices_dim(_ffd_design_variables_indices_dim)
     , jacobian_prec(nullptr)
-    , adjoint_jacobian_prec(nullptr)
+    , jacobian_prec_CFL(0.0)
+    , n_jacobian_prec_factorizations(0)
 {
     flow_CFL_ = 0.0;
 
@@ -83,7 +83,6 @@ template<int dim>
 FlowConstraints<dim>::~FlowConstraints()
 {
     destroy_JacobianPreconditioner_1();
-    destroy_AdjointJacobianPreconditioner_1();
 }
 
 template<int dim>
@@ -91,8 +90,7 @@ void FlowConstraints<dim>
 ::update_1( const ROL::Vector<double>& des_var_sim, bool flag, int iter )
 {
     (void) flag; (void) iter;
-    dg->solution = ROL_vector_to_dealii_vector_reference(des_var_sim);
-    dg->solution.update_ghost_values();
+    dg->set_solution(ROL_vector_to_dealii_vector_reference(des_var_sim));
 }
 
 template<int dim>
@@ -124,6 +122,7 @@ void FlowConstraints<dim>
         dg->high_order_grid->volume_nodes = dg->high_order_grid->initial_volume_nodes;
         dg->high_order_grid->volume_nodes += dXv;
         dg->high_order_grid->volume_nodes.update_ghost_values();
+        dg->high_order_grid->volume_nodes_modified();
 
         dg->output_results_vtk(iupdate);
         ffd.output_ffd_vtu(iupdate);
@@ -188,15 +187,15 @@ void FlowConstraints<dim>
     update_1(des_var_sim);
     update_2(des_var_ctl);
 
-    const bool compute_dRdW=true; const bool compute_dRdX=false; const bool compute_d2R=false;
+    const bool compute_dRdW=true; const bool compute_dRdX=true; const bool compute_d2R=false;
     dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
 
     const auto &input_vector_v = ROL_vector_to_dealii_vector_reference(input_vector);
     auto &output_vector_v = ROL_vector_to_dealii_vector_reference(output_vector);
     this->dg->system_matrix.vmult(output_vector_v, input_vector_v);
 
-    n_vmult += 1;
-    dRdW_mult += 1;
+    Telemetry::add_to_counter(Telemetry::n_vmult, 1);
+    Telemetry::add_to_counter(Telemetry::dRdW_mult, 1);
 
 }
 
@@ -213,7 +212,7 @@ void FlowConstraints<dim>
     update_1(des_var_sim);
     update_2(des_var_ctl);
 
-    const bool compute_dRdW=true; const bool compute_dRdX=false; const bool compute_d2R=false;
+    const bool compute_dRdW=true; const bool compute_dRdX=true; const bool compute_d2R=false;
     dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
 
     if(i_print) std::cout << __PRETTY_FUNCTION__ << std::endl;
@@ -255,27 +254,45 @@ template<int dim>
 void FlowConstraints<dim>
 ::destroy_JacobianPreconditioner_1()
 {
-    delete jacobian_prec;
-    jacobian_prec = nullptr;
+    jacobian_prec.reset();
+    jacobian_prec_stamp.invalidate();
+}
+
+template<int dim>
+bool FlowConstraints<dim>
+::has_JacobianPreconditioner_1() const
+{
+    return jacobian_prec != nullptr;
+}
+
+template<int dim>
+unsigned int FlowConstraints<dim>
+::n_JacobianPreconditioner_1_factorizations() const
+{
+    return n_jacobian_prec_factorizations;
 }
 template<int dim>
 void FlowConstraints<dim>
 ::destroy_AdjointJacobianPreconditioner_1()
 {
-    delete adjoint_jacobian_prec;
-    adjoint_jacobian_prec = nullptr;
+    destroy_JacobianPreconditioner_1();
 }
 
 template<int dim>
 int FlowConstraints<dim>
-::construct_JacobianPreconditioner_1(
+::construct_shared_JacobianPreconditioner_1(
     const ROL::Vector<double>& des_var_sim,
     const ROL::Vector<double>& des_var_ctl)
 {
     update_1(des_var_sim);
     update_2(des_var_ctl);
 
-    const bool compute_dRdW=true; const bool compute_dRdX=false; const bool compute_d2R=false;
+    const StateVersions state_versions = dg->get_state_versions();
+    if (jacobian_prec && jacobian_prec_stamp.is_current(state_versions) && jacobian_prec_CFL == flow_CFL_) {
+        return 0;
+    }
+
+    const bool compute_dRdW=true; const bool compute_dRdX=true; const bool compute_d2R=false;
     dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
 
     Epetra_CrsMatrix * jacobian = const_cast<Epetra_CrsMatrix *>(&(dg->system_matrix.trilinos_matrix()));
@@ -296,18 +313,27 @@ int FlowConstraints<dim>
 
     List.set("schwarz: reordering type", "rcm");
     const int OverlapLevel = 1; // one row of overlap among the processes
-    jacobian_prec = Factory.Create(PrecType, jacobian, OverlapLevel);
-    assert (jacobian_prec != 0);
-
-
-
+    jacobian_prec.reset(Factory.Create(PrecType, jacobian, OverlapLevel));
+    assert (jacobian_prec != nullptr);
 
     IFPACK_CHK_ERR(jacobian_prec->SetParameters(List));
     IFPACK_CHK_ERR(jacobian_prec->Initialize());
     IFPACK_CHK_ERR(jacobian_prec->Compute());
+    ++n_jacobian_prec_factorizations;
+
+    jacobian_prec_stamp.set(state_versions);
+    jacobian_prec_CFL = flow_CFL_;
 
     return 0;
+}
 
+template<int dim>
+int FlowConstraints<dim>
+::construct_JacobianPreconditioner_1(
+    const ROL::Vector<double>& des_var_sim,
+    const ROL::Vector<double>& des_var_ctl)
+{
+    return construct_shared_JacobianPreconditioner_1(des_var_sim, des_var_ctl);
 }
 
 template<int dim>
@@ -316,39 +342,8 @@ int FlowConstraints<dim>
     const ROL::Vector<double>& des_var_sim,
     const ROL::Vector<double>& des_var_ctl)
 {
-    update_1(des_var_sim);
-    update_2(des_var_ctl);
-
-    const bool compute_dRdW=true; const bool compute_dRdX=false; const bool compute_d2R=false;
-    dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
-
-    Epetra_CrsMatrix * adjoint_jacobian = const_cast<Epetra_CrsMatrix *>(&(dg->system_matrix_transpose.trilinos_matrix()));
-
-    destroy_AdjointJacobianPreconditioner_1();
-    Ifpack Factory;
-
-    Teuchos::ParameterList List;
-
-    const std::string PrecType = "ILUT"; 
-    List.set("fact: ilut level-of-fill", 50.0);
-    List.set("fact: absolute threshold", 1e-3);
-    List.set("fact: relative threshold", 1.01);//1.0+1e-2);
-    List.set("fact: drop tolerance", 0.0);//1e-12);
-
-    //const std::string PrecType = "ILU"; 
-    //List.set("fact: level-of-fill", 0);
-
-    List.set("schwarz: reordering type", "rcm");
-    const int OverlapLevel = 1; // one row of overlap among the processes
-    adjoint_jacobian_prec = Factory.Create(PrecType, adjoint_jacobian, OverlapLevel);
-    assert (adjoint_jacobian_prec != 0);
-
-    IFPACK_CHK_ERR(adjoint_jacobian_prec->SetParameters(List));
-    IFPACK_CHK_ERR(adjoint_jacobian_prec->Initialize());
-    IFPACK_CHK_ERR(adjoint_jacobian_prec->Compute());
-
-    return 0;
-
+    // The transposed solves of the factors of dRdW are applied in applyInverseAdjointJacobianPreconditioner_1.
+    return construct_shared_JacobianPreconditioner_1(des_var_sim, des_var_ctl);
 }
 
 template<int dim>
@@ -376,10 +371,10 @@ void FlowConstraints<dim>
                     output_vector_v.begin());
     jacobian_prec->ApplyInverse (input_trilinos, output_trilinos);
 
-    //n_vmult += 2;
-    //dRdW_mult += 2;
-    n_vmult += 6;
-    dRdW_mult += 6;
+    //Telemetry::add_to_counter(Telemetry::n_vmult, 2);
+    //Telemetry::add_to_counter(Telemetry::dRdW_mult, 2);
+    Telemetry::add_to_counter(Telemetry::n_vmult, 6);
+    Telemetry::add_to_counter(Telemetry::dRdW_mult, 6);
 
 }
 
@@ -401,17 +396,19 @@ void FlowConstraints<dim>
     auto &output_vector_v = ROL_vector_to_dealii_vector_reference(output_vector);
 
     Epetra_Vector input_trilinos(View,
-                    dg->system_matrix_transpose.trilinos_matrix().DomainMap(),
+                    dg->system_matrix.trilinos_matrix().RangeMap(),
                     input_vector_v.begin());
     Epetra_Vector output_trilinos(View,
-                    dg->system_matrix_transpose.trilinos_matrix().RangeMap(),
+                    dg->system_matrix.trilinos_matrix().DomainMap(),
                     output_vector_v.begin());
-    adjoint_jacobian_prec->ApplyInverse (input_trilinos, output_trilinos);
+    jacobian_prec->SetUseTranspose(true);
+    jacobian_prec->ApplyInverse (input_trilinos, output_trilinos);
+    jacobian_prec->SetUseTranspose(false);
 
-    //n_vmult += 2;
-    //dRdW_mult += 2;
-    n_vmult += 6;
-    dRdW_mult += 6;
+    //Telemetry::add_to_counter(Telemetry::n_vmult, 2);
+    //Telemetry::add_to_counter(Telemetry::dRdW_mult, 2);
+    Telemetry::add_to_counter(Telemetry::n_vmult, 6);
+    Telemetry::add_to_counter(Telemetry::dRdW_mult, 6);
 }
 
 template<int dim>
@@ -427,14 +424,14 @@ double& /*tol*/ )
     update_1(des_var_sim);
     update_2(des_var_ctl);
 
-    const bool compute_dRdW=true; const bool compute_dRdX=false; const bool compute_d2R=false;
+    const bool compute_dRdW=true; const bool compute_dRdX=true; const bool compute_d2R=false;
     dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
 
     // Input vector is copied into temporary non-const vector.
     auto input_vector_v = ROL_vector_to_dealii_vector_reference(input_vector);
     auto &output_vector_v = ROL_vector_to_dealii_vector_reference(output_vector);
 
-    solve_linear (dg->system_matrix_transpose, input_vector_v, output_vector_v, this->linear_solver_param);
+    solve_linear_transpose (dg->system_matrix, input_vector_v, output_vector_v, this->linear_solver_param);
 
 }
 
@@ -479,13 +476,13 @@ double& /*tol*/ )
     auto &output_vector_v = ROL_vector_to_dealii_vector_reference(output_vector);
 
     {
-        const bool compute_dRdW=false; const bool compute_dRdX=true; const bool compute_d2R=false;
+        const bool compute_dRdW=true; const bool compute_dRdX=true; const bool compute_d2R=false;
         dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
         dg->dRdXv.vmult(output_vector_v, dXvdXp_input);
     }
 
-    n_vmult += 7;
-    dRdX_mult += 1;
+    Telemetry::add_to_counter(Telemetry::n_vmult, 7);
+    Telemetry::add_to_counter(Telemetry::dRdX_mult, 1);
 }
 
 template<int dim>
@@ -501,15 +498,15 @@ double& /*tol*/ )
     update_1(des_var_sim);
     update_2(des_var_ctl);
 
-    const bool compute_dRdW=true; const bool compute_dRdX=false; const bool compute_d2R=false;
+    const bool compute_dRdW=true; const bool compute_dRdX=true; const bool compute_d2R=false;
     dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
 
     const auto &input_vector_v = ROL_vector_to_dealii_vector_reference(input_vector);
     auto &output_vector_v = ROL_vector_to_dealii_vector_reference(output_vector);
     this->dg->system_matrix.Tvmult(output_vector_v, input_vector_v);
 
-    n_vmult += 1;
-    dRdW_mult += 1;
+    Telemetry::add_to_counter(Telemetry::n_vmult, 1);
+    Telemetry::add_to_counter(Telemetry::dRdW_mult, 1);
 }
 
 template<int dim>
@@ -530,7 +527,7 @@ double& /*tol*/ )
 
     auto input_dRdXv = dg->high_order_grid->volume_nodes;
     {
-        const bool compute_dRdW=false; const bool compute_dRdX=true; const bool compute_d2R=false;
+        const bool compute_dRdW=true; const bool compute_dRdX=true; const bool compute_d2R=false;
         dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
         dg->dRdXv.Tvmult(input_dRdXv, input_vector_v);
     }
@@ -557,8 +554,8 @@ double& /*tol*/ )
     auto &output_vector_v = ROL_vector_to_dealii_vector_reference(output_vector);
     dXvdXp.Tvmult(output_vector_v, input_dRdXv);
 
-    n_vmult += 7;
-    dRdX_mult += 1;
+    Telemetry::add_to_counter(Telemetry::n_vmult, 7);
+    Telemetry::add_to_counter(Telemetry::dRdX_mult, 1);
 }
 
 template<int dim>
@@ -584,8 +581,8 @@ void FlowConstraints<dim>
     dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R, flow_CFL_);
     dg->d2RdWdW.vmult(ROL_vector_to_dealii_vector_reference(output_vector), ROL_vector_to_dealii_vector_reference(input_vector));
 
-    n_vmult += 6;
-    d2R_mult += 1;
+    Telemetry::add_to_counter(Telemetry::n_vmult, 6);
+    Telemetry::add_to_counter(Telemetry::d2R_mult, 1);
 }
 
 template<int dim>
@@ -639,8 +636,8 @@ void FlowConstraints<dim>
     auto &output_vector_v = ROL_vector_to_dealii_vector_reference(output_vector);
     dXvdXp.Tvmult(output_vector_v, input_d2RdWdX);
 
-    n_vmult += 7;
-    d2R_mult += 1;
+    Telemetry::add_to_counter(Telemetry::n_vmult, 7);
+    Telemetry::add_to_counter(Telemetry::d2R_mult, 1);
 }
 
 template<int dim>
@@ -697,8 +694,8 @@ void FlowConstraints<dim>
         dg->d2RdWdX.vmult(output_vector_v, dXvdXp_input);
     }
 
-    n_vmult += 7;
-    d2R_mult += 1;
+    Telemetry::add_to_counter(Telemetry::n_vmult, 7);
+    Telemetry::add_to_counter(Telemetry::d2R_mult, 1);
 }
 
 
@@ -779,8 +776,8 @@ void FlowConstraints<dim>
     auto &output_vector_v = ROL_vector_to_dealii_vector_reference(output_vector);
     dXvdXp.Tvmult(output_vector_v, d2RdXdX_dXvdXp_input);
 
-    n_vmult += 8;
-    d2R_mult += 1;
+    Telemetry::add_to_counter(Telemetry::n_vmult, 8);
+    Telemetry::add_to_counter(Telemetry::d2R_mult, 1);
 }
 
 // template<int dim>
@@ -1,6 +1,8 @@
 #ifndef __FLOWCONSTRAINTS_H__
 #define __FLOWCONSTRAINTS_H__
 
+#include <memory>
+
 #include <deal.II/optimization/rol/vector_adaptor.h>
 
 #include "ROL_Constraint_SimOpt.hpp"
@@ -13,6 +15,7 @@
 #include "mesh/meshmover_linear_elasticity.hpp"
 
 #include "dg/dg.h"
+#include "dg/state_versions.h"
 
 #include "Ifpack.h"
 
@@ -54,12 +57,23 @@ private:
     /// Used to store initial FFD design to compute FFD point displacements.
     dealii::LinearAlgebra::distributed::Vector<double> initial_ffd_des_var;
 
-    /// Jacobian preconditioner.
-    /** Currently uses ILUT */
-    Ifpack_Preconditioner *jacobian_prec;
-    /// Adjoint Jacobian preconditioner.
-    /** Currently uses ILUT */
-    Ifpack_Preconditioner *adjoint_jacobian_prec;
+    /// Jacobian preconditioner, shared with the adjoint Jacobian.
+    /** Currently uses ILUT. The adjoint Jacobian preconditioner applies the transposed
+     *  triangular solves of the same factors. Only owned by the FlowConstraints, the KKT
+     *  preconditioners merely construct and apply it.
+     */
+    std::unique_ptr<Ifpack_Preconditioner> jacobian_prec;
+    /// State at which jacobian_prec was factored.
+    EvaluationStamp jacobian_prec_stamp;
+    /// flow_CFL_ with which jacobian_prec was factored.
+    double jacobian_prec_CFL;
+    /// Number of factorizations of jacobian_prec since construction.
+    unsigned int n_jacobian_prec_factorizations;
+
+    /// Factors the Jacobian, unless jacobian_prec was already factored at the same state.
+    int construct_shared_JacobianPreconditioner_1(
+        const ROL::Vector<double>& des_var_sim,
+        const ROL::Vector<double>& des_var_ctl);
 
 protected:
     /// ID used when outputting the flow solution.
@@ -164,13 +178,22 @@ public:
         ) override;
 
     /// Constructs the Jacobian preconditioner.
+    /** The factorization is shared with the adjoint Jacobian preconditioner, and is kept until
+     *  the simulation or control variables change, or until it is destroyed.
+     */
     int construct_JacobianPreconditioner_1(
         const ROL::Vector<double>& des_var_sim,
         const ROL::Vector<double>& des_var_ctl);
 
-    /// Frees Jacobian preconditioner from memory;
+    /// Frees the Jacobian preconditioner from memory, which also frees the adjoint Jacobian one.
     void destroy_JacobianPreconditioner_1();
 
+    /// Whether the Jacobian preconditioner shared with the adjoint Jacobian is currently allocated.
+    bool has_JacobianPreconditioner_1() const;
+
+    /// Number of times the Jacobian was factored for the Jacobian and adjoint Jacobian preconditioners.
+    unsigned int n_JacobianPreconditioner_1_factorizations() const;
+
     /// Applies the inverse Jacobian preconditioner.
     /** construct_JacobianPreconditioner_1 needs to be called beforehand.
      */
@@ -183,11 +206,14 @@ public:
         );
 
     /// Constructs the Adjoint Jacobian preconditioner.
+    /** Shares the factorization of construct_JacobianPreconditioner_1(), such that
+     *  constructing both at the same state only factors the Jacobian once.
+     */
     int construct_AdjointJacobianPreconditioner_1(
         const ROL::Vector<double>& des_var_sim,
         const ROL::Vector<double>& des_var_ctl);
 
-    /// Frees adjoint Jacobian preconditioner from memory;
+    /// Frees the adjoint Jacobian preconditioner from memory, which also frees the Jacobian one.
     void destroy_AdjointJacobianPreconditioner_1();
 
     /// Applies the inverse Adjoint Jacobian preconditioner.
@@ -3,7 +3,7 @@
 #include "optimization/kkt_operator.hpp"
 #include "optimization/kkt_birosghattas_preconditioners.hpp"
 
-#include "global_counter.hpp"
+#include "telemetry/telemetry.h"
 
 namespace ROL {
 
@@ -832,11 +832,11 @@ void FullSpace_BirosGhattas<Real>::update(
         << " algo_state.gnorm: "  <<   algo_state.gnorm << std::endl
         << " algo_state.cnorm: "  <<   algo_state.cnorm << std::endl
         << " algo_state.snorm: "  <<   algo_state.snorm << std::endl
-        << " n_vmult_total: "  <<   n_vmult << std::endl
-        << "  dRdW_form " << dRdW_form << std::endl
-        << "  dRdW_mult " << dRdW_mult << std::endl
-        << "  dRdX_mult " << dRdX_mult << std::endl
-        << "  d2R_mult  " << d2R_mult  << std::endl
+        << " n_vmult_total: "  <<   PHiLiP::Telemetry::counter_value(PHiLiP::Telemetry::n_vmult) << std::endl
+        << "  dRdW_form " << PHiLiP::Telemetry::counter_value(PHiLiP::Telemetry::dRdW_form) << std::endl
+        << "  dRdW_mult " << PHiLiP::Telemetry::counter_value(PHiLiP::Telemetry::dRdW_mult) << std::endl
+        << "  dRdX_mult " << PHiLiP::Telemetry::counter_value(PHiLiP::Telemetry::dRdX_mult) << std::endl
+        << "  d2R_mult  " << PHiLiP::Telemetry::counter_value(PHiLiP::Telemetry::d2R_mult)  << std::endl
         ;
     }
     MPI_Barrier(MPI_COMM_WORLD);
@@ -926,11 +926,11 @@ std::string FullSpace_BirosGhattas<Real>::print( AlgorithmState<Real> & algo_sta
     hist << std::setw(18) << std::left << step_state->SPiter;
     hist << std::setw(18) << std::left << step_state->nfval;
     hist << std::setw(18) << std::left << step_state->ngrad;
-    hist << std::setw(18) << std::left << n_vmult;
-    hist << std::setw(18) << std::left << dRdW_form;
-    hist << std::setw(18) << std::left << dRdW_mult;
-    hist << std::setw(18) << std::left << dRdX_mult;
-    hist << std::setw(18) << std::left << d2R_mult;
+    hist << std::setw(18) << std::left << PHiLiP::Telemetry::counter_value(PHiLiP::Telemetry::n_vmult);
+    hist << std::setw(18) << std::left << PHiLiP::Telemetry::counter_value(PHiLiP::Telemetry::dRdW_form);
+    hist << std::setw(18) << std::left << PHiLiP::Telemetry::counter_value(PHiLiP::Telemetry::dRdW_mult);
+    hist << std::setw(18) << std::left << PHiLiP::Telemetry::counter_value(PHiLiP::Telemetry::dRdX_mult);
+    hist << std::setw(18) << std::left << PHiLiP::Telemetry::counter_value(PHiLiP::Telemetry::d2R_mult);
     hist << std::endl;
   }
   return hist.str();
@@ -76,13 +76,11 @@ public:
             (void) error_precond2;
         }
     }
-    ~BirosGhattasPreconditioner()
-    {
-        if (use_approximate_preconditioner_) {
-            equal_constraints_->destroy_JacobianPreconditioner_1();
-            equal_constraints_->destroy_AdjointJacobianPreconditioner_1();
-        }
-    };
+    /// Destructor.
+    /** The Jacobian preconditioners are kept by the FlowConstraints, such that the next KKT
+     *  solve at the same design variables reuses their factorization.
+     */
+    ~BirosGhattasPreconditioner() {};
 
     /// Application of KKT preconditionner on vector src outputted into dst.
     virtual void vmult (dealiiSolverVectorWrappingROL<Real>       &dst,
@@ -5,7 +5,7 @@
 
 #include "mesh/meshmover_linear_elasticity.hpp"
 
-#include "global_counter.hpp"
+#include "telemetry/telemetry.h"
 
 namespace PHiLiP {
 
@@ -68,6 +68,7 @@ void ROLObjectiveSimOpt<dim,nstate>::update(
         functional.dg->high_order_grid->volume_nodes = functional.dg->high_order_grid->initial_volume_nodes;
         functional.dg->high_order_grid->volume_nodes += dXv;
         functional.dg->high_order_grid->volume_nodes.update_ghost_values();
+        functional.dg->high_order_grid->volume_nodes_modified();
     }
 }
 
@@ -125,7 +126,7 @@ void ROLObjectiveSimOpt<dim,nstate>::gradient_2(
     auto &dealii_output = ROL_vector_to_dealii_vector_reference(gradient_ctl);
     dXvdXp.Tvmult(dealii_output, dIdXv);
 
-    //n_vmult += 1;
+    //Telemetry::add_to_counter(Telemetry::n_vmult, 1);
 
     // auto dIdXvs = dIdXv;
     // {
@@ -168,7 +169,7 @@ void ROLObjectiveSimOpt<dim,nstate>::hessVec_11(
 
     functional.d2IdWdW.vmult(hv, dealii_input);
 
-    //n_vmult += 1;
+    //Telemetry::add_to_counter(Telemetry::n_vmult, 1);
 }
 
 template <int dim, int nstate>
@@ -219,7 +220,7 @@ void ROLObjectiveSimOpt<dim,nstate>::hessVec_12(
         functional.d2IdWdX.vmult(dealii_output, dXvdXp_input);
     }
 
-    //n_vmult += 2;
+    //Telemetry::add_to_counter(Telemetry::n_vmult, 2);
 
 }
 
@@ -265,7 +266,7 @@ void ROLObjectiveSimOpt<dim,nstate>::hessVec_21(
     auto &dealii_output = ROL_vector_to_dealii_vector_reference(output_vector);
     dXvdXp.Tvmult(dealii_output, d2IdXdW_input);
 
-    //n_vmult += 2;
+    //Telemetry::add_to_counter(Telemetry::n_vmult, 2);
 }
 
 template <int dim, int nstate>
@@ -331,7 +332,7 @@ void ROLObjectiveSimOpt<dim,nstate>::hessVec_22(
     auto &dealii_output = ROL_vector_to_dealii_vector_reference(output_vector);
     dXvdXp.Tvmult(dealii_output, d2IdXdXp_input);
 
-    //n_vmult += 3;
+    //Telemetry::add_to_counter(Telemetry::n_vmult, 3);
 }
 
 template class ROLObjectiveSimOpt <PHILIP_DIM,1>;
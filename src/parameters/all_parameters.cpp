@@ -39,6 +39,25 @@ void AllParameters::declare_parameters (dealii::ParameterHandler &prm)
                       dealii::Patterns::Bool(),
                       "Use original form by defualt. Otherwise, split the fluxes.");
 
+    prm.declare_entry("use_threaded_assembly", "false",
+                      dealii::Patterns::Bool(),
+                      "Use a serial cell loop by default. Otherwise, assemble graph-colored cells with multiple threads.");
+
+    prm.declare_entry("n_threads_per_process", "0",
+                      dealii::Patterns::Integer(0,dealii::Patterns::Integer::max_int_value),
+                      "Number of threads per MPI process used by the threaded assembly. "
+                      "If n_threads_per_process=0, then all the available cores are used.");
+
+    prm.declare_entry("telemetry_report_filename", "",
+                      dealii::Patterns::FileName(dealii::Patterns::FileName::output),
+                      "JSON file receiving the wall times, estimated work and operation counts of the main parts of the solver "
+                      "at the end of the run. The timers are disabled if this and telemetry_iteration_report_filename are empty.");
+
+    prm.declare_entry("telemetry_iteration_report_filename", "",
+                      dealii::Patterns::FileName(dealii::Patterns::FileName::output),
+                      "File to which the report accumulated so far is appended as a line of JSON after every nonlinear "
+                      "iteration or time step. No per-iteration report is written if empty.");
+
     prm.declare_entry("use_periodic_bc", "false",
                       dealii::Patterns::Bool(),
                       "Use other boundary conditions by default. Otherwise use periodic (for 1d burgers only");
@@ -175,6 +194,10 @@ void AllParameters::parse_parameters (dealii::ParameterHandler &prm)
     use_collocated_nodes = prm.get_bool("use_collocated_nodes");
     use_split_form = prm.get_bool("use_split_form");
     use_periodic_bc = prm.get_bool("use_periodic_bc");
+    use_threaded_assembly = prm.get_bool("use_threaded_assembly");
+    n_threads_per_process = prm.get_integer("n_threads_per_process");
+    telemetry_report_filename = prm.get("telemetry_report_filename");
+    telemetry_iteration_report_filename = prm.get("telemetry_iteration_report_filename");
     add_artificial_dissipation = prm.get_bool("add_artificial_dissipation");
     sipg_penalty_factor = prm.get_double("sipg_penalty_factor");
 
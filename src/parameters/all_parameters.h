@@ -46,6 +46,29 @@ public:
     /// Flag to use split form.
     bool use_split_form;
 
+    /// Flag to assemble the residual with a thread-parallel cell loop.
+    /** Locally owned cells are graph-colored such that no two cells of the same color
+     *  write to the same degrees of freedom. Each color is then assembled by multiple threads.
+     *  Currently only used when assembling the residual without derivatives, since the
+     *  CoDiPack tape used for the derivatives is global.
+     */
+    bool use_threaded_assembly;
+
+    /// Number of threads used by each MPI process if use_threaded_assembly is true.
+    /** A value of 0 lets deal.II use all the available cores.
+     */
+    unsigned int n_threads_per_process;
+
+    /// File to which the timed regions and counters are written at the end of the run, as JSON.
+    /** The timers are disabled if both telemetry_report_filename and telemetry_iteration_report_filename are empty.
+     */
+    std::string telemetry_report_filename;
+
+    /// File to which the timed regions and counters accumulated so far are appended after every nonlinear iteration or time step.
+    /** Each line is a JSON object. No per-iteration report is written if empty.
+     */
+    std::string telemetry_iteration_report_filename;
+
     /// Flag to use periodic BC.
     /** Not fully tested.
      */
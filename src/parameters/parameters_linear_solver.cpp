@@ -32,6 +32,44 @@ void LinearSolverParam::declare_parameters (dealii::ParameterHandler &prm)
                               dealii::Patterns::Integer(),
                               "Number of iterations before restarting GMRES");
 
+            prm.declare_entry("preconditioner", "ilu",
+                              dealii::Patterns::Selection("ilu|block_jacobi|block_ilu|p_multigrid"),
+                              "Preconditioner used by GMRES. "
+                              "ilu uses the scalar ILU(k)/ILUT controlled by the ilut_* options. "
+                              "block_jacobi and block_ilu use the dense DG cell blocks, respectively "
+                              "with LU-factored diagonal blocks only or a block ILU(0). "
+                              "p_multigrid uses a V-cycle over the polynomial degrees controlled by the "
+                              "p_multigrid_* options. It is only available to the ODE solver, other "
+                              "linear solves fall back to block_ilu. "
+                              "Choices are <ilu|block_jacobi|block_ilu|p_multigrid>.");
+
+            prm.declare_entry("preconditioner_update_lag", "1",
+                              dealii::Patterns::Integer(1,dealii::Patterns::Integer::max_int_value),
+                              "Number of linear solves between the updates of the preconditioner kept by the ODE solver. "
+                              "The preconditioner is also updated when the sparsity pattern changes, when GMRES "
+                              "does not converge, or when the iterations stall according to preconditioner_stall_ratio. "
+                              "1 updates the preconditioner at every solve.");
+            prm.declare_entry("preconditioner_stall_ratio", "2.0",
+                              dealii::Patterns::Double(1.0,dealii::Patterns::Double::max_double_value),
+                              "The preconditioner kept by the ODE solver is updated at the next solve when the "
+                              "GMRES iterations exceed this ratio times the iterations of the first solve "
+                              "following the last update.");
+
+            // p-multigrid parameters
+            prm.declare_entry("p_multigrid_coarse_degree", "0",
+                              dealii::Patterns::Integer(0,dealii::Patterns::Integer::max_int_value),
+                              "Polynomial degree of the coarsest p-multigrid level.");
+            prm.declare_entry("p_multigrid_smoothing_steps", "2",
+                              dealii::Patterns::Integer(1,dealii::Patterns::Integer::max_int_value),
+                              "Number of pre- and post-smoothing block-Jacobi sweeps on each p-multigrid level.");
+            prm.declare_entry("p_multigrid_smoother_damping", "0.7",
+                              dealii::Patterns::Double(0.0,2.0),
+                              "Damping factor of the block-Jacobi smoother of the p-multigrid levels.");
+            prm.declare_entry("p_multigrid_coarse_solver", "direct",
+                              dealii::Patterns::Selection("direct|amg"),
+                              "Solver used on the coarsest p-multigrid level. "
+                              "Choices are <direct|amg>.");
+
             // ILU with threshold parameters
             prm.declare_entry("ilut_fill", "1",
                               dealii::Patterns::Integer(),
@@ -85,6 +123,22 @@ void LinearSolverParam ::parse_parameters (dealii::ParameterHandler &prm)
                 restart_number  = prm.get_integer("restart_number");
                 linear_residual = prm.get_double("linear_residual_tolerance");
 
+                const std::string preconditioner_string = prm.get("preconditioner");
+                if (preconditioner_string == "ilu") preconditioner_type = PreconditionerEnum::ilu;
+                if (preconditioner_string == "block_jacobi") preconditioner_type = PreconditionerEnum::block_jacobi;
+                if (preconditioner_string == "block_ilu") preconditioner_type = PreconditionerEnum::block_ilu;
+                if (preconditioner_string == "p_multigrid") preconditioner_type = PreconditionerEnum::p_multigrid;
+
+                preconditioner_update_lag = prm.get_integer("preconditioner_update_lag");
+                preconditioner_stall_ratio = prm.get_double("preconditioner_stall_ratio");
+
+                p_multigrid_coarse_degree = prm.get_integer("p_multigrid_coarse_degree");
+                p_multigrid_smoothing_steps = prm.get_integer("p_multigrid_smoothing_steps");
+                p_multigrid_smoother_damping = prm.get_double("p_multigrid_smoother_damping");
+                const std::string coarse_solver_string = prm.get("p_multigrid_coarse_solver");
+                if (coarse_solver_string == "direct") p_multigrid_coarse_solver = PMultigridCoarseSolverEnum::coarse_direct;
+                if (coarse_solver_string == "amg") p_multigrid_coarse_solver = PMultigridCoarseSolverEnum::coarse_amg;
+
                 ilut_fill = prm.get_integer("ilut_fill");
                 ilut_drop = prm.get_double("ilut_drop");
                 ilut_rtol = prm.get_double("ilut_rtol");
@@ -26,6 +26,25 @@ public:
     OutputEnum linear_solver_output; ///< quiet or verbose.
     LinearSolverEnum linear_solver_type; ///< direct or gmres.
 
+    /// Types of GMRES preconditioners available.
+    enum PreconditionerEnum {
+        ilu,          /// Scalar ILU(k) or ILUT based on ilut_fill.
+        block_jacobi, /// LU-factored dense cell blocks.
+        block_ilu,    /// Block ILU(0) on the dense cell blocks.
+        p_multigrid   /// V-cycle on the polynomial degrees of the DG FE collection.
+    };
+    PreconditionerEnum preconditioner_type; ///< ilu, block_jacobi, block_ilu, or p_multigrid.
+
+    /// Types of coarse solvers for the p-multigrid preconditioner.
+    enum PMultigridCoarseSolverEnum {
+        coarse_direct, /// Sparse LU factorization.
+        coarse_amg     /// Algebraic multigrid V-cycle.
+    };
+    unsigned int p_multigrid_coarse_degree; ///< Polynomial degree of the coarsest p-multigrid level.
+    unsigned int p_multigrid_smoothing_steps; ///< Number of pre- and post-smoothing block-Jacobi sweeps on each level.
+    double p_multigrid_smoother_damping; ///< Damping factor of the block-Jacobi smoother.
+    PMultigridCoarseSolverEnum p_multigrid_coarse_solver; ///< Solver used on the coarsest p-multigrid level.
+
     // GMRES options
     double ilut_drop; ///< Threshold to drop terms close to zero.
     double ilut_rtol; ///< Multiplies diagonal by ilut_rtol for more diagonal dominance.
@@ -37,6 +56,15 @@ public:
     int max_iterations; ///< Maximum number of linear iteration.
     int restart_number; ///< Number of iterations before restarting GMRES
 
+    /// Number of solves of the persistent LinearSolver between preconditioner updates.
+    /** 1 updates the preconditioner at every solve. */
+    unsigned int preconditioner_update_lag;
+    /// Iteration ratio triggering a preconditioner update of the persistent LinearSolver.
+    /** The preconditioner is updated at the next solve when the GMRES iterations exceed this ratio
+     *  times the iterations of the first solve following the last update.
+     */
+    double preconditioner_stall_ratio;
+
     /// Declares the possible variables and sets the defaults.
     static void declare_parameters (dealii::ParameterHandler &prm);
     /// Parses input file and sets the variables.
@@ -17,11 +17,22 @@ void ODESolverParam::declare_parameters (dealii::ParameterHandler &prm)
         prm.declare_entry("output_solution_every_x_steps", "-1",
                           dealii::Patterns::Integer(-1,dealii::Patterns::Integer::max_int_value),
                           "Outputs the solution every x steps in .vtk file");
+        prm.declare_entry("solution_output_format", "vtk",
+                          dealii::Patterns::Selection("vtk|binary_xdmf"),
+                          "File format of the solution outputs. "
+                          "vtk writes the solution and post-processed quantities in .vtu files. "
+                          "binary_xdmf writes the conservative state in a single binary file described by an .xdmf file, "
+                          "without blocking the ODE solver. "
+                          "Choices are <vtk|binary_xdmf>.");
 
         prm.declare_entry("ode_solver_type", "implicit",
                           dealii::Patterns::Selection("explicit|implicit"),
                           "Explicit or implicit solver"
                           "Choices are <explicit|implicit>.");
+        prm.declare_entry("runge_kutta_scheme", "ssp_rk3",
+                          dealii::Patterns::Selection("forward_euler|ssp_rk3|ssp_rk_4_3|ssp_rk_9_3|ssp_rk_16_3|carpenter_kennedy_rk4_5"),
+                          "Runge-Kutta scheme used by the explicit solver. "
+                          "Choices are <forward_euler|ssp_rk3|ssp_rk_4_3|ssp_rk_9_3|ssp_rk_16_3|carpenter_kennedy_rk4_5>.");
 
         prm.declare_entry("nonlinear_max_iterations", "500000",
                           dealii::Patterns::Integer(0,dealii::Patterns::Integer::max_int_value),
@@ -40,6 +51,51 @@ void ODESolverParam::declare_parameters (dealii::ParameterHandler &prm)
                           dealii::Patterns::Double(0,dealii::Patterns::Double::max_double_value),
                           "Scales initial time step by pow(time_step_factor_residual*(-log10(residual_norm_decrease)),time_step_factor_residual_exp).");
 
+        prm.declare_entry("cfl_controller", "residual_ramping",
+                          dealii::Patterns::Selection("residual_ramping|switched_evolution_relaxation"),
+                          "Controller of the pseudotime CFL number of steady-state solves. "
+                          "residual_ramping uses time_step_factor_residual and time_step_factor_residual_exp. "
+                          "switched_evolution_relaxation uses initial_time_step*pow(1/residual_norm_decrease,switched_evolution_relaxation_exponent). "
+                          "Choices are <residual_ramping|switched_evolution_relaxation>.");
+        prm.declare_entry("switched_evolution_relaxation_exponent", "1.0",
+                          dealii::Patterns::Double(0,dealii::Patterns::Double::max_double_value),
+                          "Exponent of the residual decrease in the switched evolution relaxation CFL controller.");
+        prm.declare_entry("maximum_cfl", "1e300",
+                          dealii::Patterns::Double(1e-16,dealii::Patterns::Double::max_double_value),
+                          "Upper bound of the controlled CFL number.");
+
+        prm.declare_entry("local_time_step_max_neighbor_ratio", "0.0",
+                          dealii::Patterns::Double(0,dealii::Patterns::Double::max_double_value),
+                          "Limits the local time step of each cell to this ratio times the local time steps "
+                          "of its neighbours. Must be at least 1. Disabled if 0.");
+        prm.declare_entry("local_time_step_smoothing_sweeps", "2",
+                          dealii::Patterns::Integer(1,dealii::Patterns::Integer::max_int_value),
+                          "Number of sweeps over the cells used to limit the local time steps.");
+
+        prm.declare_entry("use_jacobian_free_newton_krylov", "false",
+                          dealii::Patterns::Bool(),
+                          "Use finite-difference Jacobian-vector products within GMRES "
+                          "instead of the assembled dRdW. The assembled dRdW is only used "
+                          "to build the preconditioner, and is only re-assembled when the "
+                          "preconditioner is updated, see preconditioner_update_lag. "
+                          "With the block_jacobi preconditioner, only the cell blocks of dRdW are stored.");
+        prm.declare_entry("jacobian_free_perturbation", "1e-7",
+                          dealii::Patterns::Double(1e-16,1.0),
+                          "Relative perturbation used to approximate the Jacobian-vector products. "
+                          "The step size is jacobian_free_perturbation*(1+||w||)/||v||.");
+
+        prm.declare_entry("checkpoint_every_x_steps", "0",
+                          dealii::Patterns::Integer(0,dealii::Patterns::Integer::max_int_value),
+                          "Writes a checkpoint of the solution, high-order grid and ODE state "
+                          "every x steps. Disabled if 0.");
+        prm.declare_entry("checkpoint_filename", "checkpoint",
+                          dealii::Patterns::FileName(dealii::Patterns::FileName::FileType::output),
+                          "Directory of the checkpoint files.");
+        prm.declare_entry("restart_from_checkpoint", "false",
+                          dealii::Patterns::Bool(),
+                          "Restart the ODE solver from the checkpoint named checkpoint_filename. "
+                          "The mesh and initial conditions should still be set up as for the original run.");
+
         prm.declare_entry("print_iteration_modulo", "1",
                           dealii::Patterns::Integer(0,dealii::Patterns::Integer::max_int_value),
                           "Print every print_iteration_modulo iterations of "
@@ -57,17 +113,46 @@ void ODESolverParam::parse_parameters (dealii::ParameterHandler &prm)
         if (output_string == "verbose") ode_output = OutputEnum::verbose;
 
         output_solution_every_x_steps = prm.get_integer("output_solution_every_x_steps");
+        const std::string output_format_string = prm.get("solution_output_format");
+        if (output_format_string == "vtk")         solution_output_format = SolutionOutputFormatEnum::vtk;
+        if (output_format_string == "binary_xdmf") solution_output_format = SolutionOutputFormatEnum::binary_xdmf;
 
         const std::string solver_string = prm.get("ode_solver_type");
         if (solver_string == "explicit") ode_solver_type = ODESolverEnum::explicit_solver;
         if (solver_string == "implicit") ode_solver_type = ODESolverEnum::implicit_solver;
 
+        const std::string runge_kutta_string = prm.get("runge_kutta_scheme");
+        if (runge_kutta_string == "forward_euler")           runge_kutta_scheme = RungeKuttaSchemeEnum::forward_euler;
+        if (runge_kutta_string == "ssp_rk3")                 runge_kutta_scheme = RungeKuttaSchemeEnum::ssp_rk3;
+        if (runge_kutta_string == "ssp_rk_4_3")              runge_kutta_scheme = RungeKuttaSchemeEnum::ssp_rk_4_3;
+        if (runge_kutta_string == "ssp_rk_9_3")              runge_kutta_scheme = RungeKuttaSchemeEnum::ssp_rk_9_3;
+        if (runge_kutta_string == "ssp_rk_16_3")             runge_kutta_scheme = RungeKuttaSchemeEnum::ssp_rk_16_3;
+        if (runge_kutta_string == "carpenter_kennedy_rk4_5") runge_kutta_scheme = RungeKuttaSchemeEnum::carpenter_kennedy_rk4_5;
+
         nonlinear_steady_residual_tolerance  = prm.get_double("nonlinear_steady_residual_tolerance");
         nonlinear_max_iterations = prm.get_integer("nonlinear_max_iterations");
         initial_time_step  = prm.get_double("initial_time_step");
         time_step_factor_residual = prm.get_double("time_step_factor_residual");
         time_step_factor_residual_exp = prm.get_double("time_step_factor_residual_exp");
 
+        const std::string cfl_controller_string = prm.get("cfl_controller");
+        if (cfl_controller_string == "residual_ramping")              cfl_controller = CFLControllerEnum::residual_ramping;
+        if (cfl_controller_string == "switched_evolution_relaxation") cfl_controller = CFLControllerEnum::switched_evolution_relaxation;
+        switched_evolution_relaxation_exponent = prm.get_double("switched_evolution_relaxation_exponent");
+        maximum_cfl = prm.get_double("maximum_cfl");
+
+        local_time_step_max_neighbor_ratio = prm.get_double("local_time_step_max_neighbor_ratio");
+        AssertThrow(local_time_step_max_neighbor_ratio == 0.0 || local_time_step_max_neighbor_ratio >= 1.0,
+                    dealii::ExcMessage("local_time_step_max_neighbor_ratio must be 0 to disable the limiting, or at least 1."));
+        local_time_step_smoothing_sweeps = prm.get_integer("local_time_step_smoothing_sweeps");
+
+        use_jacobian_free_newton_krylov = prm.get_bool("use_jacobian_free_newton_krylov");
+        jacobian_free_perturbation = prm.get_double("jacobian_free_perturbation");
+
+        checkpoint_every_x_steps = prm.get_integer("checkpoint_every_x_steps");
+        checkpoint_filename = prm.get("checkpoint_filename");
+        restart_from_checkpoint = prm.get_bool("restart_from_checkpoint");
+
         print_iteration_modulo = prm.get_integer("print_iteration_modulo");
     }
     prm.leave_subsection();
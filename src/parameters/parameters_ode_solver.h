@@ -18,10 +18,34 @@ public:
         implicit_solver  /// Backward-Euler
     };
 
+    /// Explicit Runge-Kutta schemes, all integrated in a low-storage form.
+    enum RungeKuttaSchemeEnum {
+        forward_euler, ///< First-order forward Euler.
+        ssp_rk3, ///< Three-stage third-order SSP scheme of Shu and Osher.
+        ssp_rk_4_3, ///< Four-stage third-order SSP scheme, CFL coefficient of 2.
+        ssp_rk_9_3, ///< Nine-stage third-order SSP scheme, CFL coefficient of 6.
+        ssp_rk_16_3, ///< Sixteen-stage third-order SSP scheme, CFL coefficient of 12.
+        carpenter_kennedy_rk4_5 ///< Five-stage fourth-order 2N-storage scheme of Carpenter and Kennedy.
+    };
+
+    /// Controllers of the pseudotime CFL number of steady-state solves.
+    enum CFLControllerEnum {
+        residual_ramping, ///< Ramps the CFL with -log10 of the residual decrease, see time_step_factor_residual.
+        switched_evolution_relaxation ///< CFL inversely proportional to a power of the residual decrease.
+    };
+
+    /// File formats of the solution outputs of the ODE solver.
+    enum SolutionOutputFormatEnum {
+        vtk, ///< Parallel VTU files of the solution and post-processed quantities, see DGBase::output_results_vtk().
+        binary_xdmf ///< Single binary file of the conservative state described by an XDMF file, see DGBase::output_results_binary().
+    };
+
     OutputEnum ode_output; ///< verbose or quiet.
     ODESolverEnum ode_solver_type; ///< ODE solver type. Note that only implicit has been fully tested for now.
+    RungeKuttaSchemeEnum runge_kutta_scheme; ///< Runge-Kutta scheme used by the explicit ODE solver.
 
     int output_solution_every_x_steps; ///< Outputs the solution every x steps to .vtk file
+    SolutionOutputFormatEnum solution_output_format; ///< File format of the solution outputs.
 
     unsigned int nonlinear_max_iterations; ///< Maximum number of iterations.
     unsigned int print_iteration_modulo; ///< If ode_output==verbose, print every print_iteration_modulo iterations.
@@ -32,6 +56,32 @@ public:
     double time_step_factor_residual; ///< Multiplies initial time-step by time_step_factor_residual*(-log10(residual_norm_decrease))
     double time_step_factor_residual_exp; ///< Scales initial time step by pow(time_step_factor_residual*(-log10(residual_norm_decrease)),time_step_factor_residual_exp)
 
+    CFLControllerEnum cfl_controller; ///< Controller of the pseudotime CFL number.
+    double switched_evolution_relaxation_exponent; ///< CFL = initial_time_step * pow(1/residual_norm_decrease, exponent).
+    double maximum_cfl; ///< Upper bound of the controlled CFL number.
+
+    /// Limits the local time step of a cell to this ratio times the ones of its neighbours.
+    /** Avoids large jumps in the local pseudotime steps of stretched grids. Disabled if 0, otherwise at least 1. */
+    double local_time_step_max_neighbor_ratio;
+    /// Number of sweeps over the cells used to limit the local time steps.
+    unsigned int local_time_step_smoothing_sweeps;
+
+    /// Solve the implicit linear systems with GMRES using Jacobian-free matrix-vector products.
+    /** The action of dRdW is approximated by finite differences of the residual.
+     *  The assembled dRdW is then only used to build the preconditioner, and is only
+     *  re-assembled when LinearSolverParam::preconditioner_update_lag requires it.
+     */
+    bool use_jacobian_free_newton_krylov;
+    /// Relative perturbation used in the finite-difference Jacobian-vector products.
+    double jacobian_free_perturbation;
+
+    /// Writes a checkpoint of the solution, grid and ODE state every x steps. Disabled if 0.
+    unsigned int checkpoint_every_x_steps;
+    std::string checkpoint_filename; ///< Directory of the checkpoint files.
+    /// Restarts the ODE solver from the checkpoint named checkpoint_filename.
+    /** The checkpoint may have been written with a different number of MPI processes. */
+    bool restart_from_checkpoint;
+
     static void declare_parameters (dealii::ParameterHandler &prm); ///< Declares the possible variables and sets the defaults.
     void parse_parameters (dealii::ParameterHandler &prm); ///< Parses input file and sets the variables.
 };
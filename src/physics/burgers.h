@@ -55,6 +55,9 @@ public:
                 const std::array<real,nstate> &soln_const,
                 const std::array<real,nstate> & soln_loop) const;
 
+    /// The split flux is only symmetric for the scalar 1D equation.
+    bool has_symmetric_split_flux () const { return dim == 1; }
+
     /// Spectral radius of convective term Jacobian is 'c'
     std::array<real,nstate> convective_eigenvalues (
         const std::array<real,nstate> &/*solution*/,
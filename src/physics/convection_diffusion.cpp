@@ -214,7 +214,9 @@ std::array<real,nstate> ConvectionDiffusion<dim,nstate,real>
 template class ConvectionDiffusion < PHILIP_DIM, 1, double >;
 template class ConvectionDiffusion < PHILIP_DIM, 2, double >;
 template class ConvectionDiffusion < PHILIP_DIM, 1, FadType>;
+template class ConvectionDiffusion < PHILIP_DIM, 1, SFadType<PHILIP_DIM, 1>>;
 template class ConvectionDiffusion < PHILIP_DIM, 2, FadType>;
+template class ConvectionDiffusion < PHILIP_DIM, 2, SFadType<PHILIP_DIM, 2>>;
 template class ConvectionDiffusion < PHILIP_DIM, 1, RadType>;
 template class ConvectionDiffusion < PHILIP_DIM, 2, RadType>;
 template class ConvectionDiffusion < PHILIP_DIM, 1, FadFadType>;
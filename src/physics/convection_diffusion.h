@@ -53,6 +53,9 @@ public:
         const std::array<real,nstate> &soln1,
         const std::array<real,nstate> &soln2) const;
 
+    /// The split flux only uses arithmetic means of the two states.
+    bool has_symmetric_split_flux () const { return true; }
+
     /// Spectral radius of convective term Jacobian is 'c'
     std::array<real,nstate> convective_eigenvalues (
         const std::array<real,nstate> &/*solution*/,
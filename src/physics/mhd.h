@@ -198,6 +198,9 @@ public:
         const std::array<real,nstate> &conservative_soln1,
         const std::array<real,nstate> &conservative_soln2) const;
 
+    /// The split flux only uses arithmetic means of the two states.
+    bool has_symmetric_split_flux () const { return true; }
+
     /// Mean density given two sets of conservative solutions.
     /** Used in the implementation of the split form.
      */
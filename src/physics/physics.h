@@ -48,6 +48,11 @@ public:
     virtual std::array<dealii::Tensor<1,dim,real>,nstate> convective_numerical_split_flux (
             const std::array<real,nstate> &soln_const, const std::array<real,nstate> &soln_loop) const = 0;
 
+    /// Whether convective_numerical_split_flux() gives the same flux when its two solutions are swapped.
+    /** Allows the split-form volume terms to evaluate the two-point flux once per pair of points.
+     */
+    virtual bool has_symmetric_split_flux () const { return false; }
+
     /// Spectral radius of convective term Jacobian.
     /** Used for scalar dissipation
      */
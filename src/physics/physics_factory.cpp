@@ -53,11 +53,17 @@ template class PhysicsFactory<PHILIP_DIM, 4, double>;
 template class PhysicsFactory<PHILIP_DIM, 5, double>;
 template class PhysicsFactory<PHILIP_DIM, 8, double>;
 template class PhysicsFactory<PHILIP_DIM, 1, FadType >;
+template class PhysicsFactory<PHILIP_DIM, 1, SFadType<PHILIP_DIM, 1> >;
 template class PhysicsFactory<PHILIP_DIM, 2, FadType >;
+template class PhysicsFactory<PHILIP_DIM, 2, SFadType<PHILIP_DIM, 2> >;
 template class PhysicsFactory<PHILIP_DIM, 3, FadType >;
+template class PhysicsFactory<PHILIP_DIM, 3, SFadType<PHILIP_DIM, 3> >;
 template class PhysicsFactory<PHILIP_DIM, 4, FadType >;
+template class PhysicsFactory<PHILIP_DIM, 4, SFadType<PHILIP_DIM, 4> >;
 template class PhysicsFactory<PHILIP_DIM, 5, FadType >;
+template class PhysicsFactory<PHILIP_DIM, 5, SFadType<PHILIP_DIM, 5> >;
 template class PhysicsFactory<PHILIP_DIM, 8, FadType >;
+template class PhysicsFactory<PHILIP_DIM, 8, SFadType<PHILIP_DIM, 8> >;
 
 template class PhysicsFactory<PHILIP_DIM, 1, RadType >;
 template class PhysicsFactory<PHILIP_DIM, 2, RadType >;
@@ -0,0 +1,140 @@
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+#include <deal.II/base/exceptions.h>
+
+#include "binary_solution_writer.h"
+
+namespace PHiLiP {
+namespace Postprocess {
+
+BinarySolutionWriter::BinarySolutionWriter (const MPI_Comm mpi_communicator)
+    : mpi_communicator(mpi_communicator)
+    , write_pending(false)
+{ }
+
+BinarySolutionWriter::~BinarySolutionWriter ()
+{
+    wait();
+}
+
+void BinarySolutionWriter::write (
+    const std::string &filename_prefix,
+    const double time,
+    const ElementType element_type,
+    std::vector<double> &&points_input,
+    std::vector<std::int64_t> &&connectivity_input,
+    const std::vector<std::string> &field_names,
+    std::vector<std::vector<double>> &&fields_input)
+{
+    wait();
+
+    points = std::move(points_input);
+    connectivity = std::move(connectivity_input);
+    fields = std::move(fields_input);
+
+    std::string topology_type;
+    std::uint64_t nodes_per_element = 0;
+    switch (element_type) {
+        case polyline:      topology_type = "Polyline";      nodes_per_element = 2; break;
+        case quadrilateral: topology_type = "Quadrilateral"; nodes_per_element = 4; break;
+        case hexahedron:    topology_type = "Hexahedron";    nodes_per_element = 8; break;
+    }
+    AssertDimension(points.size() % 3, 0);
+    AssertDimension(connectivity.size() % nodes_per_element, 0);
+    AssertDimension(fields.size(), field_names.size());
+
+    const std::uint64_t n_local_points = points.size() / 3;
+    for (const auto &field : fields) AssertDimension(field.size(), n_local_points);
+
+    // Position of the local points and elements among the ones of all the processes.
+    std::uint64_t local_counts[2] = { n_local_points, connectivity.size() / nodes_per_element };
+    std::uint64_t offsets[2] = { 0, 0 };
+    std::uint64_t global_counts[2] = { 0, 0 };
+    MPI_Exscan(local_counts, offsets, 2, MPI_UINT64_T, MPI_SUM, mpi_communicator);
+    MPI_Allreduce(local_counts, global_counts, 2, MPI_UINT64_T, MPI_SUM, mpi_communicator);
+    int mpi_rank;
+    MPI_Comm_rank(mpi_communicator, &mpi_rank);
+    if (mpi_rank == 0) offsets[0] = offsets[1] = 0; // MPI_Exscan leaves the first process undefined.
+
+    for (auto &point_index : connectivity) point_index += offsets[0];
+
+    // Byte offset of each section within the binary file.
+    const std::uint64_t n_points = global_counts[0];
+    const std::uint64_t n_elements = global_counts[1];
+    const MPI_Offset points_start = 0;
+    const MPI_Offset connectivity_start = points_start + 3 * n_points * sizeof(double);
+    const MPI_Offset fields_start = connectivity_start + nodes_per_element * n_elements * sizeof(std::int64_t);
+    const MPI_Offset field_size = n_points * sizeof(double);
+
+    const std::string binary_filename = filename_prefix + ".bin";
+    int ierr = MPI_File_open(mpi_communicator, binary_filename.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file);
+    AssertThrow(ierr == MPI_SUCCESS, dealii::ExcMessage("Could not open " + binary_filename));
+    MPI_File_set_size(file, 0);
+    write_pending = true;
+
+    const auto as_count = [] (const std::size_t size) {
+        AssertThrow(size <= static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                    dealii::ExcMessage("Too many local entries for a single MPI write."));
+        return static_cast<int>(size);
+    };
+    requests.assign(2 + fields.size(), MPI_REQUEST_NULL);
+    MPI_File_iwrite_at_all(file, points_start + 3 * offsets[0] * sizeof(double),
+                           points.data(), as_count(points.size()), MPI_DOUBLE, &requests[0]);
+    MPI_File_iwrite_at_all(file, connectivity_start + nodes_per_element * offsets[1] * sizeof(std::int64_t),
+                           connectivity.data(), as_count(connectivity.size()), MPI_INT64_T, &requests[1]);
+    for (unsigned int ifield = 0; ifield < fields.size(); ++ifield) {
+        MPI_File_iwrite_at_all(file, fields_start + ifield * field_size + offsets[0] * sizeof(double),
+                               fields[ifield].data(), as_count(fields[ifield].size()), MPI_DOUBLE, &requests[2+ifield]);
+    }
+
+    if (mpi_rank != 0) return;
+
+    // The XDMF file refers to the binary file relative to its own location.
+    const std::string binary_basename = binary_filename.substr(binary_filename.find_last_of('/') + 1);
+    const auto data_item = [&] (const std::string &dimensions, const std::string &number_type, const MPI_Offset seek) {
+        return "<DataItem Dimensions=\"" + dimensions + "\" NumberType=\"" + number_type
+               + "\" Precision=\"8\" Format=\"Binary\" Endian=\"Native\" Seek=\"" + std::to_string(seek) + "\">"
+               + binary_basename + "</DataItem>";
+    };
+    std::ofstream xdmf(filename_prefix + ".xdmf");
+    xdmf << std::setprecision(17)
+         << "<?xml version=\"1.0\" ?>\n"
+         << "<Xdmf Version=\"3.0\">\n"
+         << "  <Domain>\n"
+         << "    <Grid Name=\"solution\" GridType=\"Uniform\">\n"
+         << "      <Time Value=\"" << time << "\"/>\n"
+         << "      <Topology TopologyType=\"" << topology_type << "\" NumberOfElements=\"" << n_elements
+         << "\" NodesPerElement=\"" << nodes_per_element << "\">\n"
+         << "        " << data_item(std::to_string(n_elements) + " " + std::to_string(nodes_per_element), "Int", connectivity_start) << "\n"
+         << "      </Topology>\n"
+         << "      <Geometry GeometryType=\"XYZ\">\n"
+         << "        " << data_item(std::to_string(n_points) + " 3", "Float", points_start) << "\n"
+         << "      </Geometry>\n";
+    for (unsigned int ifield = 0; ifield < fields.size(); ++ifield) {
+        xdmf << "      <Attribute Name=\"" << field_names[ifield] << "\" AttributeType=\"Scalar\" Center=\"Node\">\n"
+             << "        " << data_item(std::to_string(n_points), "Float", fields_start + ifield * field_size) << "\n"
+             << "      </Attribute>\n";
+    }
+    xdmf << "    </Grid>\n"
+         << "  </Domain>\n"
+         << "</Xdmf>\n";
+}
+
+void BinarySolutionWriter::wait ()
+{
+    if (!write_pending) return;
+
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    MPI_File_close(&file);
+    write_pending = false;
+
+    requests.clear();
+    points = std::vector<double>();
+    connectivity = std::vector<std::int64_t>();
+    fields = std::vector<std::vector<double>>();
+}
+
+} // Postprocess namespace
+} // PHiLiP namespace
@@ -0,0 +1,79 @@
+#ifndef __BINARY_SOLUTION_WRITER_H__
+#define __BINARY_SOLUTION_WRITER_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+namespace PHiLiP {
+namespace Postprocess {
+
+/// Writes discontinuous point data as a single raw binary file described by an XDMF file.
+/** Every process contributes the points and linear elements of its own cells. The binary file holds,
+ *  in order, the 3 coordinates of all the points, the connectivity of all the elements as 64-bit integers,
+ *  and then the values of each field at all the points. The XDMF file written by the first process
+ *  describes this layout such that ParaView or VisIt read the binary file directly.
+ *
+ *  The data of all the processes goes into a single file through non-blocking collective MPI-IO.
+ *  write() returns as soon as the write has been posted, and the write completes in the background
+ *  while the caller keeps computing. It is only waited upon by the next write() or by wait().
+ */
+class BinarySolutionWriter
+{
+public:
+    /// Linear element types of the XDMF format.
+    enum ElementType {
+        polyline, ///< 2 nodes.
+        quadrilateral, ///< 4 nodes, counter-clockwise.
+        hexahedron ///< 8 nodes, counter-clockwise bottom face followed by the top face.
+    };
+
+    /// Constructor.
+    explicit BinarySolutionWriter (const MPI_Comm mpi_communicator);
+
+    /// Destructor. Waits for the pending write.
+    ~BinarySolutionWriter ();
+
+    /// Posts the write of the files @p filename_prefix.bin and @p filename_prefix.xdmf.
+    /** Must be called by all the processes of the communicator.
+     *
+     *  @param[in] filename_prefix Prefix of the written files.
+     *  @param[in] time Time stored in the XDMF file.
+     *  @param[in] element_type Type of the elements.
+     *  @param[in] points_input Coordinates of the local points, 3 per point.
+     *  @param[in] connectivity_input Local point indices of each local element.
+     *  @param[in] field_names Name of each field.
+     *  @param[in] fields_input Values of each field at the local points.
+     *
+     *  The vectors are taken over by the writer since they must outlive the write.
+     */
+    void write (
+        const std::string &filename_prefix,
+        const double time,
+        const ElementType element_type,
+        std::vector<double> &&points_input,
+        std::vector<std::int64_t> &&connectivity_input,
+        const std::vector<std::string> &field_names,
+        std::vector<std::vector<double>> &&fields_input);
+
+    /// Waits for the pending write to complete and closes its file.
+    void wait ();
+
+private:
+    const MPI_Comm mpi_communicator; ///< MPI communicator.
+
+    bool write_pending; ///< Whether a write has been posted and not waited upon.
+    MPI_File file; ///< File of the pending write.
+    std::vector<MPI_Request> requests; ///< Requests of the pending write.
+
+    std::vector<double> points; ///< Coordinates written by the pending write.
+    std::vector<std::int64_t> connectivity; ///< Connectivity written by the pending write.
+    std::vector<std::vector<double>> fields; ///< Fields written by the pending write.
+};
+
+} // Postprocess namespace
+} // PHiLiP namespace
+
+#endif
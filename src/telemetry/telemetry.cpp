@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include "telemetry.h"
+
+namespace PHiLiP {
+namespace Telemetry {
+
+namespace internal {
+    thread_local Region *active_region = nullptr;
+    std::array<unsigned long long, n_counters> counters = {};
+}
+
+namespace {
+    /// Root of the regions, covering the time since the timers were enabled.
+    std::unique_ptr<Region> root_region;
+    /// Time at which the timers were enabled.
+    std::chrono::steady_clock::time_point enable_time;
+    /// Whether the timers are disabled and root_region->wall_time is final.
+    bool root_region_stopped = false;
+
+    /// Values of a region on the local process.
+    struct RegionValues
+    {
+        double n_calls = 0.0; ///< Number of calls.
+        double wall_time = 0.0; ///< Wall time in seconds.
+        double flops = 0.0; ///< Estimated floating point operations.
+        double bytes = 0.0; ///< Estimated bytes moved.
+    };
+
+    /// Stores the values of @p region and its children with their path from the root.
+    void flatten_regions (const Region &region, const std::string &path, std::map<std::string, RegionValues> &regions)
+    {
+        for (const auto &child : region.children) {
+            const std::string child_path = path.empty() ? child.first : path + "/" + child.first;
+            RegionValues &values = regions[child_path];
+            values.n_calls = child.second->n_calls;
+            values.wall_time = child.second->wall_time;
+            values.flops = child.second->flops;
+            values.bytes = child.second->bytes;
+            flatten_regions(*(child.second), child_path, regions);
+        }
+    }
+
+    /// Union of the region paths of all the processes, sorted such that children follow their parent.
+    std::vector<std::string> gather_region_paths (const std::map<std::string, RegionValues> &local_regions, const MPI_Comm mpi_communicator)
+    {
+        std::string local_paths;
+        for (const auto &region : local_regions) local_paths += region.first + '\n';
+
+        int n_mpi;
+        MPI_Comm_size(mpi_communicator, &n_mpi);
+        int local_size = local_paths.size();
+        std::vector<int> sizes(n_mpi), displacements(n_mpi, 0);
+        MPI_Allgather(&local_size, 1, MPI_INT, sizes.data(), 1, MPI_INT, mpi_communicator);
+        for (int i = 1; i < n_mpi; ++i) displacements[i] = displacements[i-1] + sizes[i-1];
+
+        std::string all_paths(displacements.back() + sizes.back(), '\0');
+        MPI_Allgatherv(local_paths.data(), local_size, MPI_CHAR, &all_paths[0], sizes.data(), displacements.data(), MPI_CHAR, mpi_communicator);
+
+        std::set<std::string> paths;
+        std::istringstream path_stream(all_paths);
+        for (std::string path; std::getline(path_stream, path);) paths.insert(path);
+
+        return std::vector<std::string>(paths.begin(), paths.end());
+    }
+
+    /// Minimum, maximum and average of the values of all the processes, only valid on the first process.
+    struct ReducedValues
+    {
+        std::vector<double> min, max, avg;
+    };
+
+    ReducedValues reduce (const std::vector<double> &local_values, const MPI_Comm mpi_communicator)
+    {
+        int n_mpi;
+        MPI_Comm_size(mpi_communicator, &n_mpi);
+        const int n_values = local_values.size();
+        ReducedValues reduced;
+        reduced.min.resize(n_values);
+        reduced.max.resize(n_values);
+        reduced.avg.resize(n_values);
+        std::vector<double> local_copy = local_values; // MPI-2 signatures take non-const buffers.
+        MPI_Reduce(local_copy.data(), reduced.min.data(), n_values, MPI_DOUBLE, MPI_MIN, 0, mpi_communicator);
+        MPI_Reduce(local_copy.data(), reduced.max.data(), n_values, MPI_DOUBLE, MPI_MAX, 0, mpi_communicator);
+        MPI_Reduce(local_copy.data(), reduced.avg.data(), n_values, MPI_DOUBLE, MPI_SUM, 0, mpi_communicator);
+        for (auto &value : reduced.avg) value /= n_mpi;
+        return reduced;
+    }
+
+    /// JSON object holding the minimum, maximum and average of a value.
+    std::string statistics (const ReducedValues &reduced, const unsigned int index)
+    {
+        std::ostringstream json;
+        json << std::setprecision(9)
+             << "{\"min\": " << reduced.min[index]
+             << ", \"max\": " << reduced.max[index]
+             << ", \"avg\": " << reduced.avg[index] << "}";
+        return json.str();
+    }
+
+    /// Reduces the regions and counters over the processes and returns the JSON report on the first process.
+    /** @p separator is inserted between the entries, to write either one entry per line or a single line.
+     */
+    std::string reduced_report (const std::string &separator, const MPI_Comm mpi_communicator)
+    {
+        std::map<std::string, RegionValues> local_regions;
+        double elapsed_time = 0.0;
+        if (root_region) {
+            flatten_regions(*root_region, "", local_regions);
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - enable_time;
+            elapsed_time = root_region_stopped ? root_region->wall_time : elapsed.count();
+        }
+        const std::vector<std::string> paths = gather_region_paths(local_regions, mpi_communicator);
+
+        // Values of the regions, 4 per region, followed by the counters and the elapsed time.
+        std::vector<double> local_values;
+        for (const auto &path : paths) {
+            const auto region = local_regions.find(path);
+            const RegionValues values = (region == local_regions.end()) ? RegionValues() : region->second;
+            local_values.insert(local_values.end(), { values.n_calls, values.wall_time, values.flops, values.bytes });
+        }
+        for (unsigned int icounter = 0; icounter < n_counters; ++icounter) {
+            local_values.push_back(internal::counters[icounter]);
+        }
+        local_values.push_back(elapsed_time);
+
+        const ReducedValues reduced = reduce(local_values, mpi_communicator);
+
+        int mpi_rank, n_mpi;
+        MPI_Comm_rank(mpi_communicator, &mpi_rank);
+        MPI_Comm_size(mpi_communicator, &n_mpi);
+        if (mpi_rank != 0) return std::string();
+
+        const unsigned int counters_start = 4 * paths.size();
+        const unsigned int elapsed_index = counters_start + n_counters;
+
+        std::ostringstream json;
+        json << std::setprecision(9);
+        json << "{" << separator
+             << "\"n_processes\": " << n_mpi << "," << separator
+             << "\"elapsed_time\": " << statistics(reduced, elapsed_index) << "," << separator
+             << "\"counters\": {";
+        for (unsigned int icounter = 0; icounter < n_counters; ++icounter) {
+            json << (icounter == 0 ? "" : ",") << separator
+                 << "\"" << counter_name(static_cast<Counter>(icounter)) << "\": " << statistics(reduced, counters_start + icounter);
+        }
+        json << separator << "}," << separator
+             << "\"regions\": [";
+        for (unsigned int iregion = 0; iregion < paths.size(); ++iregion) {
+            const unsigned int i_calls = 4*iregion, i_time = i_calls + 1, i_flops = i_calls + 2, i_bytes = i_calls + 3;
+            // The slowest process determines the throughput.
+            const double max_time = reduced.max[i_time];
+            const double total_flops = reduced.avg[i_flops] * n_mpi;
+            const double total_bytes = reduced.avg[i_bytes] * n_mpi;
+            const double gflops_per_second = (max_time > 0.0) ? 1e-9 * total_flops / max_time : 0.0;
+            const double gbytes_per_second = (max_time > 0.0) ? 1e-9 * total_bytes / max_time : 0.0;
+
+            json << (iregion == 0 ? "" : ",") << separator
+                 << "{\"path\": \"" << paths[iregion] << "\""
+                 << ", \"depth\": " << std::count(paths[iregion].begin(), paths[iregion].end(), '/')
+                 << ", \"calls\": " << statistics(reduced, i_calls)
+                 << ", \"wall_time\": " << statistics(reduced, i_time)
+                 << ", \"flops\": " << total_flops
+                 << ", \"bytes\": " << total_bytes
+                 << ", \"gflops_per_second\": " << gflops_per_second
+                 << ", \"gbytes_per_second\": " << gbytes_per_second
+                 << "}";
+        }
+        json << separator << "]" << separator << "}";
+        return json.str();
+    }
+} // anonymous namespace
+
+const char *counter_name (const Counter counter)
+{
+    switch (counter) {
+        case n_vmult:   return "n_vmult";
+        case dRdW_form: return "dRdW_form";
+        case dRdW_mult: return "dRdW_mult";
+        case dRdX_mult: return "dRdX_mult";
+        case d2R_mult:  return "d2R_mult";
+        default:        return "unknown";
+    }
+}
+
+Region::Region (const std::string &name, Region *parent)
+    : name(name)
+    , parent(parent)
+    , n_calls(0)
+    , wall_time(0.0)
+    , flops(0.0)
+    , bytes(0.0)
+{ }
+
+Region &Region::child (const char *child_name)
+{
+    const auto found = children.find(child_name);
+    if (found != children.end()) return *(found->second);
+    std::unique_ptr<Region> &new_child = children[child_name];
+    new_child = std::make_unique<Region>(child_name, this);
+    return *new_child;
+}
+
+void enable ()
+{
+    root_region = std::make_unique<Region>("root", nullptr);
+    root_region_stopped = false;
+    enable_time = std::chrono::steady_clock::now();
+    internal::active_region = root_region.get();
+}
+
+void disable ()
+{
+    if (root_region && !root_region_stopped) {
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - enable_time;
+        root_region->wall_time = elapsed.count();
+        root_region_stopped = true;
+    }
+    internal::active_region = nullptr;
+}
+
+void write_report (const std::string &filename, const MPI_Comm mpi_communicator)
+{
+    const std::string report = reduced_report("\n", mpi_communicator);
+
+    int mpi_rank;
+    MPI_Comm_rank(mpi_communicator, &mpi_rank);
+    if (mpi_rank != 0) return;
+
+    std::ofstream report_file(filename);
+    report_file << report << std::endl;
+}
+
+void append_iteration_report (const std::string &filename, const unsigned int iteration, const MPI_Comm mpi_communicator)
+{
+    const std::string report = reduced_report(" ", mpi_communicator);
+
+    int mpi_rank;
+    MPI_Comm_rank(mpi_communicator, &mpi_rank);
+    if (mpi_rank != 0) return;
+
+    std::ofstream report_file(filename, std::ios::app);
+    report_file << "{\"iteration\": " << iteration << ", \"report\": " << report << "}" << std::endl;
+}
+
+} // Telemetry namespace
+} // PHiLiP namespace
@@ -0,0 +1,184 @@
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <mpi.h>
+
+namespace PHiLiP {
+
+/// Instrumentation of the time and work spent in the main parts of the solver.
+/** Regions of the code are timed by ScopedTimer objects. A region timed while another one is active
+ *  becomes its child, such that the regions form a tree following the call stack, e.g.
+ *  ode_solver_step/assemble_dRdW/volume/ad_jacobian.
+ *
+ *  The timers are disabled by default. A disabled timer only checks a thread-local pointer.
+ *  Once enabled, the regions are only recorded on the thread that enabled them. The timers reached by the
+ *  worker threads of a threaded assembly are ignored, their time being accounted by the enclosing region.
+ *
+ *  The counters of the operations of the optimizers are always kept.
+ *
+ *  write_report() reduces the regions over the processes and writes the minimum, maximum and average
+ *  wall times, together with the estimated work, as a JSON file.
+ */
+namespace Telemetry {
+
+/// Operation counters, kept even when the timers are disabled.
+enum Counter {
+    n_vmult, ///< Number of matrix-vector products, in units of the cost of a dRdW product.
+    dRdW_form, ///< Number of assemblies of dRdW.
+    dRdW_mult, ///< Number of products with dRdW or its transpose.
+    dRdX_mult, ///< Number of products with dRdX or its transpose.
+    d2R_mult, ///< Number of products with the second derivatives of the residual.
+    n_counters ///< Number of counters.
+};
+
+/// Name of a counter as written in the reports.
+const char *counter_name (const Counter counter);
+
+/// Timed region of the code.
+struct Region
+{
+    /// Constructor.
+    Region (const std::string &name, Region *parent);
+
+    const std::string name; ///< Name of the region.
+    Region *const parent; ///< Region active when this one was first entered. nullptr for the root.
+
+    /// Regions entered while this one was active.
+    std::map<std::string, std::unique_ptr<Region>, std::less<>> children;
+
+    unsigned long long n_calls; ///< Number of times the region has been entered.
+    double wall_time; ///< Accumulated wall time in seconds, including the children.
+    double flops; ///< Estimated floating point operations, excluding the children.
+    double bytes; ///< Estimated bytes moved from or to the memory, excluding the children.
+
+    /// Returns the child of the given name, creating it if needed.
+    Region &child (const char *child_name);
+};
+
+namespace internal {
+    /// Region active on the current thread. nullptr if the timers are disabled or on worker threads.
+    extern thread_local Region *active_region;
+    /// Values of the counters.
+    extern std::array<unsigned long long, n_counters> counters;
+}
+
+/// Enables the timers on the calling thread and clears the previously recorded regions.
+void enable ();
+
+/// Disables the timers. The recorded regions are kept for the reports.
+void disable ();
+
+/// Whether the timers are enabled on the calling thread.
+inline bool is_enabled ()
+{
+    return internal::active_region != nullptr;
+}
+
+/// Adds @p increment to a counter.
+inline void add_to_counter (const Counter counter, const unsigned long long increment = 1)
+{
+    internal::counters[counter] += increment;
+}
+
+/// Value of a counter.
+inline unsigned long long counter_value (const Counter counter)
+{
+    return internal::counters[counter];
+}
+
+/// Sets a counter back to zero.
+inline void reset_counter (const Counter counter)
+{
+    internal::counters[counter] = 0;
+}
+
+/// Adds estimated work to the active region.
+/** Used to report the achieved floating point and memory throughputs of the region.
+ */
+inline void add_work (const double flops, const double bytes)
+{
+    if (!internal::active_region) return;
+    internal::active_region->flops += flops;
+    internal::active_region->bytes += bytes;
+}
+
+/// Times the scope in which it is declared as a child of the active region.
+class ScopedTimer
+{
+public:
+    /// Enters the region @p name.
+    explicit ScopedTimer (const char *name)
+        : region(nullptr)
+    {
+        if (!internal::active_region) return;
+        region = &(internal::active_region->child(name));
+        internal::active_region = region;
+        start = std::chrono::steady_clock::now();
+    }
+
+    /// Leaves the region.
+    ~ScopedTimer ()
+    {
+        if (!region) return;
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        region->wall_time += elapsed.count();
+        ++(region->n_calls);
+        internal::active_region = region->parent;
+    }
+
+    ScopedTimer (const ScopedTimer &) = delete; ///< Not copyable.
+    ScopedTimer &operator= (const ScopedTimer &) = delete; ///< Not copyable.
+
+private:
+    Region *region; ///< Timed region. nullptr if the timers are disabled.
+    std::chrono::steady_clock::time_point start; ///< Time at which the region was entered.
+};
+
+/// Ignores the timers reached on the calling thread within the scope in which it is declared.
+/** Used around threaded loops, where the calling thread also does some of the work of the worker threads,
+ *  such that the regions of the calling thread only see part of the work.
+ */
+class ScopedPause
+{
+public:
+    /// Pauses the timers.
+    ScopedPause ()
+        : paused_region(internal::active_region)
+    {
+        internal::active_region = nullptr;
+    }
+
+    /// Resumes the timers.
+    ~ScopedPause ()
+    {
+        internal::active_region = paused_region;
+    }
+
+    ScopedPause (const ScopedPause &) = delete; ///< Not copyable.
+    ScopedPause &operator= (const ScopedPause &) = delete; ///< Not copyable.
+
+private:
+    Region *const paused_region; ///< Region active before the pause.
+};
+
+/// Writes the regions and counters reduced over the processes as a JSON file.
+/** Must be called by all the processes of @p mpi_communicator. Only the first process writes the file.
+ */
+void write_report (const std::string &filename, const MPI_Comm mpi_communicator);
+
+/// Appends the regions and counters accumulated up to @p iteration as a single line of JSON.
+/** Must be called by all the processes of @p mpi_communicator. Only the first process writes the file.
+ */
+void append_iteration_report (const std::string &filename, const unsigned int iteration, const MPI_Comm mpi_communicator);
+
+} // Telemetry namespace
+} // PHiLiP namespace
+
+#endif
@@ -75,6 +75,7 @@ int BurgersEnergyStability<dim, nstate>::run_test() const
                                  expression,
                                  constants);
     dealii::VectorTools::interpolate(dg->dof_handler,initial_condition,dg->solution);
+    dg->solution_modified();
     // Create ODE solver using the factory and providing the DG object
     std::shared_ptr<PHiLiP::ODE::ODESolver<dim, double>> ode_solver = PHiLiP::ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
    
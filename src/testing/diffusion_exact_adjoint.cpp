@@ -465,6 +465,8 @@ int DiffusionExactAdjoint<dim,nstate>::run_test() const
 
             dg_u->solution *= 0.0;
             dg_v->solution *= 0.0;
+            dg_u->solution_modified();
+            dg_v->solution_modified();
             //dg_u->solution.add(1.1);
             //dg_v->solution.add(1.1);
             
@@ -31,7 +31,7 @@
 
 #include "optimization/full_space_step.hpp"
 
-#include "global_counter.hpp"
+#include "telemetry/telemetry.h"
 
 namespace PHiLiP {
 namespace Tests {
@@ -262,6 +262,7 @@ int EulerBumpOptimization<dim,nstate>
         // Initialize coarse grid solution with free-stream
         dg->allocate_system ();
         dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, dg->solution);
+        dg->solution_modified();
         // Create ODE solver and ramp up the solution from p0
         std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
         ode_solver->initialize_steady_polynomial_ramping (poly_degree);
@@ -289,6 +290,7 @@ int EulerBumpOptimization<dim,nstate>
         std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&param, poly_degree, grid);
         dg->allocate_system ();
         dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, dg->solution);
+        dg->solution_modified();
         // Create ODE solver and ramp up the solution from p0
         std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
         ode_solver->initialize_steady_polynomial_ramping (poly_degree);
@@ -368,6 +370,7 @@ int EulerBumpOptimization<dim,nstate>
     std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&param, poly_degree, grid);
     dg->allocate_system ();
     dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, dg->solution);
+    dg->solution_modified();
     // Create ODE solver and ramp up the solution from p0
     std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
     //param.ode_solver_param.nonlinear_steady_residual_tolerance = 1e-4;
@@ -420,11 +423,11 @@ int EulerBumpOptimization<dim,nstate>
     parlist.sublist("Full Space").set("Preconditioner",preconditioner_string);
 
     ROL::Ptr< const ROL::AlgorithmState <double> > algo_state;
-    n_vmult = 0;
-    dRdW_form = 0;
-    dRdW_mult = 0;
-    dRdX_mult = 0;
-    d2R_mult = 0;
+    Telemetry::reset_counter(Telemetry::n_vmult);
+    Telemetry::reset_counter(Telemetry::dRdW_form);
+    Telemetry::reset_counter(Telemetry::dRdW_mult);
+    Telemetry::reset_counter(Telemetry::dRdX_mult);
+    Telemetry::reset_counter(Telemetry::d2R_mult);
 
     switch (opt_type) {
         case full_space_composite_step: {
@@ -501,7 +504,7 @@ int EulerBumpOptimization<dim,nstate>
     timing_end = MPI_Wtime();
     *outStream << "The process took " << timing_end - timing_start << " seconds to run." << std::endl;
 
-    *outStream << "Total n_vmult for algorithm " << n_vmult << std::endl;
+    *outStream << "Total n_vmult for algorithm " << Telemetry::counter_value(Telemetry::n_vmult) << std::endl;
 
     test_error += algo_state->statusFlag;
 
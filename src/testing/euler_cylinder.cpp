@@ -170,6 +170,7 @@ int EulerCylinder<dim,nstate>
         dg->allocate_system ();
         // Initialize coarse grid solution with free-stream
         dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, dg->solution);
+        dg->solution_modified();
 
         // Create ODE solver and ramp up the solution from p0
         std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
@@ -196,6 +197,7 @@ int EulerCylinder<dim,nstate>
                 dg->solution.zero_out_ghosts();
                 solution_transfer.interpolate(dg->solution);
                 dg->solution.update_ghost_values();
+                dg->solution_modified();
             }
 
             // std::string filename = "grid_cylinder-" + dealii::Utilities::int_to_string(igrid, 1) + ".eps";
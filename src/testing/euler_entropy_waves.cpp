@@ -202,6 +202,7 @@ int EulerEntropyWaves<dim,nstate>
 
             // Initialize solution with vortex function at time t=0
             dealii::VectorTools::interpolate(dg->dof_handler, initial_vortex_function, dg->solution);
+            dg->solution_modified();
 
             // Create ODE solver using the factory and providing the DG object
             std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
@@ -143,6 +143,7 @@ int EulerGaussianBump<dim,nstate>
             // Initialize coarse grid solution with free-stream
             dg->allocate_system ();
             dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, dg->solution);
+            dg->solution_modified();
 
             const unsigned int n_global_active_cells = grid->n_global_active_cells();
             const unsigned int n_dofs = dg->dof_handler.n_dofs();
@@ -411,6 +411,7 @@ int EulerGaussianBumpAdjoint<dim,nstate>
         // Initialize coarse grid solution with free-stream
         dg->allocate_system ();
         dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, dg->solution);
+        dg->solution_modified();
 
         // Create ODE solver and ramp up the solution from p0
         std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
@@ -445,6 +446,7 @@ int EulerGaussianBumpAdjoint<dim,nstate>
                 dg->solution.zero_out_ghosts();
                 solution_transfer.interpolate(dg->solution);
                 dg->solution.update_ghost_values();
+                dg->solution_modified();
 
                 estimated_error_per_cell.reinit(grid.n_active_cells());
             }
@@ -213,6 +213,7 @@ int EulerNACA0012<dim,nstate>
             // Initialize coarse grid solution with free-stream
             dg->allocate_system ();
             dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, dg->solution);
+            dg->solution_modified();
 
             const unsigned int n_global_active_cells = dg->triangulation->n_global_active_cells();
             const unsigned int n_dofs = dg->dof_handler.n_dofs();
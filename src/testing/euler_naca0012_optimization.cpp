@@ -39,7 +39,7 @@
 #include "functional/lift_drag.hpp"
 #include "functional/target_wall_pressure.hpp"
 
-#include "global_counter.hpp"
+#include "telemetry/telemetry.h"
 
 namespace PHiLiP {
 namespace Tests {
@@ -530,6 +530,7 @@ int EulerNACAOptimization<dim,nstate>
 
         dg_target->allocate_system ();
         dealii::VectorTools::interpolate(dg_target->dof_handler, initial_conditions, dg_target->solution);
+        dg_target->solution_modified();
         std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg_target);
         ode_solver->n_refine = 0;
         ode_solver->initialize_steady_polynomial_ramping (poly_degree);
@@ -548,6 +549,7 @@ int EulerNACAOptimization<dim,nstate>
 
     dg->allocate_system ();
     dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, dg->solution);
+    dg->solution_modified();
     // Create ODE solver and ramp up the solution from p0
     std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
     ode_solver->n_refine = 0;
@@ -653,11 +655,11 @@ int EulerNACAOptimization<dim,nstate>
     parlist.sublist("Full Space").set("Preconditioner",preconditioner_string);
 
     ROL::Ptr< const ROL::AlgorithmState <double> > algo_state;
-    n_vmult = 0;
-    dRdW_form = 0;
-    dRdW_mult = 0;
-    dRdX_mult = 0;
-    d2R_mult = 0;
+    Telemetry::reset_counter(Telemetry::n_vmult);
+    Telemetry::reset_counter(Telemetry::dRdW_form);
+    Telemetry::reset_counter(Telemetry::dRdW_mult);
+    Telemetry::reset_counter(Telemetry::dRdX_mult);
+    Telemetry::reset_counter(Telemetry::d2R_mult);
 
     switch (opt_type) {
         case full_space_composite_step: {
@@ -746,7 +748,7 @@ int EulerNACAOptimization<dim,nstate>
     timing_end = MPI_Wtime();
     *outStream << "The process took " << timing_end - timing_start << " seconds to run." << std::endl;
 
-    *outStream << "Total n_vmult for algorithm " << n_vmult << std::endl;
+    *outStream << "Total n_vmult for algorithm " << Telemetry::counter_value(Telemetry::n_vmult) << std::endl;
 
     test_error += algo_state->statusFlag;
 
@@ -127,6 +127,7 @@ int EulerTaylorGreen<dim, nstate>::run_test() const
 
  std::cout << "initial condition successfully implemented" << std::endl;
  dealii::VectorTools::interpolate(dg->dof_handler,initial_condition,dg->solution);
+ dg->solution_modified();
  std::cout << "initial condition interpolated to DG solution" << std::endl;
  // Create ODE solver using the factory and providing the DG object
 
@@ -234,6 +234,7 @@ int EulerVortex<dim,nstate>
 
             // Initialize solution with vortex function at time t=0
             dealii::VectorTools::interpolate(dg->dof_handler, initial_vortex_function, dg->solution);
+            dg->solution_modified();
             // dealii::AffineConstraints<double> constraints;
             // constraints.close();
             // dealii::VectorTools::project (dg->dof_handler,
@@ -55,6 +55,7 @@ void GridStudy<dim,nstate>
     //    *sol = (++i) * 0.01;
     //}
     dg.solution = solution_no_ghost;
+    dg.solution_modified();
 }
 template <int dim, int nstate>
 double GridStudy<dim,nstate>
@@ -319,6 +319,7 @@ void initialize_perturbed_solution(PHiLiP::DGBase<dim,double> &dg, const PHiLiP:
     solution_no_ghost.reinit(dg.locally_owned_dofs, MPI_COMM_WORLD);
     dealii::VectorTools::interpolate(dg.dof_handler, *physics.manufactured_solution_function, solution_no_ghost);
     dg.solution = solution_no_ghost;
+    dg.solution_modified();
 }
 
 template<int dim, int nstate>
@@ -424,6 +425,7 @@ int OptimizationInverseManufactured<dim,nstate>
 
  high_order_grid->volume_nodes += volume_displacements;
  high_order_grid->volume_nodes.update_ghost_values();
+ high_order_grid->volume_nodes_modified();
     high_order_grid->update_surface_nodes();
  //{
  // std::function<dealii::Point<dim>(dealii::Point<dim>)> reverse_transformation = reverse_deformation<dim>;
@@ -494,6 +496,7 @@ int OptimizationInverseManufactured<dim,nstate>
  
  high_order_grid->volume_nodes = initial_grid;
  high_order_grid->volume_nodes.update_ghost_values();
+ high_order_grid->volume_nodes_modified();
     high_order_grid->update_surface_nodes();
  pcout << "Initial grid: " << std::endl;
  dg->output_results_vtk(9998);
@@ -619,11 +622,8 @@ int OptimizationInverseManufactured<dim,nstate>
   dIdXs.update_ghost_values();
 
   // Residual derivatives
-  pcout << "Evaluating dRdW..." << std::endl;
-  compute_dRdW = true, compute_dRdX = false, compute_d2R = false;
-  dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R);
-  pcout << "Evaluating dRdX..." << std::endl;
-  compute_dRdW = false; compute_dRdX = true, compute_d2R = false;
+  pcout << "Evaluating dRdW and dRdX..." << std::endl;
+  compute_dRdW = true, compute_dRdX = true, compute_d2R = false;
   dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R);
 
   {
@@ -704,6 +704,7 @@ int OptimizationInverseManufactured<dim,nstate>
     VectorType volume_displacements = meshmover.get_volume_displacements();
     high_order_grid->volume_nodes += volume_displacements;
     high_order_grid->volume_nodes.update_ghost_values();
+    high_order_grid->volume_nodes_modified();
     high_order_grid->update_surface_nodes();
 
     ode_solver->steady_state();
@@ -726,8 +727,10 @@ int OptimizationInverseManufactured<dim,nstate>
    }
 
    dg->solution = old_solution;
+   dg->solution_modified();
    high_order_grid->volume_nodes = old_volume_nodes;
    high_order_grid->volume_nodes.update_ghost_values();
+   high_order_grid->volume_nodes_modified();
    high_order_grid->update_surface_nodes();
    step_length *= 0.5;
   }
@@ -755,11 +758,8 @@ int OptimizationInverseManufactured<dim,nstate>
   dIdXs.update_ghost_values();
 
   // Residual derivatives
-  pcout << "Evaluating dRdW..." << std::endl;
-  compute_dRdW = true, compute_dRdX = false, compute_d2R = false;
-  dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R);
-  pcout << "Evaluating dRdX..." << std::endl;
-  compute_dRdW = false; compute_dRdX = true, compute_d2R = false;
+  pcout << "Evaluating dRdW and dRdX..." << std::endl;
+  compute_dRdW = true, compute_dRdX = true, compute_d2R = false;
   dg->assemble_residual(compute_dRdW, compute_dRdX, compute_d2R);
 
   {
@@ -1071,6 +1071,7 @@ int OptimizationInverseManufactured<dim,nstate>
  // Make sure that if the volume_nodes are located at the target volume_nodes, then we recover our target functional
  high_order_grid->volume_nodes = target_nodes;
  high_order_grid->volume_nodes.update_ghost_values();
+ high_order_grid->volume_nodes_modified();
     high_order_grid->update_surface_nodes();
  // Solve on this new grid
  ode_solver->steady_state();
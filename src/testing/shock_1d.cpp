@@ -190,6 +190,7 @@ void Shock1D<dim,nstate>
     solution_no_ghost.reinit(dg.locally_owned_dofs, MPI_COMM_WORLD);
     dealii::VectorTools::interpolate(dg.dof_handler, SineInitialCondition<dim> (1,0), solution_no_ghost);
     dg.solution = solution_no_ghost;
+    dg.solution_modified();
 }
 
 template<int dim, int nstate>
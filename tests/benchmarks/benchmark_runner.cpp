@@ -0,0 +1,167 @@
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include "benchmark_runner.h"
+
+namespace PHiLiP {
+namespace Benchmark {
+
+namespace {
+    /// Value of the option @p option_name given as --option_name=value, if any.
+    bool get_option (const std::string &argument, const std::string &option_name, std::string &value)
+    {
+        const std::string prefix = "--" + option_name + "=";
+        if (argument.compare(0, prefix.size(), prefix) != 0) return false;
+        value = argument.substr(prefix.size());
+        return true;
+    }
+
+    /// Times of the benchmarks of a JSON file written by Runner::finish().
+    /** The file holds a single benchmark per line, such that they are simply matched line by line.
+     */
+    std::map<std::string, double> read_baseline (const std::string &filename)
+    {
+        std::map<std::string, double> times;
+        std::ifstream file(filename);
+        if (!file) {
+            std::cout << "Could not open the baseline " << filename << std::endl;
+            return times;
+        }
+        const std::regex benchmark_line("\"name\": \"([^\"]*)\".*\"real_time\": ([-+0-9.eE]+)");
+        std::smatch match;
+        for (std::string line; std::getline(file, line);) {
+            if (std::regex_search(line, match, benchmark_line)) times[match[1]] = std::stod(match[2]);
+        }
+        return times;
+    }
+} // anonymous namespace
+
+Runner::Runner (int argc, char *argv[], const MPI_Comm mpi_communicator)
+    : mpi_communicator(mpi_communicator)
+    , executable(argc > 0 ? argv[0] : "")
+    , filter(".*")
+    , min_time(0.5)
+    , n_repetitions(3)
+    , tolerance(0.15)
+{
+    MPI_Comm_rank(mpi_communicator, &mpi_rank);
+
+    for (int iarg = 1; iarg < argc; ++iarg) {
+        const std::string argument = argv[iarg];
+        std::string value;
+        if (get_option(argument, "benchmark_filter", value)) {
+            filter = std::regex(value);
+        } else if (get_option(argument, "benchmark_min_time", value)) {
+            min_time = std::stod(value);
+        } else if (get_option(argument, "benchmark_repetitions", value)) {
+            n_repetitions = std::max(1, std::stoi(value));
+        } else if (get_option(argument, "benchmark_out", value)) {
+            output_filename = value;
+        } else if (get_option(argument, "benchmark_baseline", value)) {
+            baseline_filename = value;
+        } else if (get_option(argument, "benchmark_tolerance", value)) {
+            tolerance = std::stod(value);
+        } else if (get_option(argument, "benchmark_telemetry", value)) {
+            telemetry_filename = value;
+        } else if (mpi_rank == 0) {
+            std::cout << "Ignoring unknown option " << argument << std::endl;
+        }
+    }
+
+    if (!telemetry_filename.empty()) Telemetry::enable();
+
+    if (mpi_rank == 0) {
+        std::cout << std::left << std::setw(60) << "Benchmark"
+                  << std::right << std::setw(16) << "Time (ns)"
+                  << std::setw(14) << "Iterations" << std::endl;
+    }
+}
+
+void Runner::add_result (const std::string &name, const unsigned long long n_iterations, const double time, const double items_per_call)
+{
+    Result result;
+    result.name = name;
+    result.n_iterations = n_iterations;
+    result.time = 1e9 * time / (n_iterations * items_per_call);
+    result.items_per_second = (time > 0.0) ? n_iterations * items_per_call / time : 0.0;
+    results.push_back(result);
+
+    if (mpi_rank == 0) {
+        std::cout << std::left << std::setw(60) << result.name
+                  << std::right << std::setw(16) << std::setprecision(6) << result.time
+                  << std::setw(14) << result.n_iterations << std::endl;
+    }
+}
+
+int Runner::finish ()
+{
+    if (!telemetry_filename.empty()) {
+        Telemetry::disable();
+        Telemetry::write_report(telemetry_filename, mpi_communicator);
+    }
+
+    int n_processes;
+    MPI_Comm_size(mpi_communicator, &n_processes);
+    if (mpi_rank == 0 && !output_filename.empty()) {
+        char date[64];
+        const std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+        std::ofstream output(output_filename);
+        output << std::setprecision(9)
+               << "{\n"
+               << "  \"context\": {\n"
+               << "    \"date\": \"" << date << "\",\n"
+               << "    \"executable\": \"" << executable << "\",\n"
+               << "    \"num_processes\": " << n_processes << ",\n"
+#ifdef NDEBUG
+               << "    \"library_build_type\": \"release\"\n"
+#else
+               << "    \"library_build_type\": \"debug\"\n"
+#endif
+               << "  },\n"
+               << "  \"benchmarks\": [\n";
+        for (unsigned int iresult = 0; iresult < results.size(); ++iresult) {
+            const Result &result = results[iresult];
+            output << "    {\"name\": \"" << result.name << "\""
+                   << ", \"run_type\": \"iteration\""
+                   << ", \"iterations\": " << result.n_iterations
+                   << ", \"real_time\": " << result.time
+                   << ", \"time_unit\": \"ns\""
+                   << ", \"items_per_second\": " << result.items_per_second
+                   << "}" << (iresult+1 < results.size() ? "," : "") << "\n";
+        }
+        output << "  ]\n"
+               << "}\n";
+    }
+
+    if (baseline_filename.empty()) return 0;
+
+    // Every process reads the baseline such that they all return the same number of regressions.
+    const std::map<std::string, double> baseline = read_baseline(baseline_filename);
+    int n_regressions = 0;
+    for (const auto &result : results) {
+        const auto found = baseline.find(result.name);
+        if (found == baseline.end()) continue;
+        const double slowdown = result.time / found->second - 1.0;
+        if (slowdown > tolerance) {
+            ++n_regressions;
+            if (mpi_rank == 0) {
+                std::cout << "Regression of " << result.name << ": " << result.time << " ns against "
+                          << found->second << " ns in the baseline, " << 100.0*slowdown << "% slower." << std::endl;
+            }
+        }
+    }
+    if (mpi_rank == 0) {
+        std::cout << n_regressions << " regression(s) against the baseline " << baseline_filename
+                  << " with a tolerance of " << 100.0*tolerance << "%." << std::endl;
+    }
+    return n_regressions;
+}
+
+} // Benchmark namespace
+} // PHiLiP namespace
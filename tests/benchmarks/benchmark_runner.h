@@ -0,0 +1,139 @@
+#ifndef __BENCHMARK_RUNNER_H__
+#define __BENCHMARK_RUNNER_H__
+
+#include <algorithm>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+#include "telemetry/telemetry.h"
+
+namespace PHiLiP {
+
+/// Micro-benchmarks of the solver kernels.
+/** The benchmarks are timed by a Runner, which follows the command line options and the JSON output
+ *  of Google Benchmark, such that the results can be post-processed by the same tools.
+ */
+namespace Benchmark {
+
+/// Prevents the compiler from optimizing away the computation of @p value.
+template <typename T>
+inline void do_not_optimize (const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// Runs the benchmarks, writes their results and compares them with a baseline.
+/** Command line options:
+ *  - --benchmark_filter=<regex> Only runs the benchmarks whose name matches.
+ *  - --benchmark_min_time=<seconds> Minimum time of a measurement, 0.5 by default.
+ *  - --benchmark_repetitions=<n> Number of measurements, of which the fastest is kept, 3 by default.
+ *  - --benchmark_out=<file> JSON file of the results.
+ *  - --benchmark_baseline=<file> JSON file of previous results. The benchmarks slower than their
+ *    baseline by more than the tolerance are reported as regressions.
+ *  - --benchmark_tolerance=<fraction> Relative slowdown allowed against the baseline, 0.15 by default.
+ *  - --benchmark_telemetry=<file> Enables the Telemetry timers within the benchmarks and writes their report,
+ *    which splits the time of each benchmark into the timed regions of the solver.
+ *
+ *  All the processes of the communicator must run the same benchmarks. The time of a measurement is the
+ *  one of the slowest process.
+ */
+class Runner
+{
+public:
+    /// Parses the command line options.
+    Runner (int argc, char *argv[], const MPI_Comm mpi_communicator);
+
+    /// Times @p function, unless filtered out.
+    /** The function is called repeatedly until a measurement lasts at least the minimum time.
+     *  The reported time is divided by @p items_per_call, e.g. to give the time per cell of an assembly.
+     */
+    template <typename Function>
+    void run (const std::string &name, Function &&function, const double items_per_call = 1.0);
+
+    /// Writes the results and the telemetry report, and compares the results with the baseline.
+    /** Returns the number of regressions.
+     */
+    int finish ();
+
+private:
+    /// Result of a benchmark.
+    struct Result
+    {
+        std::string name; ///< Name of the benchmark.
+        unsigned long long n_iterations; ///< Number of calls of a measurement.
+        double time; ///< Time per call and per item in nanoseconds.
+        double items_per_second; ///< Items processed per second.
+    };
+
+    /// Time of @p n_iterations calls of @p function in seconds, on the slowest process.
+    template <typename Function>
+    double measure (Function &function, const unsigned long long n_iterations) const;
+
+    /// Stores and prints a result.
+    void add_result (const std::string &name, const unsigned long long n_iterations, const double time, const double items_per_call);
+
+    const MPI_Comm mpi_communicator; ///< MPI communicator.
+    int mpi_rank; ///< Rank of the process.
+    std::string executable; ///< Name of the executable.
+
+    std::regex filter; ///< Filter of the benchmark names.
+    double min_time; ///< Minimum time of a measurement in seconds.
+    unsigned int n_repetitions; ///< Number of measurements.
+    std::string output_filename; ///< JSON file of the results.
+    std::string baseline_filename; ///< JSON file of the baseline.
+    double tolerance; ///< Relative slowdown allowed against the baseline.
+    std::string telemetry_filename; ///< Telemetry report.
+
+    std::vector<Result> results; ///< Results of the benchmarks run so far.
+};
+
+template <typename Function>
+double Runner::measure (Function &function, const unsigned long long n_iterations) const
+{
+    MPI_Barrier(mpi_communicator);
+    const double start = MPI_Wtime();
+    for (unsigned long long i = 0; i < n_iterations; ++i) {
+        function();
+    }
+    double elapsed = MPI_Wtime() - start;
+    MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, mpi_communicator);
+    return elapsed;
+}
+
+template <typename Function>
+void Runner::run (const std::string &name, Function &&function, const double items_per_call)
+{
+    if (!std::regex_search(name, filter)) return;
+
+    // The region name can not contain the separator of the region paths.
+    std::string region_name = name;
+    std::replace(region_name.begin(), region_name.end(), '/', ':');
+    const Telemetry::ScopedTimer timer(region_name.c_str());
+
+    // Grows the number of iterations until a measurement lasts long enough.
+    unsigned long long n_iterations = 1;
+    double elapsed = measure(function, n_iterations);
+    const unsigned long long max_iterations = 1000000000;
+    while (elapsed < min_time && n_iterations < max_iterations) {
+        const double multiplier = (elapsed > 0.1*min_time) ? 1.4*min_time/elapsed : 10.0;
+        n_iterations = std::max(n_iterations+1, static_cast<unsigned long long>(n_iterations*multiplier));
+        n_iterations = std::min(n_iterations, max_iterations);
+        elapsed = measure(function, n_iterations);
+    }
+
+    // The fastest measurement is the least disturbed by the rest of the machine.
+    double best_time = elapsed;
+    for (unsigned int irep = 1; irep < n_repetitions; ++irep) {
+        best_time = std::min(best_time, measure(function, n_iterations));
+    }
+
+    add_result(name, n_iterations, best_time, items_per_call);
+}
+
+} // Benchmark namespace
+} // PHiLiP namespace
+
+#endif
@@ -0,0 +1,158 @@
+#include <string>
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/parameter_handler.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/all_parameters.h"
+#include "physics/physics_factory.h"
+#include "linear_solver/linear_solver.h"
+
+#include "benchmark_runner.h"
+
+using PDEType  = PHiLiP::Parameters::AllParameters::PartialDifferentialEquation;
+
+#if PHILIP_DIM==1
+    using Triangulation = dealii::Triangulation<PHILIP_DIM>;
+#else
+    using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+#endif
+
+namespace {
+
+using namespace PHiLiP;
+
+/// Uniform grid of about 32 cells whose boundaries use the manufactured solution.
+std::shared_ptr<Triangulation> create_grid ()
+{
+    const int dim = PHILIP_DIM;
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+#if PHILIP_DIM!=1
+        MPI_COMM_WORLD,
+#endif
+        typename dealii::Triangulation<dim>::MeshSmoothing(
+            dealii::Triangulation<dim>::smoothing_on_refinement |
+            dealii::Triangulation<dim>::smoothing_on_coarsening));
+
+    const unsigned int n_subdivisions = (dim == 1) ? 32 : (dim == 2) ? 6 : 3;
+    dealii::GridGenerator::subdivided_hyper_cube(*grid, n_subdivisions);
+    for (auto &cell : grid->active_cell_iterators()) {
+        for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+            if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+        }
+    }
+    return grid;
+}
+
+/// Benchmarks the assembly of the residual and its derivatives, and the linear solve with the Jacobian.
+/** The times of the assemblies are given per cell. The weak form differentiates with the CoDiPack types,
+ *  RadType for the first derivatives and RadFadType for the second derivatives, while the strong form
+ *  differentiates with the Sacado types and only assembles the Jacobian.
+ */
+template <int dim, int nstate>
+void benchmark_dg (
+    Benchmark::Runner &runner,
+    Parameters::AllParameters parameters,
+    const PDEType pde_type,
+    const std::string &pde_name)
+{
+    parameters.pde_type = pde_type;
+    parameters.linear_solver_param.linear_solver_output = Parameters::OutputEnum::quiet;
+    const auto physics_double = Physics::PhysicsFactory<dim,nstate,double>::create_Physics(&parameters);
+
+    const unsigned int max_poly_degree = (dim == 3) ? 2 : 3;
+    for (const bool use_weak_form : { true, false }) {
+        parameters.use_weak_form = use_weak_form;
+        for (unsigned int poly_degree = 1; poly_degree <= max_poly_degree; ++poly_degree) {
+
+            std::shared_ptr<Triangulation> grid = create_grid();
+            std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&parameters, poly_degree, grid);
+            dg->allocate_system ();
+
+            dealii::LinearAlgebra::distributed::Vector<double> solution_no_ghost;
+            solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+            dealii::VectorTools::interpolate(dg->dof_handler, *(physics_double->manufactured_solution_function), solution_no_ghost);
+            dg->solution = solution_no_ghost;
+            dg->solution.update_ghost_values();
+            for (auto it = dg->dual.begin(); it != dg->dual.end(); ++it) {
+                (*it) = 1.0;
+            }
+            dg->dual.update_ghost_values();
+
+            // The derivatives are not assembled again for an unchanged solution.
+            double perturbation = 1e-7;
+            const auto perturb_solution = [&] () {
+                *(dg->solution.begin()) += perturbation;
+                perturbation = -perturbation;
+                dg->solution.update_ghost_values();
+                dg->solution_modified();
+            };
+
+            const double n_cells = grid->n_global_active_cells();
+            const std::string prefix = std::to_string(dim) + "D/";
+            const std::string suffix = std::string(use_weak_form ? "/weak/" : "/strong/") + pde_name + "/p" + std::to_string(poly_degree);
+
+            runner.run(prefix + "assemble_residual" + suffix, [&] () {
+                dg->assemble_residual(false, false, false);
+            }, n_cells);
+            runner.run(prefix + "assemble_dRdW" + suffix, [&] () {
+                perturb_solution();
+                dg->assemble_residual(true, false, false);
+            }, n_cells);
+            if (use_weak_form) {
+                runner.run(prefix + "assemble_dRdX" + suffix, [&] () {
+                    perturb_solution();
+                    dg->assemble_residual(false, true, false);
+                }, n_cells);
+                runner.run(prefix + "assemble_d2R" + suffix, [&] () {
+                    perturb_solution();
+                    dg->assemble_residual(false, false, true);
+                }, n_cells);
+                runner.run(prefix + "assemble_fused" + suffix, [&] () {
+                    perturb_solution();
+                    dg->assemble_residual(true, true, true);
+                }, n_cells);
+            }
+
+            dg->assemble_residual(true, false, false);
+            dealii::LinearAlgebra::distributed::Vector<double> right_hand_side, newton_update;
+            newton_update.reinit(dg->right_hand_side);
+            runner.run(prefix + "solve_linear" + suffix, [&] () {
+                right_hand_side = dg->right_hand_side;
+                solve_linear(dg->system_matrix, right_hand_side, newton_update, parameters.linear_solver_param);
+            });
+        }
+    }
+}
+
+} // anonymous namespace
+
+/// Times the DG assembly for each polynomial degree, and the linear solve with the resulting Jacobian.
+/** The PDEs cover 1, dim, and dim+2 states. See Benchmark::Runner for the command line options.
+ */
+int main (int argc, char *argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+    Parameters::AllParameters parameters;
+    parameters.parse_parameters (parameter_handler);
+
+    Benchmark::Runner runner(argc, argv, MPI_COMM_WORLD);
+
+    benchmark_dg<dim,1>     (runner, parameters, PDEType::advection, "advection");
+    benchmark_dg<dim,dim>   (runner, parameters, PDEType::burgers_inviscid, "burgers_inviscid");
+    benchmark_dg<dim,dim+2> (runner, parameters, PDEType::euler, "euler");
+
+    const int n_regressions = runner.finish();
+    return (n_regressions == 0) ? 0 : 1;
+}
@@ -0,0 +1,238 @@
+#include <array>
+#include <cmath>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/parameter_handler.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/tensor.h>
+
+#include "ADTypes.hpp"
+#include "parameters/all_parameters.h"
+#include "physics/physics_factory.h"
+#include "numerical_flux/numerical_flux_factory.hpp"
+
+#include "benchmark_runner.h"
+
+using PDEType  = PHiLiP::Parameters::AllParameters::PartialDifferentialEquation;
+using ConvType = PHiLiP::Parameters::AllParameters::ConvectiveNumericalFlux;
+
+namespace {
+
+using namespace PHiLiP;
+
+/// Name of an AD type in the benchmark names.
+template <typename real> std::string ad_type_name ();
+template <> std::string ad_type_name<double> ()     { return "double"; }
+template <> std::string ad_type_name<FadType> ()    { return "FadType"; }
+template <> std::string ad_type_name<FadFadType> () { return "FadFadType"; }
+template <> std::string ad_type_name<RadType> ()    { return "RadType"; }
+template <> std::string ad_type_name<RadFadType> () { return "RadFadType"; }
+
+/// Whether @p real is a CoDiPack reverse type, differentiated through a tape.
+template <typename real>
+constexpr bool is_reverse_ad_type = std::is_same<real,RadType>::value || std::is_same<real,RadFadType>::value;
+
+/// Evaluates @p kernel and the derivatives of its outputs with respect to its inputs.
+/** The inputs take the given @p values. FadType gives the Jacobian and FadFadType the Hessian of the outputs,
+ *  every input being an independent variable. The reverse types record the tape and evaluate the Jacobian
+ *  (RadType) or the Hessian (RadFadType) through codi::TapeHelper, as done by the DG assembly.
+ */
+template <typename real, typename Kernel>
+void evaluate_derivatives (const std::vector<double> &values, std::vector<real> &inputs, std::vector<real> &outputs, const Kernel &kernel)
+{
+    const unsigned int n_inputs = values.size();
+    inputs.resize(n_inputs);
+
+    if constexpr (is_reverse_ad_type<real>) {
+        using TH = codi::TapeHelper<real>;
+        TH th;
+        th.startRecording();
+        for (unsigned int i = 0; i < n_inputs; ++i) {
+            inputs[i] = values[i];
+            th.registerInput(inputs[i]);
+        }
+        kernel(inputs, outputs);
+        for (auto &output : outputs) th.registerOutput(output);
+        th.stopRecording();
+
+        if constexpr (std::is_same<real,RadType>::value) {
+            typename TH::JacobianType& jac = th.createJacobian();
+            th.evalJacobian(jac);
+            Benchmark::do_not_optimize(jac);
+            th.deleteJacobian(jac);
+        } else {
+            typename TH::HessianType& hes = th.createHessian();
+            th.evalHessian(hes);
+            Benchmark::do_not_optimize(hes);
+            th.deleteHessian(hes);
+        }
+        for (auto &input : inputs) real::getGlobalTape().deactivateValue(input);
+    } else {
+        for (unsigned int i = 0; i < n_inputs; ++i) {
+            if constexpr (std::is_same<real,FadType>::value) {
+                inputs[i] = FadType(n_inputs, i, values[i]);
+            } else if constexpr (std::is_same<real,FadFadType>::value) {
+                inputs[i] = FadFadType(n_inputs, i, FadType(n_inputs, i, values[i]));
+            } else {
+                inputs[i] = values[i];
+            }
+        }
+        kernel(inputs, outputs);
+        Benchmark::do_not_optimize(outputs.data());
+    }
+}
+
+/// Copies @p n_values inputs starting at @p start into @p values.
+template <int n_values, typename real>
+void extract (const std::vector<real> &inputs, const unsigned int start, std::array<real,n_values> &values)
+{
+    for (int i = 0; i < n_values; ++i) values[i] = inputs[start+i];
+}
+
+/// Appends @p values to the outputs.
+template <int n_values, typename real>
+void append (const std::array<real,n_values> &values, std::vector<real> &outputs)
+{
+    for (int i = 0; i < n_values; ++i) outputs.push_back(values[i]);
+}
+
+/// Appends the components of @p fluxes to the outputs.
+template <int dim, int nstate, typename real>
+void append (const std::array<dealii::Tensor<1,dim,real>,nstate> &fluxes, std::vector<real> &outputs)
+{
+    for (int s = 0; s < nstate; ++s) {
+        for (int d = 0; d < dim; ++d) outputs.push_back(fluxes[s][d]);
+    }
+}
+
+/// Benchmarks the physical and numerical fluxes of a PDE evaluated with the type @p real.
+/** The states are the manufactured solution on both sides of a face.
+ */
+template <int dim, int nstate, typename real>
+void benchmark_fluxes (
+    Benchmark::Runner &runner,
+    const Parameters::AllParameters &parameters,
+    const std::string &pde_name,
+    const bool has_diffusion)
+{
+    const auto physics_double = Physics::PhysicsFactory<dim,nstate,double>::create_Physics(&parameters);
+    const auto physics = Physics::PhysicsFactory<dim,nstate,real>::create_Physics(&parameters);
+
+    dealii::Point<dim> point_int, point_ext;
+    for (int d = 0; d < dim; ++d) {
+        point_int[d] = 0.3 + 0.1*d;
+        point_ext[d] = point_int[d] + 0.05;
+    }
+    // Solution, followed by the gradient, followed by the exterior solution.
+    std::vector<double> soln_values, soln_grad_values, soln_int_ext_values;
+    for (int s = 0; s < nstate; ++s) {
+        soln_values.push_back(physics_double->manufactured_solution_function->value(point_int, s));
+    }
+    soln_grad_values = soln_values;
+    for (int s = 0; s < nstate; ++s) {
+        const dealii::Tensor<1,dim,double> gradient = physics_double->manufactured_solution_function->gradient(point_int, s);
+        for (int d = 0; d < dim; ++d) soln_grad_values.push_back(gradient[d]);
+    }
+    soln_int_ext_values = soln_values;
+    for (int s = 0; s < nstate; ++s) {
+        soln_int_ext_values.push_back(physics_double->manufactured_solution_function->value(point_ext, s));
+    }
+    dealii::Tensor<1,dim,real> normal;
+    for (int d = 0; d < dim; ++d) normal[d] = 1.0 / std::sqrt(static_cast<double>(dim));
+
+    const std::string prefix = std::to_string(dim) + "D/";
+    const std::string suffix = "/" + pde_name + "/" + ad_type_name<real>();
+    std::vector<real> inputs, outputs;
+
+    runner.run(prefix + "convective_flux" + suffix, [&] () {
+        evaluate_derivatives<real>(soln_values, inputs, outputs, [&] (const std::vector<real> &in, std::vector<real> &out) {
+            std::array<real,nstate> soln;
+            extract<nstate>(in, 0, soln);
+            out.clear();
+            append<dim,nstate>(physics->convective_flux(soln), out);
+        });
+    });
+
+    if (has_diffusion) {
+        runner.run(prefix + "dissipative_flux" + suffix, [&] () {
+            evaluate_derivatives<real>(soln_grad_values, inputs, outputs, [&] (const std::vector<real> &in, std::vector<real> &out) {
+                std::array<real,nstate> soln;
+                std::array<dealii::Tensor<1,dim,real>,nstate> soln_grad;
+                extract<nstate>(in, 0, soln);
+                for (int s = 0; s < nstate; ++s) {
+                    for (int d = 0; d < dim; ++d) soln_grad[s][d] = in[nstate + s*dim + d];
+                }
+                out.clear();
+                append<dim,nstate>(physics->dissipative_flux(soln, soln_grad), out);
+            });
+        });
+    }
+
+    std::vector<std::pair<ConvType, std::string>> numerical_fluxes {
+        { ConvType::lax_friedrichs, "lax_friedrichs" },
+        { ConvType::split_form, "split_form" }
+    };
+    // Roe is only implemented for the Euler equations.
+    if (parameters.pde_type == PDEType::euler) numerical_fluxes.push_back({ ConvType::roe, "roe" });
+
+    for (const auto &numerical_flux_type : numerical_fluxes) {
+        const auto conv_num_flux = NumericalFlux::NumericalFluxFactory<dim,nstate,real>
+            ::create_convective_numerical_flux(numerical_flux_type.first, physics);
+        runner.run(prefix + "numerical_flux/" + numerical_flux_type.second + suffix, [&] () {
+            evaluate_derivatives<real>(soln_int_ext_values, inputs, outputs, [&] (const std::vector<real> &in, std::vector<real> &out) {
+                std::array<real,nstate> soln_int, soln_ext;
+                extract<nstate>(in, 0, soln_int);
+                extract<nstate>(in, nstate, soln_ext);
+                out.clear();
+                append<nstate>(conv_num_flux->evaluate_flux(soln_int, soln_ext, normal), out);
+            });
+        });
+    }
+}
+
+/// Benchmarks the fluxes of a PDE with every AD type.
+template <int dim, int nstate>
+void benchmark_pde (
+    Benchmark::Runner &runner,
+    Parameters::AllParameters parameters,
+    const PDEType pde_type,
+    const std::string &pde_name,
+    const bool has_diffusion)
+{
+    parameters.pde_type = pde_type;
+    benchmark_fluxes<dim,nstate,double>     (runner, parameters, pde_name, has_diffusion);
+    benchmark_fluxes<dim,nstate,FadType>    (runner, parameters, pde_name, has_diffusion);
+    benchmark_fluxes<dim,nstate,FadFadType> (runner, parameters, pde_name, has_diffusion);
+    benchmark_fluxes<dim,nstate,RadType>    (runner, parameters, pde_name, has_diffusion);
+    benchmark_fluxes<dim,nstate,RadFadType> (runner, parameters, pde_name, has_diffusion);
+}
+
+} // anonymous namespace
+
+/// Times the physical and numerical fluxes of the PDEs for every AD type.
+/** The PDEs cover 1, dim, and dim+2 states. See Benchmark::Runner for the command line options.
+ */
+int main (int argc, char *argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+    Parameters::AllParameters parameters;
+    parameters.parse_parameters (parameter_handler);
+
+    Benchmark::Runner runner(argc, argv, MPI_COMM_WORLD);
+
+    benchmark_pde<dim,1>     (runner, parameters, PDEType::convection_diffusion, "convection_diffusion", true);
+    benchmark_pde<dim,dim>   (runner, parameters, PDEType::burgers_inviscid, "burgers_inviscid", false);
+    benchmark_pde<dim,dim+2> (runner, parameters, PDEType::euler, "euler", false);
+
+    const int n_regressions = runner.finish();
+    return (n_regressions == 0) ? 0 : 1;
+}
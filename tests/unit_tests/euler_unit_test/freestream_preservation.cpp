@@ -78,6 +78,7 @@ void perturb_high_order_grid ( std::shared_ptr < DGBase<dim, double> > dg, const
         }
 
     }
+    dg->high_order_grid->volume_nodes_modified();
     dg->high_order_grid->ensure_conforming_mesh();
 }
 
@@ -252,6 +253,7 @@ int test()
                         param.euler_param.side_slip_angle);
             Physics::FreeStreamInitialConditions<dim,dim+2> initial_conditions(euler_physics_double);
             dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, dg->solution);
+            dg->solution_modified();
 
             dg->assemble_residual();
             double residual_norm = dg->get_residual_l2norm();
@@ -135,6 +135,7 @@ int main(int argc, char *argv[])
  pcout << std::endl << "Starting AD... " << std::endl;
  L2_Norm_Functional<dim,nstate,double> l2norm(dg,true,false);
     dg->solution.add(1.0);
+    dg->solution_modified();
  double l2error_mpi_sum2 = std::sqrt(l2norm.evaluate_functional(true,true));
 
  dealii::LinearAlgebra::distributed::Vector<double> dIdw = l2norm.dIdw;
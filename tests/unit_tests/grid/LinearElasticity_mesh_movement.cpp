@@ -223,6 +223,7 @@ int main (int argc, char * argv[])
             // moved them using the locally owned volume displacements.
             high_order_grid.volume_nodes += volume_displacements;
             high_order_grid.volume_nodes.update_ghost_values();
+            high_order_grid.volume_nodes_modified();
 
             high_order_grid.output_results_vtk(high_order_grid.nth_refinement++);
 
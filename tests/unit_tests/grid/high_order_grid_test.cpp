@@ -171,6 +171,7 @@ int main (int argc, char * argv[])
                 *dof += 1.0;
             }
             high_order_grid.volume_nodes.update_ghost_values();
+            high_order_grid.volume_nodes_modified();
             
             // This grid transformation is not necessary, it is simply to prove a point that once we use MappingFEField,
             // the Triangulation's vertices locations become irrelevant. All that matters is the cell to cell connectivity.
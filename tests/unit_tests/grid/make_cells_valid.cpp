@@ -146,6 +146,7 @@ int main (int argc, char * argv[])
                 }
             }
             high_order_grid.volume_nodes.update_ghost_values();
+            high_order_grid.volume_nodes_modified();
             if (has_invalid_poly) std::abort();
         }
     }
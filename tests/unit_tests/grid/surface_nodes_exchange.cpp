@@ -0,0 +1,71 @@
+#include <deal.II/base/conditional_ostream.h>
+
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include "mesh/high_order_grid.h"
+
+/// Checks the distributed surface_nodes against the volume_nodes after a refinement and a repartition.
+/** Every locally relevant surface node, including the ghost ones exchanged with the neighbouring
+ *  processes, must match its volume node. The replica built on request by gather_all_surface_nodes()
+ *  must match the distributed vector.
+ */
+int main (int argc, char * argv[])
+{
+    const int dim = PHILIP_DIM;
+
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    const int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+
+    using namespace PHiLiP;
+
+    int n_errors = 0;
+    for (unsigned int poly_degree = 1; poly_degree <= 3; ++poly_degree) {
+
+        using Triangulation = dealii::parallel::distributed::Triangulation<dim>;
+        std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+            MPI_COMM_WORLD,
+            typename dealii::Triangulation<dim>::MeshSmoothing(
+                dealii::Triangulation<dim>::smoothing_on_refinement |
+                dealii::Triangulation<dim>::smoothing_on_coarsening));
+        dealii::GridGenerator::subdivided_hyper_cube(*grid, 4);
+
+        HighOrderGrid<dim,double> high_order_grid(poly_degree, grid);
+
+        high_order_grid.prepare_for_coarsening_and_refinement();
+        grid->refine_global (1);
+        high_order_grid.execute_coarsening_and_refinement();
+
+        high_order_grid.prepare_for_coarsening_and_refinement();
+        grid->repartition();
+        high_order_grid.execute_coarsening_and_refinement();
+
+        const auto &surface_nodes = high_order_grid.surface_nodes;
+        const auto &surface_to_volume_indices = high_order_grid.surface_to_volume_indices;
+        const auto &volume_nodes = high_order_grid.volume_nodes;
+
+        // Locally owned and ghost surface nodes.
+        dealii::IndexSet locally_relevant_surface_indices = high_order_grid.locally_owned_surface_nodes_indexset;
+        locally_relevant_surface_indices.add_indices(high_order_grid.ghost_surface_nodes_indexset);
+        for (const auto i_surf : locally_relevant_surface_indices) {
+            const unsigned int i_vol = surface_to_volume_indices[i_surf];
+            if (surface_nodes[i_surf] != volume_nodes[i_vol]) ++n_errors;
+        }
+        // Every locally relevant surface node of the volume must be in the surface_nodes vector.
+        if (locally_relevant_surface_indices.n_elements() != high_order_grid.locally_relevant_surface_nodes_indices.size()) ++n_errors;
+
+        high_order_grid.gather_all_surface_nodes();
+        if (high_order_grid.all_surface_nodes.size() != surface_nodes.size()) ++n_errors;
+        for (const auto i_surf : high_order_grid.locally_owned_surface_nodes_indexset) {
+            if (high_order_grid.all_surface_nodes[i_surf] != surface_nodes[i_surf]) ++n_errors;
+            if (high_order_grid.all_surface_indices[i_surf] != (dealii::types::global_dof_index) surface_to_volume_indices[i_surf]) ++n_errors;
+        }
+
+        n_errors = dealii::Utilities::MPI::sum(n_errors, MPI_COMM_WORLD);
+        pcout << "Degree " << poly_degree << " with " << surface_nodes.size() << " surface nodes: " << n_errors << " errors." << std::endl;
+        if (n_errors > 0) return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "linear_solver/cell_block_preconditioner.h"
+
+#include "implicit_system.h"
+
+/// Solves an implicit system (M/dt - dRdW) with GMRES preconditioned by the dense cell blocks and compares with a direct solve.
+/** Every other cell has its polynomial degree increased such that the cell blocks vary in size.
+ */
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    std::shared_ptr<Triangulation> grid,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    const unsigned int max_poly_degree = poly_degree+1;
+    std::shared_ptr < DGBase<PHILIP_DIM, double> > dg = DGFactory<PHILIP_DIM,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, max_poly_degree, grid);
+    dg->allocate_system ();
+
+    grid->prepare_coarsening_and_refinement();
+    for (auto cell = dg->dof_handler.begin_active(); cell != dg->dof_handler.end(); ++cell) {
+        if (cell->is_locally_owned() && cell->active_cell_index() % 2 == 0) cell->set_future_fe_index(max_poly_degree);
+    }
+    grid->execute_coarsening_and_refinement();
+    dg->allocate_system ();
+
+    pcout << "Poly degree " << poly_degree << " ncells " << grid->n_global_active_cells() << " ndofs: " << dg->dof_handler.n_dofs() << std::endl;
+
+    initialize_implicit_system<dim,nstate>(*dg, all_parameters);
+
+    // Each locally owned cell should result in one block.
+    unsigned int n_locally_owned_cells = 0;
+    for (const auto &cell : dg->dof_handler.active_cell_iterators()) {
+        if (cell->is_locally_owned()) ++n_locally_owned_cells;
+    }
+    CellBlockPreconditioner block_jacobi(PreconditionerEnum::block_jacobi);
+    block_jacobi.initialize(dg->system_matrix.trilinos_matrix());
+    if (block_jacobi.n_blocks() != n_locally_owned_cells) {
+        pcout << "Found " << block_jacobi.n_blocks() << " blocks instead of " << n_locally_owned_cells << " cells." << std::endl;
+        return 1;
+    }
+
+    Parameters::LinearSolverParam linear_solver_param = all_parameters.linear_solver_param;
+    const dealii::LinearAlgebra::distributed::Vector<double> direct_solution = direct_solve(*dg, linear_solver_param);
+
+    linear_solver_param.linear_solver_type = Parameters::LinearSolverParam::LinearSolverEnum::gmres;
+    linear_solver_param.linear_residual = 1e-12;
+    linear_solver_param.max_iterations = 2000;
+    for (const auto preconditioner_type : { PreconditionerEnum::block_jacobi, PreconditionerEnum::block_ilu }) {
+        linear_solver_param.preconditioner_type = preconditioner_type;
+        dealii::LinearAlgebra::distributed::Vector<double> gmres_solution(dg->right_hand_side);
+        solve_linear (dg->system_matrix, dg->right_hand_side, gmres_solution, linear_solver_param);
+
+        const double rel_diff = relative_difference(gmres_solution, direct_solution);
+        pcout << "Preconditioner " << preconditioner_type << " relative difference with direct solve: " << rel_diff << std::endl;
+        if (rel_diff > 1e-8) return 1;
+    }
+
+    return 0;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    const unsigned int max_poly_degree = 2;
+    return run_tests<PHILIP_DIM>({ PDEType::diffusion, PDEType::advection, PDEType::euler }, max_poly_degree);
+}
@@ -0,0 +1,145 @@
+#ifndef __IMPLICIT_SYSTEM_H__
+#define __IMPLICIT_SYSTEM_H__
+
+#include <deal.II/base/tensor.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/parameters.h"
+#include "physics/physics_factory.h"
+#include "linear_solver/linear_solver.h"
+
+using PDEType  = PHiLiP::Parameters::AllParameters::PartialDifferentialEquation;
+using PreconditionerEnum = PHiLiP::Parameters::LinearSolverParam::PreconditionerEnum;
+
+#if PHILIP_DIM==1
+    using Triangulation = dealii::Triangulation<PHILIP_DIM>;
+#else
+    using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+#endif
+
+/// Checks of each linear solver unit test, defined by the test and called by run_tests().
+/** Solves the implicit system assembled by initialize_implicit_system() on the @p grid.
+ *  Returns 0 on success.
+ */
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    std::shared_ptr<Triangulation> grid,
+    const PHiLiP::Parameters::AllParameters &all_parameters);
+
+/// Time step of the implicit system.
+const double IMPLICIT_SYSTEM_DT = 0.1;
+
+/// Assembles the implicit system (M/dt - dRdW) dW = R at the interpolated manufactured solution.
+/** The system is stored in the system_matrix and right_hand_side of the allocated @p dg.
+ */
+template<int dim, int nstate>
+void initialize_implicit_system (
+    PHiLiP::DGBase<dim, double> &dg,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    using namespace PHiLiP;
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics_double = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+    dealii::LinearAlgebra::distributed::Vector<double> solution_no_ghost;
+    solution_no_ghost.reinit(dg.locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(dg.dof_handler, *(physics_double->manufactured_solution_function), solution_no_ghost);
+    dg.solution = solution_no_ghost;
+    dg.solution.update_ghost_values();
+    dg.solution_modified();
+
+    const bool do_inverse_mass_matrix = false;
+    dg.evaluate_mass_matrices(do_inverse_mass_matrix);
+    dg.assemble_residual(true);
+    dg.system_matrix *= -1.0;
+    dg.add_mass_matrices(1.0/IMPLICIT_SYSTEM_DT);
+}
+
+/// Reference solution of the implicit system with the direct solver.
+/** Solves the system_matrix of @p dg, or its transpose when @p transpose is true.
+ */
+template<int dim>
+dealii::LinearAlgebra::distributed::Vector<double> direct_solve (
+    PHiLiP::DGBase<dim, double> &dg,
+    const PHiLiP::Parameters::LinearSolverParam &linear_solver_param,
+    const bool transpose = false)
+{
+    using namespace PHiLiP;
+    Parameters::LinearSolverParam direct_param = linear_solver_param;
+    direct_param.linear_solver_type = Parameters::LinearSolverParam::LinearSolverEnum::direct;
+    dealii::LinearAlgebra::distributed::Vector<double> direct_solution(dg.right_hand_side);
+    if (transpose) {
+        solve_linear_transpose (dg.system_matrix, dg.right_hand_side, direct_solution, direct_param);
+    } else {
+        solve_linear (dg.system_matrix, dg.right_hand_side, direct_solution, direct_param);
+    }
+    return direct_solution;
+}
+
+/// Relative l2-norm of the difference between @p solution and @p reference.
+inline double relative_difference (
+    dealii::LinearAlgebra::distributed::Vector<double> solution,
+    const dealii::LinearAlgebra::distributed::Vector<double> &reference)
+{
+    solution -= reference;
+    return solution.l2_norm() / reference.l2_norm();
+}
+
+/// Runs test<dim,nstate> for each of the @p pde_types and polynomial degrees 1 to @p max_poly_degree.
+/** Each test gets a new subdivided hyper-cube whose boundaries use the manufactured solution.
+ */
+template<int dim>
+int run_tests (const std::vector<PDEType> &pde_types, const unsigned int max_poly_degree)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+
+    using namespace PHiLiP;
+    int error = 0;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+
+    for (auto pde = pde_types.begin(); pde != pde_types.end() && error == 0; pde++) {
+        for (unsigned int poly_degree=1; poly_degree<=max_poly_degree && error == 0; ++poly_degree) {
+            pcout << "Using PDEType " << *pde << std::endl;
+            all_parameters.pde_type = *pde;
+            // Generate grids
+#if PHILIP_DIM==1
+            std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+                typename dealii::Triangulation<dim>::MeshSmoothing(
+                    dealii::Triangulation<dim>::smoothing_on_refinement |
+                    dealii::Triangulation<dim>::smoothing_on_coarsening));
+#else
+            std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+                MPI_COMM_WORLD,
+                typename dealii::Triangulation<dim>::MeshSmoothing(
+                    dealii::Triangulation<dim>::smoothing_on_refinement |
+                    dealii::Triangulation<dim>::smoothing_on_coarsening));
+#endif
+            const unsigned int n_subdivisions = 4;
+            dealii::GridGenerator::subdivided_hyper_cube(*grid, n_subdivisions);
+            for (auto &cell : grid->active_cell_iterators()) {
+                for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+                    if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+                }
+            }
+
+            if (*pde==PDEType::euler) {
+                error = test<dim,dim+2>(poly_degree, grid, all_parameters);
+            } else {
+                error = test<dim,1>(poly_degree, grid, all_parameters);
+            }
+        }
+    }
+
+    return error;
+}
+
+#endif
@@ -0,0 +1,78 @@
+#include "implicit_system.h"
+
+/// Solves an implicit system (M/dt - dRdW) repeatedly with the persistent LinearSolver.
+/** Checks that the preconditioner is only updated according to the lag or after being invalidated,
+ *  and that the lagged preconditioner still results in the direct solution.
+ */
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    std::shared_ptr<Triangulation> grid,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    std::shared_ptr < DGBase<PHILIP_DIM, double> > dg = DGFactory<PHILIP_DIM,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+    dg->allocate_system ();
+
+    pcout << "Poly degree " << poly_degree << " ncells " << grid->n_global_active_cells() << " ndofs: " << dg->dof_handler.n_dofs() << std::endl;
+
+    initialize_implicit_system<dim,nstate>(*dg, all_parameters);
+
+    Parameters::LinearSolverParam linear_solver_param = all_parameters.linear_solver_param;
+    const dealii::LinearAlgebra::distributed::Vector<double> direct_solution = direct_solve(*dg, linear_solver_param);
+
+    linear_solver_param.linear_solver_type = Parameters::LinearSolverParam::LinearSolverEnum::gmres;
+    linear_solver_param.linear_residual = 1e-12;
+    linear_solver_param.max_iterations = 2000;
+    linear_solver_param.preconditioner_update_lag = 3;
+    linear_solver_param.preconditioner_stall_ratio = 2.0;
+    for (const auto preconditioner_type : { PreconditionerEnum::ilu, PreconditionerEnum::block_ilu }) {
+        linear_solver_param.preconditioner_type = preconditioner_type;
+        LinearSolver linear_solver(linear_solver_param);
+
+        const unsigned int n_solves = 4;
+        for (unsigned int isolve = 0; isolve < n_solves; ++isolve) {
+            dealii::LinearAlgebra::distributed::Vector<double> gmres_solution(dg->right_hand_side);
+            linear_solver.solve (dg->system_matrix, dg->right_hand_side, gmres_solution);
+
+            const double rel_diff = relative_difference(gmres_solution, direct_solution);
+            pcout << "Preconditioner " << preconditioner_type << " solve " << isolve
+                  << " relative difference with direct solve: " << rel_diff << std::endl;
+            if (rel_diff > 1e-8) return 1;
+
+            // Only the first solve and the one following the lag update the preconditioner.
+            const unsigned int expected_updates = 1 + isolve / linear_solver_param.preconditioner_update_lag;
+            if (linear_solver.n_preconditioner_updates() != expected_updates) {
+                pcout << "Preconditioner updated " << linear_solver.n_preconditioner_updates()
+                      << " times instead of " << expected_updates << std::endl;
+                return 1;
+            }
+        }
+
+        // An invalidated preconditioner is rebuilt from scratch at the next solve, regardless of the lag.
+        const unsigned int n_updates_before_invalidation = linear_solver.n_preconditioner_updates();
+        linear_solver.invalidate_preconditioner();
+        dealii::LinearAlgebra::distributed::Vector<double> gmres_solution(dg->right_hand_side);
+        linear_solver.solve (dg->system_matrix, dg->right_hand_side, gmres_solution);
+        const double rel_diff = relative_difference(gmres_solution, direct_solution);
+        pcout << "Preconditioner " << preconditioner_type
+              << " relative difference with direct solve after invalidation: " << rel_diff << std::endl;
+        if (rel_diff > 1e-8) return 1;
+        if (linear_solver.n_preconditioner_updates() != n_updates_before_invalidation + 1) {
+            pcout << "Invalidated preconditioner was not rebuilt." << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    const unsigned int max_poly_degree = 2;
+    return run_tests<PHILIP_DIM>({ PDEType::diffusion, PDEType::euler }, max_poly_degree);
+}
@@ -0,0 +1,66 @@
+#include "linear_solver/p_multigrid_preconditioner.h"
+
+#include "implicit_system.h"
+
+/// Solves an implicit system (M/dt - dRdW) with GMRES preconditioned by p-multigrid and compares with a direct solve.
+/** Every other cell has its polynomial degree lowered such that the levels contain mixed degrees.
+ */
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    std::shared_ptr<Triangulation> grid,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    std::shared_ptr < DGBase<PHILIP_DIM, double> > dg = DGFactory<PHILIP_DIM,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+    dg->allocate_system ();
+
+    grid->prepare_coarsening_and_refinement();
+    for (auto cell = dg->dof_handler.begin_active(); cell != dg->dof_handler.end(); ++cell) {
+        if (cell->is_locally_owned() && cell->active_cell_index() % 2 == 0) cell->set_future_fe_index(poly_degree-1);
+    }
+    grid->execute_coarsening_and_refinement();
+    dg->allocate_system ();
+
+    pcout << "Poly degree " << poly_degree << " ncells " << grid->n_global_active_cells() << " ndofs: " << dg->dof_handler.n_dofs() << std::endl;
+
+    initialize_implicit_system<dim,nstate>(*dg, all_parameters);
+
+    Parameters::LinearSolverParam linear_solver_param = all_parameters.linear_solver_param;
+    const dealii::LinearAlgebra::distributed::Vector<double> direct_solution = direct_solve(*dg, linear_solver_param);
+
+    linear_solver_param.linear_solver_type = Parameters::LinearSolverParam::LinearSolverEnum::gmres;
+    linear_solver_param.preconditioner_type = Parameters::LinearSolverParam::PreconditionerEnum::p_multigrid;
+    linear_solver_param.linear_residual = 1e-12;
+    linear_solver_param.max_iterations = 2000;
+
+    using CoarseSolverEnum = Parameters::LinearSolverParam::PMultigridCoarseSolverEnum;
+    for (const auto coarse_solver : { CoarseSolverEnum::coarse_direct, CoarseSolverEnum::coarse_amg }) {
+        linear_solver_param.p_multigrid_coarse_solver = coarse_solver;
+        PMultigridPreconditioner<dim,double> p_multigrid(dg, linear_solver_param);
+        p_multigrid.initialize(dg->system_matrix);
+        if (p_multigrid.n_levels() != poly_degree+1) {
+            pcout << "Found " << p_multigrid.n_levels() << " levels instead of " << poly_degree+1 << std::endl;
+            return 1;
+        }
+
+        dealii::LinearAlgebra::distributed::Vector<double> gmres_solution(dg->right_hand_side);
+        solve_linear (dg->system_matrix, dg->right_hand_side, gmres_solution, linear_solver_param, &p_multigrid);
+
+        const double rel_diff = relative_difference(gmres_solution, direct_solution);
+        pcout << "Coarse solver " << coarse_solver << " relative difference with direct solve: " << rel_diff << std::endl;
+        if (rel_diff > 1e-8) return 1;
+    }
+
+    return 0;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    const unsigned int max_poly_degree = 3;
+    return run_tests<PHILIP_DIM>({ PDEType::diffusion, PDEType::advection, PDEType::euler }, max_poly_degree);
+}
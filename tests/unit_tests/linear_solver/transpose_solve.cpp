@@ -0,0 +1,66 @@
+#include <Epetra_RowMatrixTransposer.h>
+
+#include "implicit_system.h"
+
+/// Solves the transposed implicit system (M/dt - dRdW)^T without forming the transpose, and compares
+/// with a direct solve of the explicitly transposed matrix.
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    std::shared_ptr<Triangulation> grid,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    std::shared_ptr < DGBase<PHILIP_DIM, double> > dg = DGFactory<PHILIP_DIM,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+    dg->allocate_system ();
+
+    pcout << "Poly degree " << poly_degree << " ncells " << grid->n_global_active_cells() << " ndofs: " << dg->dof_handler.n_dofs() << std::endl;
+
+    initialize_implicit_system<dim,nstate>(*dg, all_parameters);
+
+    // Reference solution with the explicit transpose.
+    dealii::TrilinosWrappers::SparseMatrix system_matrix_transpose;
+    {
+        Epetra_CrsMatrix *system_matrix_transpose_tril;
+        Epetra_RowMatrixTransposer epmt(const_cast<Epetra_CrsMatrix *>(&dg->system_matrix.trilinos_matrix()));
+        epmt.CreateTranspose(false, system_matrix_transpose_tril);
+        system_matrix_transpose.reinit(*system_matrix_transpose_tril, true);
+        delete system_matrix_transpose_tril;
+    }
+    Parameters::LinearSolverParam linear_solver_param = all_parameters.linear_solver_param;
+    linear_solver_param.linear_solver_type = Parameters::LinearSolverParam::LinearSolverEnum::direct;
+    dealii::LinearAlgebra::distributed::Vector<double> reference_solution(dg->right_hand_side);
+    solve_linear (system_matrix_transpose, dg->right_hand_side, reference_solution, linear_solver_param);
+
+    {
+        const bool transpose = true;
+        const double rel_diff = relative_difference(direct_solve(*dg, linear_solver_param, transpose), reference_solution);
+        pcout << "Direct transposed solve relative difference with the explicit transpose: " << rel_diff << std::endl;
+        if (rel_diff > 1e-8) return 1;
+    }
+
+    linear_solver_param.linear_solver_type = Parameters::LinearSolverParam::LinearSolverEnum::gmres;
+    linear_solver_param.linear_residual = 1e-12;
+    linear_solver_param.max_iterations = 2000;
+    for (const auto preconditioner_type : { PreconditionerEnum::ilu, PreconditionerEnum::block_jacobi, PreconditionerEnum::block_ilu }) {
+        linear_solver_param.preconditioner_type = preconditioner_type;
+        dealii::LinearAlgebra::distributed::Vector<double> gmres_solution(dg->right_hand_side);
+        solve_linear_transpose (dg->system_matrix, dg->right_hand_side, gmres_solution, linear_solver_param);
+
+        const double rel_diff = relative_difference(gmres_solution, reference_solution);
+        pcout << "Preconditioner " << preconditioner_type << " relative difference with the explicit transpose: " << rel_diff << std::endl;
+        if (rel_diff > 1e-8) return 1;
+    }
+
+    return 0;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    const unsigned int max_poly_degree = 2;
+    return run_tests<PHILIP_DIM>({ PDEType::advection, PDEType::euler }, max_poly_degree);
+}
@@ -0,0 +1,245 @@
+#include <fstream>
+#include <iomanip>
+
+#include <deal.II/base/tensor.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/parameters.h"
+#include "physics/physics_factory.h"
+#include "ode_solver/ode_solver.h"
+
+using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+
+/// Implicit ODE solver whose CFL factor can be set and checked by the test.
+template <int dim>
+class CheckpointedODESolver : public PHiLiP::ODE::Implicit_ODESolver<dim, double>
+{
+public:
+    using PHiLiP::ODE::Implicit_ODESolver<dim, double>::Implicit_ODESolver;
+    using PHiLiP::ODE::ODESolver<dim, double>::CFL_factor;
+};
+
+/// Coarse grid shared by the written and loaded checkpoints.
+std::shared_ptr<Triangulation> create_coarse_grid ()
+{
+    const int dim = PHILIP_DIM;
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+        MPI_COMM_WORLD,
+        typename dealii::Triangulation<dim>::MeshSmoothing(
+            dealii::Triangulation<dim>::smoothing_on_refinement |
+            dealii::Triangulation<dim>::smoothing_on_coarsening));
+    const unsigned int n_subdivisions = 2;
+    dealii::GridGenerator::subdivided_hyper_cube(*grid, n_subdivisions);
+    for (auto &cell : grid->active_cell_iterators()) {
+        for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+            if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+        }
+    }
+    return grid;
+}
+
+/// Quantities of a checkpoint that do not depend on the number of processes.
+struct CheckpointSummary
+{
+    dealii::types::global_cell_index n_active_cells; ///< Number of active cells.
+    double solution_l2_norm; ///< l2-norm of the solution.
+    double solution_linfty_norm; ///< linfty-norm of the solution.
+    double volume_nodes_l2_norm; ///< l2-norm of the high-order grid nodes.
+    double volume_nodes_linfty_norm; ///< linfty-norm of the high-order grid nodes.
+    unsigned int current_iteration; ///< Iteration of the ODE solver.
+    double current_time; ///< Time of the ODE solver.
+    double CFL_factor; ///< CFL factor of the ODE solver.
+};
+
+/// Summary of the DG and ODE states of @p ode_solver.
+template <int dim>
+CheckpointSummary summarize (const CheckpointedODESolver<dim> &ode_solver)
+{
+    const auto &dg = *(ode_solver.dg);
+    CheckpointSummary summary;
+    summary.n_active_cells = dg.triangulation->n_global_active_cells();
+    summary.solution_l2_norm = dg.solution.l2_norm();
+    summary.solution_linfty_norm = dg.solution.linfty_norm();
+    summary.volume_nodes_l2_norm = dg.high_order_grid->volume_nodes.l2_norm();
+    summary.volume_nodes_linfty_norm = dg.high_order_grid->volume_nodes.linfty_norm();
+    summary.current_iteration = ode_solver.current_iteration;
+    summary.current_time = ode_solver.current_time;
+    summary.CFL_factor = ode_solver.CFL_factor;
+    return summary;
+}
+
+/// Returns the number of differences between the two summaries.
+/** The norms are summed in a different order when the number of processes differs.
+ */
+int compare (const CheckpointSummary &loaded, const CheckpointSummary &written)
+{
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+    const double tol = 1e-12;
+    const auto differ = [tol](const double a, const double b) { return std::abs(a - b) > tol * std::max(1.0, std::abs(b)); };
+
+    int n_errors = 0;
+    if (loaded.n_active_cells != written.n_active_cells) { ++n_errors; pcout << "Different number of active cells." << std::endl; }
+    if (differ(loaded.solution_l2_norm, written.solution_l2_norm)) { ++n_errors; pcout << "Different solution l2-norm." << std::endl; }
+    if (differ(loaded.solution_linfty_norm, written.solution_linfty_norm)) { ++n_errors; pcout << "Different solution linfty-norm." << std::endl; }
+    if (differ(loaded.volume_nodes_l2_norm, written.volume_nodes_l2_norm)) { ++n_errors; pcout << "Different volume_nodes l2-norm." << std::endl; }
+    if (differ(loaded.volume_nodes_linfty_norm, written.volume_nodes_linfty_norm)) { ++n_errors; pcout << "Different volume_nodes linfty-norm." << std::endl; }
+    if (loaded.current_iteration != written.current_iteration) { ++n_errors; pcout << "Different current_iteration." << std::endl; }
+    if (loaded.current_time != written.current_time) { ++n_errors; pcout << "Different current_time." << std::endl; }
+    if (loaded.CFL_factor != written.CFL_factor) { ++n_errors; pcout << "Different CFL_factor." << std::endl; }
+    return n_errors;
+}
+
+/// Creates a DG on the coarse grid and an ODE solver, ready to read a checkpoint.
+template <int dim>
+std::shared_ptr<CheckpointedODESolver<dim>> create_ode_solver (
+    const unsigned int poly_degree,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    using namespace PHiLiP;
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, create_coarse_grid());
+    dg->allocate_system ();
+    return std::make_shared<CheckpointedODESolver<dim>>(dg);
+}
+
+/// Writes a checkpoint of a locally refined and curved grid, then reads it back with the same processes.
+/** Also writes the summary of the checkpoint for the test reading it with a different number of processes.
+ */
+template <int dim, int nstate>
+int test_write (
+    const unsigned int poly_degree,
+    const std::string &checkpoint_name,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    std::shared_ptr<Triangulation> grid = create_coarse_grid();
+    grid->refine_global (1);
+    for (const auto &cell : grid->active_cell_iterators()) {
+        if (cell->is_locally_owned() && cell->center()[0] < 0.5) cell->set_refine_flag();
+    }
+    grid->execute_coarsening_and_refinement();
+
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+    dg->allocate_system ();
+
+    // Curve the grid such that the high-order nodes are not recovered by the coarse grid.
+    auto &volume_nodes = dg->high_order_grid->volume_nodes;
+    for (const auto i : dg->high_order_grid->locally_owned_dofs_grid) {
+        volume_nodes[i] += 1e-2 * std::sin(3.0 * volume_nodes[i]);
+    }
+    volume_nodes.update_ghost_values();
+    dg->high_order_grid->volume_nodes_modified();
+
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics_double = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+    dealii::LinearAlgebra::distributed::Vector<double> solution_no_ghost;
+    solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(*(dg->high_order_grid->mapping_fe_field), dg->dof_handler, *(physics_double->manufactured_solution_function), solution_no_ghost);
+    dg->solution = solution_no_ghost;
+    dg->solution.update_ghost_values();
+    dg->solution_modified();
+
+    CheckpointedODESolver<dim> ode_solver(dg);
+    ode_solver.current_iteration = 7;
+    ode_solver.current_time = 0.25;
+    ode_solver.CFL_factor = 0.375;
+    ode_solver.write_checkpoint(checkpoint_name);
+    const CheckpointSummary written = summarize(ode_solver);
+
+    if (mpi_rank == 0) {
+        std::ofstream summary_file(checkpoint_name + ".summary");
+        summary_file << std::setprecision(17)
+                     << written.n_active_cells << " "
+                     << written.solution_l2_norm << " "
+                     << written.solution_linfty_norm << " "
+                     << written.volume_nodes_l2_norm << " "
+                     << written.volume_nodes_linfty_norm << " "
+                     << written.current_iteration << " "
+                     << written.current_time << " "
+                     << written.CFL_factor << std::endl;
+    }
+
+    // With the same processes, the partition and therefore the numbering are recovered.
+    std::shared_ptr<CheckpointedODESolver<dim>> loaded_ode_solver = create_ode_solver<dim>(poly_degree, all_parameters);
+    loaded_ode_solver->read_checkpoint(checkpoint_name);
+    int n_errors = compare(summarize(*loaded_ode_solver), written);
+
+    dealii::LinearAlgebra::distributed::Vector<double> solution_diff(loaded_ode_solver->dg->solution);
+    solution_diff -= dg->solution;
+    dealii::LinearAlgebra::distributed::Vector<double> volume_nodes_diff(loaded_ode_solver->dg->high_order_grid->volume_nodes);
+    volume_nodes_diff -= volume_nodes;
+    pcout << "Loaded solution difference: " << solution_diff.linfty_norm()
+          << " Loaded volume_nodes difference: " << volume_nodes_diff.linfty_norm() << std::endl;
+    if (solution_diff.linfty_norm() != 0.0) ++n_errors;
+    if (volume_nodes_diff.linfty_norm() != 0.0) ++n_errors;
+
+    return n_errors;
+}
+
+/// Reads the checkpoint written by test_write(), possibly with a different number of processes.
+template <int dim>
+int test_read (
+    const unsigned int poly_degree,
+    const std::string &checkpoint_name,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    std::ifstream summary_file(checkpoint_name + ".summary");
+    if (!summary_file.good()) {
+        std::cout << "Could not open " << checkpoint_name << ".summary, the write test must run first." << std::endl;
+        return 1;
+    }
+    CheckpointSummary written;
+    summary_file >> written.n_active_cells
+                 >> written.solution_l2_norm
+                 >> written.solution_linfty_norm
+                 >> written.volume_nodes_l2_norm
+                 >> written.volume_nodes_linfty_norm
+                 >> written.current_iteration
+                 >> written.current_time
+                 >> written.CFL_factor;
+    if (summary_file.fail()) return 1;
+
+    std::shared_ptr<CheckpointedODESolver<dim>> loaded_ode_solver = create_ode_solver<dim>(poly_degree, all_parameters);
+    loaded_ode_solver->read_checkpoint(checkpoint_name);
+    return compare(summarize(*loaded_ode_solver), written);
+}
+
+/// Writes a checkpoint with "write", or reads it back with "read".
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+
+    if (argc != 2 || (std::string(argv[1]) != "write" && std::string(argv[1]) != "read")) {
+        pcout << "Usage: " << argv[0] << " write|read" << std::endl;
+        return 1;
+    }
+    const bool write = (std::string(argv[1]) == "write");
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+    all_parameters.pde_type = Parameters::AllParameters::PartialDifferentialEquation::advection;
+
+    const unsigned int poly_degree = 2;
+    const std::string checkpoint_name = "checkpoint_restart_" + std::to_string(dim) + "D";
+    const unsigned int n_mpi = dealii::Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+    pcout << (write ? "Writing " : "Reading ") << checkpoint_name << " with " << n_mpi << " processes." << std::endl;
+
+    const int n_errors = write ? test_write<dim,1>(poly_degree, checkpoint_name, all_parameters)
+                               : test_read<dim>(poly_degree, checkpoint_name, all_parameters);
+    pcout << n_errors << " errors." << std::endl;
+
+    return (n_errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+#include <deal.II/base/function.h>
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/parameters.h"
+
+using PDEType  = PHiLiP::Parameters::AllParameters::PartialDifferentialEquation;
+
+#if PHILIP_DIM==1
+    using Triangulation = dealii::Triangulation<PHILIP_DIM>;
+#else
+    using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+#endif
+
+/// Location of the step, inside the cells of the second half of the domain.
+const double STEP_LOCATION = 0.6;
+
+/// Field used by the sensor, identical for all the states.
+/** The step is 1 for x < STEP_LOCATION and 2 otherwise.
+ *  The smooth field is linear and is therefore exactly represented by the p-1 basis when p >= 2.
+ */
+template <int dim>
+class SensorTestField : public dealii::Function<dim>
+{
+public:
+    /// Constructor.
+    SensorTestField (const unsigned int nstate, const bool is_step)
+    : dealii::Function<dim>(nstate)
+    , is_step(is_step)
+    { }
+
+    /// Value of the field, identical for all the states.
+    double value (const dealii::Point<dim> &point, const unsigned int /*istate*/ = 0) const override
+    {
+        if (is_step) return (point[0] < STEP_LOCATION) ? 1.0 : 2.0;
+        double value = 1.5;
+        for (int d=0; d<dim; ++d) {
+            value += 0.25 * point[d];
+        }
+        return value;
+    }
+private:
+    /// Whether the field is the step or the smooth field.
+    const bool is_step;
+};
+
+/** This test checks the discontinuity sensor on known fields.
+ *  A smooth field exactly represented by the p-1 basis must not add any artificial dissipation,
+ *  while a step must only add it to the cells that contain the discontinuity.
+ */
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+#if PHILIP_DIM==1
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>();
+#else
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(MPI_COMM_WORLD);
+#endif
+    // The cell faces are at multiples of 0.25 such that the step lies inside cells.
+    dealii::GridGenerator::subdivided_hyper_cube(*grid, 4);
+
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+    dg->allocate_system ();
+
+    pcout << "Poly degree " << poly_degree << " nstate " << nstate << std::endl;
+
+    int n_wrong_cells = 0;
+    for (const bool is_step : {false, true}) {
+        const SensorTestField<dim> field(nstate, is_step);
+        dealii::LinearAlgebra::distributed::Vector<double> solution_no_ghost;
+        solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+        dealii::VectorTools::interpolate(dg->dof_handler, field, solution_no_ghost);
+        dg->solution = solution_no_ghost;
+        dg->solution.update_ghost_values();
+        dg->solution_modified();
+
+        dg->update_artificial_dissipation_discontinuity_sensor();
+
+        int n_dissipative_cells = 0;
+        for (const auto &cell : dg->dof_handler.active_cell_iterators()) {
+            if (!cell->is_locally_owned()) continue;
+
+            double x_min = cell->vertex(0)[0];
+            double x_max = cell->vertex(0)[0];
+            for (unsigned int v=0; v<dealii::GeometryInfo<dim>::vertices_per_cell; ++v) {
+                x_min = std::min(x_min, cell->vertex(v)[0]);
+                x_max = std::max(x_max, cell->vertex(v)[0]);
+            }
+            const bool contains_step = is_step && x_min < STEP_LOCATION && STEP_LOCATION < x_max;
+
+            const double coeff = dg->artificial_dissipation_coeffs[cell->active_cell_index()];
+            if (coeff > 0.0) ++n_dissipative_cells;
+            if ((coeff > 0.0) != contains_step) {
+                std::cout << "Cell with x in [" << x_min << ", " << x_max << "] has an artificial dissipation of " << coeff
+                          << (contains_step ? " but contains the step." : " but does not contain any discontinuity.") << std::endl;
+                ++n_wrong_cells;
+            }
+        }
+        n_dissipative_cells = dealii::Utilities::MPI::sum(n_dissipative_cells, MPI_COMM_WORLD);
+        pcout << (is_step ? "Step" : "Smooth") << " field: " << n_dissipative_cells << " cells with artificial dissipation." << std::endl;
+    }
+    n_wrong_cells = dealii::Utilities::MPI::sum(n_wrong_cells, MPI_COMM_WORLD);
+
+    return (n_wrong_cells == 0) ? 0 : 1;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    int error = 0;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+
+    std::vector<PDEType> pde_type {
+        PDEType::advection,
+        PDEType::euler
+    };
+    std::vector<std::string> pde_name {
+        " PDEType::advection "
+        , " PDEType::euler "
+    };
+
+    int ipde = -1;
+    for (auto pde = pde_type.begin(); pde != pde_type.end() && error == 0; pde++) {
+        ipde++;
+        // The smooth field is only exactly represented by the p-1 basis from p = 2.
+        for (unsigned int poly_degree=2; poly_degree<4 && error == 0; ++poly_degree) {
+            pcout << "Using " << pde_name[ipde] << std::endl;
+            all_parameters.pde_type = *pde;
+
+            if (*pde==PDEType::euler) {
+                error = test<dim,dim+2>(poly_degree, all_parameters);
+            } else {
+                error = test<dim,1>(poly_degree, all_parameters);
+            }
+        }
+    }
+
+    return error;
+}
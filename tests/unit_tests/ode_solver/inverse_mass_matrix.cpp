@@ -0,0 +1,124 @@
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/parameters.h"
+
+using PDEType  = PHiLiP::Parameters::AllParameters::PartialDifferentialEquation;
+
+#if PHILIP_DIM==1
+    using Triangulation = dealii::Triangulation<PHILIP_DIM>;
+#else
+    using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+#endif
+
+const double TOLERANCE = 1E-12;
+
+/** This test checks that the inverse mass matrix applied one cell block at a time by
+ *  apply_inverse_mass_matrix() is the inverse of the assembled global_mass_matrix,
+ *  and that it matches the assembled global_inverse_mass_matrix, on a distorted grid.
+ */
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+#if PHILIP_DIM==1
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>();
+#else
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(MPI_COMM_WORLD);
+#endif
+    dealii::GridGenerator::subdivided_hyper_cube(*grid, 3);
+    const double random_factor = 0.2;
+    const bool keep_boundary = false;
+    dealii::GridTools::distort_random (random_factor, *grid, keep_boundary);
+
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+    dg->allocate_system ();
+
+    dg->evaluate_mass_matrices(false);
+    dg->evaluate_mass_matrices(true);
+
+    pcout << "Poly degree " << poly_degree << " nstate " << nstate << " n_dofs " << dg->dof_handler.n_dofs() << std::endl;
+
+    dealii::LinearAlgebra::distributed::Vector<double> src;
+    src.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    for (const auto i : dg->locally_owned_dofs) {
+        src[i] = 1.0 + std::sin(0.1 * i) + 0.5 * std::cos(0.7 * i);
+    }
+
+    dealii::LinearAlgebra::distributed::Vector<double> block_inverse_src;
+    block_inverse_src.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dg->apply_inverse_mass_matrix(src, block_inverse_src);
+
+    // M (M^{-1} src) = src
+    dealii::LinearAlgebra::distributed::Vector<double> mass_block_inverse_src;
+    mass_block_inverse_src.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dg->global_mass_matrix.vmult(mass_block_inverse_src, block_inverse_src);
+    mass_block_inverse_src -= src;
+    const double mass_rel_diff = mass_block_inverse_src.l2_norm() / src.l2_norm();
+
+    // Cell blocks vs the assembled global_inverse_mass_matrix.
+    dealii::LinearAlgebra::distributed::Vector<double> global_inverse_src;
+    global_inverse_src.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dg->global_inverse_mass_matrix.vmult(global_inverse_src, src);
+    const double global_inverse_norm = global_inverse_src.l2_norm();
+    global_inverse_src -= block_inverse_src;
+    const double inverse_rel_diff = global_inverse_src.l2_norm() / global_inverse_norm;
+
+    pcout << "|| M M_block^{-1} v - v || / || v || = " << mass_rel_diff << std::endl;
+    pcout << "|| M^{-1} v - M_block^{-1} v || / || M^{-1} v || = " << inverse_rel_diff << std::endl;
+    if (mass_rel_diff > TOLERANCE || inverse_rel_diff > TOLERANCE) return 1;
+
+    return 0;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    int error = 0;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+
+    std::vector<PDEType> pde_type {
+        PDEType::advection,
+        PDEType::euler
+    };
+    std::vector<std::string> pde_name {
+        " PDEType::advection "
+        , " PDEType::euler "
+    };
+
+    int ipde = -1;
+    for (auto pde = pde_type.begin(); pde != pde_type.end() && error == 0; pde++) {
+        ipde++;
+        for (unsigned int poly_degree=1; poly_degree<4 && error == 0; ++poly_degree) {
+            pcout << "Using " << pde_name[ipde] << std::endl;
+            all_parameters.pde_type = *pde;
+
+            if (*pde==PDEType::euler) {
+                error = test<dim,dim+2>(poly_degree, all_parameters);
+            } else {
+                error = test<dim,1>(poly_degree, all_parameters);
+            }
+        }
+    }
+
+    return error;
+}
@@ -0,0 +1,227 @@
+#include <deal.II/base/tensor.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/parameters.h"
+#include "physics/physics_factory.h"
+#include "ode_solver/ode_solver.h"
+
+using PDEType  = PHiLiP::Parameters::AllParameters::PartialDifferentialEquation;
+using PreconditionerEnum = PHiLiP::Parameters::LinearSolverParam::PreconditionerEnum;
+
+#if PHILIP_DIM==1
+    using Triangulation = dealii::Triangulation<PHILIP_DIM>;
+#else
+    using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+#endif
+
+/// Uniform grid whose boundaries use the manufactured solution.
+std::shared_ptr<Triangulation> create_grid ()
+{
+    const int dim = PHILIP_DIM;
+#if PHILIP_DIM==1
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>();
+#else
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(MPI_COMM_WORLD);
+#endif
+    const unsigned int n_subdivisions = 4;
+    dealii::GridGenerator::subdivided_hyper_cube(*grid, n_subdivisions);
+    for (auto &cell : grid->active_cell_iterators()) {
+        for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+            if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+        }
+    }
+    return grid;
+}
+
+/// Creates and allocates the DG with the interpolated manufactured solution.
+template<int dim, int nstate>
+std::shared_ptr < PHiLiP::DGBase<dim, double> > create_dg (
+    const unsigned int poly_degree,
+    std::shared_ptr<Triangulation> grid,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    using namespace PHiLiP;
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+    dg->allocate_system ();
+
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics_double = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+    dealii::LinearAlgebra::distributed::Vector<double> solution_no_ghost;
+    solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(dg->dof_handler, *(physics_double->manufactured_solution_function), solution_no_ghost);
+    dg->solution = solution_no_ghost;
+    dg->solution.update_ghost_values();
+    dg->solution_modified();
+    return dg;
+}
+
+/// Compares the Jacobian-free products with the assembled (M/dt - dRdW), and the cell blocks
+/// assembled by the cell-block Jacobian with the ones of the full Jacobian.
+template<int dim, int nstate>
+int test_jacobian_free_operator (
+    const unsigned int poly_degree,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    std::shared_ptr<Triangulation> grid = create_grid();
+    std::shared_ptr < DGBase<dim, double> > dg = create_dg<dim,nstate>(poly_degree, grid, all_parameters);
+
+    const bool do_inverse_mass_matrix = false;
+    dg->evaluate_mass_matrices(do_inverse_mass_matrix);
+    dg->assemble_residual(true);
+    dg->system_matrix *= -1.0;
+    const double dt = 0.1;
+    dg->add_mass_matrices(1.0/dt);
+
+    dealii::LinearAlgebra::distributed::Vector<double> direction(dg->right_hand_side);
+    for (const auto row : dg->locally_owned_dofs) {
+        direction[row] = std::sin(0.37*row) + 0.5;
+    }
+    dealii::LinearAlgebra::distributed::Vector<double> assembled_product(direction), jacobian_free_product(direction);
+    dg->system_matrix.vmult(assembled_product, direction);
+
+    const unsigned int solution_version = dg->get_solution_version();
+    const double perturbation = 1e-7;
+    const ODE::JacobianFreeOperator<dim,double> jacobian_free_operator(dg, dg->global_mass_matrix, 1.0/dt, perturbation);
+    jacobian_free_operator.vmult(jacobian_free_product, direction);
+
+    jacobian_free_product -= assembled_product;
+    const double rel_diff = jacobian_free_product.l2_norm() / assembled_product.l2_norm();
+    pcout << "Jacobian-free product relative difference with the assembled product: " << rel_diff << std::endl;
+    if (rel_diff > 1e-5) return 1;
+
+    // The products must not invalidate the quantities evaluated at the unperturbed solution.
+    if (dg->get_solution_version() != solution_version) {
+        pcout << "Jacobian-free product changed the solution version." << std::endl;
+        return 1;
+    }
+
+    // The cell-block Jacobian must have the same cell blocks as the full one.
+    dg->assemble_residual(true);
+    dealii::TrilinosWrappers::SparseMatrix full_dRdW;
+    full_dRdW.copy_from(dg->system_matrix);
+    dg->set_cell_block_jacobian(true);
+    dg->assemble_residual(true);
+    if (dg->system_matrix.n_nonzero_elements() >= full_dRdW.n_nonzero_elements()) {
+        pcout << "Cell-block Jacobian has as many non-zeros as the full Jacobian." << std::endl;
+        return 1;
+    }
+    double max_block_diff = 0.0;
+    for (const auto row : dg->locally_owned_dofs) {
+        for (auto entry = dg->system_matrix.begin(row); entry != dg->system_matrix.end(row); ++entry) {
+            max_block_diff = std::max(max_block_diff, std::abs(entry->value() - full_dRdW.el(row, entry->column())));
+        }
+    }
+    max_block_diff = dealii::Utilities::MPI::max(max_block_diff, MPI_COMM_WORLD);
+    pcout << "Maximum difference between the cell blocks of the cell-block and full Jacobians: " << max_block_diff << std::endl;
+    if (max_block_diff > 1e-12 * full_dRdW.linfty_norm()) return 1;
+
+    return 0;
+}
+
+/// Solves the steady state with the assembled Jacobian and with the Jacobian-free operator.
+template<int dim, int nstate>
+int test_steady_state (
+    const unsigned int poly_degree,
+    PHiLiP::Parameters::AllParameters all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    all_parameters.ode_solver_param.ode_solver_type = Parameters::ODESolverParam::ODESolverEnum::implicit_solver;
+    all_parameters.ode_solver_param.nonlinear_steady_residual_tolerance = 1e-12;
+    all_parameters.ode_solver_param.nonlinear_max_iterations = 200;
+    all_parameters.ode_solver_param.initial_time_step = 10.0;
+    all_parameters.ode_solver_param.ode_output = Parameters::OutputEnum::quiet;
+    all_parameters.linear_solver_param.linear_solver_type = Parameters::LinearSolverParam::LinearSolverEnum::gmres;
+    all_parameters.linear_solver_param.linear_residual = 1e-10;
+    all_parameters.linear_solver_param.max_iterations = 2000;
+    all_parameters.linear_solver_param.preconditioner_update_lag = 3;
+
+    dealii::LinearAlgebra::distributed::Vector<double> assembled_solution;
+    {
+        all_parameters.ode_solver_param.use_jacobian_free_newton_krylov = false;
+        std::shared_ptr < DGBase<dim, double> > dg = create_dg<dim,nstate>(poly_degree, create_grid(), all_parameters);
+        std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
+        if (ode_solver->steady_state() != 0) {
+            pcout << "Steady state with the assembled Jacobian did not converge." << std::endl;
+            return 1;
+        }
+        assembled_solution = dg->solution;
+    }
+
+    all_parameters.ode_solver_param.use_jacobian_free_newton_krylov = true;
+    for (const auto preconditioner_type : { PreconditionerEnum::ilu, PreconditionerEnum::block_jacobi }) {
+        all_parameters.linear_solver_param.preconditioner_type = preconditioner_type;
+        std::shared_ptr < DGBase<dim, double> > dg = create_dg<dim,nstate>(poly_degree, create_grid(), all_parameters);
+        std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
+        if (ode_solver->steady_state() != 0) {
+            pcout << "Jacobian-free steady state with preconditioner " << preconditioner_type << " did not converge." << std::endl;
+            return 1;
+        }
+        if (dg->is_cell_block_jacobian()) {
+            pcout << "The full Jacobian was not restored after the steady state." << std::endl;
+            return 1;
+        }
+
+        dealii::LinearAlgebra::distributed::Vector<double> solution_diff(dg->solution);
+        solution_diff -= assembled_solution;
+        const double rel_diff = solution_diff.l2_norm() / assembled_solution.l2_norm();
+        pcout << "Jacobian-free steady state with preconditioner " << preconditioner_type
+              << " relative difference with the assembled Jacobian one: " << rel_diff << std::endl;
+        if (rel_diff > 1e-8) return 1;
+    }
+
+    return 0;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    int error = 0;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+    std::vector<PDEType> pde_type {
+        PDEType::advection,
+        PDEType::euler
+    };
+    std::vector<std::string> pde_name {
+        " PDEType::advection "
+        , " PDEType::euler "
+    };
+
+    int ipde = -1;
+    for (auto pde = pde_type.begin(); pde != pde_type.end() && error == 0; pde++) {
+        ipde++;
+        for (unsigned int poly_degree=1; poly_degree<3 && error == 0; ++poly_degree) {
+            pcout << "Using " << pde_name[ipde] << " with poly degree " << poly_degree << std::endl;
+            all_parameters.pde_type = *pde;
+
+            if (*pde==PDEType::euler) {
+                error = test_jacobian_free_operator<dim,dim+2>(poly_degree, all_parameters);
+                if (error == 0) error = test_steady_state<dim,dim+2>(poly_degree, all_parameters);
+            } else {
+                error = test_jacobian_free_operator<dim,1>(poly_degree, all_parameters);
+                if (error == 0) error = test_steady_state<dim,1>(poly_degree, all_parameters);
+            }
+        }
+    }
+
+    return error;
+}
@@ -0,0 +1,225 @@
+#include <deal.II/base/tensor.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/parameters.h"
+#include "physics/physics_factory.h"
+#include "ode_solver/ode_solver.h"
+
+using CFLControllerEnum = PHiLiP::Parameters::ODESolverParam::CFLControllerEnum;
+
+#if PHILIP_DIM==1
+    using Triangulation = dealii::Triangulation<PHILIP_DIM>;
+#else
+    using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+#endif
+
+/// Grid refined towards the origin, such that the local time steps of neighbouring cells differ.
+std::shared_ptr<Triangulation> create_graded_grid ()
+{
+    const int dim = PHILIP_DIM;
+#if PHILIP_DIM==1
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+        typename dealii::Triangulation<dim>::MeshSmoothing(
+            dealii::Triangulation<dim>::smoothing_on_refinement |
+            dealii::Triangulation<dim>::smoothing_on_coarsening));
+#else
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+        MPI_COMM_WORLD,
+        typename dealii::Triangulation<dim>::MeshSmoothing(
+            dealii::Triangulation<dim>::smoothing_on_refinement |
+            dealii::Triangulation<dim>::smoothing_on_coarsening));
+#endif
+    const unsigned int n_subdivisions = 4;
+    dealii::GridGenerator::subdivided_hyper_cube(*grid, n_subdivisions);
+    for (auto &cell : grid->active_cell_iterators()) {
+        for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+            if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+        }
+    }
+    const dealii::Point<dim> origin;
+    for (unsigned int i_refine = 0; i_refine < 3; ++i_refine) {
+        for (const auto &cell : grid->active_cell_iterators()) {
+            if (cell->is_locally_owned() && cell->center().distance(origin) < 0.5) cell->set_refine_flag();
+        }
+        grid->execute_coarsening_and_refinement();
+    }
+    return grid;
+}
+
+/// Creates and allocates the DG with the interpolated manufactured solution.
+template<int dim, int nstate>
+std::shared_ptr < PHiLiP::DGBase<dim, double> > create_dg (
+    const unsigned int poly_degree,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    using namespace PHiLiP;
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, create_graded_grid());
+    dg->allocate_system ();
+
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics_double = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+    dealii::LinearAlgebra::distributed::Vector<double> solution_no_ghost;
+    solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(dg->dof_handler, *(physics_double->manufactured_solution_function), solution_no_ghost);
+    dg->solution = solution_no_ghost;
+    dg->solution.update_ghost_values();
+    dg->solution_modified();
+    return dg;
+}
+
+/// Checks that the ratios of the local time steps of neighbouring cells are bounded after assemble_residual(),
+/// including the ghost neighbours, and that the limited time steps are never larger than the unlimited ones.
+template<int dim, int nstate>
+int test_neighbor_ratio (
+    const unsigned int poly_degree,
+    PHiLiP::Parameters::AllParameters all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    all_parameters.ode_solver_param.local_time_step_max_neighbor_ratio = 0.0;
+    std::shared_ptr < DGBase<dim, double> > unlimited_dg = create_dg<dim,nstate>(poly_degree, all_parameters);
+    unlimited_dg->assemble_residual();
+
+    const double max_ratio = 1.5;
+    all_parameters.ode_solver_param.local_time_step_max_neighbor_ratio = max_ratio;
+    // Enough sweeps for the limiting to converge on the whole locally owned grid.
+    all_parameters.ode_solver_param.local_time_step_smoothing_sweeps = 1000;
+    std::shared_ptr < DGBase<dim, double> > dg = create_dg<dim,nstate>(poly_degree, all_parameters);
+    dg->assemble_residual();
+
+    int n_errors = 0;
+    int n_limited = 0;
+    std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator> active_neighbors;
+    for (const auto &cell : dg->dof_handler.active_cell_iterators()) {
+        if (!cell->is_locally_owned()) continue;
+
+        const double dt = dg->max_dt_cell[cell->active_cell_index()];
+        const double unlimited_dt = unlimited_dg->max_dt_cell[cell->active_cell_index()];
+        if (dt > unlimited_dt) ++n_errors;
+        if (dt < unlimited_dt) ++n_limited;
+
+        dealii::GridTools::get_active_neighbors<dealii::DoFHandler<dim>>(cell, active_neighbors);
+        // The ghost time steps are exchanged by the limiting, such that the ratio also holds across processors.
+        for (const auto &neighbor : active_neighbors) {
+            const double neighbor_dt = dg->max_dt_cell[neighbor->active_cell_index()];
+            if (dt > max_ratio * neighbor_dt * (1.0 + 1e-14)) ++n_errors;
+        }
+    }
+    n_errors = dealii::Utilities::MPI::sum(n_errors, MPI_COMM_WORLD);
+    n_limited = dealii::Utilities::MPI::sum(n_limited, MPI_COMM_WORLD);
+    pcout << "Limited " << n_limited << " local time steps with " << n_errors << " errors." << std::endl;
+    // The graded grid must actually exercise the limiting.
+    if (n_limited == 0) return 1;
+
+    return n_errors;
+}
+
+/// Solves the steady state with the switched evolution relaxation controller and the limited local time steps,
+/// and compares it with the one of the residual ramping controller.
+template<int dim, int nstate>
+int test_steady_state (
+    const unsigned int poly_degree,
+    PHiLiP::Parameters::AllParameters all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    all_parameters.ode_solver_param.ode_solver_type = Parameters::ODESolverParam::ODESolverEnum::implicit_solver;
+    all_parameters.ode_solver_param.nonlinear_steady_residual_tolerance = 1e-12;
+    all_parameters.ode_solver_param.nonlinear_max_iterations = 200;
+    all_parameters.ode_solver_param.initial_time_step = 10.0;
+    all_parameters.ode_solver_param.ode_output = Parameters::OutputEnum::quiet;
+    all_parameters.linear_solver_param.linear_residual = 1e-10;
+
+    dealii::LinearAlgebra::distributed::Vector<double> reference_solution;
+    {
+        all_parameters.ode_solver_param.cfl_controller = CFLControllerEnum::residual_ramping;
+        all_parameters.ode_solver_param.local_time_step_max_neighbor_ratio = 0.0;
+        std::shared_ptr < DGBase<dim, double> > dg = create_dg<dim,nstate>(poly_degree, all_parameters);
+        std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
+        if (ode_solver->steady_state() != 0) {
+            pcout << "Steady state with the residual ramping controller did not converge." << std::endl;
+            return 1;
+        }
+        reference_solution = dg->solution;
+    }
+
+    all_parameters.ode_solver_param.cfl_controller = CFLControllerEnum::switched_evolution_relaxation;
+    all_parameters.ode_solver_param.switched_evolution_relaxation_exponent = 1.0;
+    all_parameters.ode_solver_param.local_time_step_max_neighbor_ratio = 1.5;
+    std::shared_ptr < DGBase<dim, double> > dg = create_dg<dim,nstate>(poly_degree, all_parameters);
+    std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
+    if (ode_solver->steady_state() != 0) {
+        pcout << "Steady state with the switched evolution relaxation controller did not converge." << std::endl;
+        return 1;
+    }
+
+    // The local time steps only change the path to the steady state, not the steady state itself.
+    dealii::LinearAlgebra::distributed::Vector<double> solution_diff(dg->solution);
+    solution_diff -= reference_solution;
+    const double rel_diff = solution_diff.l2_norm() / reference_solution.l2_norm();
+    pcout << "Switched evolution relaxation steady state relative difference with the residual ramping one: " << rel_diff << std::endl;
+    if (rel_diff > 1e-8) return 1;
+
+    return 0;
+}
+
+/// Checks that parse_parameters() rejects the neighbour ratios that would increase the time steps.
+int test_parameter_check ()
+{
+    using namespace PHiLiP;
+    int n_errors = 0;
+    for (const double ratio : { 0.0, 0.5, 1.0, 2.0 }) {
+        dealii::ParameterHandler parameter_handler;
+        Parameters::AllParameters::declare_parameters (parameter_handler);
+        parameter_handler.enter_subsection("ODE solver");
+        parameter_handler.set("local_time_step_max_neighbor_ratio", ratio);
+        parameter_handler.leave_subsection();
+
+        Parameters::AllParameters all_parameters;
+        bool is_rejected = false;
+        try {
+            all_parameters.parse_parameters (parameter_handler);
+        } catch (const dealii::ExceptionBase &) {
+            is_rejected = true;
+        }
+        const bool should_be_rejected = (ratio != 0.0 && ratio < 1.0);
+        if (is_rejected != should_be_rejected) ++n_errors;
+    }
+    return n_errors;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+
+    int error = test_parameter_check();
+    pcout << "Parameter check errors: " << error << std::endl;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+    all_parameters.pde_type = Parameters::AllParameters::PartialDifferentialEquation::advection;
+
+    for (unsigned int poly_degree=1; poly_degree<3 && error == 0; ++poly_degree) {
+        pcout << "Using poly degree " << poly_degree << std::endl;
+        error = test_neighbor_ratio<dim,1>(poly_degree, all_parameters);
+        if (error == 0) error = test_steady_state<dim,1>(poly_degree, all_parameters);
+    }
+
+    return error;
+}
@@ -0,0 +1,62 @@
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "parameters/parameters_ode_solver.h"
+#include "ode_solver/low_storage_runge_kutta.h"
+
+using RKEnum = PHiLiP::Parameters::ODESolverParam::RungeKuttaSchemeEnum;
+
+/// Integrates du/dt = -u^2, u(0) = 1, up to t = 1 with the low-storage registers and returns the error.
+double integrate (const PHiLiP::ODE::LowStorageRungeKutta &runge_kutta, const unsigned int n_steps)
+{
+    const double final_time = 1.0;
+    const double dt = final_time / n_steps;
+
+    double S1 = 1.0, S2 = 0.0, S3 = 0.0;
+    double *S2_ptr = runge_kutta.uses_register_2() ? &S2 : nullptr;
+    double *S3_ptr = runge_kutta.uses_register_3() ? &S3 : nullptr;
+    for (unsigned int istep = 0; istep < n_steps; ++istep) {
+        runge_kutta.initialize_registers(1, &S1, S2_ptr, S3_ptr);
+        for (unsigned int istage = 0; istage < runge_kutta.n_stages(); ++istage) {
+            runge_kutta.begin_stage(istage, 1, &S1, S2_ptr);
+            const double stage_derivative = runge_kutta.stage_derivative_factor(istage) * dt * (-S1*S1);
+            runge_kutta.end_stage(istage, 1, &S1, S2_ptr, S3_ptr, &stage_derivative);
+        }
+    }
+    const double exact = 1.0 / (1.0 + final_time);
+    return std::abs(S1 - exact);
+}
+
+int main ()
+{
+    const std::vector<RKEnum> schemes {
+        RKEnum::forward_euler,
+        RKEnum::ssp_rk3,
+        RKEnum::ssp_rk_4_3,
+        RKEnum::ssp_rk_9_3,
+        RKEnum::ssp_rk_16_3,
+        RKEnum::carpenter_kennedy_rk4_5
+    };
+
+    int error = 0;
+    for (const auto scheme : schemes) {
+        const PHiLiP::ODE::LowStorageRungeKutta runge_kutta(scheme);
+
+        const unsigned int n_steps = 20;
+        const double error_coarse = integrate(runge_kutta, n_steps);
+        const double error_fine = integrate(runge_kutta, 2*n_steps);
+        const double observed_order = std::log(error_coarse/error_fine) / std::log(2.0);
+
+        std::cout << runge_kutta.name << " with " << runge_kutta.n_stages() << " stages:"
+                  << " errors " << error_coarse << " " << error_fine
+                  << " observed order " << observed_order
+                  << " expected order " << runge_kutta.order << std::endl;
+
+        if (std::abs(observed_order - runge_kutta.order) > 0.2) {
+            std::cout << "Observed order does not match the expected order." << std::endl;
+            error = 1;
+        }
+    }
+    return error;
+}
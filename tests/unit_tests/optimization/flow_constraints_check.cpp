@@ -147,6 +147,7 @@ int test(const unsigned int nx_ffd)
 
     // Initialize coarse grid solution with free-stream
     dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, dg->solution);
+    dg->solution_modified();
     // Create ODE solver and ramp up the solution from p0
     std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
     ode_solver->initialize_steady_polynomial_ramping (POLY_DEGREE);
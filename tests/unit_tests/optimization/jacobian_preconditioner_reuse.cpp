@@ -0,0 +1,173 @@
+#include <iostream>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include <deal.II/optimization/rol/vector_adaptor.h>
+
+#include "physics/euler.h"
+#include "dg/dg_factory.hpp"
+
+#include "mesh/grids/gaussian_bump.h"
+#include "mesh/free_form_deformation.h"
+
+#include "optimization/flow_constraints.hpp"
+
+const int dim = 2;
+const int nstate = 4;
+const int POLY_DEGREE = 1;
+const double BUMP_HEIGHT = 0.0625;
+const double CHANNEL_LENGTH = 3.0;
+const double CHANNEL_HEIGHT = 0.8;
+const unsigned int NY_CELL = 3;
+const unsigned int NX_CELL = 5*NY_CELL;
+
+/// Checks the number of factorizations of the shared Jacobian preconditioner and whether it is allocated.
+int check_preconditioner (
+    const PHiLiP::FlowConstraints<dim> &con,
+    const std::string &step,
+    const unsigned int expected_n_factorizations,
+    const bool expected_allocation)
+{
+    dealii::ConditionalOStream pcout(std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0);
+    const unsigned int n_factorizations = con.n_JacobianPreconditioner_1_factorizations();
+    const bool is_allocated = con.has_JacobianPreconditioner_1();
+    pcout << step << ": " << n_factorizations << " factorizations, " << (is_allocated ? "allocated" : "released") << std::endl;
+    if (n_factorizations != expected_n_factorizations || is_allocated != expected_allocation) {
+        pcout << " Expected " << expected_n_factorizations << " factorizations, " << (expected_allocation ? "allocated" : "released") << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/** This test checks that the Jacobian preconditioner of the FlowConstraints is factored once,
+ *  shared by the adjoint Jacobian preconditioner, and reused as long as the state and flow_CFL_ are unchanged.
+ *  It must be re-factored after a change of the state or of flow_CFL_, and released by either destroy function.
+ */
+int test ()
+{
+    int test_error = 0;
+    using namespace PHiLiP;
+    using DealiiVector = dealii::LinearAlgebra::distributed::Vector<double>;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+    parameter_handler.set("pde_type", "euler");
+    parameter_handler.set("conv_num_flux", "roe");
+    parameter_handler.set("dimension", (long int)dim);
+    parameter_handler.enter_subsection("euler");
+    parameter_handler.set("mach_infinity", 0.3);
+    parameter_handler.leave_subsection();
+
+    Parameters::AllParameters param;
+    param.parse_parameters (parameter_handler);
+
+    param.euler_param.parse_parameters (parameter_handler);
+    param.euler_param.mach_inf = 0.3;
+    Physics::Euler<dim,nstate,double> euler_physics_double = Physics::Euler<dim, nstate, double>(
+                param.euler_param.ref_length,
+                param.euler_param.gamma_gas,
+                param.euler_param.mach_inf,
+                param.euler_param.angle_of_attack,
+                param.euler_param.side_slip_angle);
+    Physics::FreeStreamInitialConditions<dim,nstate> initial_conditions(euler_physics_double);
+
+    std::vector<unsigned int> n_subdivisions(dim);
+    n_subdivisions[1] = NY_CELL;
+    n_subdivisions[0] = NX_CELL;
+
+    const unsigned int nx_ffd = 5;
+    const dealii::Point<dim> ffd_origin(-1.4,-0.1);
+    const std::array<double,dim> ffd_rectangle_lengths = {{2.8,0.6}};
+    const std::array<unsigned int,dim> ffd_ndim_control_pts = {{nx_ffd,2}};
+    FreeFormDeformation<dim> ffd( ffd_origin, ffd_rectangle_lengths, ffd_ndim_control_pts);
+
+    unsigned int n_design_variables = 0;
+    std::vector< std::pair< unsigned int, unsigned int > > ffd_design_variables_indices_dim;
+    for (unsigned int i_ctl = 0; i_ctl < ffd.n_control_pts; ++i_ctl) {
+        const std::array<unsigned int,dim> ijk = ffd.global_to_grid ( i_ctl );
+        for (unsigned int d_ffd = 0; d_ffd < dim; ++d_ffd) {
+            if (   ijk[0] == 0 // Constrain first column of FFD points.
+                || ijk[0] == ffd_ndim_control_pts[0] - 1  // Constrain last column of FFD points.
+                || d_ffd == 0 // Constrain x-direction of FFD points.
+               ) {
+                continue;
+            }
+            ++n_design_variables;
+            ffd_design_variables_indices_dim.push_back(std::make_pair(i_ctl, d_ffd));
+        }
+    }
+
+    const dealii::IndexSet row_part = dealii::Utilities::MPI::create_evenly_distributed_partitioning(MPI_COMM_WORLD,n_design_variables);
+    dealii::IndexSet ghost_row_part(n_design_variables);
+    ghost_row_part.add_range(0,n_design_variables);
+    DealiiVector ffd_design_variables(row_part,ghost_row_part,MPI_COMM_WORLD);
+    ffd.get_design_variables( ffd_design_variables_indices_dim, ffd_design_variables);
+
+    using Triangulation = dealii::parallel::distributed::Triangulation<dim>;
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+        MPI_COMM_WORLD,
+        typename dealii::Triangulation<dim>::MeshSmoothing(
+            dealii::Triangulation<dim>::smoothing_on_refinement |
+            dealii::Triangulation<dim>::smoothing_on_coarsening));
+    Grids::gaussian_bump(*grid, n_subdivisions, CHANNEL_LENGTH, CHANNEL_HEIGHT, BUMP_HEIGHT);
+
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&param, POLY_DEGREE, grid);
+    dg->allocate_system ();
+    dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, dg->solution);
+    dg->solution.update_ghost_values();
+    dg->solution_modified();
+
+    const bool has_ownership = false;
+    DealiiVector des_var_sim = dg->solution;
+    DealiiVector des_var_ctl = ffd_design_variables;
+    Teuchos::RCP<DealiiVector> des_var_sim_rcp = Teuchos::rcp(&des_var_sim, has_ownership);
+    Teuchos::RCP<DealiiVector> des_var_ctl_rcp = Teuchos::rcp(&des_var_ctl, has_ownership);
+
+    using VectorAdaptor = dealii::Rol::VectorAdaptor<DealiiVector>;
+    VectorAdaptor des_var_sim_rol(des_var_sim_rcp);
+    VectorAdaptor des_var_ctl_rol(des_var_ctl_rcp);
+
+    FlowConstraints<dim> con(dg,ffd,ffd_design_variables_indices_dim);
+    test_error += check_preconditioner(con, "Constructed FlowConstraints", 0, false);
+
+    con.construct_JacobianPreconditioner_1(des_var_sim_rol, des_var_ctl_rol);
+    test_error += check_preconditioner(con, "Jacobian preconditioner", 1, true);
+
+    // The adjoint preconditioner shares the factorization at the same state.
+    con.construct_AdjointJacobianPreconditioner_1(des_var_sim_rol, des_var_ctl_rol);
+    test_error += check_preconditioner(con, "Adjoint Jacobian preconditioner at the same state", 1, true);
+    con.construct_JacobianPreconditioner_1(des_var_sim_rol, des_var_ctl_rol);
+    test_error += check_preconditioner(con, "Jacobian preconditioner at the same state", 1, true);
+
+    // State change.
+    for (auto &value : des_var_sim) value *= 1.0 + 1e-3;
+    des_var_sim.update_ghost_values();
+    con.construct_AdjointJacobianPreconditioner_1(des_var_sim_rol, des_var_ctl_rol);
+    test_error += check_preconditioner(con, "Adjoint Jacobian preconditioner after a state change", 2, true);
+    con.construct_JacobianPreconditioner_1(des_var_sim_rol, des_var_ctl_rol);
+    test_error += check_preconditioner(con, "Jacobian preconditioner at the changed state", 2, true);
+
+    // CFL change.
+    con.flow_CFL_ = 1.0;
+    con.construct_JacobianPreconditioner_1(des_var_sim_rol, des_var_ctl_rol);
+    test_error += check_preconditioner(con, "Jacobian preconditioner after a CFL change", 3, true);
+
+    // Both destroy functions release the single shared factorization.
+    con.destroy_AdjointJacobianPreconditioner_1();
+    test_error += check_preconditioner(con, "Destroyed the adjoint Jacobian preconditioner", 3, false);
+    con.construct_JacobianPreconditioner_1(des_var_sim_rol, des_var_ctl_rol);
+    test_error += check_preconditioner(con, "Jacobian preconditioner after its destruction", 4, true);
+    con.destroy_JacobianPreconditioner_1();
+    test_error += check_preconditioner(con, "Destroyed the Jacobian preconditioner", 4, false);
+
+    return test_error;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    int test_error = test();
+    return test_error;
+}
@@ -127,6 +127,7 @@ int test(const unsigned int nx_ffd)
         // Initialize coarse grid solution with free-stream
         dg->allocate_system ();
         dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, dg->solution);
+        dg->solution_modified();
         // Create ODE solver and ramp up the solution from p0
         std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
         ode_solver->initialize_steady_polynomial_ramping (POLY_DEGREE);
@@ -184,6 +185,7 @@ int test(const unsigned int nx_ffd)
     // Initialize coarse grid solution with free-stream
     dg->allocate_system ();
     dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, dg->solution);
+    dg->solution_modified();
     // Create ODE solver and ramp up the solution from p0
     std::shared_ptr<ODE::ODESolver<dim, double>> ode_solver = ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
     ode_solver->initialize_steady_polynomial_ramping (POLY_DEGREE);
@@ -276,6 +278,7 @@ int test(const unsigned int nx_ffd)
         const auto direction_ctl = des_var_ctl_rol_p->clone();
         *outStream << "robj->checkGradient..." << std::endl;
         dealii::VectorTools::interpolate(dg->dof_handler, initial_conditions, dg->solution);
+        dg->solution_modified();
         std::vector<std::vector<double>> results
             = robj->checkGradient( *des_var_ctl_rol_p, *direction_ctl, steps, true, *outStream, order);
 
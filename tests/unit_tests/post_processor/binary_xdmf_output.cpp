@@ -0,0 +1,239 @@
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <regex>
+#include <sstream>
+
+#include <deal.II/base/tensor.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/parameters.h"
+#include "physics/physics_factory.h"
+
+using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+
+/// Data of the locally owned cells, in the order it is expected in the binary file.
+struct ExpectedOutput
+{
+    std::uint64_t first_point; ///< Global index of the first local point.
+    std::uint64_t first_element; ///< Global index of the first local element.
+    std::uint64_t n_points; ///< Number of points of all the processes.
+    std::uint64_t n_elements; ///< Number of elements of all the processes.
+    std::vector<double> points; ///< Coordinates of the local points, 3 per point.
+    std::vector<std::int64_t> connectivity; ///< Global point indices of the local elements.
+    std::vector<std::vector<double>> fields; ///< Values of each state at the local points.
+};
+
+/// Evaluates the points, connectivity and fields the binary output should contain for the local cells.
+/** The cells are subdivided as many times as the grid degree, and the sub-cells are linear
+ *  quadrilaterals or hexahedra in the counter-clockwise XDMF vertex ordering.
+ */
+template <int dim, int nstate>
+ExpectedOutput evaluate_expected_output (const PHiLiP::DGBase<dim,double> &dg)
+{
+    const unsigned int n_subdivisions = std::max(1u, dg.high_order_grid->max_degree);
+    const unsigned int n_points_1d = n_subdivisions + 1;
+    const unsigned int n_points_cell = dealii::Utilities::pow(n_points_1d, dim);
+    const unsigned int n_subcells = dealii::Utilities::pow(n_subdivisions, dim);
+
+    // Unit points indexed as (i + j*n_points_1d + k*n_points_1d^2).
+    std::vector<dealii::Point<dim>> unit_points;
+    for (unsigned int k = 0; k < (dim == 3 ? n_points_1d : 1); ++k) {
+        for (unsigned int j = 0; j < n_points_1d; ++j) {
+            for (unsigned int i = 0; i < n_points_1d; ++i) {
+                dealii::Point<dim> point;
+                point[0] = static_cast<double>(i) / n_subdivisions;
+                point[1] = static_cast<double>(j) / n_subdivisions;
+                if (dim == 3) point[dim-1] = static_cast<double>(k) / n_subdivisions;
+                unit_points.push_back(point);
+            }
+        }
+    }
+    // Corners of a sub-cell: counter-clockwise bottom face, then the top face.
+    std::vector<std::array<unsigned int, 3>> corners { {{0,0,0}}, {{1,0,0}}, {{1,1,0}}, {{0,1,0}} };
+    if (dim == 3) {
+        for (unsigned int icorner = 0; icorner < 4; ++icorner) corners.push_back({{corners[icorner][0], corners[icorner][1], 1}});
+    }
+
+    const std::uint64_t n_local_cells = dg.triangulation->n_locally_owned_active_cells();
+    std::uint64_t first_cell = 0;
+    MPI_Exscan(&n_local_cells, &first_cell, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+    if (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0) first_cell = 0;
+    const std::uint64_t n_cells = dg.triangulation->n_global_active_cells();
+
+    ExpectedOutput expected;
+    expected.first_point = first_cell * n_points_cell;
+    expected.first_element = first_cell * n_subcells;
+    expected.n_points = n_cells * n_points_cell;
+    expected.n_elements = n_cells * n_subcells;
+    expected.fields.resize(nstate);
+
+    const dealii::hp::QCollection<dim> quadrature_collection(dealii::Quadrature<dim>(unit_points));
+    const dealii::hp::MappingCollection<dim> mapping_collection(*(dg.high_order_grid->mapping_fe_field));
+    dealii::hp::FEValues<dim,dim> fe_values_collection(mapping_collection, dg.fe_collection, quadrature_collection,
+                                                       dealii::update_values | dealii::update_quadrature_points);
+    std::vector<dealii::Vector<double>> point_values(n_points_cell, dealii::Vector<double>(nstate));
+    for (const auto &cell : dg.dof_handler.active_cell_iterators()) {
+        if (!cell->is_locally_owned()) continue;
+
+        fe_values_collection.reinit (cell, 0, 0, cell->active_fe_index());
+        const dealii::FEValues<dim,dim> &fe_values = fe_values_collection.get_present_fe_values();
+        fe_values.get_function_values(dg.solution, point_values);
+
+        const std::int64_t first_cell_point = expected.first_point + expected.points.size() / 3;
+        for (unsigned int ipoint = 0; ipoint < n_points_cell; ++ipoint) {
+            for (int d = 0; d < 3; ++d) expected.points.push_back(d < dim ? fe_values.quadrature_point(ipoint)[d] : 0.0);
+            for (int s = 0; s < nstate; ++s) expected.fields[s].push_back(point_values[ipoint][s]);
+        }
+        for (unsigned int k = 0; k < (dim == 3 ? n_subdivisions : 1); ++k) {
+            for (unsigned int j = 0; j < n_subdivisions; ++j) {
+                for (unsigned int i = 0; i < n_subdivisions; ++i) {
+                    for (const auto &corner : corners) {
+                        const unsigned int ipoint = (i + corner[0]) + (j + corner[1]) * n_points_1d
+                                                    + (dim == 3 ? (k + corner[2]) * n_points_1d * n_points_1d : 0);
+                        expected.connectivity.push_back(first_cell_point + ipoint);
+                    }
+                }
+            }
+        }
+    }
+    return expected;
+}
+
+/// Reads @p count values of type T at byte @p offset of @p file.
+template <typename T>
+std::vector<T> read_binary (std::ifstream &file, const std::uint64_t offset, const std::size_t count)
+{
+    std::vector<T> values(count);
+    file.seekg(offset);
+    file.read(reinterpret_cast<char *>(values.data()), count * sizeof(T));
+    return values;
+}
+
+/// Writes the solution with DGBase::output_results_binary() and reads the binary file back at the
+/// offsets given by the XDMF file, on all the processes.
+template <int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(MPI_COMM_WORLD);
+    dealii::GridGenerator::subdivided_hyper_cube(*grid, 4);
+    const double random_factor = 0.2;
+    const bool keep_boundary = false;
+    dealii::GridTools::distort_random (random_factor, *grid, keep_boundary);
+    for (auto &cell : grid->active_cell_iterators()) {
+        for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+            if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+        }
+    }
+
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+    dg->allocate_system ();
+
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics_double = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+    dealii::LinearAlgebra::distributed::Vector<double> solution_no_ghost;
+    solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(*(dg->high_order_grid->mapping_fe_field), dg->dof_handler, *(physics_double->manufactured_solution_function), solution_no_ghost);
+    dg->solution = solution_no_ghost;
+    dg->solution.update_ghost_values();
+    dg->solution_modified();
+
+    const ExpectedOutput expected = evaluate_expected_output<dim,nstate>(*dg);
+
+    const unsigned int cycle = poly_degree;
+    const double time = 0.5;
+    dg->output_results_binary(cycle, time);
+    // The write completes in the background until the writer of the DG is destroyed.
+    dg.reset();
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    const std::string filename = "solution-" + dealii::Utilities::int_to_string(dim, 1) + "D_maxpoly"
+                                 + dealii::Utilities::int_to_string(poly_degree, 2) + "-"
+                                 + dealii::Utilities::int_to_string(cycle, 4);
+
+    int n_errors = 0;
+
+    // Offsets of the connectivity, the points, and each field, in their order of appearance in the XDMF file.
+    std::ifstream xdmf_file(filename + ".xdmf");
+    std::stringstream xdmf;
+    xdmf << xdmf_file.rdbuf();
+    const std::string xdmf_string = xdmf.str();
+    std::vector<std::uint64_t> seeks;
+    const std::regex seek_regex("Seek=\"([0-9]+)\"");
+    for (auto match = std::sregex_iterator(xdmf_string.begin(), xdmf_string.end(), seek_regex); match != std::sregex_iterator(); ++match) {
+        seeks.push_back(std::stoull((*match)[1]));
+    }
+    if (seeks.size() != 2 + static_cast<std::size_t>(nstate)) {
+        pcout << "Found " << seeks.size() << " data items in " << filename << ".xdmf instead of " << 2 + nstate << std::endl;
+        return 1;
+    }
+    if (xdmf_string.find("NumberOfElements=\"" + std::to_string(expected.n_elements) + "\"") == std::string::npos) {
+        pcout << "Wrong number of elements in " << filename << ".xdmf" << std::endl;
+        ++n_errors;
+    }
+    if (xdmf_string.find("<Time Value=\"0.5\"/>") == std::string::npos) {
+        pcout << "Wrong time in " << filename << ".xdmf" << std::endl;
+        ++n_errors;
+    }
+
+    std::ifstream binary_file(filename + ".bin", std::ios::binary);
+    const std::uint64_t nodes_per_element = (dim == 2) ? 4 : 8;
+    const std::vector<std::int64_t> connectivity = read_binary<std::int64_t>(binary_file,
+        seeks[0] + expected.first_element * nodes_per_element * sizeof(std::int64_t), expected.connectivity.size());
+    const std::vector<double> points = read_binary<double>(binary_file,
+        seeks[1] + expected.first_point * 3 * sizeof(double), expected.points.size());
+    if (!binary_file.good()) {
+        std::cout << "Could not read " << filename << ".bin on process " << mpi_rank << std::endl;
+        ++n_errors;
+    }
+    if (connectivity != expected.connectivity) ++n_errors;
+    if (points != expected.points) ++n_errors;
+    for (int s = 0; s < nstate; ++s) {
+        const std::vector<double> field = read_binary<double>(binary_file,
+            seeks[2+s] + expected.first_point * sizeof(double), expected.fields[s].size());
+        if (field != expected.fields[s]) ++n_errors;
+    }
+    // The file must hold the data of all the processes and nothing else.
+    binary_file.clear();
+    binary_file.seekg(0, std::ios::end);
+    const std::uint64_t expected_size = seeks[2] + nstate * expected.n_points * sizeof(double);
+    if (static_cast<std::uint64_t>(binary_file.tellg()) != expected_size) ++n_errors;
+
+    n_errors = dealii::Utilities::MPI::sum(n_errors, MPI_COMM_WORLD);
+    pcout << "Poly degree " << poly_degree << " with " << expected.n_points << " points and "
+          << expected.n_elements << " elements: " << n_errors << " errors." << std::endl;
+
+    return n_errors;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    int error = 0;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+    all_parameters.pde_type = Parameters::AllParameters::PartialDifferentialEquation::euler;
+
+    for (unsigned int poly_degree = 1; poly_degree <= 2 && error == 0; ++poly_degree) {
+        error = test<dim,dim+2>(poly_degree, all_parameters);
+    }
+
+    return (error == 0) ? 0 : 1;
+}
@@ -66,6 +66,7 @@ int main (int argc, char * argv[])
                 dg->allocate_system ();
 
                 dg->solution *= 0.0;
+                dg->solution_modified();
 
                 dg->assemble_residual(true);
 
@@ -105,6 +105,7 @@ int test (
     for (int i=0; i < n; ++i) {
         std::cout << i << " out of " << n << std::endl;
         *(dg->solution.begin()) += 1e-7;
+        dg->solution_modified();
         dg->assemble_residual(false, false, true);
     }
     double timing_end = MPI_Wtime();
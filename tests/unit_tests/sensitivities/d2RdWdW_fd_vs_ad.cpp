@@ -112,6 +112,7 @@ int test (
         //(*it) += 1.0;
     }
     dg->solution.update_ghost_values();
+    dg->solution_modified();
 
     // Solving the flow to make sure that we're not at the point of non-differentiality between elements.
     std::shared_ptr<PHiLiP::ODE::ODESolver<dim, double>> ode_solver = PHiLiP::ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
@@ -122,6 +123,7 @@ int test (
         (*it) = 1.0;
     }
     dg->dual.update_ghost_values();
+    dg->dual_modified();
 
 
     dealii::TrilinosWrappers::SparseMatrix d2RdWdW_fd;
@@ -182,6 +184,7 @@ int test (
                             dg->solution[jw] = old_jw+j*EPS;
                         }
                     }
+                    dg->solution_modified();
                     dg->assemble_residual(false, false, false);
                     perturbed_dual_dot_residual[ij] = dg->right_hand_side * dg->dual;
 
@@ -256,6 +259,7 @@ int test (
             if (jw_relevant) {
                 dg->solution[jw] = old_jw;
             }
+            dg->solution_modified();
 
             // Set
             if (dg->locally_owned_dofs.is_element(iw) ) {
@@ -80,6 +80,7 @@ int test (
         //(*it) += 1.0;
     }
     dg->solution.update_ghost_values();
+    dg->solution_modified();
 
     // Solving the flow to make sure that we're not at the point of non-differentiality between elements.
     std::shared_ptr<PHiLiP::ODE::ODESolver<dim, double>> ode_solver = PHiLiP::ODE::ODESolverFactory<dim, double>::create_ODESolver(dg);
@@ -90,6 +91,7 @@ int test (
         (*it) = 1.0;
     }
     dg->dual.update_ghost_values();
+    dg->dual_modified();
 
 
     dealii::TrilinosWrappers::SparseMatrix d2RdWdX_fd;
@@ -146,6 +148,8 @@ int test (
                     if (jnode_relevant) {
                         dg->high_order_grid->volume_nodes[jnode] = old_jnode+j*EPS;
                     }
+                    dg->high_order_grid->volume_nodes_modified();
+                    dg->solution_modified();
                     dg->assemble_residual(false, false, false);
                     perturbed_dual_dot_residual[ij] = dg->right_hand_side * dg->dual;
 
@@ -155,6 +159,7 @@ int test (
                     if (jnode_relevant) {
                         dg->high_order_grid->volume_nodes[jnode] = old_jnode;
                     }
+                    dg->high_order_grid->volume_nodes_modified();
                 }
             }
 
@@ -220,6 +225,8 @@ int test (
             if (jnode_relevant) {
                 dg->high_order_grid->volume_nodes[jnode] = old_jnode;
             }
+            dg->high_order_grid->volume_nodes_modified();
+            dg->solution_modified();
 
             // Set
             if (dg->locally_owned_dofs.is_element(iw) ) {
@@ -190,6 +190,7 @@ int test (
                             high_order_grid->volume_nodes(jnode) = old_jnode+j*EPS;
                         }
                     }
+                    high_order_grid->volume_nodes_modified();
                     dg->assemble_residual(false, false, false);
                     perturbed_dual_dot_residual[ij] = dg->right_hand_side * dg->dual;
 
@@ -199,6 +200,7 @@ int test (
                     if (jnode_relevant) {
                         high_order_grid->volume_nodes(jnode) = old_jnode;
                     }
+                    high_order_grid->volume_nodes_modified();
                 }
             }
 
@@ -264,6 +266,7 @@ int test (
             if (jnode_relevant) {
                 high_order_grid->volume_nodes(jnode) = old_jnode;
             }
+            high_order_grid->volume_nodes_modified();
 
             // Set
             if (dg->high_order_grid->locally_owned_dofs_grid.is_element(inode) ) {
@@ -80,6 +80,7 @@ int test (
         (*it) += 1.0;
     }
     dg->solution.update_ghost_values();
+    dg->solution_modified();
 
 
     dealii::TrilinosWrappers::SparseMatrix dRdW_fd;
@@ -104,6 +105,7 @@ int test (
             old_dof = dg->solution[idof];
             dg->solution(idof) = old_dof+eps;
         }
+        dg->solution_modified();
         dg->assemble_residual(false, false, false);
         solutionVector perturbed_residual_p = dg->right_hand_side;
 
@@ -111,6 +113,7 @@ int test (
         if (dg->locally_owned_dofs.is_element(idof) ) {
             dg->solution(idof) = old_dof-eps;
         }
+        dg->solution_modified();
         dg->assemble_residual(false, false, false);
         solutionVector perturbed_residual_m = dg->right_hand_side;
 
@@ -122,6 +125,7 @@ int test (
         if (dg->locally_owned_dofs.is_element(idof) ) {
             dg->solution(idof) = old_dof;
         }
+        dg->solution_modified();
 
         // Set
         for (unsigned int iresidual = 0; iresidual < dg->dof_handler.n_dofs(); ++iresidual) {
@@ -112,6 +112,7 @@ int test (
             old_node = high_order_grid->volume_nodes[inode];
             high_order_grid->volume_nodes(inode) = old_node+EPS;
         }
+        high_order_grid->volume_nodes_modified();
         // This should be uncommented once we fix:
         // https://github.com/dougshidong/PHiLiP/issues/48#issue-771199898
         //high_order_grid->ensure_conforming_mesh();
@@ -128,6 +129,7 @@ int test (
         if (high_order_grid->locally_relevant_dofs_grid.is_element(inode) ) {
             high_order_grid->volume_nodes(inode) = old_node-EPS;
         }
+        high_order_grid->volume_nodes_modified();
         // This should be uncommented once we fix:
         // https://github.com/dougshidong/PHiLiP/issues/48#issue-771199898
         //high_order_grid->ensure_conforming_mesh();
@@ -148,6 +150,7 @@ int test (
         if (high_order_grid->locally_relevant_dofs_grid.is_element(inode) ) {
             high_order_grid->volume_nodes(inode) = old_node;
         }
+        high_order_grid->volume_nodes_modified();
 
         // Set
         for (unsigned int iresidual = 0; iresidual < dg->dof_handler.n_dofs(); ++iresidual) {
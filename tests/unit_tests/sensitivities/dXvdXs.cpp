@@ -220,6 +220,23 @@ int main (int argc, char * argv[])
 
             // Analytical dXvdXs
             meshmover.evaluate_dXvdXs();
+
+            // The block GMRES and the factored direct solver should agree.
+            {
+                MeshMover::LinearElasticity<dim, double> meshmover_direct(high_order_grid, surface_node_displacements_vector);
+                meshmover_direct.multiple_rhs_solver = MeshMover::LinearElasticity<dim, double>::MultipleRHSSolverEnum::direct;
+                meshmover_direct.evaluate_dXvdXs();
+                for (unsigned int isurface = 0; isurface < meshmover.dXvdXs.size(); ++isurface) {
+                    VectorType diff = meshmover_direct.dXvdXs[isurface];
+                    diff.add(-1.0, meshmover.dXvdXs[isurface]);
+                    const double diff_norm = diff.l2_norm();
+                    if (diff_norm > 1e-8 * std::max(1.0, meshmover.dXvdXs[isurface].l2_norm())) {
+                        pcout << "Block GMRES and direct dXvdXs differ by " << diff_norm
+                              << " for surface node " << isurface << std::endl;
+                        std::abort();
+                    }
+                }
+            }
             // Start finite difference
             std::vector<VectorType> dXvdXs_FD;
             const auto &part = surface_node_displacements_vector.get_partitioner();
@@ -243,9 +260,11 @@ int main (int argc, char * argv[])
 
                 high_order_grid.volume_nodes += volume_displacements_p;
                 high_order_grid.volume_nodes.update_ghost_values();
+                high_order_grid.volume_nodes_modified();
                 high_order_grid.output_results_vtk(high_order_grid.nth_refinement++);
                 high_order_grid.volume_nodes -= volume_displacements_p;
                 high_order_grid.volume_nodes.update_ghost_values();
+                high_order_grid.volume_nodes_modified();
                 high_order_grid.output_results_vtk(high_order_grid.nth_refinement++);
 
 
@@ -0,0 +1,165 @@
+#include <deal.II/base/tensor.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/parameters.h"
+#include "physics/physics_factory.h"
+
+using PDEType  = PHiLiP::Parameters::AllParameters::PartialDifferentialEquation;
+
+#if PHILIP_DIM==1
+    using Triangulation = dealii::Triangulation<PHILIP_DIM>;
+#else
+    using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+#endif
+
+/// Relative Frobenius norm of the difference between two matrices with the same sparsity pattern.
+double relative_difference (
+    const dealii::TrilinosWrappers::SparseMatrix &reference,
+    const dealii::TrilinosWrappers::SparseMatrix &matrix)
+{
+    dealii::TrilinosWrappers::SparseMatrix difference;
+    difference.copy_from(matrix);
+    difference.add(-1.0, reference);
+    const double reference_norm = reference.frobenius_norm();
+    return difference.frobenius_norm() / (reference_norm > 0.0 ? reference_norm : 1.0);
+}
+
+/// Compares the derivatives assembled in a single pass with the ones assembled by separate calls.
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    std::shared_ptr<Triangulation> grid,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    std::shared_ptr < DGBase<PHILIP_DIM, double> > dg_fused = DGFactory<PHILIP_DIM,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+    dg_fused->allocate_system ();
+    std::shared_ptr < DGBase<PHILIP_DIM, double> > dg_separate = DGFactory<PHILIP_DIM,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+    dg_separate->allocate_system ();
+
+    pcout << "Poly degree " << poly_degree << " ncells " << grid->n_active_cells() << " ndofs: " << dg_fused->dof_handler.n_dofs() << std::endl;
+
+    // Initialize solution with something
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics_double = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+    dealii::LinearAlgebra::distributed::Vector<double> solution_no_ghost;
+    solution_no_ghost.reinit(dg_fused->locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(*(dg_fused->high_order_grid->mapping_fe_field), dg_fused->dof_handler, *(physics_double->manufactured_solution_function), solution_no_ghost);
+
+    // Non-uniform dual such that every second derivative is weighted differently.
+    dealii::LinearAlgebra::distributed::Vector<double> dual(solution_no_ghost);
+    for (const auto row : dg_fused->locally_owned_dofs) {
+        dual[row] = std::cos(0.23*row) + 1.5;
+    }
+
+    for (auto dg : { dg_fused, dg_separate }) {
+        dg->solution = solution_no_ghost;
+        dg->solution.update_ghost_values();
+        dg->solution_modified();
+        dg->set_dual(dual);
+    }
+
+    pcout << "Assembling dRdW, dRdX and d2R in a single pass..." << std::endl;
+    dg_fused->assemble_residual(true, true, true);
+
+    pcout << "Assembling dRdW, dRdX and d2R separately..." << std::endl;
+    dg_separate->assemble_residual(true, false, false);
+    dealii::LinearAlgebra::distributed::Vector<double> rhs_separate(dg_separate->right_hand_side);
+    dg_separate->assemble_residual(false, true, false);
+    dg_separate->assemble_residual(false, false, true);
+
+    dealii::LinearAlgebra::distributed::Vector<double> rhs_diff(dg_fused->right_hand_side);
+    rhs_diff -= rhs_separate;
+
+    const std::vector<std::pair<std::string, double>> rel_diffs {
+        { "right_hand_side", rhs_diff.l2_norm() / rhs_separate.l2_norm() },
+        { "system_matrix", relative_difference(dg_separate->system_matrix, dg_fused->system_matrix) },
+        { "dRdXv", relative_difference(dg_separate->dRdXv, dg_fused->dRdXv) },
+        { "d2RdWdW", relative_difference(dg_separate->d2RdWdW, dg_fused->d2RdWdW) },
+        { "d2RdWdX", relative_difference(dg_separate->d2RdWdX, dg_fused->d2RdWdX) },
+        { "d2RdXdX", relative_difference(dg_separate->d2RdXdX, dg_fused->d2RdXdX) }
+    };
+
+    // Both assemblies differentiate the same operations, only the order of the summations may differ.
+    const double tol = 1e-12;
+    int error = 0;
+    for (const auto &rel_diff : rel_diffs) {
+        pcout << "Fused vs separate " << rel_diff.first << " relative difference: " << rel_diff.second << std::endl;
+        if (rel_diff.second > tol) error = 1;
+    }
+
+    return error;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    int error = 0;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+    std::vector<PDEType> pde_type {
+        PDEType::diffusion,
+        PDEType::advection,
+        PDEType::euler
+    };
+    std::vector<std::string> pde_name {
+        " PDEType::diffusion "
+        , " PDEType::advection "
+        , " PDEType::euler "
+    };
+
+    int ipde = -1;
+    for (auto pde = pde_type.begin(); pde != pde_type.end() && error == 0; pde++) {
+        ipde++;
+        for (unsigned int poly_degree=1; poly_degree<3 && error == 0; ++poly_degree) {
+            pcout << "Using " << pde_name[ipde] << std::endl;
+            all_parameters.pde_type = *pde;
+            // Generate grids
+#if PHILIP_DIM==1
+            std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+                typename dealii::Triangulation<dim>::MeshSmoothing(
+                    dealii::Triangulation<dim>::smoothing_on_refinement |
+                    dealii::Triangulation<dim>::smoothing_on_coarsening));
+#else
+            std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+                MPI_COMM_WORLD,
+                typename dealii::Triangulation<dim>::MeshSmoothing(
+                    dealii::Triangulation<dim>::smoothing_on_refinement |
+                    dealii::Triangulation<dim>::smoothing_on_coarsening));
+#endif
+            dealii::GridGenerator::subdivided_hyper_cube(*grid, 3);
+            const double random_factor = 0.2;
+            const bool keep_boundary = false;
+            dealii::GridTools::distort_random (random_factor, *grid, keep_boundary);
+            for (auto &cell : grid->active_cell_iterators()) {
+                for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+                    if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+                }
+            }
+
+            if (*pde==PDEType::euler) {
+                error = test<dim,dim+2>(poly_degree, grid, all_parameters);
+            } else {
+                error = test<dim,1>(poly_degree, grid, all_parameters);
+            }
+        }
+    }
+
+    return error;
+}
@@ -0,0 +1,206 @@
+#include <deal.II/base/tensor.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/parameters.h"
+#include "physics/physics_factory.h"
+
+using PDEType  = PHiLiP::Parameters::AllParameters::PartialDifferentialEquation;
+
+#if PHILIP_DIM==1
+    using Triangulation = dealii::Triangulation<PHILIP_DIM>;
+#else
+    using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+#endif
+
+/// Uniform grid whose boundaries use the manufactured solution.
+std::shared_ptr<Triangulation> create_grid ()
+{
+    const int dim = PHILIP_DIM;
+#if PHILIP_DIM==1
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>();
+#else
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(MPI_COMM_WORLD);
+#endif
+    const unsigned int n_subdivisions = 3;
+    dealii::GridGenerator::subdivided_hyper_cube(*grid, n_subdivisions);
+    for (auto &cell : grid->active_cell_iterators()) {
+        for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+            if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+        }
+    }
+    return grid;
+}
+
+/// Moves every node with the smooth and invertible x -> x + 0.02 sin(4x), component-wise.
+template<int dim>
+void move_grid (PHiLiP::HighOrderGrid<dim,double> &high_order_grid)
+{
+    for (const auto i : high_order_grid.locally_owned_dofs_grid) {
+        high_order_grid.volume_nodes[i] += 0.02 * std::sin(4.0 * high_order_grid.volume_nodes[i]);
+    }
+    high_order_grid.volume_nodes.update_ghost_values();
+    high_order_grid.volume_nodes_modified();
+}
+
+/// Checks that the assembly filled the cached JxW values, unit normals and surface Jacobian determinants of the weak form.
+/** Those must be consistent with the cached metric Jacobians of the same slot.
+ */
+template<int dim>
+int check_cached_integration_terms (const PHiLiP::DGBase<dim,double> &dg)
+{
+    using MetricTermsCache = typename PHiLiP::DGBase<dim,double>::MetricTermsCache;
+    const MetricTermsCache &volume_cache = dg.volume_metric_terms_cache;
+    const MetricTermsCache &face_cache = dg.face_metric_terms_cache;
+    const double tolerance = 1e-12;
+
+    for (const auto &cell : dg.dof_handler.active_cell_iterators()) {
+        if (!cell->is_locally_owned()) continue;
+        const unsigned int i_quad = cell->active_fe_index();
+        const unsigned int cell_index = cell->active_cell_index();
+
+        const dealii::Quadrature<dim> &volume_quadrature = dg.volume_quadrature_collection[i_quad];
+        const unsigned int n_volume_quad_pts = volume_quadrature.size();
+        if (volume_cache.n_quad_pts[cell_index] != n_volume_quad_pts) return 1;
+        for (unsigned int iquad=0; iquad<n_volume_quad_pts; ++iquad) {
+            const unsigned int index = cell_index*volume_cache.max_n_quad_pts + iquad;
+            const double expected_JxW = volume_cache.jacobian_determinant[index] * volume_quadrature.weight(iquad);
+            if (std::abs(volume_cache.JxW[index] - expected_JxW) > tolerance * std::abs(expected_JxW)) return 1;
+        }
+
+        const dealii::Quadrature<dim-1> &face_quadrature = dg.face_quadrature_collection[i_quad];
+        const unsigned int n_face_quad_pts = face_quadrature.size();
+        for (unsigned int iface=0; iface<dealii::GeometryInfo<dim>::faces_per_cell; ++iface) {
+            const unsigned int slot = cell_index*dealii::GeometryInfo<dim>::faces_per_cell + iface;
+            if (face_cache.n_quad_pts[slot] != n_face_quad_pts) return 1;
+            const dealii::Tensor<1,dim,double> reference_normal = dealii::GeometryInfo<dim>::unit_normal_vector[iface];
+            for (unsigned int iquad=0; iquad<n_face_quad_pts; ++iquad) {
+                const unsigned int index = slot*face_cache.max_n_quad_pts + iquad;
+                dealii::Tensor<1,dim,double> normal;
+                for (int row=0; row<dim; ++row) {
+                    for (int col=0; col<dim; ++col) {
+                        normal[row] += face_cache.jacobian_transpose_inverse[index*dim*dim + row*dim + col] * reference_normal[col];
+                    }
+                }
+                const double area = normal.norm();
+                const double expected_surface_jac_det = area * face_cache.jacobian_determinant[index];
+                const double surface_jac_det = face_cache.surface_jacobian_determinant[index];
+                if (std::abs(surface_jac_det - expected_surface_jac_det) > tolerance * std::abs(expected_surface_jac_det)) return 1;
+                const double expected_JxW = expected_surface_jac_det * face_quadrature.weight(iquad);
+                if (std::abs(face_cache.JxW[index] - expected_JxW) > tolerance * std::abs(expected_JxW)) return 1;
+                for (int d=0; d<dim; ++d) {
+                    if (std::abs(face_cache.unit_normal[index*dim + d] - normal[d] / area) > tolerance) return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/// Moves the grid of a DG whose metric terms are cached and compares the residual with the one of a new DG on the moved grid.
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, create_grid());
+    dg->allocate_system ();
+
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics_double = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+    dealii::LinearAlgebra::distributed::Vector<double> solution_no_ghost;
+    solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(dg->dof_handler, *(physics_double->manufactured_solution_function), solution_no_ghost);
+    dg->solution = solution_no_ghost;
+    dg->solution.update_ghost_values();
+    dg->solution_modified();
+
+    // Fills the metric terms caches on the initial grid.
+    dg->assemble_residual();
+    dealii::LinearAlgebra::distributed::Vector<double> rhs_initial_grid(dg->right_hand_side);
+
+    move_grid(*(dg->high_order_grid));
+    dg->assemble_residual();
+    dealii::LinearAlgebra::distributed::Vector<double> rhs_moved_grid(dg->right_hand_side);
+
+    // Same grid and partition, and therefore the same numbering, without any cached metric terms.
+    std::shared_ptr < DGBase<dim, double> > fresh_dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, create_grid());
+    fresh_dg->allocate_system ();
+    move_grid(*(fresh_dg->high_order_grid));
+    fresh_dg->solution = dg->solution;
+    fresh_dg->solution_modified();
+    fresh_dg->assemble_residual();
+
+    const double norm_rhs_fresh = fresh_dg->right_hand_side.l2_norm();
+    rhs_initial_grid -= fresh_dg->right_hand_side;
+    const double rel_diff_initial = rhs_initial_grid.l2_norm() / norm_rhs_fresh;
+    rhs_moved_grid -= fresh_dg->right_hand_side;
+    const double rel_diff_moved = rhs_moved_grid.l2_norm() / norm_rhs_fresh;
+
+    pcout << "Poly degree " << poly_degree
+          << " moved grid vs fresh DG relative difference: " << rel_diff_moved
+          << " initial grid vs fresh DG relative difference: " << rel_diff_initial << std::endl;
+    // The grid motion must change the residual for the comparison to be meaningful.
+    if (rel_diff_initial < 1e-6) return 1;
+    // Both evaluate exactly the same operations.
+    if (rel_diff_moved > 1e-14) return 1;
+
+    if (all_parameters.use_weak_form && check_cached_integration_terms<dim>(*dg)) {
+        pcout << "The cached JxW values, unit normals or surface Jacobian determinants are inconsistent." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    int error = 0;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+
+    std::vector<PDEType> pde_type {
+        PDEType::advection,
+        PDEType::euler
+    };
+    std::vector<std::string> pde_name {
+        " PDEType::advection "
+        , " PDEType::euler "
+    };
+
+    int ipde = -1;
+    for (auto pde = pde_type.begin(); pde != pde_type.end() && error == 0; pde++) {
+        ipde++;
+        for (const bool use_weak_form : { true, false }) {
+            for (unsigned int poly_degree=1; poly_degree<=2 && error == 0; ++poly_degree) {
+                pcout << "Using " << pde_name[ipde] << "in " << (use_weak_form ? "weak" : "strong") << " form" << std::endl;
+                all_parameters.pde_type = *pde;
+                all_parameters.use_weak_form = use_weak_form;
+
+                if (*pde==PDEType::euler) {
+                    error = test<dim,dim+2>(poly_degree, all_parameters);
+                } else {
+                    error = test<dim,1>(poly_degree, all_parameters);
+                }
+            }
+        }
+    }
+
+    return error;
+}
@@ -0,0 +1,151 @@
+#include <deal.II/base/tensor.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/lac/trilinos_sparse_matrix.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "mesh/high_order_grid.h"
+#include "parameters/parameters.h"
+#include "physics/physics_factory.h"
+
+using PDEType  = PHiLiP::Parameters::AllParameters::PartialDifferentialEquation;
+
+#if PHILIP_DIM==1
+    using Triangulation = dealii::Triangulation<PHILIP_DIM>;
+#else
+    using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+#endif
+
+const double TOLERANCE = 1E-12;
+
+/// Distorted grid whose boundaries use the manufactured solution.
+std::shared_ptr<Triangulation> create_grid ()
+{
+    const int dim = PHILIP_DIM;
+#if PHILIP_DIM==1
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>();
+#else
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(MPI_COMM_WORLD);
+#endif
+    dealii::GridGenerator::subdivided_hyper_cube(*grid, 3);
+    const double random_factor = 0.2;
+    const bool keep_boundary = false;
+    dealii::GridTools::distort_random (random_factor, *grid, keep_boundary);
+    for (auto &cell : grid->active_cell_iterators()) {
+        for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+            if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+        }
+    }
+    return grid;
+}
+
+/// Curves the high-order grid with the smooth and invertible x -> x + 0.05 sin(2 pi x), component-wise.
+template<int dim>
+void curve_grid (PHiLiP::HighOrderGrid<dim,double> &high_order_grid)
+{
+    for (const auto i : high_order_grid.locally_owned_dofs_grid) {
+        high_order_grid.volume_nodes[i] += 0.05 * std::sin(2.0 * dealii::numbers::PI * high_order_grid.volume_nodes[i]);
+    }
+    high_order_grid.volume_nodes.update_ghost_values();
+    high_order_grid.volume_nodes_modified();
+}
+
+/** This test checks that dRdW and the residual assembled with the passive metric terms,
+ *  i.e. when only dRdW is requested, match the ones assembled with the metric terms seeded
+ *  with respect to the grid nodes, as done when dRdX is requested in the same pass.
+ */
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, create_grid());
+    dg->allocate_system ();
+    curve_grid(*(dg->high_order_grid));
+
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics_double = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+    dealii::LinearAlgebra::distributed::Vector<double> solution_no_ghost;
+    solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(*(dg->high_order_grid->mapping_fe_field), dg->dof_handler, *(physics_double->manufactured_solution_function), solution_no_ghost);
+    dg->solution = solution_no_ghost;
+    dg->solution.update_ghost_values();
+    dg->solution_modified();
+
+    pcout << "Poly degree " << poly_degree << " grid degree " << dg->high_order_grid->fe_system.tensor_degree() << std::endl;
+
+    dg->assemble_residual(true, false, false);
+    dealii::TrilinosWrappers::SparseMatrix dRdW_passive;
+    dRdW_passive.copy_from(dg->system_matrix);
+    dealii::LinearAlgebra::distributed::Vector<double> rhs_passive(dg->right_hand_side);
+
+    // Re-assemble dRdW at the same state with the metric terms seeded.
+    dg->solution_modified();
+    dg->assemble_residual(true, true, false);
+
+    const double dRdW_norm = dg->system_matrix.frobenius_norm();
+    dRdW_passive.add(-1.0, dg->system_matrix);
+    const double dRdW_rel_diff = dRdW_passive.frobenius_norm() / dRdW_norm;
+
+    rhs_passive -= dg->right_hand_side;
+    const double rhs_rel_diff = rhs_passive.l2_norm() / dg->right_hand_side.l2_norm();
+
+    pcout << "Passive vs seeded metric dRdW relative Frobenius norm = " << dRdW_rel_diff << std::endl;
+    pcout << "Passive vs seeded metric residual relative l2 norm = " << rhs_rel_diff << std::endl;
+    if (dRdW_rel_diff > TOLERANCE || rhs_rel_diff > TOLERANCE) return 1;
+
+    return 0;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    int error = 0;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+    all_parameters.use_weak_form = true;
+
+    std::vector<PDEType> pde_type {
+        PDEType::diffusion,
+        PDEType::advection,
+        PDEType::euler
+    };
+    std::vector<std::string> pde_name {
+        " PDEType::diffusion "
+        , " PDEType::advection "
+        , " PDEType::euler "
+    };
+
+    int ipde = -1;
+    for (auto pde = pde_type.begin(); pde != pde_type.end() && error == 0; pde++) {
+        ipde++;
+        for (unsigned int poly_degree=1; poly_degree<4 && error == 0; ++poly_degree) {
+            pcout << "Using " << pde_name[ipde] << std::endl;
+            all_parameters.pde_type = *pde;
+
+            if (*pde==PDEType::euler) {
+                error = test<dim,dim+2>(poly_degree, all_parameters);
+            } else {
+                error = test<dim,1>(poly_degree, all_parameters);
+            }
+        }
+    }
+
+    return error;
+}
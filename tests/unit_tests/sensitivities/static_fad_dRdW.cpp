@@ -0,0 +1,144 @@
+#include <deal.II/base/tensor.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/lac/trilinos_sparse_matrix.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "ADTypes.hpp"
+#include "dg/dg_factory.hpp"
+#include "parameters/parameters.h"
+#include "physics/physics_factory.h"
+
+using PDEType  = PHiLiP::Parameters::AllParameters::PartialDifferentialEquation;
+
+#if PHILIP_DIM==1
+    using Triangulation = dealii::Triangulation<PHILIP_DIM>;
+#else
+    using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+#endif
+
+const double TOLERANCE = 1E-12;
+
+/// Distorted grid whose boundaries use the manufactured solution.
+std::shared_ptr<Triangulation> create_grid ()
+{
+    const int dim = PHILIP_DIM;
+#if PHILIP_DIM==1
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>();
+#else
+    std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(MPI_COMM_WORLD);
+#endif
+    dealii::GridGenerator::subdivided_hyper_cube(*grid, 2);
+    const double random_factor = 0.2;
+    const bool keep_boundary = false;
+    dealii::GridTools::distort_random (random_factor, *grid, keep_boundary);
+    for (auto &cell : grid->active_cell_iterators()) {
+        for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+            if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+        }
+    }
+    return grid;
+}
+
+/** This test checks that dRdW assembled with the statically allocated SFadType
+ *  matches the one assembled with the dynamically allocated FadType to round-off.
+ *  set_physics() discards the SFadType physics, such that the second assembly uses FadType.
+ *  The weak form is taped with CoDiPack and must not depend on the SFadType physics.
+ */
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, create_grid());
+    dg->allocate_system ();
+
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics_double = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+    dealii::LinearAlgebra::distributed::Vector<double> solution_no_ghost;
+    solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(dg->dof_handler, *(physics_double->manufactured_solution_function), solution_no_ghost);
+    dg->solution = solution_no_ghost;
+    dg->solution.update_ghost_values();
+    dg->solution_modified();
+
+    auto dg_state = std::dynamic_pointer_cast< DGBaseState<dim,nstate,double> >(dg);
+    if (!dg_state) return 1;
+    const unsigned int n_dofs_cell = nstate * std::pow(poly_degree+1, dim);
+    const bool face_uses_sfad = 2*n_dofs_cell <= static_cast<unsigned int>(n_static_fad_derivatives<dim,nstate>());
+    if (!all_parameters.use_weak_form && !face_uses_sfad) {
+        pcout << "Poly degree " << poly_degree << " does not fit in SFadType." << std::endl;
+        return 1;
+    }
+
+    dg->assemble_residual(true, false, false);
+    dealii::TrilinosWrappers::SparseMatrix dRdW_sfad;
+    dRdW_sfad.copy_from(dg->system_matrix);
+
+    dg_state->set_physics(dg_state->pde_physics_double, dg_state->pde_physics_fad, dg_state->pde_physics_rad,
+                          dg_state->pde_physics_fad_fad, dg_state->pde_physics_rad_fad);
+    // The residual depends on the physics, which set_physics() does not flag.
+    dg->solution_modified();
+    dg->assemble_residual(true, false, false);
+
+    const double dRdW_norm = dg->system_matrix.frobenius_norm();
+    dRdW_sfad.add(-1.0, dg->system_matrix);
+    const double rel_diff = dRdW_sfad.frobenius_norm() / dRdW_norm;
+
+    pcout << "Poly degree " << poly_degree << " (dRdW_SFad - dRdW_DFad) relative Frobenius norm = " << rel_diff << std::endl;
+    if (rel_diff > TOLERANCE) return 1;
+
+    return 0;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    int error = 0;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+
+    std::vector<PDEType> pde_type {
+        PDEType::advection,
+        PDEType::euler
+    };
+    std::vector<std::string> pde_name {
+        " PDEType::advection "
+        , " PDEType::euler "
+    };
+
+    int ipde = -1;
+    for (auto pde = pde_type.begin(); pde != pde_type.end() && error == 0; pde++) {
+        ipde++;
+        for (const bool use_weak_form : { false, true }) {
+            for (unsigned int poly_degree=1; poly_degree<=static_cast<unsigned int>(max_static_fad_degree) && error == 0; ++poly_degree) {
+                pcout << "Using " << pde_name[ipde] << "in " << (use_weak_form ? "weak" : "strong") << " form" << std::endl;
+                all_parameters.pde_type = *pde;
+                all_parameters.use_weak_form = use_weak_form;
+
+                if (*pde==PDEType::euler) {
+                    error = test<dim,dim+2>(poly_degree, all_parameters);
+                } else {
+                    error = test<dim,1>(poly_degree, all_parameters);
+                }
+            }
+        }
+    }
+
+    return error;
+}
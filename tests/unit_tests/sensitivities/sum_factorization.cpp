@@ -0,0 +1,129 @@
+#include <deal.II/base/tensor.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "dg/strong_dg.hpp"
+#include "parameters/parameters.h"
+#include "physics/physics_factory.h"
+
+using PDEType  = PHiLiP::Parameters::AllParameters::PartialDifferentialEquation;
+
+using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+
+/// Compares the strong-form explicit residual assembled with the sum-factorized volume kernels
+/// and with the dense evaluation, on a curved grid.
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    std::shared_ptr<Triangulation> grid,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    std::shared_ptr < DGBase<dim, double> > dg = DGFactory<dim,double>::create_discontinuous_galerkin(&all_parameters, poly_degree, grid);
+    dg->allocate_system ();
+    std::shared_ptr < DGStrong<dim, nstate, double> > dg_strong = std::dynamic_pointer_cast< DGStrong<dim, nstate, double> >(dg);
+    if (!dg_strong) {
+        pcout << "The factory did not create a DGStrong." << std::endl;
+        return 1;
+    }
+
+    pcout << "Poly degree " << poly_degree << " ncells " << grid->n_global_active_cells() << " ndofs: " << dg->dof_handler.n_dofs() << std::endl;
+
+    // Initialize solution with something
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics_double = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+    dealii::LinearAlgebra::distributed::Vector<double> solution_no_ghost;
+    solution_no_ghost.reinit(dg->locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(*(dg->high_order_grid->mapping_fe_field), dg->dof_handler, *(physics_double->manufactured_solution_function), solution_no_ghost);
+    dg->solution = solution_no_ghost;
+    dg->solution.update_ghost_values();
+    dg->solution_modified();
+
+    pcout << "Evaluating RHS with the sum-factorized volume terms..." << std::endl;
+    dg_strong->use_sum_factorization = true;
+    dg->assemble_residual();
+    dealii::LinearAlgebra::distributed::Vector<double> rhs_sum_factorized(dg->right_hand_side);
+
+    pcout << "Evaluating RHS with the dense volume terms..." << std::endl;
+    dg_strong->use_sum_factorization = false;
+    dg->assemble_residual();
+    dealii::LinearAlgebra::distributed::Vector<double> rhs_dense(dg->right_hand_side);
+
+    const double norm_rhs_dense = rhs_dense.l2_norm();
+    rhs_sum_factorized -= rhs_dense;
+    const double rel_diff = rhs_sum_factorized.l2_norm() / norm_rhs_dense;
+
+    // Both evaluate the same sums, in a different order.
+    const double tol = 1e-12;
+    pcout << "Sum-factorized vs dense relative difference: " << rel_diff << std::endl;
+    if (rel_diff > tol) return 1;
+
+    return 0;
+}
+
+int main (int argc, char * argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    int error = 0;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+    all_parameters.use_weak_form = false;
+
+    std::vector<PDEType> pde_type {
+        PDEType::advection,
+        PDEType::convection_diffusion,
+        PDEType::euler
+    };
+    std::vector<std::string> pde_name {
+        " PDEType::advection "
+        , " PDEType::convection_diffusion "
+        , " PDEType::euler "
+    };
+
+    int ipde = -1;
+    for (auto pde = pde_type.begin(); pde != pde_type.end() && error == 0; pde++) {
+        ipde++;
+        for (const bool use_collocated_nodes : { false, true }) {
+            for (unsigned int poly_degree=1; poly_degree<=3 && error == 0; ++poly_degree) {
+                pcout << "Using " << pde_name[ipde] << (use_collocated_nodes ? "with" : "without") << " collocated nodes" << std::endl;
+                all_parameters.pde_type = *pde;
+                all_parameters.use_collocated_nodes = use_collocated_nodes;
+
+                // Curved grid, whose high-order nodes follow the spherical manifold of the shell.
+                std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(MPI_COMM_WORLD);
+                const dealii::Point<dim> center;
+                const double inner_radius = 1.0;
+                const double outer_radius = 2.0;
+                dealii::GridGenerator::hyper_shell(*grid, center, inner_radius, outer_radius);
+                if (dim == 2) grid->refine_global(1);
+                for (auto &cell : grid->active_cell_iterators()) {
+                    for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+                        if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+                    }
+                }
+
+                if (*pde==PDEType::euler) {
+                    error = test<dim,dim+2>(poly_degree, grid, all_parameters);
+                } else {
+                    error = test<dim,1>(poly_degree, grid, all_parameters);
+                }
+            }
+        }
+    }
+
+    return error;
+}
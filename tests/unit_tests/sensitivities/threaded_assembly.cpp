@@ -0,0 +1,154 @@
+#include <deal.II/base/tensor.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "dg/dg_factory.hpp"
+#include "parameters/parameters.h"
+#include "physics/physics_factory.h"
+
+using PDEType  = PHiLiP::Parameters::AllParameters::PartialDifferentialEquation;
+
+#if PHILIP_DIM==1
+    using Triangulation = dealii::Triangulation<PHILIP_DIM>;
+#else
+    using Triangulation = dealii::parallel::distributed::Triangulation<PHILIP_DIM>;
+#endif
+
+/// Compares the residual assembled by the serial cell loop and by the graph-colored threaded cell loop.
+template<int dim, int nstate>
+int test (
+    const unsigned int poly_degree,
+    std::shared_ptr<Triangulation> grid,
+    const PHiLiP::Parameters::AllParameters &all_parameters)
+{
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    using namespace PHiLiP;
+
+    Parameters::AllParameters serial_parameters = all_parameters;
+    serial_parameters.use_threaded_assembly = false;
+    Parameters::AllParameters threaded_parameters = all_parameters;
+    threaded_parameters.use_threaded_assembly = true;
+
+    std::shared_ptr < DGBase<PHILIP_DIM, double> > dg_serial = DGFactory<PHILIP_DIM,double>::create_discontinuous_galerkin(&serial_parameters, poly_degree, grid);
+    dg_serial->allocate_system ();
+    std::shared_ptr < DGBase<PHILIP_DIM, double> > dg_threaded = DGFactory<PHILIP_DIM,double>::create_discontinuous_galerkin(&threaded_parameters, poly_degree, grid);
+    dg_threaded->allocate_system ();
+
+    pcout << "Poly degree " << poly_degree << " ncells " << grid->n_active_cells() << " ndofs: " << dg_serial->dof_handler.n_dofs() << std::endl;
+
+    // Initialize solution with something
+    std::shared_ptr <Physics::PhysicsBase<dim,nstate,double>> physics_double = Physics::PhysicsFactory<dim, nstate, double>::create_Physics(&all_parameters);
+    dealii::LinearAlgebra::distributed::Vector<double> solution_no_ghost;
+    solution_no_ghost.reinit(dg_serial->locally_owned_dofs, MPI_COMM_WORLD);
+    dealii::VectorTools::interpolate(*(dg_serial->high_order_grid->mapping_fe_field), dg_serial->dof_handler, *(physics_double->manufactured_solution_function), solution_no_ghost);
+    dg_serial->solution = solution_no_ghost;
+    dg_threaded->solution = solution_no_ghost;
+
+    pcout << "Evaluating RHS with the serial cell loop..." << std::endl;
+    dg_serial->assemble_residual();
+    dealii::LinearAlgebra::distributed::Vector<double> rhs_serial(dg_serial->right_hand_side);
+
+    pcout << "Evaluating RHS with the threaded cell loop..." << std::endl;
+    dg_threaded->assemble_residual();
+    dealii::LinearAlgebra::distributed::Vector<double> rhs_threaded(dg_threaded->right_hand_side);
+
+    const double norm_rhs_serial = rhs_serial.l2_norm();
+    rhs_threaded -= rhs_serial;
+    const double rel_diff = rhs_threaded.l2_norm() / norm_rhs_serial;
+
+    // Only the order of the summation of the face contributions differs.
+    const double tol = 1e-13;
+    pcout << "Error: threaded_vs_serial_rel_diff: " << rel_diff << std::endl;
+    if (rel_diff > tol) return 1;
+
+    return 0;
+}
+
+int main (int argc, char * argv[])
+{
+    const unsigned int n_threads = 4;
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, n_threads);
+    int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    dealii::ConditionalOStream pcout(std::cout, mpi_rank==0);
+    pcout << "Using " << dealii::MultithreadInfo::n_threads() << " threads per processor..." << std::endl;
+
+    using namespace PHiLiP;
+    const int dim = PHILIP_DIM;
+    int error = 0;
+
+    dealii::ParameterHandler parameter_handler;
+    Parameters::AllParameters::declare_parameters (parameter_handler);
+
+    Parameters::AllParameters all_parameters;
+    all_parameters.parse_parameters (parameter_handler);
+    std::vector<PDEType> pde_type {
+        PDEType::diffusion,
+        PDEType::advection,
+        PDEType::convection_diffusion,
+        PDEType::advection_vector,
+        PDEType::euler
+    };
+    std::vector<std::string> pde_name {
+        " PDEType::diffusion "
+        , " PDEType::advection "
+        , " PDEType::convection_diffusion "
+        , " PDEType::advection_vector "
+        , " PDEType::euler "
+    };
+
+    int ipde = -1;
+    for (auto pde = pde_type.begin(); pde != pde_type.end() && error == 0; pde++) {
+        ipde++;
+        for (unsigned int poly_degree=1; poly_degree<3 && error == 0; ++poly_degree) {
+            for (unsigned int igrid=2; igrid<5 && error == 0; ++igrid) {
+                pcout << "Using " << pde_name[ipde] << std::endl;
+                all_parameters.pde_type = *pde;
+                // Generate grids
+#if PHILIP_DIM==1
+                std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+                    typename dealii::Triangulation<dim>::MeshSmoothing(
+                        dealii::Triangulation<dim>::smoothing_on_refinement |
+                        dealii::Triangulation<dim>::smoothing_on_coarsening));
+#else
+                std::shared_ptr<Triangulation> grid = std::make_shared<Triangulation>(
+                    MPI_COMM_WORLD,
+                    typename dealii::Triangulation<dim>::MeshSmoothing(
+                        dealii::Triangulation<dim>::smoothing_on_refinement |
+                        dealii::Triangulation<dim>::smoothing_on_coarsening));
+#endif
+                dealii::GridGenerator::subdivided_hyper_cube(*grid, igrid);
+                const double random_factor = 0.3;
+                const bool keep_boundary = false;
+                if (random_factor > 0.0) dealii::GridTools::distort_random (random_factor, *grid, keep_boundary);
+                for (auto &cell : grid->active_cell_iterators()) {
+                    for (unsigned int face=0; face<dealii::GeometryInfo<dim>::faces_per_cell; ++face) {
+                        if (cell->face(face)->at_boundary()) cell->face(face)->set_boundary_id (1000);
+                    }
+                }
+                // Refine half of the cells to obtain hanging faces.
+                unsigned int icell = 0;
+                for (auto cell = grid->begin_active(); cell!=grid->end(); ++cell) {
+                    if (!cell->is_locally_owned()) continue;
+                    icell++;
+                    if (icell < grid->n_active_cells()/2) cell->set_refine_flag();
+                }
+                grid->execute_coarsening_and_refinement();
+
+                if (*pde==PDEType::euler) {
+                    error = test<dim,dim+2>(poly_degree, grid, all_parameters);
+                } else if (*pde==PDEType::advection_vector) {
+                    error = test<dim,2>(poly_degree, grid, all_parameters);
+                } else {
+                    error = test<dim,1>(poly_degree, grid, all_parameters);
+                }
+            }
+        }
+    }
+
+    return error;
+}
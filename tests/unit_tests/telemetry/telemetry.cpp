@@ -0,0 +1,77 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <deal.II/base/mpi.h>
+
+#include "telemetry/telemetry.h"
+
+namespace Telemetry = PHiLiP::Telemetry;
+
+/// Returns the line of the report describing the region @p path, or an empty string.
+std::string region_line (const std::string &report, const std::string &path)
+{
+    std::istringstream report_stream(report);
+    for (std::string line; std::getline(report_stream, line);) {
+        if (line.find("\"path\": \"" + path + "\"") != std::string::npos) return line;
+    }
+    return std::string();
+}
+
+int main (int argc, char *argv[])
+{
+    dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+    const int mpi_rank = dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+
+    // Not recorded since the timers are still disabled.
+    {
+        const Telemetry::ScopedTimer timer("disabled");
+    }
+
+    Telemetry::enable();
+    for (int i = 0; i < 3; ++i) {
+        const Telemetry::ScopedTimer step_timer("step");
+        {
+            const Telemetry::ScopedTimer assembly_timer("assembly");
+            Telemetry::add_work(100.0, 800.0);
+            // Only the first process enters this region, such that it is missing on the others.
+            if (mpi_rank == 0) {
+                const Telemetry::ScopedTimer face_timer("face");
+            }
+            const Telemetry::ScopedPause pause;
+            const Telemetry::ScopedTimer paused_timer("paused");
+        }
+        Telemetry::add_to_counter(Telemetry::n_vmult, 2);
+    }
+    Telemetry::disable();
+
+    const std::string filename = "telemetry_report.json";
+    Telemetry::write_report(filename, MPI_COMM_WORLD);
+
+    int error = 0;
+    if (Telemetry::counter_value(Telemetry::n_vmult) != 6) {
+        std::cout << "Wrong n_vmult counter: " << Telemetry::counter_value(Telemetry::n_vmult) << std::endl;
+        error = 1;
+    }
+    if (mpi_rank == 0) {
+        std::ifstream report_file(filename);
+        std::stringstream report_stream;
+        report_stream << report_file.rdbuf();
+        const std::string report = report_stream.str();
+        std::cout << report << std::endl;
+
+        const int n_mpi = dealii::Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+        const std::string three_calls = "\"calls\": {\"min\": 3, \"max\": 3, \"avg\": 3}";
+        if (region_line(report, "step").find(three_calls) == std::string::npos) error = 1;
+        if (region_line(report, "step/assembly").find(three_calls) == std::string::npos) error = 1;
+        if (region_line(report, "step/assembly").find("\"flops\": " + std::to_string(300*n_mpi)) == std::string::npos) error = 1;
+        if (region_line(report, "step/assembly/face").find("\"max\": 3") == std::string::npos) error = 1;
+        if (!region_line(report, "disabled").empty()) error = 1;
+        if (report.find("paused") != std::string::npos) error = 1;
+        if (report.find("\"n_vmult\": {\"min\": 6, \"max\": 6, \"avg\": 6}") == std::string::npos) error = 1;
+
+        if (error) std::cout << "The telemetry report does not match the timed regions." << std::endl;
+    }
+    return dealii::Utilities::MPI::max(error, MPI_COMM_WORLD);
+}